@@ -0,0 +1,238 @@
+/**
+ * @file backfit_hw1_wvuep.c
+ * @brief Source code file for least-squares growth rate fits to enrollment history for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * The fit of y = log(enrollment) against t = year - first_year needs five sums over the present
+ * years: n, sum t, sum t^2, sum y and sum t y. The kernel keeps each sum as four partial sums,
+ * one per lane, takes the logarithm of four enrollments at once with vector_log, and masks
+ * missing years out of every sum, so a whole row is fitted in one pass without branches. A row
+ * whose length is not a multiple of four ends with an overlapping load of its last four years,
+ * with the years already added masked out. The slope is
+ * (n sum t y - sum t sum y) / (n sum t^2 - (sum t)^2).
+ */
+
+#include "backfit_hw1_wvuep.h"
+#include "vector_hw1_wvuep.h"
+#include <string.h>
+#include <math.h>
+
+// The regression kernels inline the vector helpers, so the AVX argument-passing ABI never applies. GCC reports
+// it when the file ends, after any pop, so it is turned off for this file rather than around the kernels.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/**
+ * @brief Rows of enrollment history to fit on a worker pool
+ */
+struct backfit_job {
+	const int* enrollments; /**< Matrix of histories, one row per campus */
+	size_t campus_count; /**< Number of rows */
+	size_t year_count; /**< Number of columns */
+	double* growth_rates; /**< Output growth rate per campus */
+};
+
+/**
+ * @brief Regression sums over the present years, one partial sum per lane
+ */
+struct backfit_sums {
+	vector_double count; /**< Number of present years */
+	vector_double t; /**< Sum of t */
+	vector_double tt; /**< Sum of t^2 */
+	vector_double y; /**< Sum of log(enrollment) */
+	vector_double ty; /**< Sum of t log(enrollment) */
+};
+
+/**
+ * @brief Add the lanes of a vector
+ * @param x Vector to add up
+ * @return Sum of the lanes
+ */
+static inline __attribute__((always_inline)) double backfit_add_lanes(vector_double x)
+{
+	return (x[0] + x[1]) + (x[2] + x[3]);
+}
+
+/**
+ * @brief Accumulate the regression sums for four years
+ * @param values Enrollments of four consecutive years, 0 or below for missing years
+ * @param t Years since first_year of each lane
+ * @param sums Partial sums, updated
+ */
+static inline __attribute__((always_inline)) void backfit_accumulate(vector_int32 values, vector_double t, struct backfit_sums* sums)
+{
+	// Missing years take the logarithm of 1 and a weight of 0, so they add nothing
+	const vector_double one = { 1.0, 1.0, 1.0, 1.0 };
+	vector_double enrollment = __builtin_convertvector(values, vector_double);
+	vector_int64 present = enrollment > 0.0;
+	vector_double weight = (vector_double)((vector_int64)one & present);
+	vector_double log_enrollment = vector_log((vector_double)(((vector_int64)enrollment & present) | ((vector_int64)one & ~present)));
+
+	// Add this group to the partial sums
+	sums->count += weight;
+	sums->t += weight * t;
+	sums->tt += weight * t * t;
+	sums->y += log_enrollment;
+	sums->ty += t * log_enrollment;
+}
+
+/**
+ * @brief Fit one row of enrollment history
+ * @param enrollments Enrollment of each year, 0 or below for missing years
+ * @param year_count Number of years
+ * @return Least-squares growth rate, or NaN if fewer than two years are present
+ */
+static inline __attribute__((always_inline)) double backfit_kernel(const int* enrollments, size_t year_count)
+{
+	struct backfit_sums sums = { { 0.0 }, { 0.0 }, { 0.0 }, { 0.0 }, { 0.0 } };
+	vector_double t = { 0.0, 1.0, 2.0, 3.0 };
+
+	// Stream over the row four years at a time
+	size_t i = 0;
+	for (; i + VECTOR_DOUBLE_LANES <= year_count; i += VECTOR_DOUBLE_LANES)
+	{
+		vector_int32 values;
+		memcpy(&values, enrollments + i, sizeof(values));
+		backfit_accumulate(values, t, &sums);
+		t += (double)VECTOR_DOUBLE_LANES;
+	}
+
+	// Finish with the last four years of the row, marking the years already added as missing
+	if (i < year_count && year_count >= VECTOR_DOUBLE_LANES)
+	{
+		const vector_int32 lanes = { 0, 1, 2, 3 };
+		vector_int32 values;
+		memcpy(&values, enrollments + year_count - VECTOR_DOUBLE_LANES, sizeof(values));
+		values &= lanes >= (int)(i + VECTOR_DOUBLE_LANES - year_count);
+		backfit_accumulate(values, t - (double)(i + VECTOR_DOUBLE_LANES - year_count), &sums);
+	}
+
+	// Rows shorter than a vector are padded with missing years instead
+	else if (i < year_count)
+	{
+		vector_int32 values = { 0, 0, 0, 0 };
+		memcpy(&values, enrollments, year_count * sizeof(int));
+		backfit_accumulate(values, t, &sums);
+	}
+
+	// Add the lanes of each sum
+	double count = backfit_add_lanes(sums.count);
+	if (count < 2.0)
+	{
+		return NAN;
+	}
+	double sum_t = backfit_add_lanes(sums.t);
+	double sum_tt = backfit_add_lanes(sums.tt);
+	double sum_y = backfit_add_lanes(sums.y);
+	double sum_ty = backfit_add_lanes(sums.ty);
+
+	// Solve for the slope and turn it into a compound rate
+	double slope = (count * sum_ty - sum_t * sum_y) / (count * sum_tt - sum_t * sum_t);
+	return expm1(slope);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @brief Backfit kernel compiled for AVX2
+ */
+__attribute__((target("avx2"))) static void backfit_rows_avx2(const int* enrollments, size_t row_count, size_t year_count, double* growth_rates)
+{
+	for (size_t row = 0; row < row_count; row++)
+	{
+		growth_rates[row] = backfit_kernel(enrollments + row * year_count, year_count);
+	}
+}
+#endif
+
+/**
+ * @brief Backfit kernel compiled for the baseline instruction set (SSE2 on x86-64)
+ */
+static void backfit_rows_baseline(const int* enrollments, size_t row_count, size_t year_count, double* growth_rates)
+{
+	for (size_t row = 0; row < row_count; row++)
+	{
+		growth_rates[row] = backfit_kernel(enrollments + row * year_count, year_count);
+	}
+}
+
+/**
+ * @brief Fit consecutive rows with the widest kernel the CPU supports
+ * @param enrollments First row to fit
+ * @param row_count Number of rows
+ * @param year_count Number of years in each row
+ * @param growth_rates Output growth rate per row
+ */
+static void backfit_rows(const int* enrollments, size_t row_count, size_t year_count, double* growth_rates)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	if (__builtin_cpu_supports("avx2"))
+	{
+		backfit_rows_avx2(enrollments, row_count, year_count, growth_rates);
+		return;
+	}
+#endif
+	backfit_rows_baseline(enrollments, row_count, year_count, growth_rates);
+}
+
+double fit_growth_rate(const int* enrollments, int first_year, int last_year)
+{
+	// An empty range has nothing to fit
+	if (last_year < first_year)
+	{
+		return NAN;
+	}
+
+	double growth_rate;
+	backfit_rows(enrollments, 1, (size_t)((long long)last_year - first_year + 1), &growth_rate);
+	return growth_rate;
+}
+
+/**
+ * @brief Fit one tile of campuses
+ * @param context Pointer to the backfit_job
+ * @param task_index Index of the campus tile
+ * @param worker_index Unused
+ */
+static void fit_campus_tile(void* context, size_t task_index, unsigned int worker_index)
+{
+	(void)worker_index;
+	const struct backfit_job* job = context;
+
+	// Find the campuses in this tile
+	size_t first_campus = task_index * BACKFIT_TILE_CAMPUSES;
+	size_t campus_count = job->campus_count - first_campus;
+	if (campus_count > BACKFIT_TILE_CAMPUSES)
+	{
+		campus_count = BACKFIT_TILE_CAMPUSES;
+	}
+
+	backfit_rows(job->enrollments + first_campus * job->year_count, campus_count, job->year_count, job->growth_rates + first_campus);
+}
+
+void fit_growth_rates(struct worker_pool* pool, const int* enrollments, size_t campus_count, int first_year, int last_year, double* growth_rates)
+{
+	// An empty range has nothing to fit
+	if (last_year < first_year)
+	{
+		for (size_t i = 0; i < campus_count; i++)
+		{
+			growth_rates[i] = NAN;
+		}
+		return;
+	}
+
+	struct backfit_job job = { enrollments, campus_count, (size_t)((long long)last_year - first_year + 1), growth_rates };
+	size_t tile_count = (campus_count + BACKFIT_TILE_CAMPUSES - 1) / BACKFIT_TILE_CAMPUSES;
+
+	// Run on the calling thread without a pool
+	if (pool == NULL)
+	{
+		for (size_t i = 0; i < tile_count; i++)
+		{
+			fit_campus_tile(&job, i, 0);
+		}
+		return;
+	}
+
+	worker_pool_run(pool, fit_campus_tile, &job, tile_count);
+}
@@ -0,0 +1,44 @@
+/**
+ * @file backfit_hw1_wvuep.h
+ * @brief Header file for least-squares growth rate fits to enrollment history for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * calculate_growth_rate uses two points of a campus' history. A backfit uses every year: it fits
+ * log(enrollment) = a + b * (year - first_year) by least squares and returns exp(b) - 1, the
+ * compound growth rate that best explains the whole series. Years with an enrollment of 0 or
+ * below are missing and left out of the fit.
+ *
+ * Histories for many campuses are stored as a matrix with one row per campus and one column per
+ * year from first_year through last_year. Each row is read once, with the sums of the
+ * regression accumulated four years at a time in vector registers.
+ */
+
+#pragma once
+
+#include "pool_hw1_wvuep.h"
+#include <stddef.h>
+
+/**
+ * @brief Number of campuses fitted by each task of fit_growth_rates
+ */
+#define BACKFIT_TILE_CAMPUSES 64
+
+/**
+ * @brief Fit the compound annual growth rate of one campus' enrollment history
+ * @param enrollments Enrollment for each year from first_year through last_year; 0 or below marks a missing year
+ * @param first_year Year of the first enrollment
+ * @param last_year Year of the last enrollment, not before first_year
+ * @return Least-squares growth rate, or NaN if fewer than two years are present
+ */
+double fit_growth_rate(const int* enrollments, int first_year, int last_year);
+
+/**
+ * @brief Fit the compound annual growth rates of many campuses' enrollment histories
+ * @param pool Pool to run on, or NULL to run on the calling thread
+ * @param enrollments Matrix of campus_count rows, each holding the enrollments of first_year through last_year
+ * @param campus_count Number of campuses
+ * @param first_year Year of the first column
+ * @param last_year Year of the last column, not before first_year
+ * @param growth_rates Output array receiving the growth rate of each campus, as fit_growth_rate returns it
+ */
+void fit_growth_rates(struct worker_pool* pool, const int* enrollments, size_t campus_count, int first_year, int last_year, double* growth_rates);
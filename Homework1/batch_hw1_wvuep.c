@@ -0,0 +1,221 @@
+/**
+ * @file batch_hw1_wvuep.c
+ * @brief Source code file for batch versions of the CS 350 Homework #1 enrollment model
+ * @author Rashaan Clay
+ *
+ * @details
+ * The growth rate kernel evaluates (target/initial)^(1/years) as exp(log(target/initial) * (1/years))
+ * four scenarios at a time. The log and exp approximations follow the fdlibm reductions and
+ * polynomials, written with GCC vector extensions so the same source compiles to AVX2 or SSE2.
+ *
+ * The classifier compares four rates against each threshold at once and adds the compare masks,
+ * which gives the category without a branch and the histogram counts without a second pass.
+ */
+
+#include "batch_hw1_wvuep.h"
+#include "hw1_wvuep.h"
+#include "vector_hw1_wvuep.h"
+#include <string.h>
+
+// The growth rate and classification kernels inline the vector helpers, so the AVX argument-passing ABI never
+// applies. GCC reports it when the file ends, so it is turned off for this file rather than around the kernels.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/**
+ * @brief Four bytes stored as the categories of four rates
+ */
+typedef unsigned char vector_uint8 __attribute__((vector_size(4)));
+
+/**
+ * @brief Number of scenarios processed per kernel iteration
+ */
+#define GROWTH_VECTOR_LANES 4
+
+/**
+ * @brief Calculate growth rates for every full group of lanes, returning how many scenarios were processed
+ * @param initial_enrollments Enrollment in initial_year for each scenario
+ * @param target_enrollments Target enrollment for target_year for each scenario
+ * @param initial_years Year for initial enrollment for each scenario
+ * @param target_years Year for target enrollment for each scenario
+ * @param growth_rates Output array receiving the growth rate for each scenario
+ * @param count Number of scenarios
+ * @return Number of scenarios processed
+ */
+static inline __attribute__((always_inline)) size_t growth_rates_kernel(const int* initial_enrollments, const int* target_enrollments, const int* initial_years, const int* target_years, double* growth_rates, size_t count)
+{
+	size_t i = 0;
+	for (; i + GROWTH_VECTOR_LANES <= count; i += GROWTH_VECTOR_LANES)
+	{
+		// Load four scenarios from each input array
+		vector_int32 initial_enrollment, target_enrollment, initial_year, target_year;
+		memcpy(&initial_enrollment, initial_enrollments + i, sizeof(initial_enrollment));
+		memcpy(&target_enrollment, target_enrollments + i, sizeof(target_enrollment));
+		memcpy(&initial_year, initial_years + i, sizeof(initial_year));
+		memcpy(&target_year, target_years + i, sizeof(target_year));
+
+		// Match the scalar operation order: ratio of doubles, reciprocal of integer year difference
+		vector_double ratio = __builtin_convertvector(target_enrollment, vector_double) / __builtin_convertvector(initial_enrollment, vector_double);
+		vector_double exponent = 1.0 / __builtin_convertvector(target_year - initial_year, vector_double);
+
+		// Compute growth factor and rate
+		vector_double rate = vector_exp(vector_log(ratio) * exponent) - 1.0;
+		memcpy(growth_rates + i, &rate, sizeof(rate));
+
+		// Recompute lanes the kernel cannot handle with the scalar function
+		vector_int64 supported = (ratio > 0.0) & (ratio < __builtin_inf()) & (exponent < __builtin_inf());
+		if (!(supported[0] & supported[1] & supported[2] & supported[3]))
+		{
+			for (size_t lane = 0; lane < GROWTH_VECTOR_LANES; lane++)
+			{
+				if (!supported[lane])
+				{
+					growth_rates[i + lane] = calculate_growth_rate(initial_enrollments[i + lane], target_enrollments[i + lane], initial_years[i + lane], target_years[i + lane]);
+				}
+			}
+		}
+	}
+
+	return i;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @brief Growth rate kernel compiled for AVX2
+ */
+__attribute__((target("avx2"))) static size_t growth_rates_kernel_avx2(const int* initial_enrollments, const int* target_enrollments, const int* initial_years, const int* target_years, double* growth_rates, size_t count)
+{
+	return growth_rates_kernel(initial_enrollments, target_enrollments, initial_years, target_years, growth_rates, count);
+}
+#endif
+
+/**
+ * @brief Growth rate kernel compiled for the baseline instruction set (SSE2 on x86-64)
+ */
+static size_t growth_rates_kernel_baseline(const int* initial_enrollments, const int* target_enrollments, const int* initial_years, const int* target_years, double* growth_rates, size_t count)
+{
+	return growth_rates_kernel(initial_enrollments, target_enrollments, initial_years, target_years, growth_rates, count);
+}
+
+void calculate_growth_rates(const int* initial_enrollments, const int* target_enrollments, const int* initial_years, const int* target_years, double* growth_rates, size_t count)
+{
+	// Select the widest kernel the CPU supports
+	size_t processed;
+#if defined(__x86_64__) || defined(__i386__)
+	if (__builtin_cpu_supports("avx2"))
+	{
+		processed = growth_rates_kernel_avx2(initial_enrollments, target_enrollments, initial_years, target_years, growth_rates, count);
+	}
+	else
+#endif
+	{
+		processed = growth_rates_kernel_baseline(initial_enrollments, target_enrollments, initial_years, target_years, growth_rates, count);
+	}
+
+	// Use the scalar function for the remaining scenarios
+	for (size_t i = processed; i < count; i++)
+	{
+		growth_rates[i] = calculate_growth_rate(initial_enrollments[i], target_enrollments[i], initial_years[i], target_years[i]);
+	}
+}
+
+/**
+ * @brief Classify every full group of lanes and count lanes below each threshold
+ * @param growth_rates Growth rates to classify
+ * @param categories Output array receiving the category of each rate
+ * @param count Number of rates
+ * @param below_thresholds Counts of rates below 0, 0.01, 0.02 and 0.04, incremented
+ * @return Number of rates processed
+ */
+static inline __attribute__((always_inline)) size_t classify_kernel(const double* growth_rates, unsigned char* categories, size_t count, size_t below_thresholds[4])
+{
+	// Compare masks are -1 for true lanes, so subtracting them counts and adding them lowers the category
+	vector_int64 below_zero = { 0 }, below_ambitious = { 0 }, below_high = { 0 }, below_unreasonable = { 0 };
+
+	size_t i = 0;
+	for (; i + GROWTH_VECTOR_LANES <= count; i += GROWTH_VECTOR_LANES)
+	{
+		vector_double rate;
+		memcpy(&rate, growth_rates + i, sizeof(rate));
+
+		// Same thresholds and comparisons as get_growth_rate_description
+		vector_int64 negative = rate < 0.0;
+		vector_int64 reasonable = rate < 0.01;
+		vector_int64 ambitious = rate < 0.02;
+		vector_int64 high = rate < 0.04;
+
+		vector_int64 category = GROWTH_RATE_UNREASONABLE + negative + reasonable + ambitious + high;
+		vector_uint8 bytes = __builtin_convertvector(category, vector_uint8);
+		memcpy(categories + i, &bytes, sizeof(bytes));
+
+		below_zero -= negative;
+		below_ambitious -= reasonable;
+		below_high -= ambitious;
+		below_unreasonable -= high;
+	}
+
+	// Add the lanes together
+	vector_int64* counters[] = { &below_zero, &below_ambitious, &below_high, &below_unreasonable };
+	for (size_t threshold = 0; threshold < 4; threshold++)
+	{
+		vector_int64 counter = *counters[threshold];
+		below_thresholds[threshold] += (size_t)(counter[0] + counter[1] + counter[2] + counter[3]);
+	}
+
+	return i;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @brief Classification kernel compiled for AVX2
+ */
+__attribute__((target("avx2"))) static size_t classify_kernel_avx2(const double* growth_rates, unsigned char* categories, size_t count, size_t below_thresholds[4])
+{
+	return classify_kernel(growth_rates, categories, count, below_thresholds);
+}
+#endif
+
+/**
+ * @brief Classification kernel compiled for the baseline instruction set (SSE2 on x86-64)
+ */
+static size_t classify_kernel_baseline(const double* growth_rates, unsigned char* categories, size_t count, size_t below_thresholds[4])
+{
+	return classify_kernel(growth_rates, categories, count, below_thresholds);
+}
+
+void classify_growth_rates(const double* growth_rates, unsigned char* categories, size_t count, size_t* histogram)
+{
+	// Select the widest kernel the CPU supports
+	size_t below_thresholds[4] = { 0, 0, 0, 0 };
+	size_t processed;
+#if defined(__x86_64__) || defined(__i386__)
+	if (__builtin_cpu_supports("avx2"))
+	{
+		processed = classify_kernel_avx2(growth_rates, categories, count, below_thresholds);
+	}
+	else
+#endif
+	{
+		processed = classify_kernel_baseline(growth_rates, categories, count, below_thresholds);
+	}
+
+	// Classify the remaining rates one at a time
+	for (size_t i = processed; i < count; i++)
+	{
+		enum growth_rate_category category = classify_growth_rate(growth_rates[i]);
+		categories[i] = (unsigned char)category;
+		below_thresholds[0] += category <= GROWTH_RATE_NEGATIVE;
+		below_thresholds[1] += category <= GROWTH_RATE_REASONABLE;
+		below_thresholds[2] += category <= GROWTH_RATE_AMBITIOUS;
+		below_thresholds[3] += category <= GROWTH_RATE_HIGH;
+	}
+
+	// Each category's count is the difference between the counts below its bounds
+	if (histogram != NULL)
+	{
+		histogram[GROWTH_RATE_NEGATIVE] = below_thresholds[0];
+		histogram[GROWTH_RATE_REASONABLE] = below_thresholds[1] - below_thresholds[0];
+		histogram[GROWTH_RATE_AMBITIOUS] = below_thresholds[2] - below_thresholds[1];
+		histogram[GROWTH_RATE_HIGH] = below_thresholds[3] - below_thresholds[2];
+		histogram[GROWTH_RATE_UNREASONABLE] = count - below_thresholds[3];
+	}
+}
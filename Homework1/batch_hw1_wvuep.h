@@ -0,0 +1,79 @@
+/**
+ * @file batch_hw1_wvuep.h
+ * @brief Header file for batch versions of the CS 350 Homework #1 enrollment model
+ * @author Rashaan Clay
+ *
+ * Batch functions take struct-of-arrays inputs (one array per parameter) so that many
+ * scenarios can be evaluated in a single call with vectorized kernels.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * @brief Maximum difference between calculate_growth_rates and calculate_growth_rate
+ *
+ * The difference is measured in units in the last place (ULP) of 1 + |growth rate|, the scale of the
+ * growth factor both functions compute before subtracting 1. The bound holds for growth rates with
+ * magnitude below 1 (100% per year). Larger rates lose about one more ULP per unit of log(1 + growth rate).
+ */
+#define GROWTH_RATES_MAX_ULP 2
+
+/**
+ * @brief Number of growth rate categories
+ */
+#define GROWTH_RATE_CATEGORY_COUNT 5
+
+/**
+ * @brief Categories of get_growth_rate_description, in increasing order of growth rate
+ */
+enum growth_rate_category {
+	GROWTH_RATE_NEGATIVE = 0, /**< Below 0 */
+	GROWTH_RATE_REASONABLE = 1, /**< At least 0 and below 1% */
+	GROWTH_RATE_AMBITIOUS = 2, /**< At least 1% and below 2% */
+	GROWTH_RATE_HIGH = 3, /**< At least 2% and below 4% */
+	GROWTH_RATE_UNREASONABLE = 4, /**< At least 4%, or NaN */
+};
+
+/**
+ * @brief Get the category of a growth rate without branching
+ *
+ * Uses the same thresholds and comparisons as get_growth_rate_description, so NaN is unreasonable
+ * and -0.0 is reasonable.
+ *
+ * @param growth_rate Growth rate to classify
+ * @return Category of the growth rate
+ */
+static inline enum growth_rate_category classify_growth_rate(double growth_rate)
+{
+	return (enum growth_rate_category)(GROWTH_RATE_UNREASONABLE - (growth_rate < 0.04) - (growth_rate < 0.02) - (growth_rate < 0.01) - (growth_rate < 0));
+}
+
+/**
+ * @brief Calculate annual growth rates for many scenarios using the formula ((target_enrollment/initial_enrollment)^(1/years) - 1)
+ *
+ * Uses an AVX2 kernel when the CPU supports it, an SSE2 kernel otherwise, and calculate_growth_rate
+ * for any scenario the kernels cannot handle (equal years, non-positive enrollment ratios).
+ *
+ * @param initial_enrollments Enrollment in initial_year for each scenario
+ * @param target_enrollments Target enrollment for target_year for each scenario
+ * @param initial_years Year for initial enrollment for each scenario
+ * @param target_years Year for target enrollment for each scenario
+ * @param growth_rates Output array receiving the growth rate for each scenario
+ * @param count Number of scenarios
+ */
+void calculate_growth_rates(const int* initial_enrollments, const int* target_enrollments, const int* initial_years, const int* target_years, double* growth_rates, size_t count);
+
+/**
+ * @brief Classify many growth rates into categories, optionally counting each category in the same pass
+ *
+ * Compares four rates at a time with vector compares. Every category equals classify_growth_rate
+ * for the same rate.
+ *
+ * @param growth_rates Growth rates to classify
+ * @param categories Output array receiving an enum growth_rate_category value for each rate
+ * @param count Number of rates
+ * @param histogram Array of GROWTH_RATE_CATEGORY_COUNT counts set to the number of rates in each category, or NULL
+ */
+void classify_growth_rates(const double* growth_rates, unsigned char* categories, size_t count, size_t* histogram);
@@ -0,0 +1,166 @@
+/**
+ * @file bench_ctest_hw1_wvuep.c
+ * @brief Benchmark of the ctest fork server for CS 350 Homework #1: WVU Enrollment Problem
+ * @author Rashaan Clay
+ *
+ * Build together with hw1_wvuep.c, the other module source files, ctest.c and unity.c, without
+ * main_hw1_wvuep.c or test_hw1_wvuep.c. Times CALL_FUNCTION_DOUBLE(calculate_growth_rate, ...)
+ * with the fork server and with a plain fork of the calling process, first from a small process
+ * and then after the process has touched a large heap, which a plain fork has to copy the page
+ * tables of while the fork server, started before the heap grew, does not. The optional argument is the number of calls per measurement.
+ */
+
+// Use GNU source for clock_gettime
+#define _GNU_SOURCE // NOLINT(*-reserved-identifier)
+
+// Set timeout for forked processes
+#define TIMEOUT_SECONDS 15
+
+// Run CALL_FUNCTION_* children from the fork server while it is running
+#define USE_FORK_SERVER 1 // True
+
+#include "hw1_wvuep.h"
+#include "ctest.h"
+#include "unity.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+/**
+ * @brief Number of calls per measurement when no argument is given
+ */
+#define BENCH_CTEST_DEFAULT_CALLS 2000
+
+/**
+ * @brief Size of the heap touched before the second pair of measurements
+ */
+#define BENCH_CTEST_HEAP_BYTES ((size_t)256 * 1024 * 1024)
+
+/**
+ * @brief Tracks if the calculate_growth_rate function has been implemented, as in test_hw1_wvuep.c
+ */
+static bool not_implemented_calculate_growth_rate = false;
+
+/**
+ * @brief Tracks if the calculate_growth_rate function has crashed, as in test_hw1_wvuep.c
+ */
+static bool crashes_calculate_growth_rate = false;
+
+// Declare the function called by CALL_FUNCTION_DOUBLE for the fork server
+FORK_SERVER_FUNCTION(calculate_growth_rate, double, int, int, int, int)
+
+void setUp(void)
+{
+	// set up test environment
+}
+
+void tearDown(void)
+{
+	// clean up test environment
+}
+
+/**
+ * @brief Get the current time from a monotonic clock
+ * @return Time in seconds
+ */
+static double bench_ctest_get_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Time calls of calculate_growth_rate through CALL_FUNCTION_DOUBLE
+ * @param calls Number of calls
+ * @return Calls per second, or 0 if a call failed
+ */
+static double bench_ctest_calls_per_second(long calls)
+{
+	double start = bench_ctest_get_time();
+	if (!TEST_PROTECT())
+	{
+		return 0.0;
+	}
+	for (long i = 0; i < calls; i++)
+	{
+		CALL_FUNCTION_DOUBLE(calculate_growth_rate, 30000, 36000 + (int)(i % 1000), 2024, 2034);
+	}
+
+	return (double)calls / (bench_ctest_get_time() - start);
+}
+
+/**
+ * @brief Time calls with the running fork server, stop it, then time calls with a plain fork and print the speedup
+ * @param label Description of the process state
+ * @param calls Number of calls per measurement
+ * @return True on success, false if a measurement failed
+ */
+static bool bench_ctest_compare(const char* label, long calls)
+{
+	// Time the fork server
+	double server_rate = bench_ctest_calls_per_second(calls);
+	stop_fork_server();
+
+	// Time a plain fork of this process
+	double fork_rate = bench_ctest_calls_per_second(calls);
+	if (server_rate <= 0.0 || fork_rate <= 0.0)
+	{
+		fprintf(stderr, "Could not call calculate_growth_rate in a child process.\n");
+		return false;
+	}
+
+	printf("%s:\n", label);
+	printf("  fork server: %8.0f calls/s\n", server_rate);
+	printf("  plain fork:  %8.0f calls/s\n", fork_rate);
+	printf("  Speedup: %.2fx\n", server_rate / fork_rate);
+
+	return true;
+}
+
+/**
+ * @brief Program entry point
+ * @param argc Number of arguments
+ * @param argv Arguments; argv[1] is the number of calls per measurement
+ * @return Status code
+ */
+int main(int argc, char** argv)
+{
+	// Read the number of calls
+	long calls = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_CTEST_DEFAULT_CALLS;
+	if (calls <= 0)
+	{
+		fprintf(stderr, "Usage: %s [calls]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// Compare from a small process
+	printf("%ld calls of calculate_growth_rate per measurement\n", calls);
+	if (!start_fork_server() || !bench_ctest_compare("Small heap", calls))
+	{
+		return EXIT_FAILURE;
+	}
+
+	// Start the fork server early, as run_tests does, then touch a large heap as a suite does once it has run for a while
+	if (!start_fork_server())
+	{
+		return EXIT_FAILURE;
+	}
+	unsigned char* heap = malloc(BENCH_CTEST_HEAP_BYTES);
+	if (heap == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		stop_fork_server();
+		return EXIT_FAILURE;
+	}
+	memset(heap, 1, BENCH_CTEST_HEAP_BYTES);
+	bool succeeded = bench_ctest_compare("256 MB heap", calls);
+
+	// Free memory
+	free(heap);
+
+	return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,1597 @@
+/**
+ * @file bench_hw1_wvuep.c
+ * @brief Benchmarks source code file for CS 350 Homework #1: WVU Enrollment Problem
+ * @author Rashaan Clay
+ *
+ * Build together with hw1_wvuep.c and the other module source files, without main_hw1_wvuep.c.
+ */
+
+// Use GNU source for clock_gettime
+#define _GNU_SOURCE // NOLINT(*-reserved-identifier)
+
+#include "hw1_wvuep.h"
+#include "batch_hw1_wvuep.h"
+#include "series_hw1_wvuep.h"
+#include "table_hw1_wvuep.h"
+#include "engine_hw1_wvuep.h"
+#include "ingest_hw1_wvuep.h"
+#include "results_hw1_wvuep.h"
+#include "targets_hw1_wvuep.h"
+#include "montecarlo_hw1_wvuep.h"
+#include "schedule_hw1_wvuep.h"
+#include "server_hw1_wvuep.h"
+#include "factor_hw1_wvuep.h"
+#include "fixedpoint_hw1_wvuep.h"
+#include "backfit_hw1_wvuep.h"
+#include "sensitivity_hw1_wvuep.h"
+#include "bench_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/**
+ * @brief Number of scenarios used by the growth rate benchmarks
+ */
+#define BENCH_SCENARIOS 4000000
+
+/**
+ * @brief Number of years in the long-horizon projection benchmarks
+ */
+#define BENCH_HORIZON_YEARS 10000
+
+/**
+ * @brief Number of campus tables printed by the output benchmarks
+ */
+#define BENCH_CAMPUSES 1000
+
+/**
+ * @brief Number of campuses projected by the engine scaling benchmark
+ */
+#define BENCH_ENGINE_CAMPUSES 200000
+
+/**
+ * @brief Last year projected by the engine scaling benchmark, starting from 2024
+ */
+#define BENCH_ENGINE_LAST_YEAR 2073
+
+/**
+ * @brief Number of rows in the CSV ingest benchmark file
+ */
+#define BENCH_CSV_ROWS 4000000
+
+/**
+ * @brief Number of campuses in the results file benchmark
+ */
+#define BENCH_RESULTS_CAMPUSES 20000
+
+/**
+ * @brief Number of single campus/year lookups timed in the results file benchmark
+ */
+#define BENCH_RESULTS_LOOKUPS 1000000
+
+/**
+ * @brief Number of targets in the target input benchmark
+ */
+#define BENCH_TARGETS 2000000
+
+/**
+ * @brief Number of paths in the Monte Carlo benchmark
+ */
+#define BENCH_MONTE_CARLO_PATHS 1000000
+
+/**
+ * @brief Last year simulated by the Monte Carlo benchmark, starting from 2024
+ */
+#define BENCH_MONTE_CARLO_LAST_YEAR 2054
+
+/**
+ * @brief Number of segments in the growth schedule benchmark
+ */
+#define BENCH_SCHEDULE_SEGMENTS 64
+
+/**
+ * @brief Number of random years estimated in the growth schedule benchmark
+ */
+#define BENCH_SCHEDULE_QUERIES 2000000
+
+/**
+ * @brief Number of client threads in the projection server load test
+ */
+#define BENCH_SERVER_CLIENTS 4
+
+/**
+ * @brief Number of requests each client sends in the projection server load test
+ */
+#define BENCH_SERVER_REQUESTS 25000
+
+/**
+ * @brief Number of distinct campuses the load test's requests are drawn from
+ */
+#define BENCH_SERVER_CAMPUSES 1024
+
+/**
+ * @brief Number of campuses projected in the fixed-point benchmark
+ */
+#define BENCH_FIXED_POINT_CAMPUSES 20000
+
+/**
+ * @brief Most years between the initial and target years in the fixed-point benchmark
+ */
+#define BENCH_FIXED_POINT_YEARS 50
+
+/**
+ * @brief Number of campus histories fitted in the backfit benchmark
+ */
+#define BENCH_BACKFIT_CAMPUSES 100000
+
+/**
+ * @brief Number of years in each history of the backfit benchmark
+ */
+#define BENCH_BACKFIT_YEARS 25
+
+/**
+ * @brief Number of campuses in the sensitivity benchmark
+ */
+#define BENCH_SENSITIVITY_CAMPUSES 20000
+
+/**
+ * @brief Last year estimated in the sensitivity benchmarks, starting from 2024
+ */
+#define BENCH_SENSITIVITY_LAST_YEAR 2123
+
+/**
+ * @brief Number of rates in the sensitivity grid benchmark, -10% to 10% in basis points
+ */
+#define BENCH_SENSITIVITY_RATES 2001
+
+/**
+ * @brief Per client load test state
+ */
+struct bench_server_client {
+	const char* path; /**< Socket path of the server */
+	unsigned int seed; /**< Seed for choosing campuses */
+	double* latencies; /**< Latency of each request in seconds */
+	bool failed; /**< Set if a request failed */
+};
+
+/**
+ * @brief Program entry point
+ * @return Status code
+ */
+int main(void)
+{
+	// Turn off buffering like run_tests does, so printed output costs what it does in the program
+	setbuf(stdout, NULL);
+	setbuf(stderr, NULL);
+
+	// Seed random number generator with a fixed value so runs are comparable
+	srand(350);
+
+	run_benchmarks();
+
+	return 0;
+}
+
+void run_benchmarks(void)
+{
+	// Display status
+	puts("");
+	puts("==========");
+	puts("Running benchmarks...");
+	puts("");
+
+	puts("Step 3a: Running calculate_growth_rates benchmark...");
+	bench_3a_calculate_growth_rates();
+
+	puts("");
+	puts("Step 3b: Running calculate_enrollment_estimates benchmark...");
+	bench_3b_calculate_enrollment_estimates();
+
+	puts("");
+	puts("Step 3c: Running buffered table benchmark...");
+	bench_3c_print_enrollment_estimates_buffered();
+
+	puts("");
+	puts("Step 3d: Running multi-campus projection engine scaling benchmark...");
+	bench_3d_project_campuses();
+
+	puts("");
+	puts("Step 3e: Running CSV ingest benchmark...");
+	bench_3e_load_campus_csv();
+
+	puts("");
+	puts("Step 3f: Running binary results file benchmark...");
+	bench_3f_projection_file();
+
+	puts("");
+	puts("Step 3g: Running classify_growth_rates benchmark...");
+	bench_3g_classify_growth_rates();
+
+	puts("");
+	puts("Step 3h: Running read_target_enrollments benchmark...");
+	bench_3h_read_target_enrollments();
+
+	puts("");
+	puts("Step 3i: Running Monte Carlo uncertainty band scaling benchmark...");
+	bench_3i_simulate_enrollment_bands();
+
+	puts("");
+	puts("Step 3j: Running growth schedule benchmark...");
+	bench_3j_calculate_scheduled_enrollment_estimate();
+
+	puts("");
+	puts("Step 3k: Running projection server load test...");
+	bench_3k_projection_server();
+
+	puts("");
+	puts("Step 3l: Running growth factor table benchmark...");
+	bench_3l_growth_factor_table();
+
+	puts("");
+	puts("Step 3m: Running fixed-point projection benchmark...");
+	bench_3m_fixed_point_projection();
+
+	puts("");
+	puts("Step 3n: Running growth rate backfit benchmark...");
+	bench_3n_fit_growth_rates();
+
+	puts("");
+	puts("Step 3o: Running growth rate sensitivity benchmark...");
+	bench_3o_calculate_enrollment_sensitivities();
+
+	// Display blank lines
+	puts("");
+	puts("==========");
+	puts("");
+}
+
+double bench_get_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+void bench_3a_calculate_growth_rates(void)
+{
+	// Allocate struct-of-arrays scenarios
+	const size_t count = BENCH_SCENARIOS;
+	int* initial_enrollments = malloc(count * sizeof(int));
+	int* target_enrollments = malloc(count * sizeof(int));
+	int* initial_years = malloc(count * sizeof(int));
+	int* target_years = malloc(count * sizeof(int));
+	double* growth_rates = malloc(count * sizeof(double));
+	if (initial_enrollments == NULL || target_enrollments == NULL || initial_years == NULL || target_years == NULL || growth_rates == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	// Fill scenarios with planning-sweep style values
+	for (size_t i = 0; i < count; i++)
+	{
+		initial_enrollments[i] = rand() % 30000 + 10000; // NOLINT(*-msc50-cpp)
+		target_enrollments[i] = rand() % 60000 + 1000; // NOLINT(*-msc50-cpp)
+		initial_years[i] = 2024;
+		target_years[i] = 2024 + rand() % 50 + 1; // NOLINT(*-msc50-cpp)
+	}
+
+	// Time the scalar function, keeping the fastest run
+	double scalar_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		for (size_t i = 0; i < count; i++)
+		{
+			growth_rates[i] = calculate_growth_rate(initial_enrollments[i], target_enrollments[i], initial_years[i], target_years[i]);
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < scalar_seconds)
+		{
+			scalar_seconds = elapsed;
+		}
+	}
+
+	// Time the batch function, keeping the fastest run
+	double batch_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		calculate_growth_rates(initial_enrollments, target_enrollments, initial_years, target_years, growth_rates, count);
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < batch_seconds)
+		{
+			batch_seconds = elapsed;
+		}
+	}
+
+	// Report throughput
+	printf("calculate_growth_rate:  %8.2f M scenarios/s (%.2f ns/scenario)\n", (double)count / scalar_seconds * 1e-6, scalar_seconds / (double)count * 1e9);
+	printf("calculate_growth_rates: %8.2f M scenarios/s (%.2f ns/scenario)\n", (double)count / batch_seconds * 1e-6, batch_seconds / (double)count * 1e9);
+	printf("Speedup: %.2fx\n", scalar_seconds / batch_seconds);
+
+	// Free memory
+	free(initial_enrollments);
+	free(target_enrollments);
+	free(initial_years);
+	free(target_years);
+	free(growth_rates);
+}
+
+void bench_3b_calculate_enrollment_estimates(void)
+{
+	// Allocate room for one long-horizon table
+	const int years = BENCH_HORIZON_YEARS;
+	int* estimates = malloc((size_t)years * sizeof(int));
+	if (estimates == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	// Time one pow per year, keeping the fastest run
+	double pow_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		for (int i = 0; i < years; i++)
+		{
+			estimates[i] = calculate_enrollment_estimate(25994, 0.0001, 2024, 2024 + i);
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < pow_seconds)
+		{
+			pow_seconds = elapsed;
+		}
+	}
+
+	// Time the projection series, keeping the fastest run
+	double series_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		calculate_enrollment_estimates(25994, 0.0001, 2024, 2024 + years - 1, estimates);
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < series_seconds)
+		{
+			series_seconds = elapsed;
+		}
+	}
+
+	// Report time per projected year
+	printf("calculate_enrollment_estimate:  %8.2f ns/year\n", pow_seconds / years * 1e9);
+	printf("calculate_enrollment_estimates: %8.2f ns/year\n", series_seconds / years * 1e9);
+	printf("Speedup: %.2fx\n", pow_seconds / series_seconds);
+
+	// Free memory
+	free(estimates);
+}
+
+void bench_3c_print_enrollment_estimates_buffered(void)
+{
+	// Send stdout to /dev/null while timing
+	int null_fd = open("/dev/null", O_WRONLY);
+	int saved_stdout = dup(STDOUT_FILENO);
+	if (null_fd < 0 || saved_stdout < 0)
+	{
+		fprintf(stderr, "Could not redirect output: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	dup2(null_fd, STDOUT_FILENO);
+
+	// Time one printf per line, keeping the fastest run
+	double printf_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		for (int campus = 0; campus < BENCH_CAMPUSES; campus++)
+		{
+			print_enrollment_estimates(25994 + campus, 0.01, 2024, 2070);
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < printf_seconds)
+		{
+			printf_seconds = elapsed;
+		}
+	}
+
+	// Time all campus tables formatted into one arena and written at once, keeping the fastest run
+	struct table_buffer buffer;
+	if (!table_buffer_init(&buffer, NULL, 0))
+	{
+		exit(EXIT_FAILURE);
+	}
+	double buffered_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		for (int campus = 0; campus < BENCH_CAMPUSES; campus++)
+		{
+			table_buffer_append_enrollment_estimates(&buffer, 25994 + campus, 0.01, 2024, 2070);
+		}
+		table_buffer_flush(&buffer, STDOUT_FILENO);
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < buffered_seconds)
+		{
+			buffered_seconds = elapsed;
+		}
+	}
+	table_buffer_free(&buffer);
+
+	// Redirect output to original destination
+	dup2(saved_stdout, STDOUT_FILENO);
+	close(saved_stdout);
+	close(null_fd);
+
+	// Report time per campus table
+	printf("print_enrollment_estimates:  %8.2f us/campus (%d writes)\n", printf_seconds / BENCH_CAMPUSES * 1e6, (2070 - 2024 + 1) * BENCH_CAMPUSES);
+	printf("table_buffer (one flush):    %8.2f us/campus (1 write)\n", buffered_seconds / BENCH_CAMPUSES * 1e6);
+	printf("Speedup: %.2fx\n", printf_seconds / buffered_seconds);
+}
+
+void bench_3d_project_campuses(void)
+{
+	// Build campuses and a matrix for the whole horizon
+	struct campus_table campuses;
+	struct projection_matrix matrix;
+	if (!campus_table_init(&campuses, BENCH_ENGINE_CAMPUSES) || !projection_matrix_init(&matrix, BENCH_ENGINE_CAMPUSES, 2024, BENCH_ENGINE_LAST_YEAR))
+	{
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i < BENCH_ENGINE_CAMPUSES; i++)
+	{
+		campus_table_add(&campuses, rand() % 30000 + 10000, 2024, rand() % 60000 + 1000, 2024 + rand() % 50 + 1); // NOLINT(*-msc50-cpp)
+	}
+	double estimates = (double)BENCH_ENGINE_CAMPUSES * (double)matrix.year_count;
+
+	// Go up to at least 4 threads so the table has the same rows on small machines
+	unsigned int processors = worker_pool_default_thread_count();
+	unsigned int max_threads = processors > 4 ? processors : 4;
+	printf("%u processors online, %d campuses x %zu years\n", processors, BENCH_ENGINE_CAMPUSES, matrix.year_count);
+
+	// Time each pool size, keeping the fastest run
+	double single_seconds = 0.0;
+	for (unsigned int threads = 1; threads <= max_threads; threads *= 2)
+	{
+		struct worker_pool pool;
+		if (!worker_pool_init(&pool, threads))
+		{
+			exit(EXIT_FAILURE);
+		}
+
+		double seconds = 0.0;
+		for (int run = 0; run < BENCH_REPETITIONS; run++)
+		{
+			double start = bench_get_time();
+			project_campuses(&pool, &campuses, &matrix);
+			double elapsed = bench_get_time() - start;
+			if (run == 0 || elapsed < seconds)
+			{
+				seconds = elapsed;
+			}
+		}
+		worker_pool_free(&pool);
+
+		// Report throughput and scaling relative to one thread
+		if (threads == 1)
+		{
+			single_seconds = seconds;
+		}
+		printf("%3u threads: %8.2f M estimates/s, speedup %.2fx%s\n", threads, estimates / seconds * 1e-6, single_seconds / seconds, threads > processors ? " (more threads than processors)" : "");
+	}
+
+	// Free memory
+	projection_matrix_free(&matrix);
+	campus_table_free(&campuses);
+}
+
+void bench_3e_load_campus_csv(void)
+{
+	// Write a CSV file of campus histories
+	char filename[] = "/tmp/bench_hw1_wvuep_XXXXXX";
+	int fd = mkstemp(filename);
+	FILE* file = fd < 0 ? NULL : fdopen(fd, "w");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Could not create %s: %s.\n", filename, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	fprintf(file, "initial_enrollment,target_enrollment,initial_year,target_year\n");
+	for (int i = 0; i < BENCH_CSV_ROWS; i++)
+	{
+		fprintf(file, "%d,%d,%d,%d\n", rand() % 30000 + 10000, rand() % 60000 + 1000, 2024, 2024 + rand() % 50 + 1); // NOLINT(*-msc50-cpp)
+	}
+	double gigabytes = (double)ftell(file) * 1e-9;
+	fclose(file);
+
+	// Time fscanf as a baseline, keeping the fastest run
+	struct campus_table campuses;
+	if (!campus_table_init(&campuses, BENCH_CSV_ROWS))
+	{
+		exit(EXIT_FAILURE);
+	}
+	double fscanf_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		file = fopen(filename, "r");
+		if (file == NULL)
+		{
+			fprintf(stderr, "Could not open %s: %s.\n", filename, strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+		campuses.count = 0;
+		fscanf(file, "%*[^\n]\n");
+		int initial_enrollment, target_enrollment, initial_year, target_year;
+		while (fscanf(file, "%d,%d,%d,%d\n", &initial_enrollment, &target_enrollment, &initial_year, &target_year) == 4)
+		{
+			campus_table_add(&campuses, initial_enrollment, initial_year, target_enrollment, target_year);
+		}
+		fclose(file);
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < fscanf_seconds)
+		{
+			fscanf_seconds = elapsed;
+		}
+	}
+	printf("fscanf:                       %8.3f GB/s\n", gigabytes / fscanf_seconds);
+
+	// Time the mapped loader on one thread and on a pool with one worker per processor
+	unsigned int thread_counts[] = { 1, worker_pool_default_thread_count() };
+	for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++)
+	{
+		if (t > 0 && thread_counts[t] == 1)
+		{
+			break;
+		}
+
+		struct worker_pool pool;
+		if (!worker_pool_init(&pool, thread_counts[t]))
+		{
+			exit(EXIT_FAILURE);
+		}
+		double seconds = 0.0;
+		for (int run = 0; run < BENCH_REPETITIONS; run++)
+		{
+			double start = bench_get_time();
+			campuses.count = 0;
+			if (!load_campus_csv(filename, &pool, &campuses, NULL))
+			{
+				exit(EXIT_FAILURE);
+			}
+			double elapsed = bench_get_time() - start;
+			if (run == 0 || elapsed < seconds)
+			{
+				seconds = elapsed;
+			}
+		}
+		worker_pool_free(&pool);
+
+		printf("load_campus_csv, %3u thread%s: %8.3f GB/s, speedup %.2fx\n", thread_counts[t], thread_counts[t] == 1 ? " " : "s", gigabytes / seconds, fscanf_seconds / seconds);
+	}
+	printf("%.1f MB file in page cache, %zu rows\n", gigabytes * 1e3, campuses.count);
+
+	// Free memory
+	campus_table_free(&campuses);
+	unlink(filename);
+}
+
+void bench_3f_projection_file(void)
+{
+	// Project campuses for the usual horizon
+	struct campus_table campuses;
+	struct projection_matrix matrix;
+	if (!campus_table_init(&campuses, BENCH_RESULTS_CAMPUSES) || !projection_matrix_init(&matrix, BENCH_RESULTS_CAMPUSES, 2024, 2070))
+	{
+		exit(EXIT_FAILURE);
+	}
+	for (int i = 0; i < BENCH_RESULTS_CAMPUSES; i++)
+	{
+		campus_table_add(&campuses, rand() % 30000 + 10000, 2024, rand() % 60000 + 1000, 2024 + rand() % 50 + 1); // NOLINT(*-msc50-cpp)
+	}
+	project_campuses(NULL, &campuses, &matrix);
+
+	// Write the text tables the program prints, and the binary file
+	char text_filename[] = "/tmp/bench_hw1_wvuep_XXXXXX";
+	char binary_filename[] = "/tmp/bench_hw1_wvuep_XXXXXX";
+	int text_fd = mkstemp(text_filename);
+	int binary_fd = mkstemp(binary_filename);
+	struct table_buffer buffer;
+	if (text_fd < 0 || binary_fd < 0 || !table_buffer_init(&buffer, NULL, 0))
+	{
+		fprintf(stderr, "Could not create benchmark files: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	close(binary_fd);
+	for (int i = 0; i < BENCH_RESULTS_CAMPUSES; i++)
+	{
+		table_buffer_append_enrollment_estimates(&buffer, campuses.initial_enrollments[i], matrix.growth_rates[i], 2024, 2070);
+	}
+	size_t text_bytes = buffer.length;
+	table_buffer_flush(&buffer, text_fd);
+	table_buffer_free(&buffer);
+	close(text_fd);
+	if (!write_projection_file(binary_filename, &matrix))
+	{
+		exit(EXIT_FAILURE);
+	}
+
+	// Time reparsing every estimate from the text, keeping the fastest run
+	long long text_sum = 0;
+	double text_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		FILE* file = fopen(text_filename, "r");
+		if (file == NULL)
+		{
+			fprintf(stderr, "Could not open %s: %s.\n", text_filename, strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+		text_sum = 0;
+		char line[64];
+		while (fgets(line, sizeof(line), file) != NULL)
+		{
+			const char* value = strrchr(line, ' ');
+			text_sum += value == NULL ? 0 : strtol(value, NULL, 10);
+		}
+		fclose(file);
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < text_seconds)
+		{
+			text_seconds = elapsed;
+		}
+	}
+
+	// Time mapping the binary file and reading every estimate, keeping the fastest run
+	long long binary_sum = 0;
+	double binary_seconds = 0.0;
+	struct projection_file file;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		if (!projection_file_open(&file, binary_filename))
+		{
+			exit(EXIT_FAILURE);
+		}
+		binary_sum = 0;
+		size_t estimate_count = file.header->campus_count * file.header->year_count;
+		for (size_t i = 0; i < estimate_count; i++)
+		{
+			binary_sum += file.estimates[i];
+		}
+		projection_file_close(&file);
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < binary_seconds)
+		{
+			binary_seconds = elapsed;
+		}
+	}
+
+	// Time single campus/year lookups in the mapped file
+	if (!projection_file_open(&file, binary_filename))
+	{
+		exit(EXIT_FAILURE);
+	}
+	long long lookup_sum = 0;
+	double start = bench_get_time();
+	for (int i = 0; i < BENCH_RESULTS_LOOKUPS; i++)
+	{
+		lookup_sum += projection_file_estimate(&file, (size_t)(rand() % BENCH_RESULTS_CAMPUSES), 2024 + rand() % 47); // NOLINT(*-msc50-cpp)
+	}
+	double lookup_seconds = bench_get_time() - start;
+	size_t binary_bytes = file.length;
+	projection_file_close(&file);
+
+	// Report sizes and read costs
+	printf("text tables:  %8.2f MB, read all %8.2f ms\n", (double)text_bytes * 1e-6, text_seconds * 1e3);
+	printf("results file: %8.2f MB, read all %8.2f ms (%.1fx smaller, %.1fx faster)\n", (double)binary_bytes * 1e-6, binary_seconds * 1e3, (double)text_bytes / (double)binary_bytes, text_seconds / binary_seconds);
+	printf("random campus/year lookup: %.1f ns including rand (checksum %lld)\n", lookup_seconds / BENCH_RESULTS_LOOKUPS * 1e9, lookup_sum);
+	if (text_sum != binary_sum)
+	{
+		printf("Warning: text and binary totals differ (%lld, %lld)\n", text_sum, binary_sum);
+	}
+
+	// Free memory
+	unlink(text_filename);
+	unlink(binary_filename);
+	projection_matrix_free(&matrix);
+	campus_table_free(&campuses);
+}
+
+void bench_3g_classify_growth_rates(void)
+{
+	// Random rates spread over every category, so the scalar branches are unpredictable
+	const size_t count = BENCH_SCENARIOS;
+	double* growth_rates = malloc(count * sizeof(double));
+	unsigned char* categories = malloc(count);
+	if (growth_rates == NULL || categories == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i < count; i++)
+	{
+		growth_rates[i] = (rand() % 10001 - 2000) / 100000.0; // NOLINT(*-msc50-cpp)
+	}
+
+	// Time get_growth_rate_description with a histogram keyed on the returned strings, keeping the fastest run
+	const char* descriptions[GROWTH_RATE_CATEGORY_COUNT];
+	for (int category = 0; category < GROWTH_RATE_CATEGORY_COUNT; category++)
+	{
+		static const double representatives[GROWTH_RATE_CATEGORY_COUNT] = { -0.01, 0.005, 0.015, 0.03, 0.05 };
+		descriptions[category] = get_growth_rate_description(representatives[category]);
+	}
+	size_t scalar_histogram[GROWTH_RATE_CATEGORY_COUNT];
+	double scalar_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		memset(scalar_histogram, 0, sizeof(scalar_histogram));
+		for (size_t i = 0; i < count; i++)
+		{
+			const char* description = get_growth_rate_description(growth_rates[i]);
+			for (unsigned char category = 0; category < GROWTH_RATE_CATEGORY_COUNT; category++)
+			{
+				if (description == descriptions[category])
+				{
+					categories[i] = category;
+					scalar_histogram[category]++;
+					break;
+				}
+			}
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < scalar_seconds)
+		{
+			scalar_seconds = elapsed;
+		}
+	}
+
+	// Time the vector classifier with its histogram, keeping the fastest run
+	size_t histogram[GROWTH_RATE_CATEGORY_COUNT];
+	double batch_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		classify_growth_rates(growth_rates, categories, count, histogram);
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < batch_seconds)
+		{
+			batch_seconds = elapsed;
+		}
+	}
+
+	// Report throughput
+	printf("get_growth_rate_description: %8.2f M rates/s\n", (double)count / scalar_seconds * 1e-6);
+	printf("classify_growth_rates:       %8.2f M rates/s\n", (double)count / batch_seconds * 1e-6);
+	printf("Speedup: %.2fx\n", scalar_seconds / batch_seconds);
+	if (memcmp(histogram, scalar_histogram, sizeof(histogram)) != 0)
+	{
+		printf("Warning: histograms differ\n");
+	}
+
+	// Free memory
+	free(growth_rates);
+	free(categories);
+}
+
+void bench_3h_read_target_enrollments(void)
+{
+	// Write a file of targets, one per line as a script would send them
+	char filename[] = "/tmp/bench_hw1_wvuep_XXXXXX";
+	int fd = mkstemp(filename);
+	FILE* file = fd < 0 ? NULL : fdopen(fd, "w");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Could not create %s: %s.\n", filename, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	for (int i = 0; i < BENCH_TARGETS; i++)
+	{
+		fprintf(file, "%d\n", rand() % 60000 + 1000); // NOLINT(*-msc50-cpp)
+	}
+	fclose(file);
+
+	// Send prompts to /dev/null while timing
+	int null_fd = open("/dev/null", O_WRONLY);
+	int saved_stdout = dup(STDOUT_FILENO);
+	if (null_fd < 0 || saved_stdout < 0)
+	{
+		fprintf(stderr, "Could not redirect output: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	dup2(null_fd, STDOUT_FILENO);
+
+	// Time a prompt and scanf per value, the way prompt_target_enrollment reads, keeping the fastest run
+	int* targets = malloc(BENCH_TARGETS * sizeof(int));
+	if (targets == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	double prompt_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		file = fopen(filename, "r");
+		if (file == NULL)
+		{
+			exit(EXIT_FAILURE);
+		}
+		for (int i = 0; i < BENCH_TARGETS; i++)
+		{
+			printf("Enter the enrollment target for the year %d: ", 2030);
+			if (fscanf(file, "%d", &targets[i]) != 1)
+			{
+				break;
+			}
+		}
+		fclose(file);
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < prompt_seconds)
+		{
+			prompt_seconds = elapsed;
+		}
+	}
+	free(targets);
+
+	// Redirect output to original destination
+	dup2(saved_stdout, STDOUT_FILENO);
+	close(saved_stdout);
+	close(null_fd);
+
+	// Time reading the whole stream at once, keeping the fastest run
+	double batch_seconds = 0.0;
+	size_t count = 0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		fd = open(filename, O_RDONLY);
+		struct target_enrollments batch;
+		if (fd < 0 || !read_target_enrollments(fd, &batch))
+		{
+			exit(EXIT_FAILURE);
+		}
+		close(fd);
+		count = batch.count;
+		target_enrollments_free(&batch);
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < batch_seconds)
+		{
+			batch_seconds = elapsed;
+		}
+	}
+	unlink(filename);
+
+	// Report time per target
+	printf("prompt and scanf per target: %8.2f ns/target\n", prompt_seconds / BENCH_TARGETS * 1e9);
+	printf("read_target_enrollments:     %8.2f ns/target (%zu targets)\n", batch_seconds / BENCH_TARGETS * 1e9, count);
+	printf("Speedup: %.2fx\n", prompt_seconds / batch_seconds);
+}
+
+void bench_3i_simulate_enrollment_bands(void)
+{
+	// Go up to at least 4 threads so the table has the same rows on small machines
+	unsigned int processors = worker_pool_default_thread_count();
+	unsigned int max_threads = processors > 4 ? processors : 4;
+	double samples = (double)BENCH_MONTE_CARLO_PATHS * (BENCH_MONTE_CARLO_LAST_YEAR - 2024);
+	printf("%u processors online, %d paths x %d years\n", processors, BENCH_MONTE_CARLO_PATHS, BENCH_MONTE_CARLO_LAST_YEAR - 2024);
+
+	// Time each pool size, keeping the fastest run
+	double single_seconds = 0.0;
+	double single_median = 0.0;
+	for (unsigned int threads = 1; threads <= max_threads; threads *= 2)
+	{
+		struct worker_pool pool;
+		if (!worker_pool_init(&pool, threads))
+		{
+			exit(EXIT_FAILURE);
+		}
+
+		double seconds = 0.0;
+		double median = 0.0;
+		for (int run = 0; run < BENCH_REPETITIONS; run++)
+		{
+			struct enrollment_bands bands;
+			double start = bench_get_time();
+			if (!simulate_enrollment_bands(&pool, 25000, 0.015, 2024, BENCH_MONTE_CARLO_LAST_YEAR, 0.02, BENCH_MONTE_CARLO_PATHS, 2024, &bands))
+			{
+				exit(EXIT_FAILURE);
+			}
+			double elapsed = bench_get_time() - start;
+			if (run == 0 || elapsed < seconds)
+			{
+				seconds = elapsed;
+			}
+			median = bands.p50[bands.year_count - 1];
+			enrollment_bands_free(&bands);
+		}
+		worker_pool_free(&pool);
+
+		// Report throughput and scaling relative to one thread
+		if (threads == 1)
+		{
+			single_seconds = seconds;
+			single_median = median;
+		}
+		printf("%3u threads: %8.2f M path-years/s, speedup %.2fx%s\n", threads, samples / seconds * 1e-6, single_seconds / seconds, threads > processors ? " (more threads than processors)" : "");
+		if (median != single_median)
+		{
+			printf("Warning: bands depend on the number of threads\n");
+		}
+	}
+
+	// Compare the sketch memory per worker with storing every path
+	double bucket_width = log((1.0 + MONTE_CARLO_RELATIVE_ACCURACY) / (1.0 - MONTE_CARLO_RELATIVE_ACCURACY));
+	printf("Sketch memory per worker: %8.2f MB, storing every path: %8.2f MB\n", ceil((MONTE_CARLO_MAX_LOG - MONTE_CARLO_MIN_LOG) / bucket_width) * 4.0 * (BENCH_MONTE_CARLO_LAST_YEAR - 2024) * 1e-6, samples * sizeof(double) * 1e-6);
+}
+
+/**
+ * @brief Calculate a scheduled estimate by multiplying the growth of every segment from initial_year
+ * @param schedule Growth schedule
+ * @param estimate_year Year for which to calculate enrollment estimate
+ * @return Estimated enrollment
+ */
+static int bench_recompute_scheduled_enrollment_estimate(const struct growth_schedule* schedule, int estimate_year)
+{
+	double growth_factor = 1.0;
+	size_t segment = 0;
+	while (segment + 1 < schedule->count && schedule->start_years[segment + 1] <= estimate_year)
+	{
+		growth_factor *= pow(1 + schedule->growth_rates[segment], schedule->start_years[segment + 1] - schedule->start_years[segment]);
+		segment++;
+	}
+	growth_factor *= pow(1 + schedule->growth_rates[segment], estimate_year - schedule->start_years[segment]);
+
+	return (int)round(schedule->initial_enrollment * growth_factor);
+}
+
+void bench_3j_calculate_scheduled_enrollment_estimate(void)
+{
+	// Build a schedule with a new rate every one to ten years
+	struct growth_schedule schedule;
+	if (!growth_schedule_init(&schedule, 29862, 0.01, 2024))
+	{
+		exit(EXIT_FAILURE);
+	}
+	int start_year = 2024;
+	for (int segment = 1; segment < BENCH_SCHEDULE_SEGMENTS; segment++)
+	{
+		start_year += rand() % 10 + 1; // NOLINT(*-msc50-cpp)
+		if (!growth_schedule_append(&schedule, start_year, (rand() % 401 - 100) / 10000.0)) // NOLINT(*-msc50-cpp)
+		{
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	// Random years across the whole schedule
+	int* years = malloc(BENCH_SCHEDULE_QUERIES * sizeof(int));
+	if (years == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i < BENCH_SCHEDULE_QUERIES; i++)
+	{
+		years[i] = 2024 + rand() % (start_year - 2024 + 20); // NOLINT(*-msc50-cpp)
+	}
+
+	// Time recomputing from initial_year, keeping the fastest run
+	long long naive_sum = 0;
+	double naive_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		naive_sum = 0;
+		for (size_t i = 0; i < BENCH_SCHEDULE_QUERIES; i++)
+		{
+			naive_sum += bench_recompute_scheduled_enrollment_estimate(&schedule, years[i]);
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < naive_seconds)
+		{
+			naive_seconds = elapsed;
+		}
+	}
+
+	// Time the cached prefix factors, keeping the fastest run
+	long long cached_sum = 0;
+	double cached_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		cached_sum = 0;
+		for (size_t i = 0; i < BENCH_SCHEDULE_QUERIES; i++)
+		{
+			cached_sum += calculate_scheduled_enrollment_estimate(&schedule, years[i]);
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < cached_seconds)
+		{
+			cached_seconds = elapsed;
+		}
+	}
+
+	// Report time per estimate
+	printf("%d segments, %d random years\n", BENCH_SCHEDULE_SEGMENTS, BENCH_SCHEDULE_QUERIES);
+	printf("Recomputed from initial year: %8.2f ns/estimate\n", naive_seconds / BENCH_SCHEDULE_QUERIES * 1e9);
+	printf("Cached prefix factors:        %8.2f ns/estimate\n", cached_seconds / BENCH_SCHEDULE_QUERIES * 1e9);
+	printf("Speedup: %.2fx\n", naive_seconds / cached_seconds);
+	if (naive_sum != cached_sum)
+	{
+		printf("Warning: estimates differ\n");
+	}
+
+	// Free memory
+	free(years);
+	growth_schedule_free(&schedule);
+}
+
+/**
+ * @brief Run a projection server until it is stopped
+ * @param server Pointer to the open projection_server
+ * @return NULL
+ */
+static void* bench_run_projection_server(void* server)
+{
+	projection_server_run(server);
+
+	return NULL;
+}
+
+/**
+ * @brief Send requests one at a time on a new connection and time each answer
+ * @param argument Pointer to the client's bench_server_client
+ * @return NULL
+ */
+static void* bench_run_projection_client(void* argument)
+{
+	struct bench_server_client* state = argument;
+	struct projection_client client;
+	if (!projection_client_connect(&client, state->path))
+	{
+		state->failed = true;
+		return NULL;
+	}
+
+	// Each request projects a random campus from 2024 through 2070
+	int32_t estimates[PROJECTION_SERVER_MAX_YEARS];
+	for (size_t i = 0; i < BENCH_SERVER_REQUESTS; i++)
+	{
+		int campus = rand_r(&state->seed) % BENCH_SERVER_CAMPUSES;
+		struct projection_request request = { 10000 + campus * 37, 30000, 2024, 2040, 2024, 2070 };
+		struct projection_response response;
+		double start = bench_get_time();
+		if (!projection_client_query(&client, &request, &response, estimates, PROJECTION_SERVER_MAX_YEARS))
+		{
+			state->failed = true;
+			break;
+		}
+		state->latencies[i] = bench_get_time() - start;
+	}
+	projection_client_close(&client);
+
+	return NULL;
+}
+
+/**
+ * @brief Compare two doubles for qsort
+ * @param a First double
+ * @param b Second double
+ * @return Negative, zero or positive as a is less than, equal to or greater than b
+ */
+static int bench_compare_doubles(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
+
+void bench_3k_projection_server(void)
+{
+	// Start the server on a temporary socket
+	char path[] = "/tmp/bench_hw1_wvuep_XXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Could not create temporary file: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	close(fd);
+	unlink(path);
+	struct projection_server server;
+	pthread_t server_thread;
+	if (!projection_server_open(&server, path) || pthread_create(&server_thread, NULL, bench_run_projection_server, &server) != 0)
+	{
+		exit(EXIT_FAILURE);
+	}
+
+	// Run the clients at once
+	size_t request_count = (size_t)BENCH_SERVER_CLIENTS * BENCH_SERVER_REQUESTS;
+	double* latencies = malloc(request_count * sizeof(double));
+	if (latencies == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	struct bench_server_client clients[BENCH_SERVER_CLIENTS];
+	pthread_t client_threads[BENCH_SERVER_CLIENTS];
+	double start = bench_get_time();
+	for (unsigned int c = 0; c < BENCH_SERVER_CLIENTS; c++)
+	{
+		clients[c] = (struct bench_server_client){ path, c + 1, latencies + (size_t)c * BENCH_SERVER_REQUESTS, false };
+		if (pthread_create(&client_threads[c], NULL, bench_run_projection_client, &clients[c]) != 0)
+		{
+			exit(EXIT_FAILURE);
+		}
+	}
+	bool failed = false;
+	for (unsigned int c = 0; c < BENCH_SERVER_CLIENTS; c++)
+	{
+		pthread_join(client_threads[c], NULL);
+		failed = failed || clients[c].failed;
+	}
+	double seconds = bench_get_time() - start;
+
+	// Stop the server
+	projection_server_stop(&server);
+	pthread_join(server_thread, NULL);
+
+	// Report throughput, latency percentiles and cache use
+	qsort(latencies, request_count, sizeof(double), bench_compare_doubles);
+	printf("%d clients x %d requests of 47 years, %d distinct campuses\n", BENCH_SERVER_CLIENTS, BENCH_SERVER_REQUESTS, BENCH_SERVER_CAMPUSES);
+	printf("Throughput: %10.0f requests/s\n", (double)request_count / seconds);
+	printf("Latency p50: %8.2f us, p99: %8.2f us\n", latencies[request_count / 2] * 1e6, latencies[request_count * 99 / 100] * 1e6);
+	printf("Cache hits: %zu of %zu requests\n", server.cache_hits, server.requests);
+	if (failed)
+	{
+		printf("Warning: requests failed\n");
+	}
+
+	// Free memory
+	projection_server_close(&server);
+	free(latencies);
+}
+
+void bench_3l_growth_factor_table(void)
+{
+	// Time building the default table and mapping it back from a file
+	struct growth_factor_table table;
+	double start = bench_get_time();
+	if (!growth_factor_table_init(&table, GROWTH_FACTOR_DEFAULT_MIN_BASIS_POINTS, GROWTH_FACTOR_DEFAULT_MAX_BASIS_POINTS, GROWTH_FACTOR_DEFAULT_YEARS))
+	{
+		exit(EXIT_FAILURE);
+	}
+	double init_seconds = bench_get_time() - start;
+	char filename[] = "/tmp/bench_hw1_wvuep_XXXXXX";
+	int fd = mkstemp(filename);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Could not create temporary file: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	close(fd);
+	struct growth_factor_table loaded;
+	if (!growth_factor_table_save(&table, filename))
+	{
+		exit(EXIT_FAILURE);
+	}
+	start = bench_get_time();
+	if (!growth_factor_table_load(&loaded, filename))
+	{
+		exit(EXIT_FAILURE);
+	}
+	double load_seconds = bench_get_time() - start;
+	unlink(filename);
+
+	// Off-grid rates like calculate_growth_rate returns, queried at random and as one campus' years at a time
+	const size_t count = BENCH_SCENARIOS;
+	double* growth_rates = malloc(count * sizeof(double));
+	int* years = malloc(count * sizeof(int));
+	if (growth_rates == NULL || years == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	printf("Table of %zu rates x %zu years: computed in %.2f ms, mapped in %.3f ms\n", table.rate_count, table.year_count, init_seconds * 1e3, load_seconds * 1e3);
+	static const char* patterns[] = { "Random rates and horizons", "Each campus' years in order" };
+	for (size_t pattern = 0; pattern < sizeof(patterns) / sizeof(patterns[0]); pattern++)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			bool random = pattern == 0 || i % GROWTH_FACTOR_DEFAULT_YEARS == 0;
+			growth_rates[i] = random ? (rand() % 1500001 - 500000) / 1e7 + 1e-9 : growth_rates[i - 1]; // NOLINT(*-msc50-cpp)
+			years[i] = pattern == 0 ? rand() % GROWTH_FACTOR_DEFAULT_YEARS : (int)(i % GROWTH_FACTOR_DEFAULT_YEARS); // NOLINT(*-msc50-cpp)
+		}
+
+		// Time pow, keeping the fastest run
+		double pow_sum = 0.0;
+		double pow_seconds = 0.0;
+		for (int run = 0; run < BENCH_REPETITIONS; run++)
+		{
+			start = bench_get_time();
+			pow_sum = 0.0;
+			for (size_t i = 0; i < count; i++)
+			{
+				pow_sum += pow(1 + growth_rates[i], years[i]);
+			}
+			double elapsed = bench_get_time() - start;
+			if (run == 0 || elapsed < pow_seconds)
+			{
+				pow_seconds = elapsed;
+			}
+		}
+
+		// Time the mapped table, keeping the fastest run
+		double table_sum = 0.0;
+		double table_seconds = 0.0;
+		for (int run = 0; run < BENCH_REPETITIONS; run++)
+		{
+			start = bench_get_time();
+			table_sum = 0.0;
+			for (size_t i = 0; i < count; i++)
+			{
+				table_sum += growth_factor_table_factor(&loaded, growth_rates[i], years[i]);
+			}
+			double elapsed = bench_get_time() - start;
+			if (run == 0 || elapsed < table_seconds)
+			{
+				table_seconds = elapsed;
+			}
+		}
+
+		// Report time per factor and how far the sums drift apart
+		printf("%s:\n", patterns[pattern]);
+		printf("  pow:                %8.2f ns/factor\n", pow_seconds / (double)count * 1e9);
+		printf("  Interpolated table: %8.2f ns/factor\n", table_seconds / (double)count * 1e9);
+		printf("  Speedup: %.2fx, relative difference of sums: %.3g\n", pow_seconds / table_seconds, fabs(table_sum / pow_sum - 1));
+	}
+	printf("Max relative error: %.3g\n", growth_factor_table_max_error(&table));
+
+	// Free memory
+	free(growth_rates);
+	free(years);
+	growth_factor_table_free(&loaded);
+	growth_factor_table_free(&table);
+}
+
+void bench_3m_fixed_point_projection(void)
+{
+	// Campuses with the enrollments and horizons the tests use
+	const size_t count = BENCH_FIXED_POINT_CAMPUSES;
+	int* initial_enrollments = malloc(count * sizeof(int));
+	int* target_enrollments = malloc(count * sizeof(int));
+	int* target_years = malloc(count * sizeof(int));
+	int* estimates = malloc((BENCH_FIXED_POINT_YEARS + 1) * sizeof(int));
+	if (initial_enrollments == NULL || target_enrollments == NULL || target_years == NULL || estimates == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i < count; i++)
+	{
+		initial_enrollments[i] = rand() % 30000 + 10000; // NOLINT(*-msc50-cpp)
+		target_enrollments[i] = rand() % 60000 + 1000; // NOLINT(*-msc50-cpp)
+		target_years[i] = 2024 + rand() % BENCH_FIXED_POINT_YEARS + 1; // NOLINT(*-msc50-cpp)
+	}
+
+	// Time the double-precision path, keeping the fastest run
+	long long double_sum = 0;
+	double double_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		double_sum = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			double growth_rate = calculate_growth_rate(initial_enrollments[i], target_enrollments[i], 2024, target_years[i]);
+			for (int year = 2024; year <= target_years[i]; year++)
+			{
+				double_sum += calculate_enrollment_estimate(initial_enrollments[i], growth_rate, 2024, year);
+			}
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < double_seconds)
+		{
+			double_seconds = elapsed;
+		}
+	}
+
+	// Time the fixed-point path with bulk estimates, keeping the fastest run
+	long long fixed_sum = 0;
+	double fixed_seconds = 0.0;
+	double factor_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		double factor_elapsed = 0.0;
+		fixed_sum = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			uint64_t growth_factor;
+			double factor_start = bench_get_time();
+			if (!calculate_fixed_growth_factor(initial_enrollments[i], target_enrollments[i], 2024, target_years[i], &growth_factor))
+			{
+				exit(EXIT_FAILURE);
+			}
+			factor_elapsed += bench_get_time() - factor_start;
+			size_t estimate_count = calculate_fixed_enrollment_estimates(initial_enrollments[i], growth_factor, 2024, target_years[i], estimates);
+			for (size_t year = 0; year < estimate_count; year++)
+			{
+				fixed_sum += estimates[year];
+			}
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < fixed_seconds)
+		{
+			fixed_seconds = elapsed;
+			factor_seconds = factor_elapsed;
+		}
+	}
+
+	// Report time per campus and how far the sums drift apart
+	printf("%zu campuses, each estimated up to its target year within %d years:\n", count, BENCH_FIXED_POINT_YEARS);
+	printf("  pow and round: %8.2f us/campus\n", double_seconds / (double)count * 1e6);
+	printf("  Fixed point:   %8.2f us/campus, %.2f us of it finding the growth factor\n", fixed_seconds / (double)count * 1e6, factor_seconds / (double)count * 1e6);
+	printf("  Speedup: %.2fx, difference of sums: %lld\n", double_seconds / fixed_seconds, fixed_sum - double_sum);
+
+	// Report the divergence over the ranges the tests use
+	struct fixed_point_divergence divergence;
+	if (!measure_fixed_point_divergence(10000, 40000, 1000, 61000, 500, 50, &divergence))
+	{
+		exit(EXIT_FAILURE);
+	}
+	print_fixed_point_divergence(&divergence);
+
+	// Free memory
+	free(initial_enrollments);
+	free(target_enrollments);
+	free(target_years);
+	free(estimates);
+}
+
+/**
+ * @brief Fit a growth rate with scalar log, computing the means first and regressing around them
+ * @param enrollments Enrollment for each year, 0 or below for missing years
+ * @param year_count Number of years
+ * @return Least-squares growth rate, or NaN if fewer than two years are present
+ */
+static double bench_refit_growth_rate(const int* enrollments, size_t year_count)
+{
+	// Find the means of the present years
+	double count = 0.0;
+	double mean_t = 0.0;
+	double mean_y = 0.0;
+	for (size_t t = 0; t < year_count; t++)
+	{
+		if (enrollments[t] > 0)
+		{
+			count++;
+			mean_t += (double)t;
+			mean_y += log(enrollments[t]);
+		}
+	}
+	if (count < 2.0)
+	{
+		return NAN;
+	}
+	mean_t /= count;
+	mean_y /= count;
+
+	// Regress around the means
+	double covariance = 0.0;
+	double variance = 0.0;
+	for (size_t t = 0; t < year_count; t++)
+	{
+		if (enrollments[t] > 0)
+		{
+			covariance += ((double)t - mean_t) * (log(enrollments[t]) - mean_y);
+			variance += ((double)t - mean_t) * ((double)t - mean_t);
+		}
+	}
+
+	return expm1(covariance / variance);
+}
+
+void bench_3n_fit_growth_rates(void)
+{
+	// Histories with a few missing years
+	const size_t count = BENCH_BACKFIT_CAMPUSES;
+	int* enrollments = malloc(count * BENCH_BACKFIT_YEARS * sizeof(int));
+	double* growth_rates = malloc(count * sizeof(double));
+	if (enrollments == NULL || growth_rates == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i < count * BENCH_BACKFIT_YEARS; i++)
+	{
+		enrollments[i] = rand() % 20 == 0 ? 0 : rand() % 30000 + 10000; // NOLINT(*-msc50-cpp)
+	}
+	unsigned int processors = worker_pool_default_thread_count();
+	unsigned int max_threads = processors > 4 ? processors : 4;
+	printf("%u processors online, %d campuses x %d years\n", processors, BENCH_BACKFIT_CAMPUSES, BENCH_BACKFIT_YEARS);
+
+	// Time the scalar two-pass regression, keeping the fastest run
+	double scalar_sum = 0.0;
+	double scalar_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		scalar_sum = 0.0;
+		for (size_t i = 0; i < count; i++)
+		{
+			scalar_sum += bench_refit_growth_rate(enrollments + i * BENCH_BACKFIT_YEARS, BENCH_BACKFIT_YEARS);
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < scalar_seconds)
+		{
+			scalar_seconds = elapsed;
+		}
+	}
+	printf("Scalar log, two passes: %8.2f M campuses/s\n", (double)count / scalar_seconds * 1e-6);
+
+	// Time the vector kernel on each pool size, keeping the fastest run
+	for (unsigned int threads = 1; threads <= max_threads; threads *= 2)
+	{
+		struct worker_pool pool;
+		if (!worker_pool_init(&pool, threads))
+		{
+			exit(EXIT_FAILURE);
+		}
+
+		double seconds = 0.0;
+		for (int run = 0; run < BENCH_REPETITIONS; run++)
+		{
+			double start = bench_get_time();
+			fit_growth_rates(&pool, enrollments, count, 2000, 2000 + BENCH_BACKFIT_YEARS - 1, growth_rates);
+			double elapsed = bench_get_time() - start;
+			if (run == 0 || elapsed < seconds)
+			{
+				seconds = elapsed;
+			}
+		}
+		worker_pool_free(&pool);
+
+		// Report throughput, speedup over the scalar fit and how far the sums drift apart
+		double vector_sum = 0.0;
+		for (size_t i = 0; i < count; i++)
+		{
+			vector_sum += growth_rates[i];
+		}
+		printf("%3u threads:            %8.2f M campuses/s, speedup %.2fx, relative difference of sums %.3g%s\n", threads, (double)count / seconds * 1e-6, scalar_seconds / seconds, fabs(vector_sum / scalar_sum - 1), threads > processors ? " (more threads than processors)" : "");
+	}
+
+	// Free memory
+	free(enrollments);
+	free(growth_rates);
+}
+
+void bench_3o_calculate_enrollment_sensitivities(void)
+{
+	// Campuses with rates like calculate_growth_rate returns
+	const size_t count = BENCH_SENSITIVITY_CAMPUSES;
+	const size_t year_count = BENCH_SENSITIVITY_LAST_YEAR - 2024 + 1;
+	int* initial_enrollments = malloc(count * sizeof(int));
+	double* growth_rates = malloc(count * sizeof(double));
+	int* estimates = malloc(year_count * sizeof(int));
+	double* sensitivities = malloc(year_count * sizeof(double));
+	if (initial_enrollments == NULL || growth_rates == NULL || estimates == NULL || sensitivities == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i < count; i++)
+	{
+		initial_enrollments[i] = rand() % 30000 + 10000; // NOLINT(*-msc50-cpp)
+		growth_rates[i] = calculate_growth_rate(initial_enrollments[i], rand() % 60000 + 1000, 2024, 2024 + rand() % 50 + 1); // NOLINT(*-msc50-cpp)
+	}
+
+	// Time finite differences of one basis point with pow, keeping the fastest run
+	double difference_sum = 0.0;
+	double difference_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		difference_sum = 0.0;
+		for (size_t i = 0; i < count; i++)
+		{
+			for (int year = 2024; year <= BENCH_SENSITIVITY_LAST_YEAR; year++)
+			{
+				double above = initial_enrollments[i] * pow(1 + growth_rates[i] + 1e-4, year - 2024);
+				double below = initial_enrollments[i] * pow(1 + growth_rates[i] - 1e-4, year - 2024);
+				difference_sum += calculate_enrollment_estimate(initial_enrollments[i], growth_rates[i], 2024, year) + (above - below) / 2e-4;
+			}
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < difference_seconds)
+		{
+			difference_seconds = elapsed;
+		}
+	}
+
+	// Time the analytic kernel, keeping the fastest run
+	double analytic_sum = 0.0;
+	double analytic_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		analytic_sum = 0.0;
+		for (size_t i = 0; i < count; i++)
+		{
+			calculate_enrollment_sensitivities(initial_enrollments[i], growth_rates[i], 2024, BENCH_SENSITIVITY_LAST_YEAR, estimates, sensitivities);
+			for (size_t year = 0; year < year_count; year++)
+			{
+				analytic_sum += estimates[year] + sensitivities[year];
+			}
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < analytic_seconds)
+		{
+			analytic_seconds = elapsed;
+		}
+	}
+
+	// Report time per year and how far the sums drift apart
+	double years = (double)count * (double)year_count;
+	printf("%zu campuses x %zu years:\n", count, year_count);
+	printf("  Finite differences with pow: %8.2f ns/year\n", difference_seconds / years * 1e9);
+	printf("  Analytic kernel:             %8.2f ns/year\n", analytic_seconds / years * 1e9);
+	printf("  Speedup: %.2fx, relative difference of sums: %.3g\n", difference_seconds / analytic_seconds, fabs(analytic_sum / difference_sum - 1));
+
+	// Time a grid of rates and years against finite differences at every point
+	struct sensitivity_grid grid;
+	if (!sensitivity_grid_init(&grid, -0.1, 1e-4, BENCH_SENSITIVITY_RATES, 2024, BENCH_SENSITIVITY_LAST_YEAR))
+	{
+		exit(EXIT_FAILURE);
+	}
+	double grid_difference_seconds = 0.0;
+	double grid_seconds = 0.0;
+	for (int run = 0; run < BENCH_REPETITIONS; run++)
+	{
+		double start = bench_get_time();
+		for (size_t row = 0; row < grid.year_count; row++)
+		{
+			for (size_t column = 0; column < grid.rate_count; column++)
+			{
+				double growth_rate = grid.growth_rates[column];
+				grid.estimates[row * grid.stride + column] = 31234 * pow(1 + growth_rate, (int)row);
+				grid.sensitivities[row * grid.stride + column] = 31234 * (pow(1 + growth_rate + 1e-4, (int)row) - pow(1 + growth_rate - 1e-4, (int)row)) / 2e-4;
+			}
+		}
+		double elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < grid_difference_seconds)
+		{
+			grid_difference_seconds = elapsed;
+		}
+
+		start = bench_get_time();
+		calculate_sensitivity_grid(&grid, 31234);
+		elapsed = bench_get_time() - start;
+		if (run == 0 || elapsed < grid_seconds)
+		{
+			grid_seconds = elapsed;
+		}
+	}
+	double cells = (double)grid.rate_count * (double)grid.year_count;
+	printf("Grid of %zu rates x %zu years:\n", grid.rate_count, grid.year_count);
+	printf("  Finite differences with pow: %8.2f ms (%.2f ns/cell)\n", grid_difference_seconds * 1e3, grid_difference_seconds / cells * 1e9);
+	printf("  Sensitivity grid:            %8.2f ms (%.2f ns/cell)\n", grid_seconds * 1e3, grid_seconds / cells * 1e9);
+	printf("  Speedup: %.2fx\n", grid_difference_seconds / grid_seconds);
+
+	// Free memory
+	sensitivity_grid_free(&grid);
+	free(initial_enrollments);
+	free(growth_rates);
+	free(estimates);
+	free(sensitivities);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file bench_hw1_wvuep.h
+ * @brief Benchmarks header file for CS 350 Homework #1: WVU Enrollment Problem
+ * @author Rashaan Clay
+ */
+
+#pragma once
+
+/**
+ * @brief Number of times each benchmark is repeated, keeping the fastest run
+ */
+#ifndef BENCH_REPETITIONS
+	#define BENCH_REPETITIONS 5
+#endif
+
+/**
+ * @brief Run all benchmarks
+ */
+void run_benchmarks(void);
+
+/**
+ * @brief Get the current time from a monotonic clock
+ * @return Time in seconds
+ */
+double bench_get_time(void);
+
+/**
+ * @brief Benchmark calculate_growth_rates against calculate_growth_rate
+ */
+void bench_3a_calculate_growth_rates(void);
+
+/**
+ * @brief Benchmark calculate_enrollment_estimates against per-year calculate_enrollment_estimate over a long horizon
+ */
+void bench_3b_calculate_enrollment_estimates(void);
+
+/**
+ * @brief Benchmark print_enrollment_estimates against buffered tables written with one write call
+ */
+void bench_3c_print_enrollment_estimates_buffered(void);
+
+/**
+ * @brief Benchmark project_campuses with 1, 2, 4, ... threads
+ */
+void bench_3d_project_campuses(void);
+
+/**
+ * @brief Benchmark load_campus_csv throughput against fscanf
+ */
+void bench_3e_load_campus_csv(void);
+
+/**
+ * @brief Benchmark the size and read cost of results files against printed text tables
+ */
+void bench_3f_projection_file(void);
+
+/**
+ * @brief Benchmark classify_growth_rates with a histogram against get_growth_rate_description
+ */
+void bench_3g_classify_growth_rates(void);
+
+/**
+ * @brief Benchmark read_target_enrollments against a prompt and scanf per target
+ */
+void bench_3h_read_target_enrollments(void);
+
+/**
+ * @brief Benchmark simulate_enrollment_bands with 1, 2, 4, ... threads
+ */
+void bench_3i_simulate_enrollment_bands(void);
+
+/**
+ * @brief Benchmark calculate_scheduled_enrollment_estimate against recomputing every segment
+ */
+void bench_3j_calculate_scheduled_enrollment_estimate(void);
+
+/**
+ * @brief Load test a projection server with concurrent clients, reporting throughput and p50/p99 latency
+ */
+void bench_3k_projection_server(void);
+
+/**
+ * @brief Benchmark growth_factor_table_factor against pow on off-grid rates
+ */
+void bench_3l_growth_factor_table(void);
+
+/**
+ * @brief Benchmark fixed-point projections against pow and round, and report their divergence
+ */
+void bench_3m_fixed_point_projection(void);
+
+/**
+ * @brief Benchmark vectorized growth rate backfits on 1 to 4+ threads against a scalar regression
+ */
+void bench_3n_fit_growth_rates(void);
+
+/**
+ * @brief Benchmark analytic growth rate sensitivities and the sensitivity grid against finite differences with pow
+ */
+void bench_3o_calculate_enrollment_sensitivities(void);
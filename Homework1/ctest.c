@@ -2,7 +2,7 @@
  * @file ctest.c
  * @brief Source code file for WVU CTest testing framework
  * @author Brian Powell
- * @version 1.23
+ * @version 1.24
  *
  * Place this file in the same directory as your own source code and add it to your project.
  *
@@ -38,6 +38,21 @@
 #include <setjmp.h>
 #include <signal.h>
 #include <time.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
 
 // OS-specific includes
 #ifdef __APPLE__
@@ -45,8 +60,12 @@
 #else
 	#include <malloc.h>
 #endif
+#ifdef __linux__
+	#include <sys/prctl.h>
+	#include <sys/signalfd.h>
+#endif
 
-// Define file to store capture output - comment out to not capture output
+// Define file to store capture output, kept in memory shared with forked children and appended at exit - comment out to not capture output
 //#define CAPTURE_OUTPUT "captured_output.txt"
 
 char* add_regex_anchors(const char* pattern)
@@ -453,489 +472,2517 @@ bool does_string_contain(const char* pattern, const char* string)
 static void* (*real_malloc)(size_t) = NULL;
 
 /**
- * @brief Overridden version of malloc to initialize memory to 0xFFFFFFFFFFFFFFFF
- * @param size Number of bytes requested
- * @return Pointer to allocated memory or NULL if allocation failed
+ * @brief Tracks the location of original calloc function
  */
-// ReSharper disable once CppParameterNamesMismatch
-void* malloc(size_t size)
-{
-	// Store original malloc function prior to remapping
-	if (real_malloc == NULL)
-	{
-		// Locate original malloc function
-		real_malloc = dlsym(RTLD_NEXT, "malloc");
-
-		// Check for errors
-		if (real_malloc == NULL)
-		{
-			fprintf(stderr, "Error in `dlsym`: %s\n", dlerror());
-		}
-	}
-
-	// Pointer to new memory
-	void* memoryPtr = NULL;
-
-	// Call original malloc function
-	memoryPtr = real_malloc(size);
-
-	// If memory was allocated, set it to 0xFFFFFFFFFFFFFFFF
-	if (memoryPtr != NULL)
-	{
-		memset(memoryPtr, 0xFF, size);
-	}
+static void* (*real_calloc)(size_t, size_t) = NULL;
 
-	return memoryPtr;
-}
+/**
+ * @brief Tracks the location of original realloc function
+ */
+static void* (*real_realloc)(void*, size_t) = NULL;
 
-char* read_file(const char* path)
-{
-	// Exit if path is NULL
-	if (path == NULL) {
-		fprintf(stderr, "Path is NULL.\n");
-		return NULL;
-	}
+/**
+ * @brief Tracks the location of original posix_memalign function
+ */
+static int (*real_posix_memalign)(void**, size_t, size_t) = NULL;
 
-	// Get file size
-	size_t file_size = get_file_size(path);
+/**
+ * @brief Tracks the location of original malloc_usable_size function
+ */
+static size_t (*real_malloc_usable_size)(void*) = NULL;
 
-	// Attempt to open file.
-	FILE* filePtr = fopen(path, "r");
-	if (filePtr == NULL) {
-		fprintf(stderr, "File %s not found.\n", path);
-		return NULL;
-	}
+/**
+ * @brief Tracks the location of original free function, set last, once the others have been located
+ */
+static void (*real_free)(void*) = NULL;
 
-	// Malloc memory for file
-	char* buffer = malloc(file_size + 1);
-	if (buffer == NULL) {
-		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
-		return NULL;
-	}
+/**
+ * @brief Memory handed out while the original functions are being located, as dlsym may allocate
+ */
+static unsigned char bootstrap_heap[4096] __attribute__((aligned(16)));
 
-	// Read file contents
-	size_t bytes_read = fread(buffer, 1, file_size, filePtr);
-	if (bytes_read != file_size) {
-		fprintf(stderr,"Error reading file: %s.\n", strerror(errno));
-		return NULL;
-	}
+/**
+ * @brief Bytes of bootstrap_heap handed out
+ */
+static size_t bootstrap_heap_used = 0;
 
-	// Null terminate string
-	buffer[file_size] = '\0';
+/**
+ * @brief Whether the original functions are being located
+ */
+static bool locating_allocators = false;
 
-	// Close file
-	fclose(filePtr);
-	filePtr = NULL;
+/**
+ * @brief Address of a slot in allocation_table that has never been used
+ */
+#define ALLOCATION_EMPTY ((uintptr_t) 0)
 
-	return buffer;
-}
+/**
+ * @brief Address of a slot in allocation_table whose block was freed, skipped by lookups and reused by insertions
+ */
+#define ALLOCATION_REMOVED ((uintptr_t) 1)
 
-char* read_source_code_file(const char* filename)
-{
-	// Get directory this source code file is in
-	char* directory = get_directory(__FILE__);
+/**
+ * @brief Address of a slot in allocation_table claimed by an insertion that has not yet published its block
+ */
+#define ALLOCATION_CLAIMED ((uintptr_t) 2)
 
-	// Build path incorporating directory and specified file
-	char* path = build_path(directory, filename);
+_Static_assert((ALLOCATION_TABLE_SIZE & (ALLOCATION_TABLE_SIZE - 1)) == 0, "ALLOCATION_TABLE_SIZE must be a power of 2");
 
-	// Free directory
-	free(directory);
-	directory = NULL;
+/**
+ * @brief Live block recorded in allocation_table
+ */
+struct allocation_record {
+	atomic_uintptr_t address; /**< Address of the block, ALLOCATION_EMPTY, ALLOCATION_REMOVED or ALLOCATION_CLAIMED */
+	size_t size; /**< Size requested for the block */
+	const void* callsite; /**< Return address of the call that allocated the block */
+	unsigned int epoch; /**< Value of allocation_epoch when the block was allocated */
+	bool guarded; /**< Whether the block was mapped in front of a guard page */
+};
 
-	// Read file
-	char* source_code = read_file(path);
+/**
+ * @brief Live blocks by address, with linear probing; slots are claimed by compare-and-swap, so no lock is taken
+ */
+static struct allocation_record allocation_table[ALLOCATION_TABLE_SIZE];
 
-	// Free path info
-	free(path);
-	path = NULL;
+/**
+ * @brief Most slots past its first that any block has been recorded at, so lookups stop there instead of
+ * running through the slots of freed blocks, which never become empty again, to the end of the table
+ */
+static atomic_size_t allocation_probe_limit = 0;
 
-	// Return file
-	// ReSharper disable once CppDFAMemoryLeak
-	return source_code;
-}
+/**
+ * @brief Incremented by begin_allocation_tracking, so blocks allocated before it are not reported as leaks
+ */
+static atomic_uint allocation_epoch = 0;
 
-char* write_file(const char* path, const char* contents, const bool overwrite)
-{
-	// If file exists, check if we should overwrite
-	FILE* filePtr = fopen(path, "r");
-	char* old_contents = NULL;
-	if (filePtr != NULL) {
-		fclose(filePtr);
+/**
+ * @brief Blocks allocated since begin_allocation_tracking
+ */
+static atomic_size_t allocation_count = 0;
 
-		// Load existing contents of file
-		old_contents = read_file(path);
+/**
+ * @brief Tracked blocks freed since begin_allocation_tracking
+ */
+static atomic_size_t free_count = 0;
 
-		// If file content exists, and we were not set to overwrite, display error and return
-		if (!overwrite) {
-			// Print error message
-			fprintf(stderr, "File %s already exists. Function was set to not overwrite.\n", path);
+/**
+ * @brief Bytes of tracked blocks not yet freed
+ */
+static atomic_size_t live_bytes = 0;
 
-			// Free old_contents
-			free(old_contents);
-			old_contents = NULL;
-			
-			return NULL;
-		}
-	}
+/**
+ * @brief Highest value of live_bytes since begin_allocation_tracking
+ */
+static atomic_size_t peak_bytes = 0;
 
-	// Write contents to file
-	filePtr = fopen(path, "w");
-	if (filePtr == NULL) {
-		// Print error message
-		fprintf(stderr, "Error writing to file %s: %s.\n", path, strerror(errno));
-		
-		exit(EXIT_FAILURE);
-	}
+/**
+ * @brief Blocks allocated since begin_allocation_tracking that did not fit in allocation_table
+ */
+static atomic_size_t untracked_allocations = 0;
 
-	// Write to file
-	fputs(contents, filePtr);
+/**
+ * @brief Poisoning of new blocks, an enum malloc_poisoning
+ */
+static atomic_int malloc_poisoning = MALLOC_POISONING;
 
-	// Close file
-	fclose(filePtr);
-	filePtr = NULL;
+/**
+ * @brief Number of bytes poisoned with MALLOC_POISON_PREFIX
+ */
+static atomic_size_t malloc_poison_prefix_bytes = MALLOC_POISON_PREFIX_BYTES;
 
-	return old_contents;
-}
+/**
+ * @brief Whether any block has been mapped in front of a guard page, which malloc_usable_size must then look up
+ */
+static atomic_bool guarded_allocations_made = false;
 
-#ifdef CAPTURE_OUTPUT
-int putchar(int c)
+/**
+ * @brief Hands out zeroed memory from bootstrap_heap
+ * @param size Number of bytes requested
+ * @return Pointer to memory or NULL if bootstrap_heap is used up
+ */
+static void* allocate_from_bootstrap_heap(size_t size)
 {
-	// Open file for storing output
-	FILE* filePtr = fopen(CAPTURE_OUTPUT, "a");
-	if (filePtr == NULL)
+	size_t start = (bootstrap_heap_used + 15) & ~(size_t) 15;
+	if (start > sizeof(bootstrap_heap) || size > sizeof(bootstrap_heap) - start)
 	{
-		fprintf(stderr, "Error opening file for writing: %s\n", strerror(errno));
-		exit(EXIT_FAILURE);
+		return NULL;
 	}
+	bootstrap_heap_used = start + size;
 
-	// Write char to file
-	fputc(c, filePtr);
-
-	// Write char to screen
-	int fputc_return = fputc(c, stdout);
-
-	// Close captured output file
-	fclose(filePtr);
-	filePtr = NULL;
+	return bootstrap_heap + start;
+}
 
-	return fputc_return;
+/**
+ * @brief Determines if memory came from bootstrap_heap
+ * @param ptr Pointer to check
+ * @return True if ptr points into bootstrap_heap, false otherwise
+ */
+static bool is_in_bootstrap_heap(const void* ptr)
+{
+	return (const unsigned char*) ptr >= bootstrap_heap && (const unsigned char*) ptr < bootstrap_heap + sizeof(bootstrap_heap);
 }
 
-int printf(const char* __restrict __fmt, ...)
+/**
+ * @brief Locates the original allocation functions on first use
+ * @return True if they have been located, false while they are being located or if one is missing
+ */
+static bool locate_allocators(void)
 {
-	// Open file for storing output
-	FILE* filePtr = fopen(CAPTURE_OUTPUT, "a");
-	if (filePtr == NULL)
+	if (real_free != NULL)
 	{
-		fprintf(stderr, "Error opening file for writing: %s\n", strerror(errno));
-		exit(EXIT_FAILURE);
+		return true;
+	}
+	if (locating_allocators)
+	{
+		return false;
 	}
 
-	// Use variadic arguments to print to file
-	va_list args_file;
-	va_start(args_file, __fmt);
-	vfprintf(filePtr, __fmt, args_file);
-	va_end(args_file);
-
-	// Use variadic arguments to print to screen
-	va_list args_screen;
-	va_start(args_screen, __fmt);
-	int printf_return = vprintf(__fmt, args_screen);
-	va_end(args_screen);
-
-	// Close captured output file
-	fclose(filePtr);
-	filePtr = NULL;
+	// Locate original functions, serving any allocation dlsym makes from bootstrap_heap
+	locating_allocators = true;
+	real_malloc = dlsym(RTLD_NEXT, "malloc");
+	real_calloc = dlsym(RTLD_NEXT, "calloc");
+	real_realloc = dlsym(RTLD_NEXT, "realloc");
+	real_posix_memalign = dlsym(RTLD_NEXT, "posix_memalign");
+	real_malloc_usable_size = dlsym(RTLD_NEXT, "malloc_usable_size");
+	void (*located_free)(void*) = dlsym(RTLD_NEXT, "free");
+
+	// Check for errors
+	if (real_malloc == NULL || real_calloc == NULL || real_realloc == NULL || real_posix_memalign == NULL || real_malloc_usable_size == NULL || located_free == NULL)
+	{
+		fprintf(stderr, "Error in `dlsym`: %s\n", dlerror());
+		locating_allocators = false;
+		return false;
+	}
+	real_free = located_free;
+	locating_allocators = false;
 
-	return printf_return;
+	return true;
 }
 
-int puts(const char* __s)
+/**
+ * @brief Gets the first slot to probe for a block
+ * @param address Address of the block
+ * @return Index into allocation_table
+ */
+static size_t get_allocation_slot(uintptr_t address)
 {
-	return printf("%s\n", __s);
+	// Drop the alignment bits and mix the rest with a Fibonacci hash
+	return (size_t) (((uint64_t) (address >> 4) * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (ALLOCATION_TABLE_SIZE - 1);
 }
 
 /**
- * @brief Tracks the location of original fprintf function
+ * @brief Records a block in allocation_table
+ * @param ptr Address of the block
+ * @param size Size requested for the block
+ * @param callsite Return address of the call that allocated the block
+ * @param epoch Epoch the block was allocated in
+ * @param guarded Whether the block was mapped in front of a guard page
+ * @return True on success, false if the table is full
  */
-static int (*real_fprintf)(FILE* __stream, const char*, ...) = NULL;
-
-int fprintf(FILE* __restrict __stream, const char* __restrict __fmt, ...)
+static bool insert_allocation_record(const void* ptr, size_t size, const void* callsite, unsigned int epoch, bool guarded)
 {
-	// Store original malloc function prior to remapping
-	if (real_fprintf == NULL)
+	uintptr_t address = (uintptr_t) ptr;
+	size_t slot = get_allocation_slot(address);
+	for (size_t probe = 0; probe < ALLOCATION_TABLE_SIZE; probe++)
 	{
-		// Locate original malloc function
-		real_fprintf = dlsym(RTLD_NEXT, "fprintf");
-
-		// Check for errors
-		if (real_fprintf == NULL)
+		// Claim the first free slot, which no other thread can be looking for this address in
+		struct allocation_record* record = &allocation_table[slot];
+		uintptr_t current = atomic_load_explicit(&record->address, memory_order_relaxed);
+		if (current == ALLOCATION_EMPTY || current == ALLOCATION_REMOVED)
 		{
-			real_fprintf(stderr, "Error in `dlsym`: %s\n", dlerror());
+			// Let lookups reach this slot before the block can be looked up
+			size_t limit = atomic_load_explicit(&allocation_probe_limit, memory_order_relaxed);
+			while (probe > limit && !atomic_compare_exchange_weak_explicit(&allocation_probe_limit, &limit, probe, memory_order_relaxed, memory_order_relaxed))
+			{
+			}
+			// Fill in the claimed slot, then publish the address, so a lookup that matches it sees the whole record
+			if (atomic_compare_exchange_strong_explicit(&record->address, &current, ALLOCATION_CLAIMED, memory_order_acquire, memory_order_relaxed))
+			{
+				record->size = size;
+				record->callsite = callsite;
+				record->epoch = epoch;
+				record->guarded = guarded;
+				atomic_store_explicit(&record->address, address, memory_order_release);
+				return true;
+			}
 		}
+		slot = (slot + 1) & (ALLOCATION_TABLE_SIZE - 1);
 	}
 
-	// Use variadic arguments to print to screen
-	va_list args_screen;
-	va_start(args_screen, __fmt);
-	int fprintf_return = vfprintf(__stream, __fmt, args_screen);
-	va_end(args_screen);
+	return false;
+}
 
-	// Print to file if target was stdout or stderr
-	if (__stream == stdout || __stream == stderr)
+/**
+ * @brief Looks up a block in allocation_table
+ * @param ptr Address of the block
+ * @param remove Whether to remove the block from the table
+ * @param found Receives a copy of the record of the block
+ * @return True if the block was found, false if it is not tracked
+ */
+static bool find_allocation_record(const void* ptr, bool remove, struct allocation_record* found)
+{
+	uintptr_t address = (uintptr_t) ptr;
+	size_t slot = get_allocation_slot(address);
+	size_t limit = atomic_load_explicit(&allocation_probe_limit, memory_order_relaxed);
+	for (size_t probe = 0; probe <= limit && probe < ALLOCATION_TABLE_SIZE; probe++)
 	{
-		// Open file for storing output
-		FILE* filePtr = fopen(CAPTURE_OUTPUT, "a");
-		if (filePtr == NULL)
+		struct allocation_record* record = &allocation_table[slot];
+		uintptr_t current = atomic_load_explicit(&record->address, memory_order_acquire);
+		if (current == ALLOCATION_EMPTY)
 		{
-			real_fprintf(stderr, "Error opening file for writing: %s\n", strerror(errno));
-			exit(EXIT_FAILURE);
+			return false;
 		}
-
-		// Use variadic arguments to print to file
-		va_list args_file;
-		va_start(args_file, __fmt);
-		vfprintf(filePtr, __fmt, args_file);
-		va_end(args_file);
-
-		// Close captured output file
-		fclose(filePtr);
-		filePtr = NULL;
+		if (current == address)
+		{
+			// Copy the record before releasing the slot to other insertions
+			found->size = record->size;
+			found->callsite = record->callsite;
+			found->epoch = record->epoch;
+			found->guarded = record->guarded;
+			if (remove)
+			{
+				atomic_store_explicit(&record->address, ALLOCATION_REMOVED, memory_order_release);
+			}
+			return true;
+		}
+		slot = (slot + 1) & (ALLOCATION_TABLE_SIZE - 1);
 	}
 
-	return fprintf_return;
+	return false;
 }
 
-char* get_captured_output(void)
+/**
+ * @brief Records and counts a new block
+ * @param ptr Address of the block, or NULL if the allocation failed
+ * @param size Size requested for the block
+ * @param callsite Return address of the call that allocated the block
+ * @param guarded Whether the block was mapped in front of a guard page
+ * @return True if the block is tracked, false if the table is full
+ */
+static bool track_allocation(const void* ptr, size_t size, const void* callsite, bool guarded)
 {
-	#ifndef CAPTURE_OUTPUT
-		fprintf(stderr, "Output is not being captured.\n");
-		return NULL;
-	#else
-		// Check to see if file exists
-		if (!does_file_exist(CAPTURE_OUTPUT))
-		{
-			fprintf(stderr, "File %s does not exist.\n", CAPTURE_OUTPUT);
-			return NULL;
-		}
+	if (ptr == NULL)
+	{
+		return false;
+	}
+
+	atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+	if (!insert_allocation_record(ptr, size, callsite, atomic_load_explicit(&allocation_epoch, memory_order_relaxed), guarded))
+	{
+		atomic_fetch_add_explicit(&untracked_allocations, 1, memory_order_relaxed);
+		return false;
+	}
 
-		// Read file
-		char* file_contentsPtr = read_file(CAPTURE_OUTPUT);
+	// Count the bytes, raising the peak if this is the most live at once
+	size_t live = atomic_fetch_add_explicit(&live_bytes, size, memory_order_relaxed) + size;
+	size_t peak = atomic_load_explicit(&peak_bytes, memory_order_relaxed);
+	while (live > peak && !atomic_compare_exchange_weak_explicit(&peak_bytes, &peak, live, memory_order_relaxed, memory_order_relaxed))
+	{
+	}
 
-		// Return file contents
-		return file_contentsPtr;
-	#endif
+	return true;
 }
-#endif
 
 /**
- * @brief Buffer for jumping to in case of a caught signal
+ * @brief Counts a tracked block that has been removed from allocation_table for freeing
+ * @param record Copy of the record of the block
  */
-static sigjmp_buf jump_buffer;
-
-// ReSharper disable once CppParameterNeverUsed
-void sigsegv_handler(int sig)
+static void count_free(const struct allocation_record* record)
 {
-	// Jump to specified location
-	siglongjmp(jump_buffer, 1);
+	atomic_fetch_add_explicit(&free_count, 1, memory_order_relaxed);
+	atomic_fetch_sub_explicit(&live_bytes, record->size, memory_order_relaxed);
 }
 
-bool is_pointer_null_or_valid(const void* ptr)
+/**
+ * @brief Poisons new memory as set by set_malloc_poisoning
+ * @param memory Memory to poison
+ * @param size Number of bytes of memory
+ */
+static void poison_memory(void* memory, size_t size)
 {
-	// Return true for NULL pointers
-	if (ptr == NULL)
+	switch (atomic_load_explicit(&malloc_poisoning, memory_order_relaxed))
 	{
-		return true;
+		case MALLOC_POISON_NONE:
+			break;
+		case MALLOC_POISON_PREFIX:
+		{
+			size_t prefix = atomic_load_explicit(&malloc_poison_prefix_bytes, memory_order_relaxed);
+			memset(memory, 0xFF, size < prefix ? size : prefix);
+			break;
+		}
+		default:
+			memset(memory, 0xFF, size);
+			break;
 	}
+}
 
-	// Do other checks to see if valid
-	return is_pointer_valid(ptr);
+/**
+ * @brief Gets the size of a memory page
+ * @return Page size in bytes
+ */
+static size_t get_page_size(void)
+{
+	static size_t page_size = 0;
+	if (page_size == 0)
+	{
+		page_size = (size_t) sysconf(_SC_PAGESIZE);
+	}
+
+	return page_size;
 }
 
-bool is_pointer_valid(const void* ptr)
+/**
+ * @brief Maps a block that ends as close to an inaccessible guard page as malloc's alignment allows
+ * @param size Number of bytes requested
+ * @return Pointer to zeroed memory or NULL if it could not be mapped
+ */
+static void* allocate_guarded(size_t size)
+{
+	size_t page_size = get_page_size();
+	if (size > SIZE_MAX - 2 * page_size)
+	{
+		return NULL;
+	}
+	size_t data_length = (size + page_size - 1) & ~(page_size - 1);
+	unsigned char* mapping = mmap(NULL, data_length + page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapping == MAP_FAILED)
+	{
+		return NULL;
+	}
+	unsigned char* guard = mapping + data_length;
+	if (mprotect(guard, page_size, PROT_NONE) != 0)
+	{
+		munmap(mapping, data_length + page_size);
+		return NULL;
+	}
+
+	return (void*) ((uintptr_t) (guard - size) & ~(uintptr_t) (_Alignof(max_align_t) - 1));
+}
+
+/**
+ * @brief Unmaps a block mapped by allocate_guarded, with its guard page
+ * @param ptr Pointer returned by allocate_guarded
+ * @param size Number of bytes requested for it
+ */
+static void release_guarded(void* ptr, size_t size)
+{
+	size_t page_size = get_page_size();
+	uintptr_t start = (uintptr_t) ptr & ~(uintptr_t) (page_size - 1);
+	uintptr_t guard = ((uintptr_t) ptr + size + page_size - 1) & ~(uintptr_t) (page_size - 1);
+	munmap((void*) start, guard + page_size - start);
+}
+
+/**
+ * @brief Allocates, poisons and tracks a block
+ * @param size Number of bytes requested
+ * @param zeroed Whether the block must be zeroed instead of poisoned
+ * @param callsite Return address of the call that allocated the block
+ * @return Pointer to allocated memory or NULL if allocation failed
+ */
+static void* allocate_memory(size_t size, bool zeroed, const void* callsite)
+{
+	if (!locate_allocators())
+	{
+		return locating_allocators ? allocate_from_bootstrap_heap(size) : NULL;
+	}
+
+	// Map the block in front of a guard page if asked to and it can be tracked, since free must find it to unmap it
+	if (atomic_load_explicit(&malloc_poisoning, memory_order_relaxed) == MALLOC_POISON_GUARD_PAGE)
+	{
+		void* memoryPtr = allocate_guarded(size);
+		if (memoryPtr != NULL)
+		{
+			if (track_allocation(memoryPtr, size, callsite, true))
+			{
+				atomic_store_explicit(&guarded_allocations_made, true, memory_order_relaxed);
+				if (!zeroed)
+				{
+					memset(memoryPtr, 0xFF, size);
+				}
+				return memoryPtr;
+			}
+			release_guarded(memoryPtr, size);
+		}
+	}
+
+	// Call original function
+	void* memoryPtr = zeroed ? real_calloc(1, size) : real_malloc(size);
+	if (memoryPtr != NULL && !zeroed)
+	{
+		poison_memory(memoryPtr, size);
+	}
+	track_allocation(memoryPtr, size, callsite, false);
+
+	return memoryPtr;
+}
+
+/**
+ * @brief Allocates, poisons and tracks an aligned block
+ * @param alignment Alignment of the block, a power of 2
+ * @param size Number of bytes requested
+ * @param callsite Return address of the call that allocated the block
+ * @param memptr Receives the pointer to allocated memory
+ * @return 0 on success, or an errno value if allocation failed
+ */
+static int allocate_aligned_memory(size_t alignment, size_t size, const void* callsite, void** memptr)
+{
+	if (!locate_allocators())
+	{
+		return ENOMEM;
+	}
+	int result = real_posix_memalign(memptr, alignment, size);
+	if (result == 0)
+	{
+		poison_memory(*memptr, size);
+		track_allocation(*memptr, size, callsite, false);
+	}
+
+	return result;
+}
+
+/**
+ * @brief Overridden version of malloc to poison memory as set by set_malloc_poisoning and to track the block
+ * @param size Number of bytes requested
+ * @return Pointer to allocated memory or NULL if allocation failed
+ */
+// ReSharper disable once CppParameterNamesMismatch
+__attribute__((noinline)) void* malloc(size_t size)
+{
+	return allocate_memory(size, false, __builtin_return_address(0));
+}
+
+/**
+ * @brief Overridden version of calloc to track the block
+ * @param count Number of elements
+ * @param size Size of each element
+ * @return Pointer to zeroed memory or NULL if allocation failed
+ */
+__attribute__((noinline)) void* calloc(size_t count, size_t size)
+{
+	if (size != 0 && count > SIZE_MAX / size)
+	{
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	return allocate_memory(count * size, true, __builtin_return_address(0));
+}
+
+/**
+ * @brief Resizes, poisons the added memory of and tracks a block
+ * @param ptr Block to resize, or NULL
+ * @param size Number of bytes requested
+ * @param callsite Return address of the call that resized the block
+ * @return Pointer to the resized block, or NULL if allocation failed or size was 0
+ */
+static void* resize_memory(void* ptr, size_t size, const void* callsite)
 {
-	// Treat NULL pointers as not valid
 	if (ptr == NULL)
 	{
+		return allocate_memory(size, false, callsite);
+	}
+
+	// Move blocks from bootstrap_heap, which was zeroed and is never reused, to the heap
+	if (is_in_bootstrap_heap(ptr))
+	{
+		void* memoryPtr = allocate_memory(size, false, callsite);
+		size_t available = (size_t) (bootstrap_heap + sizeof(bootstrap_heap) - (unsigned char*) ptr);
+		if (memoryPtr != NULL)
+		{
+			memcpy(memoryPtr, ptr, size < available ? size : available);
+		}
+		return memoryPtr;
+	}
+	if (!locate_allocators())
+	{
+		return NULL;
+	}
+	if (size == 0)
+	{
+		free(ptr);
+		return NULL;
+	}
+
+	// Take the block out of the table first, as another thread may be given its address once it is released
+	struct allocation_record record;
+	bool tracked = find_allocation_record(ptr, true, &record);
+
+	// Copy guarded blocks, and any block while guarding, as the original realloc cannot resize them in place
+	if ((tracked && record.guarded) || atomic_load_explicit(&malloc_poisoning, memory_order_relaxed) == MALLOC_POISON_GUARD_PAGE)
+	{
+		void* memoryPtr = allocate_memory(size, false, callsite);
+		if (memoryPtr == NULL)
+		{
+			if (tracked)
+			{
+				insert_allocation_record(ptr, record.size, record.callsite, record.epoch, record.guarded);
+			}
+			return NULL;
+		}
+		size_t old_size = tracked ? record.size : real_malloc_usable_size(ptr);
+		memcpy(memoryPtr, ptr, size < old_size ? size : old_size);
+		if (tracked)
+		{
+			count_free(&record);
+		}
+		if (tracked && record.guarded)
+		{
+			release_guarded(ptr, record.size);
+		}
+		else
+		{
+			real_free(ptr);
+		}
+		return memoryPtr;
+	}
+
+	// Resize with the original function, putting the record back if it fails and the block is unchanged
+	void* memoryPtr = real_realloc(ptr, size);
+	if (memoryPtr == NULL)
+	{
+		if (tracked)
+		{
+			insert_allocation_record(ptr, record.size, record.callsite, record.epoch, record.guarded);
+		}
+		return NULL;
+	}
+	if (tracked)
+	{
+		count_free(&record);
+		if (size > record.size)
+		{
+			poison_memory((unsigned char*) memoryPtr + record.size, size - record.size);
+		}
+	}
+	track_allocation(memoryPtr, size, callsite, false);
+
+	return memoryPtr;
+}
+
+/**
+ * @brief Overridden version of realloc to poison the added memory and to track the block
+ * @param ptr Block to resize, or NULL
+ * @param size Number of bytes requested
+ * @return Pointer to the resized block, or NULL if allocation failed or size was 0
+ */
+__attribute__((noinline)) void* realloc(void* ptr, size_t size)
+{
+	return resize_memory(ptr, size, __builtin_return_address(0));
+}
+
+/**
+ * @brief Overridden version of free to count the block and to unmap guarded blocks
+ * @param ptr Block to free, or NULL
+ */
+__attribute__((noinline)) void free(void* ptr)
+{
+	if (ptr == NULL || is_in_bootstrap_heap(ptr) || !locate_allocators())
+	{
+		return;
+	}
+
+	// Count tracked blocks, freeing untracked ones, allocated before they could be tracked, as they are
+	struct allocation_record record;
+	if (find_allocation_record(ptr, true, &record))
+	{
+		count_free(&record);
+		if (record.guarded)
+		{
+			release_guarded(ptr, record.size);
+			return;
+		}
+	}
+	real_free(ptr);
+}
+
+/**
+ * @brief Overridden version of posix_memalign to poison memory and to track the block, never guarded
+ * @param memptr Receives the pointer to allocated memory
+ * @param alignment Alignment of the block, a power of 2 and multiple of sizeof(void*)
+ * @param size Number of bytes requested
+ * @return 0 on success, or an errno value if allocation failed
+ */
+__attribute__((noinline)) int posix_memalign(void** memptr, size_t alignment, size_t size)
+{
+	return allocate_aligned_memory(alignment, size, __builtin_return_address(0), memptr);
+}
+
+/**
+ * @brief Overridden version of aligned_alloc to poison memory and to track the block, never guarded
+ * @param alignment Alignment of the block, a power of 2
+ * @param size Number of bytes requested
+ * @return Pointer to allocated memory or NULL if allocation failed
+ */
+__attribute__((noinline)) void* aligned_alloc(size_t alignment, size_t size)
+{
+	void* memoryPtr = NULL;
+	int result = allocate_aligned_memory(alignment < sizeof(void*) ? sizeof(void*) : alignment, size, __builtin_return_address(0), &memoryPtr);
+	if (result != 0)
+	{
+		errno = result;
+		return NULL;
+	}
+
+	return memoryPtr;
+}
+
+/**
+ * @brief Overridden version of memalign to poison memory and to track the block, never guarded
+ * @param alignment Alignment of the block, a power of 2
+ * @param size Number of bytes requested
+ * @return Pointer to allocated memory or NULL if allocation failed
+ */
+__attribute__((noinline)) void* memalign(size_t alignment, size_t size)
+{
+	void* memoryPtr = NULL;
+	int result = allocate_aligned_memory(alignment < sizeof(void*) ? sizeof(void*) : alignment, size, __builtin_return_address(0), &memoryPtr);
+	if (result != 0)
+	{
+		errno = result;
+		return NULL;
+	}
+
+	return memoryPtr;
+}
+
+/**
+ * @brief Overridden version of valloc to poison memory and to track the block, never guarded
+ * @param size Number of bytes requested
+ * @return Page-aligned pointer to allocated memory or NULL if allocation failed
+ */
+__attribute__((noinline)) void* valloc(size_t size)
+{
+	void* memoryPtr = NULL;
+	int result = allocate_aligned_memory(get_page_size(), size, __builtin_return_address(0), &memoryPtr);
+	if (result != 0)
+	{
+		errno = result;
+		return NULL;
+	}
+
+	return memoryPtr;
+}
+
+/**
+ * @brief Overridden version of reallocarray, as the original resizes with the original realloc, which cannot resize guarded blocks
+ * @param ptr Block to resize, or NULL
+ * @param count Number of elements
+ * @param size Size of each element
+ * @return Pointer to the resized block, or NULL if allocation failed or the size overflowed
+ */
+__attribute__((noinline)) void* reallocarray(void* ptr, size_t count, size_t size)
+{
+	if (size != 0 && count > SIZE_MAX / size)
+	{
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	return resize_memory(ptr, count * size, __builtin_return_address(0));
+}
+
+/**
+ * @brief Overridden version of malloc_usable_size that knows the size of guarded blocks
+ * @param ptr Block to measure
+ * @return Number of usable bytes in the block
+ */
+__attribute__((noinline)) size_t malloc_usable_size(void* ptr)
+{
+	if (ptr == NULL || is_in_bootstrap_heap(ptr))
+	{
+		return 0;
+	}
+	struct allocation_record record;
+	if (atomic_load_explicit(&guarded_allocations_made, memory_order_relaxed) && find_allocation_record(ptr, false, &record) && record.guarded)
+	{
+		return record.size;
+	}
+	if (!locate_allocators())
+	{
+		return 0;
+	}
+
+	return real_malloc_usable_size(ptr);
+}
+
+void set_malloc_poisoning(enum malloc_poisoning poisoning, size_t prefix_bytes)
+{
+	atomic_store_explicit(&malloc_poisoning, (int) poisoning, memory_order_relaxed);
+	atomic_store_explicit(&malloc_poison_prefix_bytes, prefix_bytes, memory_order_relaxed);
+}
+
+void begin_allocation_tracking(void)
+{
+	// Start a new epoch, so older blocks are no longer counted as leaks
+	atomic_fetch_add_explicit(&allocation_epoch, 1, memory_order_relaxed);
+	atomic_store_explicit(&allocation_count, 0, memory_order_relaxed);
+	atomic_store_explicit(&free_count, 0, memory_order_relaxed);
+	atomic_store_explicit(&untracked_allocations, 0, memory_order_relaxed);
+	atomic_store_explicit(&peak_bytes, atomic_load_explicit(&live_bytes, memory_order_relaxed), memory_order_relaxed);
+}
+
+void get_allocation_statistics(struct allocation_statistics* statistics)
+{
+	statistics->allocations = atomic_load_explicit(&allocation_count, memory_order_relaxed);
+	statistics->frees = atomic_load_explicit(&free_count, memory_order_relaxed);
+	statistics->live_bytes = atomic_load_explicit(&live_bytes, memory_order_relaxed);
+	statistics->peak_bytes = atomic_load_explicit(&peak_bytes, memory_order_relaxed);
+	statistics->untracked_allocations = atomic_load_explicit(&untracked_allocations, memory_order_relaxed);
+
+	// Add up the blocks of this epoch left in the table, which keeps allocating and freeing to a few atomic operations
+	unsigned int epoch = atomic_load_explicit(&allocation_epoch, memory_order_relaxed);
+	statistics->leaked_allocations = 0;
+	statistics->leaked_bytes = 0;
+	for (size_t slot = 0; slot < ALLOCATION_TABLE_SIZE; slot++)
+	{
+		struct allocation_record* record = &allocation_table[slot];
+		uintptr_t address = atomic_load_explicit(&record->address, memory_order_acquire);
+		if (address != ALLOCATION_EMPTY && address != ALLOCATION_REMOVED && address != ALLOCATION_CLAIMED && record->epoch == epoch)
+		{
+			statistics->leaked_allocations++;
+			statistics->leaked_bytes += record->size;
+		}
+	}
+}
+
+size_t report_allocation_leaks(FILE* stream)
+{
+	// Print the blocks of this epoch left in the table
+	unsigned int epoch = atomic_load_explicit(&allocation_epoch, memory_order_relaxed);
+	size_t leaks = 0;
+	for (size_t slot = 0; slot < ALLOCATION_TABLE_SIZE; slot++)
+	{
+		struct allocation_record* record = &allocation_table[slot];
+		uintptr_t address = atomic_load_explicit(&record->address, memory_order_acquire);
+		if (address == ALLOCATION_EMPTY || address == ALLOCATION_REMOVED || address == ALLOCATION_CLAIMED || record->epoch != epoch)
+		{
+			continue;
+		}
+		leaks++;
+
+		// Name the caller by symbol where it is exported, otherwise by its offset in the file for addr2line
+		Dl_info info;
+		bool located = dladdr(record->callsite, &info) != 0;
+		if (located && info.dli_sname != NULL)
+		{
+			fprintf(stream, "Leaked %zu bytes at %p, allocated from %s+0x%lx\n", record->size, (void*) address, info.dli_sname, (unsigned long) ((uintptr_t) record->callsite - (uintptr_t) info.dli_saddr));
+		}
+		else if (located && info.dli_fname != NULL)
+		{
+			fprintf(stream, "Leaked %zu bytes at %p, allocated from %s+0x%lx\n", record->size, (void*) address, info.dli_fname, (unsigned long) ((uintptr_t) record->callsite - (uintptr_t) info.dli_fbase));
+		}
+		else
+		{
+			fprintf(stream, "Leaked %zu bytes at %p, allocated from %p\n", record->size, (void*) address, record->callsite);
+		}
+	}
+
+	return leaks;
+}
+
+char* read_file(const char* path)
+{
+	// Exit if path is NULL
+	if (path == NULL) {
+		fprintf(stderr, "Path is NULL.\n");
+		return NULL;
+	}
+
+	// Get file size
+	size_t file_size = get_file_size(path);
+
+	// Attempt to open file.
+	FILE* filePtr = fopen(path, "r");
+	if (filePtr == NULL) {
+		fprintf(stderr, "File %s not found.\n", path);
+		return NULL;
+	}
+
+	// Malloc memory for file
+	char* buffer = malloc(file_size + 1);
+	if (buffer == NULL) {
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return NULL;
+	}
+
+	// Read file contents
+	size_t bytes_read = fread(buffer, 1, file_size, filePtr);
+	if (bytes_read != file_size) {
+		fprintf(stderr,"Error reading file: %s.\n", strerror(errno));
+		return NULL;
+	}
+
+	// Null terminate string
+	buffer[file_size] = '\0';
+
+	// Close file
+	fclose(filePtr);
+	filePtr = NULL;
+
+	return buffer;
+}
+
+char* read_source_code_file(const char* filename)
+{
+	// Get directory this source code file is in
+	char* directory = get_directory(__FILE__);
+
+	// Build path incorporating directory and specified file
+	char* path = build_path(directory, filename);
+
+	// Free directory
+	free(directory);
+	directory = NULL;
+
+	// Read file
+	char* source_code = read_file(path);
+
+	// Free path info
+	free(path);
+	path = NULL;
+
+	// Return file
+	// ReSharper disable once CppDFAMemoryLeak
+	return source_code;
+}
+
+char* write_file(const char* path, const char* contents, const bool overwrite)
+{
+	// If file exists, check if we should overwrite
+	FILE* filePtr = fopen(path, "r");
+	char* old_contents = NULL;
+	if (filePtr != NULL) {
+		fclose(filePtr);
+
+		// Load existing contents of file
+		old_contents = read_file(path);
+
+		// If file content exists, and we were not set to overwrite, display error and return
+		if (!overwrite) {
+			// Print error message
+			fprintf(stderr, "File %s already exists. Function was set to not overwrite.\n", path);
+
+			// Free old_contents
+			free(old_contents);
+			old_contents = NULL;
+			
+			return NULL;
+		}
+	}
+
+	// Write contents to file
+	filePtr = fopen(path, "w");
+	if (filePtr == NULL) {
+		// Print error message
+		fprintf(stderr, "Error writing to file %s: %s.\n", path, strerror(errno));
+		
+		exit(EXIT_FAILURE);
+	}
+
+	// Write to file
+	fputs(contents, filePtr);
+
+	// Close file
+	fclose(filePtr);
+	filePtr = NULL;
+
+	return old_contents;
+}
+
+#ifdef CAPTURE_OUTPUT
+/**
+ * @brief Bytes reserved for captured output; output past this is not captured
+ */
+#ifndef CAPTURE_OUTPUT_CAPACITY
+#define CAPTURE_OUTPUT_CAPACITY ((size_t)256 * 1024 * 1024)
+#endif
+
+/**
+ * @brief Output captured by the overridden output functions, shared with forked children
+ */
+struct captured_output_buffer
+{
+	atomic_size_t length; /**< Bytes reserved so far, which may pass CAPTURE_OUTPUT_CAPACITY */
+	char contents[]; /**< Output in the order it was reserved */
+};
+
+/**
+ * @brief Shared buffer of captured output, or NULL if it could not be mapped
+ */
+static struct captured_output_buffer* captured_output = NULL;
+
+/**
+ * @brief Process that mapped the buffer, the only one that appends it to the CAPTURE_OUTPUT file
+ */
+static pid_t captured_output_owner = -1;
+
+/**
+ * @brief Bytes of captured output already appended to the CAPTURE_OUTPUT file
+ */
+static size_t captured_output_flushed = 0;
+
+/**
+ * @brief Appends the captured output at exit
+ */
+static void flush_captured_output_at_exit(void)
+{
+	flush_captured_output();
+}
+
+/**
+ * @brief Maps the capture buffer before main, so that every forked child writes to the same one
+ */
+__attribute__((constructor)) static void map_captured_output(void)
+{
+	// Reserve address space only; pages are allocated as output reaches them
+	void* buffer = mmap(NULL, sizeof(struct captured_output_buffer) + CAPTURE_OUTPUT_CAPACITY, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (buffer == MAP_FAILED)
+	{
+		fputs("Error mapping memory for captured output.\n", stderr);
+		return;
+	}
+	captured_output = buffer;
+	captured_output_owner = getpid();
+	atexit(flush_captured_output_at_exit);
+}
+
+/**
+ * @brief Gets the number of bytes of captured output held in the buffer
+ * @return Bytes of output, at most CAPTURE_OUTPUT_CAPACITY
+ */
+static size_t get_captured_output_length(void)
+{
+	size_t length = atomic_load(&captured_output->length);
+
+	return length < CAPTURE_OUTPUT_CAPACITY ? length : CAPTURE_OUTPUT_CAPACITY;
+}
+
+/**
+ * @brief Reserves room at the end of the capture buffer, so output from several processes does not interleave
+ * @param length Number of bytes to reserve
+ * @return Start of the reserved bytes, or NULL if they do not fit
+ */
+static char* reserve_captured_output(size_t length)
+{
+	if (captured_output == NULL)
+	{
+		return NULL;
+	}
+	size_t offset = atomic_fetch_add(&captured_output->length, length);
+	if (offset > CAPTURE_OUTPUT_CAPACITY || length > CAPTURE_OUTPUT_CAPACITY - offset)
+	{
+		return NULL;
+	}
+
+	return captured_output->contents + offset;
+}
+
+/**
+ * @brief Appends formatted output to the capture buffer
+ * @param format Format string
+ * @param args Arguments for the format string
+ */
+static void capture_formatted_output(const char* format, va_list args)
+{
+	// Format on the stack, or on the heap if it does not fit, as the length must be known to reserve it
+	char local[512];
+	va_list args_retry;
+	va_copy(args_retry, args);
+	int length = vsnprintf(local, sizeof(local), format, args);
+	if (length > 0)
+	{
+		char* formatted = local;
+		if ((size_t) length >= sizeof(local))
+		{
+			formatted = malloc((size_t) length + 1);
+			if (formatted != NULL)
+			{
+				vsnprintf(formatted, (size_t) length + 1, format, args_retry);
+			}
+		}
+		char* reserved = formatted != NULL ? reserve_captured_output((size_t) length) : NULL;
+		if (reserved != NULL)
+		{
+			memcpy(reserved, formatted, (size_t) length);
+		}
+		if (formatted != local)
+		{
+			free(formatted);
+		}
+	}
+	va_end(args_retry);
+}
+
+int putchar(int c)
+{
+	// Append char to capture buffer
+	char* reserved = reserve_captured_output(1);
+	if (reserved != NULL)
+	{
+		*reserved = (char) c;
+	}
+
+	// Write char to screen
+	return fputc(c, stdout);
+}
+
+int printf(const char* __restrict __fmt, ...)
+{
+	// Use variadic arguments to append to capture buffer
+	va_list args_capture;
+	va_start(args_capture, __fmt);
+	capture_formatted_output(__fmt, args_capture);
+	va_end(args_capture);
+
+	// Use variadic arguments to print to screen
+	va_list args_screen;
+	va_start(args_screen, __fmt);
+	int printf_return = vprintf(__fmt, args_screen);
+	va_end(args_screen);
+
+	return printf_return;
+}
+
+int puts(const char* __s)
+{
+	return printf("%s\n", __s);
+}
+
+int fprintf(FILE* __restrict __stream, const char* __restrict __fmt, ...)
+{
+	// Use variadic arguments to print to screen
+	va_list args_screen;
+	va_start(args_screen, __fmt);
+	int fprintf_return = vfprintf(__stream, __fmt, args_screen);
+	va_end(args_screen);
+
+	// Append to capture buffer if target was stdout or stderr
+	if (__stream == stdout || __stream == stderr)
+	{
+		va_list args_capture;
+		va_start(args_capture, __fmt);
+		capture_formatted_output(__fmt, args_capture);
+		va_end(args_capture);
+	}
+
+	return fprintf_return;
+}
+
+void flush_captured_output(void)
+{
+	// Only the process that mapped the buffer appends it, so the file keeps the order of the buffer
+	if (captured_output == NULL || captured_output_owner != getpid())
+	{
+		return;
+	}
+
+	// Append output not yet in the file with a single write
+	size_t length = get_captured_output_length();
+	if (captured_output_flushed >= length)
+	{
+		return;
+	}
+	FILE* filePtr = fopen(CAPTURE_OUTPUT, "a");
+	if (filePtr == NULL)
+	{
+		fputs("Error opening file for writing captured output.\n", stderr);
+		return;
+	}
+	fwrite(captured_output->contents + captured_output_flushed, 1, length - captured_output_flushed, filePtr);
+	fclose(filePtr);
+	filePtr = NULL;
+	captured_output_flushed = length;
+}
+
+char* get_captured_output(void)
+{
+	// Copy the capture buffer
+	size_t length = captured_output != NULL ? get_captured_output_length() : 0;
+	char* outputPtr = malloc(length + 1);
+	if (outputPtr == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return NULL;
+	}
+	if (length > 0)
+	{
+		memcpy(outputPtr, captured_output->contents, length);
+	}
+	outputPtr[length] = '\0';
+
+	return outputPtr;
+}
+#endif
+
+/**
+ * @brief Buffer for jumping to in case of a caught signal
+ */
+static sigjmp_buf jump_buffer;
+
+// ReSharper disable once CppParameterNeverUsed
+void sigsegv_handler(int sig)
+{
+	// Jump to specified location
+	siglongjmp(jump_buffer, 1);
+}
+
+bool is_pointer_null_or_valid(const void* ptr)
+{
+	// Return true for NULL pointers
+	if (ptr == NULL)
+	{
+		return true;
+	}
+
+	// Do other checks to see if valid
+	return is_pointer_valid(ptr);
+}
+
+bool is_pointer_valid(const void* ptr)
+{
+	// Treat NULL pointers as not valid
+	if (ptr == NULL)
+	{
+		return false;
+	}
+
+	// Configure signal handler	
+	struct sigaction sa;
+	sa.sa_handler = sigsegv_handler;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = 0;
+
+	// Change signal handler, storing old one
+	struct sigaction old_sa;
+	sigaction(SIGSEGV, &sa, &old_sa);
+
+	// Figure out if signal handler fired
+	if (sigsetjmp(jump_buffer, 1) == 0)
+	{
+		// Either first try, or signal handler did not fire meaning pointer was valid
+
+		// Try to read from pointer, with volatile keyword keeping optimizers from skipping the read operation
+		volatile char tmp = *(volatile char*)ptr;
+
+		// Suppress unused variable warning
+		(void)tmp;
+
+		// Reset signal handler
+		sigaction(SIGSEGV, &old_sa, NULL);
+	
+		// Pointer is valid, assuming that signal handler did not fire
+		return true;
+	}
+	else
+	{
+		// Signal handler did fire, so pointer was invalid
+
+		// Reset signal handler
+		sigaction(SIGSEGV, &old_sa, NULL);
+
+		// Pointer is invalid
+		return false;
+	}
+}
+
+bool is_pointer_read_only(const void* ptr)
+{
+	// Configure signal handler	
+	struct sigaction sa;
+	sa.sa_handler = sigsegv_handler;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = 0;
+
+	// Change signal handler, storing old one
+	struct sigaction old_sa;
+	sigaction(SIGSEGV, &sa, &old_sa);
+
+	// Figure out if signal handler fired
+	if (sigsetjmp(jump_buffer, 1) == 0)
+	{
+		// Signal handler did not fire, so pointer was not read only
+
+		// Try to write its current value back to the pointer to see if it's read-only, with volatile keyword keeping optimizers from skipping the operation
+		*(volatile char*)ptr = *(volatile char*)ptr;
+
+		// Reset signal handler
+		sigaction(SIGSEGV, &old_sa, NULL);
+
+		// Pointer is not read-only
+		return false;
+	}
+	else
+	{
+		// Signal handler did fire, so pointer was read-only
+
+		// Reset signal handler
+		sigaction(SIGSEGV, &old_sa, NULL);
+
+		// Pointer is read-only
+		return true;
+	}
+}
+
+int robust_nanosleep(const int seconds, const long nanoseconds)
+{
+	// Configure requested time
+	struct timespec sleep_time = { .tv_sec = seconds, .tv_nsec = nanoseconds };
+
+	// Structure to hold the remaining time after an interruption.
+	struct timespec remaining_time;
+
+	// Track status from calling nanosleep
+	int status;
+
+	// Call nanosleep in a loop to handle interruptions from signals
+	do
+	{
+		// Attempt to sleep
+		status = nanosleep(&sleep_time, &remaining_time);
+
+		// If status is 0, the sleep completed successfully
+		if (status == 0)
+		{
+			return 0;
+		}
+
+		// If status is -1, an error occurred. Check if it was EINTR (signal interruption).
+		if (errno == EINTR)
+		{
+			// A signal interrupted the sleep. Restart sleep with time from remaining_time object.
+			sleep_time = remaining_time;
+		}
+		else
+		{
+			// A different, unhandled error occurred
+			return -1;
+		}
+	}
+	while (status == -1 && errno == EINTR); // Continue loop only if interrupted by EINTR
+
+	return 0; // Should be unreachable given loop logic, but added for completeness
+}
+
+bool is_printable(const char* string)
+{
+	// Check to see if pointer is valid and not NULL
+	if (!is_pointer_valid(string))
+	{
+		return false;
+	}
+
+	// Check if string is empty
+	if (strlen(string) == 0)
+	{
+		return false;
+	}
+
+	// Loop to look for non-printable characters
+	for (size_t i = 0; i < strlen(string); i++)
+	{
+		// Check if character is not printable
+		if (!isprint(string[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+char* fix_string_null_termination(const char* string)
+{
+	// Return NULL if string is NULL or not valid
+	if (!is_pointer_valid(string))
+	{
+		return NULL;
+	}
+
+	// Malloc new string
+	char* fixedPtr = malloc(strlen(string) + 1);
+	if (fixedPtr == NULL)
+	{
+		return NULL;
+	}
+
+	// Initialize to null
+	memset(fixedPtr, 0, strlen(string) + 1);
+
+	// Copy string
+	strncpy(fixedPtr, string, strlen(string));
+
+	// Get position of last character, using signed type to avoid looping around
+	int position = (int) strlen(fixedPtr) - 1;
+
+	// Loop from end of string, moving left
+	while (position >= 0 && !isprint(fixedPtr[position]))
+	{
+		fixedPtr[position] = '\0';
+		position--;
+	}
+
+	return fixedPtr;
+}
+
+/**
+ * @brief Shared memory for the return values of CALL_FUNCTION_*_WITH_RETURN children, or NULL until first used
+ */
+static unsigned char* result_slab = NULL;
+
+/**
+ * @brief Slot handed out next from the result slab
+ */
+static size_t next_result_slot = 0;
+
+/**
+ * @brief Shared memory for return values too large for a slot, reused while large enough
+ */
+static unsigned char* large_result_slot = NULL;
+
+/**
+ * @brief Size of large_result_slot
+ */
+static size_t large_result_slot_size = 0;
+
+/**
+ * @brief Process that mapped the result slab; children map their own, so they do not hand out slots their parent uses
+ */
+static pid_t result_slab_owner = -1;
+
+void* get_result_slot(size_t size)
+{
+	// Map the slab once per process
+	if (result_slab_owner != getpid())
+	{
+		void* slab = mmap(NULL, RESULT_SLOT_SIZE * RESULT_SLOT_COUNT, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (slab == MAP_FAILED)
+		{
+			return NULL;
+		}
+		result_slab = slab;
+		next_result_slot = 0;
+		large_result_slot = NULL;
+		large_result_slot_size = 0;
+		result_slab_owner = getpid();
+	}
+
+	// Hand out the slots in turn, as each call has finished with its slot before the next
+	unsigned char* slot;
+	if (size <= RESULT_SLOT_SIZE)
+	{
+		slot = result_slab + next_result_slot * RESULT_SLOT_SIZE;
+		next_result_slot = (next_result_slot + 1) % RESULT_SLOT_COUNT;
+	}
+	else
+	{
+		// Grow the large slot when needed; the call that used the old mapping has finished with it
+		if (size > large_result_slot_size)
+		{
+			void* large_slot = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+			if (large_slot == MAP_FAILED)
+			{
+				return NULL;
+			}
+			if (large_result_slot != NULL)
+			{
+				munmap(large_result_slot, large_result_slot_size);
+			}
+			large_result_slot = large_slot;
+			large_result_slot_size = size;
+		}
+		slot = large_result_slot;
+	}
+
+	// Start from zeros, as a new shared memory segment does
+	memset(slot, 0, size);
+
+	return slot;
+}
+
+/**
+ * @brief Gets the current time from a monotonic clock
+ * @return Time in milliseconds
+ */
+static long long get_monotonic_milliseconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (long long) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Gets the deadline for a timeout starting now
+ * @param timeout_milliseconds Timeout in milliseconds, or a negative number for no timeout
+ * @return Deadline on the monotonic clock in milliseconds, or -1 for no deadline
+ */
+static long long get_deadline(int timeout_milliseconds)
+{
+	return timeout_milliseconds < 0 ? -1 : get_monotonic_milliseconds() + timeout_milliseconds;
+}
+
+/**
+ * @brief Sleeps until a file descriptor is readable or a deadline passes
+ * @param fd File descriptor to wait for
+ * @param deadline Deadline on the monotonic clock in milliseconds, or -1 for no deadline
+ * @return 1 if the file descriptor is readable, 0 if the deadline passed, or -1 if poll failed
+ */
+static int poll_until_deadline(int fd, long long deadline)
+{
+	struct pollfd poll_fd = { fd, POLLIN, 0 };
+	while (true)
+	{
+		// Sleep for the rest of the time to the deadline
+		int timeout = -1;
+		if (deadline >= 0)
+		{
+			long long remaining = deadline - get_monotonic_milliseconds();
+			if (remaining <= 0)
+			{
+				return 0;
+			}
+			timeout = remaining > INT_MAX ? INT_MAX : (int) remaining;
+		}
+
+		// Retry if interrupted by a signal
+		int ready = poll(&poll_fd, 1, timeout);
+		if (ready > 0)
+		{
+			return 1;
+		}
+		if (ready < 0 && errno != EINTR)
+		{
+			return -1;
+		}
+	}
+}
+
+/**
+ * @brief Kills a child that took too long and reaps it
+ * @param child_pid Child to kill
+ * @return Status reporting the timeout to CHECK_CHILD_RETURN
+ */
+static int kill_timed_out_child(pid_t child_pid)
+{
+	kill(child_pid, SIGKILL);
+	TEMP_FAILURE_RETRY(waitpid(child_pid, NULL, 0));
+
+	return W_EXITCODE(EXIT_TIMED_OUT, 0);
+}
+
+/**
+ * @brief Waits for a child by polling waitpid, for systems without pidfd_open or signalfd
+ * @param child_pid Child to wait for
+ * @param deadline Deadline on the monotonic clock in milliseconds, or -1 for no deadline
+ * @return Status of the child
+ */
+static int wait_for_child_pid_sleeping(pid_t child_pid, long long deadline)
+{
+	int child_return = -1;
+	while (true)
+	{
+		pid_t result = waitpid(child_pid, &child_return, WNOHANG);
+		if (result == child_pid || (result < 0 && errno != EINTR))
+		{
+			return child_return;
+		}
+		if (deadline >= 0 && get_monotonic_milliseconds() >= deadline)
+		{
+			return kill_timed_out_child(child_pid);
+		}
+		usleep(SLEEP_MICROSECONDS);
+	}
+}
+
+/**
+ * @brief Waits for a child by sleeping on a pidfd, which becomes readable when the child exits
+ * @param child_pid Child to wait for
+ * @param deadline Deadline on the monotonic clock in milliseconds, or -1 for no deadline
+ * @param child_return Receives the status of the child
+ * @return True if the wait finished, false if pidfd_open is not available
+ */
+static bool wait_for_child_pid_pidfd(pid_t child_pid, long long deadline, int* child_return)
+{
+#ifdef SYS_pidfd_open
+	// Open a file descriptor for the child
+	int pid_fd = (int) syscall(SYS_pidfd_open, child_pid, 0);
+	if (pid_fd < 0)
+	{
+		return false;
+	}
+
+	// Sleep until the child exits or the deadline passes
+	int ready = poll_until_deadline(pid_fd, deadline);
+	close(pid_fd);
+	if (ready == 0)
+	{
+		*child_return = kill_timed_out_child(child_pid);
+	}
+	else if (ready > 0)
+	{
+		*child_return = -1;
+		TEMP_FAILURE_RETRY(waitpid(child_pid, child_return, 0));
+	}
+	else
+	{
+		*child_return = wait_for_child_pid_sleeping(child_pid, deadline);
+	}
+
+	return true;
+#else
+	(void) child_pid;
+	(void) deadline;
+	(void) child_return;
+	return false;
+#endif
+}
+
+/**
+ * @brief Waits for a child by sleeping on a signalfd for SIGCHLD
+ * @param child_pid Child to wait for
+ * @param deadline Deadline on the monotonic clock in milliseconds, or -1 for no deadline
+ * @param child_return Receives the status of the child
+ * @return True if the wait finished, false if signalfd is not available
+ */
+static bool wait_for_child_pid_signalfd(pid_t child_pid, long long deadline, int* child_return)
+{
+#ifdef __linux__
+	// Block SIGCHLD so it is queued for the signalfd
+	sigset_t child_signal;
+	sigset_t previous_mask;
+	sigemptyset(&child_signal);
+	sigaddset(&child_signal, SIGCHLD);
+	if (pthread_sigmask(SIG_BLOCK, &child_signal, &previous_mask) != 0)
+	{
+		return false;
+	}
+	int signal_fd = signalfd(-1, &child_signal, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (signal_fd < 0)
+	{
+		pthread_sigmask(SIG_SETMASK, &previous_mask, NULL);
+		return false;
+	}
+
+	// Check the child after each SIGCHLD, as the signal may be for another child
+	*child_return = -1;
+	while (true)
+	{
+		pid_t result = waitpid(child_pid, child_return, WNOHANG);
+		if (result == child_pid || (result < 0 && errno != EINTR))
+		{
+			break;
+		}
+		int ready = poll_until_deadline(signal_fd, deadline);
+		if (ready == 0)
+		{
+			*child_return = kill_timed_out_child(child_pid);
+			break;
+		}
+		if (ready < 0)
+		{
+			*child_return = wait_for_child_pid_sleeping(child_pid, deadline);
+			break;
+		}
+		struct signalfd_siginfo info;
+		while (read(signal_fd, &info, sizeof(info)) > 0)
+		{
+		}
+	}
+
+	// Restore the signal mask
+	close(signal_fd);
+	pthread_sigmask(SIG_SETMASK, &previous_mask, NULL);
+
+	return true;
+#else
+	(void) child_pid;
+	(void) deadline;
+	(void) child_return;
+	return false;
+#endif
+}
+
+int wait_for_child_pid(pid_t child_pid, int timeout_milliseconds)
+{
+	// Use the first mechanism that is available
+	long long deadline = get_deadline(timeout_milliseconds);
+	int child_return;
+	if (wait_for_child_pid_pidfd(child_pid, deadline, &child_return) || wait_for_child_pid_signalfd(child_pid, deadline, &child_return))
+	{
+		return child_return;
+	}
+
+	return wait_for_child_pid_sleeping(child_pid, deadline);
+}
+
+/**
+ * @brief Largest block of arguments or return value passed through the fork server
+ */
+#define FORK_SERVER_MAX_DATA 4096
+
+/**
+ * @brief Number of file descriptors passed with each request: stdin, stdout and stderr
+ */
+#define FORK_SERVER_FD_COUNT 3
+
+/**
+ * @brief Request from the test process to the fork server
+ */
+struct fork_server_request {
+	fork_server_function function; /**< Function to call in the child */
+	enum fork_server_check check; /**< Checks to run on the return value */
+	size_t result_size; /**< Size of the return value */
+	size_t argument_size; /**< Size of the packed arguments */
+	unsigned char arguments[FORK_SERVER_MAX_DATA]; /**< Packed arguments */
+};
+
+/**
+ * @brief Reply from the fork server, sent once the child is forked and again once it has finished
+ */
+struct fork_server_reply {
+	pid_t child_pid; /**< Child running the call, or -1 if it could not be forked */
+	bool finished; /**< False when the child has started, true when it has finished */
+	int status; /**< Status of the finished child from waitpid */
+	size_t result_size; /**< Size of the return value */
+	unsigned char result[FORK_SERVER_MAX_DATA]; /**< Return value */
+};
+
+/**
+ * @brief Socket connected to the fork server, or -1 if it is not running
+ */
+static int fork_server_socket = -1;
+
+/**
+ * @brief Process ID of the fork server
+ */
+static pid_t fork_server_pid = -1;
+
+/**
+ * @brief Process that started the fork server; its children fork for themselves
+ */
+static pid_t fork_server_owner = -1;
+
+/**
+ * @brief Copies the memory a returned pointer refers to, crashing the child if it cannot be read
+ * @param pointer Pointer to copy from
+ * @param size Number of bytes to copy
+ * @return 0 on success, or EXIT_MALLOC_FAILED if memory could not be allocated
+ */
+static int copy_returned_memory(const void* pointer, size_t size)
+{
+	// Copy into a new block, as the CALL_FUNCTION_* macros do
+	void* testPtr = malloc(size > 0 ? size : 1);
+	if (testPtr == NULL)
+	{
+		return EXIT_MALLOC_FAILED;
+	}
+	memcpy(testPtr, pointer, size);
+
+	free(testPtr);
+	testPtr = NULL;
+
+	return 0;
+}
+
+/**
+ * @brief Runs the checks of a CALL_FUNCTION_* macro on a return value
+ * @param check Checks to run
+ * @param result Return value
+ * @return 0 if the return value passed, or an EXIT_* status
+ */
+static int check_fork_server_result(enum fork_server_check check, const unsigned char* result)
+{
+	// Every check other than none is on a returned pointer
+	void* resultPtr;
+	memcpy(&resultPtr, result, sizeof(resultPtr));
+
+	switch (check)
+	{
+		case FORK_SERVER_CHECK_POINTER_NO_VALIDATION:
+			return resultPtr == NULL ? 0 : copy_returned_memory(resultPtr, ctest_get_malloc_size(resultPtr));
+
+		case FORK_SERVER_CHECK_POINTER:
+			if (resultPtr == NULL)
+			{
+				return 0;
+			}
+			if (!is_pointer_null_or_valid(resultPtr))
+			{
+				return EXIT_INVALID_POINTER;
+			}
+			return copy_returned_memory(resultPtr, ctest_get_malloc_size(resultPtr));
+
+		case FORK_SERVER_CHECK_POINTER_NOT_NULL:
+			if (resultPtr == NULL)
+			{
+				return EXIT_UNEXPECTED_NULL;
+			}
+			if (!is_pointer_valid(resultPtr))
+			{
+				return EXIT_INVALID_POINTER;
+			}
+			return copy_returned_memory(resultPtr, ctest_get_malloc_size(resultPtr));
+
+		case FORK_SERVER_CHECK_STRING:
+		case FORK_SERVER_CHECK_WRITEABLE_STRING:
+			if (resultPtr == NULL)
+			{
+				return 0;
+			}
+			if (!is_pointer_valid(resultPtr))
+			{
+				return EXIT_INVALID_POINTER;
+			}
+			if (check == FORK_SERVER_CHECK_WRITEABLE_STRING && is_pointer_read_only(resultPtr))
+			{
+				return EXIT_READ_ONLY_POINTER;
+			}
+			return copy_returned_memory(resultPtr, strlen(resultPtr) + 1);
+
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief Runs one call in a child of the fork server and exits with its status
+ * @param request Call to run
+ * @param fds stdin, stdout and stderr of the test process
+ * @param result_fd Pipe for sending the return value to the fork server
+ */
+static void run_fork_server_child(const struct fork_server_request* request, const int* fds, int result_fd)
+{
+	// Use the standard streams of the test process
+	for (int i = 0; i < FORK_SERVER_FD_COUNT; i++)
+	{
+		dup2(fds[i], i);
+		if (fds[i] >= FORK_SERVER_FD_COUNT)
+		{
+			close(fds[i]);
+		}
+	}
+
+	// Call the function and check its return value
+	unsigned char result[FORK_SERVER_MAX_DATA];
+	memset(result, 0, sizeof(result));
+	int status = request->function(request->arguments, result);
+	if (status == 0)
+	{
+		status = check_fork_server_result(request->check, result);
+	}
+
+	// Send the return value
+	if (status == 0 && request->result_size > 0 && write(result_fd, result, request->result_size) != (ssize_t) request->result_size)
+	{
+		status = EXIT_UNRELATED_FAILURE;
+	}
+	close(result_fd);
+
+	// Wait for any children the function started, passing on the first failure
+	int child_return;
+	pid_t child_pid;
+	while ((child_pid = wait(&child_return)) > 0 || (child_pid < 0 && errno == EINTR))
+	{
+		if (child_pid > 0 && child_return != 0 && status == 0)
+		{
+			status = WIFEXITED(child_return) ? WEXITSTATUS(child_return) : EXIT_FAILURE;
+		}
+	}
+
+	exit(status);
+}
+
+/**
+ * @brief Receives a request and the standard streams sent with it
+ * @param socket_fd Socket to receive from
+ * @param request Receives the request
+ * @param fds Receives stdin, stdout and stderr
+ * @return True on success, false if the test process closed the socket or sent a malformed request
+ */
+static bool receive_fork_server_request(int socket_fd, struct fork_server_request* request, int* fds)
+{
+	// Receive the request with its file descriptors
+	union {
+		char buffer[CMSG_SPACE(sizeof(int) * FORK_SERVER_FD_COUNT)];
+		struct cmsghdr align;
+	} control;
+	struct iovec iov = { request, sizeof(*request) };
+	struct msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &iov;
+	message.msg_iovlen = 1;
+	message.msg_control = control.buffer;
+	message.msg_controllen = sizeof(control.buffer);
+	ssize_t received = TEMP_FAILURE_RETRY(recvmsg(socket_fd, &message, 0));
+	if (received < 0)
+	{
+		return false;
+	}
+
+	// Take the file descriptors
+	struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+	if (header == NULL || header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS || header->cmsg_len != CMSG_LEN(sizeof(int) * FORK_SERVER_FD_COUNT))
+	{
+		return false;
+	}
+	memcpy(fds, CMSG_DATA(header), sizeof(int) * FORK_SERVER_FD_COUNT);
+
+	// Accept only a whole request carrying exactly its arguments, so the function never sees uninitialized bytes
+	size_t header_size = offsetof(struct fork_server_request, arguments);
+	if ((message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0 || (size_t) received < header_size
+		|| request->argument_size > FORK_SERVER_MAX_DATA || request->result_size > FORK_SERVER_MAX_DATA
+		|| (size_t) received != header_size + request->argument_size)
+	{
+		for (int i = 0; i < FORK_SERVER_FD_COUNT; i++)
+		{
+			close(fds[i]);
+		}
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Sends a reply to the test process
+ * @param socket_fd Socket to send on
+ * @param reply Reply to send, of which only result_size bytes of the result are sent
+ */
+static void send_fork_server_reply(int socket_fd, const struct fork_server_reply* reply)
+{
+	TEMP_FAILURE_RETRY(send(socket_fd, reply, offsetof(struct fork_server_reply, result) + reply->result_size, MSG_NOSIGNAL));
+}
+
+/**
+ * @brief Serves requests until the test process closes the socket
+ * @param socket_fd Socket connected to the test process
+ */
+static void run_fork_server(int socket_fd)
+{
+	struct fork_server_request request;
+	struct fork_server_reply reply;
+	int fds[FORK_SERVER_FD_COUNT];
+	while (receive_fork_server_request(socket_fd, &request, fds))
+	{
+		memset(&reply, 0, offsetof(struct fork_server_reply, result));
+
+		// Fork the child with a pipe for its return value
+		int result_pipe[2] = { -1, -1 };
+		pid_t child_pid = -1;
+		if (pipe(result_pipe) == 0)
+		{
+			child_pid = fork();
+			if (child_pid == 0)
+			{
+				close(socket_fd);
+				close(result_pipe[0]);
+				run_fork_server_child(&request, fds, result_pipe[1]);
+			}
+			close(result_pipe[1]);
+		}
+		for (int i = 0; i < FORK_SERVER_FD_COUNT; i++)
+		{
+			close(fds[i]);
+		}
+
+		// Report a failure to fork as a finished call
+		reply.child_pid = child_pid;
+		if (child_pid < 0)
+		{
+			if (result_pipe[0] >= 0)
+			{
+				close(result_pipe[0]);
+			}
+			reply.finished = true;
+			reply.status = W_EXITCODE(EXIT_FORK_FAILED, 0);
+			send_fork_server_reply(socket_fd, &reply);
+			continue;
+		}
+
+		// Tell the test process which child to kill if it takes too long
+		send_fork_server_reply(socket_fd, &reply);
+
+		// Wait for the child, then collect its return value
+		TEMP_FAILURE_RETRY(waitpid(child_pid, &reply.status, 0));
+		if (WIFEXITED(reply.status) && WEXITSTATUS(reply.status) == 0)
+		{
+			ssize_t bytes_read = TEMP_FAILURE_RETRY(read(result_pipe[0], reply.result, request.result_size));
+			reply.result_size = bytes_read > 0 ? (size_t) bytes_read : 0;
+		}
+		close(result_pipe[0]);
+
+		reply.finished = true;
+		send_fork_server_reply(socket_fd, &reply);
+	}
+
+	exit(0);
+}
+
+bool start_fork_server(void)
+{
+	// Nothing to do if already running
+	if (is_fork_server_running())
+	{
+		return true;
+	}
+
+	// Connect to the fork server with a socket that keeps messages whole
+	int sockets[2];
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0)
+	{
+		fprintf(stderr, "Could not create fork server socket: %s.\n", strerror(errno));
+		return false;
+	}
+
+	// Flush output so the fork server does not repeat it
+	fflush(stdout);
+	fflush(stderr);
+
+	// Fork the fork server
+	pid_t owner = getpid();
+	pid_t server_pid = fork();
+	if (server_pid < 0)
+	{
+		fprintf(stderr, "Could not fork fork server: %s.\n", strerror(errno));
+		close(sockets[0]);
+		close(sockets[1]);
 		return false;
 	}
+	if (server_pid == 0)
+	{
+		// Exit with the test process
+		close(sockets[0]);
+		#ifdef __linux__
+			prctl(PR_SET_PDEATHSIG, SIGKILL);
+		#endif
+		if (getppid() != owner)
+		{
+			exit(0);
+		}
 
-	// Configure signal handler	
-	struct sigaction sa;
-	sa.sa_handler = sigsegv_handler;
-	sigemptyset(&sa.sa_mask);
-	sa.sa_flags = 0;
+		run_fork_server(sockets[1]);
+	}
 
-	// Change signal handler, storing old one
-	struct sigaction old_sa;
-	sigaction(SIGSEGV, &sa, &old_sa);
+	// Keep the test process' end of the socket
+	close(sockets[1]);
+	fork_server_socket = sockets[0];
+	fork_server_pid = server_pid;
+	fork_server_owner = owner;
 
-	// Figure out if signal handler fired
-	if (sigsetjmp(jump_buffer, 1) == 0)
+	return true;
+}
+
+void stop_fork_server(void)
+{
+	// Only the process that started the fork server stops it
+	if (!is_fork_server_running())
 	{
-		// Either first try, or signal handler did not fire meaning pointer was valid
+		return;
+	}
 
-		// Try to read from pointer, with volatile keyword keeping optimizers from skipping the read operation
-		volatile char tmp = *(volatile char*)ptr;
+	// Close the socket and reap the fork server
+	close(fork_server_socket);
+	kill(fork_server_pid, SIGKILL);
+	TEMP_FAILURE_RETRY(waitpid(fork_server_pid, NULL, 0));
 
-		// Suppress unused variable warning
-		(void)tmp;
+	fork_server_socket = -1;
+	fork_server_pid = -1;
+	fork_server_owner = -1;
+}
 
-		// Reset signal handler
-		sigaction(SIGSEGV, &old_sa, NULL);
-	
-		// Pointer is valid, assuming that signal handler did not fire
-		return true;
+bool is_fork_server_running(void)
+{
+	return fork_server_socket >= 0 && fork_server_owner == getpid();
+}
+
+/**
+ * @brief Receives a reply from the fork server
+ * @param reply Receives the reply
+ * @return True on success, false if the fork server closed the socket or sent a malformed reply
+ */
+static bool receive_fork_server_reply(struct fork_server_reply* reply)
+{
+	ssize_t received = TEMP_FAILURE_RETRY(recv(fork_server_socket, reply, sizeof(*reply), 0));
+	return received >= (ssize_t) offsetof(struct fork_server_reply, result) && (size_t) received == offsetof(struct fork_server_reply, result) + reply->result_size;
+}
+
+int call_in_fork_server(fork_server_function function, enum fork_server_check check, const void* arguments, size_t argument_size, void* result, size_t result_size, int timeout_milliseconds)
+{
+	// Check that the call fits in a request
+	if (!is_fork_server_running() || argument_size > FORK_SERVER_MAX_DATA || result_size > FORK_SERVER_MAX_DATA)
+	{
+		return W_EXITCODE(EXIT_FORK_FAILED, 0);
 	}
-	else
+
+	// Build the request
+	struct fork_server_request request;
+	request.function = function;
+	request.check = check;
+	request.result_size = result_size;
+	request.argument_size = argument_size;
+	memcpy(request.arguments, arguments, argument_size);
+
+	// Flush output so the child's output follows it
+	fflush(stdout);
+	fflush(stderr);
+
+	// Send the request with stdin, stdout and stderr
+	int fds[FORK_SERVER_FD_COUNT] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+	union {
+		char buffer[CMSG_SPACE(sizeof(fds))];
+		struct cmsghdr align;
+	} control;
+	memset(&control, 0, sizeof(control));
+	struct iovec iov = { &request, offsetof(struct fork_server_request, arguments) + argument_size };
+	struct msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &iov;
+	message.msg_iovlen = 1;
+	message.msg_control = control.buffer;
+	message.msg_controllen = sizeof(control.buffer);
+	struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+	header->cmsg_level = SOL_SOCKET;
+	header->cmsg_type = SCM_RIGHTS;
+	header->cmsg_len = CMSG_LEN(sizeof(fds));
+	memcpy(CMSG_DATA(header), fds, sizeof(fds));
+
+	// Learn which child is running the call
+	struct fork_server_reply reply;
+	if (TEMP_FAILURE_RETRY(sendmsg(fork_server_socket, &message, MSG_NOSIGNAL)) < 0 || !receive_fork_server_reply(&reply))
 	{
-		// Signal handler did fire, so pointer was invalid
+		stop_fork_server();
+		return W_EXITCODE(EXIT_FORK_FAILED, 0);
+	}
 
-		// Reset signal handler
-		sigaction(SIGSEGV, &old_sa, NULL);
+	// Wait for the child to finish, killing it if it takes too long
+	bool timed_out = false;
+	if (!reply.finished)
+	{
+		if (poll_until_deadline(fork_server_socket, get_deadline(timeout_milliseconds)) == 0)
+		{
+			kill(reply.child_pid, SIGKILL);
+			timed_out = true;
+		}
+		if (!receive_fork_server_reply(&reply))
+		{
+			stop_fork_server();
+			return W_EXITCODE(EXIT_FORK_FAILED, 0);
+		}
+	}
 
-		// Pointer is invalid
-		return false;
+	// Hand back the return value
+	if (timed_out)
+	{
+		return W_EXITCODE(EXIT_TIMED_OUT, 0);
+	}
+	if (result != NULL && reply.result_size == result_size)
+	{
+		memcpy(result, reply.result, result_size);
 	}
-}
 
-bool is_pointer_read_only(const void* ptr)
-{
-	// Configure signal handler	
-	struct sigaction sa;
-	sa.sa_handler = sigsegv_handler;
-	sigemptyset(&sa.sa_mask);
-	sa.sa_flags = 0;
+	return reply.status;
+}
 
-	// Change signal handler, storing old one
-	struct sigaction old_sa;
-	sigaction(SIGSEGV, &sa, &old_sa);
+/**
+ * @brief Smallest free space the reader thread of an output capture reads into
+ */
+#define OUTPUT_CAPTURE_READ_SIZE 4096
 
-	// Figure out if signal handler fired
-	if (sigsetjmp(jump_buffer, 1) == 0)
+/**
+ * @brief Drains the pipe of an output capture into its buffer until every writer has closed it
+ * @param argument Output capture
+ * @return NULL
+ */
+static void* read_output_capture_pipe(void* argument)
+{
+	struct output_capture* capture = argument;
+	char discarded[OUTPUT_CAPTURE_READ_SIZE];
+	while (true)
 	{
-		// Signal handler did not fire, so pointer was not read only
+		// Grow the buffer, discarding output if it cannot grow so writers still do not block
+		char* destination = discarded;
+		size_t space = sizeof(discarded);
+		if (capture->error == 0 && capture->capacity - capture->length < OUTPUT_CAPTURE_READ_SIZE)
+		{
+			size_t capacity = capture->capacity == 0 ? OUTPUT_CAPTURE_READ_SIZE : capture->capacity * 2;
+			char* buffer = realloc(capture->buffer, capacity);
+			if (buffer == NULL)
+			{
+				capture->error = ENOMEM;
+			}
+			else
+			{
+				capture->buffer = buffer;
+				capture->capacity = capacity;
+			}
+		}
+		if (capture->error == 0)
+		{
+			destination = capture->buffer + capture->length;
+			space = capture->capacity - capture->length;
+		}
 
-		// Try to write its current value back to the pointer to see if it's read-only, with volatile keyword keeping optimizers from skipping the operation
-		*(volatile char*)ptr = *(volatile char*)ptr;
+		// Read until the end of the output
+		ssize_t bytes_read = TEMP_FAILURE_RETRY(read(capture->read_fd, destination, space));
+		if (bytes_read <= 0)
+		{
+			if (bytes_read < 0 && capture->error == 0)
+			{
+				capture->error = errno;
+			}
+			return NULL;
+		}
+		if (destination != discarded)
+		{
+			capture->length += (size_t) bytes_read;
+		}
+	}
+}
 
-		// Reset signal handler
-		sigaction(SIGSEGV, &old_sa, NULL);
+bool open_output_capture(struct output_capture* capture)
+{
+	memset(capture, 0, sizeof(*capture));
+	capture->fd = -1;
+	capture->read_fd = -1;
+	capture->saved_stdout = -1;
+	capture->saved_stderr = -1;
+
+#ifdef __linux__
+	// Use an anonymous memory file, which is written and read back without a thread
+	capture->fd = memfd_create("ctest_output_capture", MFD_CLOEXEC);
+	if (capture->fd >= 0)
+	{
+		capture->read_fd = capture->fd;
+		return true;
+	}
+#endif
 
-		// Pointer is not read-only
+	// Otherwise use a pipe, drained as it is written
+	int pipe_fds[2];
+	if (pipe2(pipe_fds, O_CLOEXEC) != 0)
+	{
 		return false;
 	}
-	else
+	capture->read_fd = pipe_fds[0];
+	capture->fd = pipe_fds[1];
+	if (pthread_create(&capture->reader, NULL, read_output_capture_pipe, capture) != 0)
 	{
-		// Signal handler did fire, so pointer was read-only
+		close(capture->read_fd);
+		close(capture->fd);
+		capture->read_fd = -1;
+		capture->fd = -1;
+		return false;
+	}
+	capture->has_reader = true;
 
-		// Reset signal handler
-		sigaction(SIGSEGV, &old_sa, NULL);
+	return true;
+}
 
-		// Pointer is read-only
-		return true;
+bool start_output_capture(struct output_capture* capture)
+{
+	if (!open_output_capture(capture))
+	{
+		return false;
+	}
+
+	// Write out anything buffered for the original destinations, then redirect stdout and stderr
+	fflush(stdout);
+	fflush(stderr);
+	capture->saved_stdout = dup(STDOUT_FILENO);
+	capture->saved_stderr = dup(STDERR_FILENO);
+	if (capture->saved_stdout < 0 || capture->saved_stderr < 0 || dup2(capture->fd, STDOUT_FILENO) < 0 || dup2(capture->fd, STDERR_FILENO) < 0)
+	{
+		free(finish_output_capture(capture, NULL));
+		return false;
 	}
+
+	return true;
 }
 
-int robust_nanosleep(const int seconds, const long nanoseconds)
+/**
+ * @brief Reads the whole of a memory file
+ * @param fd Memory file
+ * @param length Receives the number of bytes read
+ * @return New dynamically allocated, null-terminated string of the contents, or NULL if they could not be read
+ */
+static char* read_output_capture_file(int fd, size_t* length)
 {
-	// Configure requested time
-	struct timespec sleep_time = { .tv_sec = seconds, .tv_nsec = nanoseconds };
+	// Allocate memory for the contents
+	struct stat status;
+	if (fstat(fd, &status) != 0)
+	{
+		return NULL;
+	}
+	size_t size = (size_t) status.st_size;
+	char* contents = malloc(size + 1);
+	if (contents == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return NULL;
+	}
 
-	// Structure to hold the remaining time after an interruption.
-	struct timespec remaining_time;
+	// Read from the start, as the file offset is shared with every writer
+	size_t total = 0;
+	while (total < size)
+	{
+		ssize_t bytes_read = TEMP_FAILURE_RETRY(pread(fd, contents + total, size - total, (off_t) total));
+		if (bytes_read <= 0)
+		{
+			break;
+		}
+		total += (size_t) bytes_read;
+	}
+	contents[total] = '\0';
+	*length = total;
 
-	// Track status from calling nanosleep
-	int status;
+	return contents;
+}
 
-	// Call nanosleep in a loop to handle interruptions from signals
-	do
+char* finish_output_capture(struct output_capture* capture, size_t* length)
+{
+	// Restore stdout and stderr, writing out what is buffered for the capture first
+	fflush(stdout);
+	fflush(stderr);
+	if (capture->saved_stdout >= 0)
 	{
-		// Attempt to sleep
-		status = nanosleep(&sleep_time, &remaining_time);
+		dup2(capture->saved_stdout, STDOUT_FILENO);
+		close(capture->saved_stdout);
+		capture->saved_stdout = -1;
+	}
+	if (capture->saved_stderr >= 0)
+	{
+		dup2(capture->saved_stderr, STDERR_FILENO);
+		close(capture->saved_stderr);
+		capture->saved_stderr = -1;
+	}
 
-		// If status is 0, the sleep completed successfully
-		if (status == 0)
+	char* output = NULL;
+	size_t output_length = 0;
+	if (capture->has_reader)
+	{
+		// Close the write end, so the reader finishes once every forked writer has exited
+		close(capture->fd);
+		pthread_join(capture->reader, NULL);
+		close(capture->read_fd);
+		capture->has_reader = false;
+
+		// Hand over the drained output
+		if (capture->error == 0)
 		{
-			return 0;
+			output = realloc(capture->buffer, capture->length + 1);
 		}
-
-		// If status is -1, an error occurred. Check if it was EINTR (signal interruption).
-		if (errno == EINTR)
+		if (output == NULL)
 		{
-			// A signal interrupted the sleep. Restart sleep with time from remaining_time object.
-			sleep_time = remaining_time;
+			free(capture->buffer);
 		}
 		else
 		{
-			// A different, unhandled error occurred
-			return -1;
+			output[capture->length] = '\0';
+			output_length = capture->length;
 		}
 	}
-	while (status == -1 && errno == EINTR); // Continue loop only if interrupted by EINTR
-
-	return 0; // Should be unreachable given loop logic, but added for completeness
-}
+	else if (capture->fd >= 0)
+	{
+		output = read_output_capture_file(capture->fd, &output_length);
+		close(capture->fd);
+	}
+	capture->fd = -1;
+	capture->read_fd = -1;
+	capture->buffer = NULL;
+	capture->length = 0;
+	capture->capacity = 0;
 
-bool is_printable(const char* string)
-{
-	// Check to see if pointer is valid and not NULL
-	if (!is_pointer_valid(string))
+	if (length != NULL)
 	{
-		return false;
+		*length = output_length;
 	}
 
-	// Check if string is empty
-	if (strlen(string) == 0)
+	return output;
+}
+
+/**
+ * @brief Microseconds between the first checks on a child reading scripted input
+ */
+#define SCRIPTED_INPUT_FIRST_CHECK_MICROSECONDS 50
+
+/**
+ * @brief Longest interval in microseconds between checks on a child reading scripted input
+ */
+#define SCRIPTED_INPUT_MAX_CHECK_MICROSECONDS 10000
+
+/**
+ * @brief Consecutive checks that must find a child waiting for input before it is ended
+ */
+#define SCRIPTED_INPUT_WAITING_CHECKS 2
+
+bool open_scripted_input(struct scripted_input* input, const char* script)
+{
+	int pipe_fds[2];
+	if (pipe2(pipe_fds, O_CLOEXEC | O_NONBLOCK) != 0)
 	{
+		input->read_fd = -1;
+		input->write_fd = -1;
 		return false;
 	}
+	input->read_fd = pipe_fds[0];
+	input->write_fd = pipe_fds[1];
 
-	// Loop to look for non-printable characters
-	for (size_t i = 0; i < strlen(string); i++)
+	// Write the whole script now, as nothing drains the pipe before the child runs
+	size_t length = strlen(script);
+	size_t total = 0;
+	while (total < length)
 	{
-		// Check if character is not printable
-		if (!isprint(string[i]))
+		ssize_t bytes_written = TEMP_FAILURE_RETRY(write(input->write_fd, script + total, length - total));
+		if (bytes_written <= 0)
 		{
+			close_scripted_input(input);
 			return false;
 		}
+		total += (size_t) bytes_written;
 	}
 
+	// Let the child block on reads once the script is used up
+	fcntl(input->read_fd, F_SETFL, fcntl(input->read_fd, F_GETFL) & ~O_NONBLOCK);
+
 	return true;
 }
 
-char* fix_string_null_termination(const char* string)
+void close_scripted_input(struct scripted_input* input)
 {
-	// Return NULL if string is NULL or not valid
-	if (!is_pointer_valid(string))
+	if (input->read_fd >= 0)
 	{
-		return NULL;
+		close(input->read_fd);
+		input->read_fd = -1;
+	}
+	if (input->write_fd >= 0)
+	{
+		close(input->write_fd);
+		input->write_fd = -1;
 	}
+}
 
-	// Malloc new string
-	char* fixedPtr = malloc(strlen(string) + 1);
-	if (fixedPtr == NULL)
+/**
+ * @brief Reads a small file from /proc for a child
+ * @param child_pid Child the file describes
+ * @param name Name of the file
+ * @param contents Buffer receiving the null-terminated contents
+ * @param size Size of the buffer
+ * @return True if anything was read, false otherwise
+ */
+static bool read_child_proc_file(pid_t child_pid, const char* name, char* contents, size_t size)
+{
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%d/%s", (int) child_pid, name);
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
 	{
-		return NULL;
+		return false;
+	}
+	ssize_t bytes_read = TEMP_FAILURE_RETRY(read(fd, contents, size - 1));
+	close(fd);
+	if (bytes_read <= 0)
+	{
+		return false;
 	}
+	contents[bytes_read] = '\0';
 
-	// Initialize to null
-	memset(fixedPtr, 0, strlen(string) + 1);
+	return true;
+}
 
-	// Copy string
-	strncpy(fixedPtr, string, strlen(string));
+/**
+ * @brief Determines if a child is blocked reading stdin with nothing left in the pipe of its scripted input
+ * @param child_pid Child to check
+ * @param input Scripted input of the child
+ * @return True if the child is blocked for good, false if it may still make progress
+ */
+static bool is_child_waiting_for_input(pid_t child_pid, const struct scripted_input* input)
+{
+	// The child can continue while any of the script is left
+	int unread = 0;
+	if (ioctl(input->read_fd, FIONREAD, &unread) != 0 || unread > 0)
+	{
+		return false;
+	}
 
-	// Get position of last character, using signed type to avoid looping around
-	int position = (int) strlen(fixedPtr) - 1;
+	// A child that has just read the last of the script may still be in the read, so require it to be asleep
+	char contents[256];
+	const char* state = read_child_proc_file(child_pid, "stat", contents, sizeof(contents)) ? strrchr(contents, ')') : NULL;
+	if (state == NULL || state[1] != ' ' || state[2] != 'S')
+	{
+		return false;
+	}
 
-	// Loop from end of string, moving left
-	while (position >= 0 && !isprint(fixedPtr[position]))
+	// Check for a read of stdin, shown as the system call number and its arguments, or "running"
+	if (read_child_proc_file(child_pid, "syscall", contents, sizeof(contents)))
 	{
-		fixedPtr[position] = '\0';
-		position--;
+		long number;
+		unsigned long long fd;
+		return sscanf(contents, "%ld %llx", &number, &fd) == 2 && number == SYS_read && fd == STDIN_FILENO;
 	}
 
-	return fixedPtr;
+	// Otherwise check that it is sleeping in a read of a pipe, taken to be its stdin, in pipe_read or anon_pipe_read
+	return read_child_proc_file(child_pid, "wchan", contents, sizeof(contents)) && strstr(contents, "pipe_read") != NULL;
+}
+
+int wait_for_child_pid_reading_input(pid_t child_pid, const struct scripted_input* input, int timeout_milliseconds)
+{
+	long long deadline = get_deadline(timeout_milliseconds);
+	int pid_fd = -1;
+#ifdef SYS_pidfd_open
+	pid_fd = (int) syscall(SYS_pidfd_open, child_pid, 0);
+#endif
+
+	// Check on the child at growing intervals, as blocking on a read raises no event to wait for
+	long interval = SCRIPTED_INPUT_FIRST_CHECK_MICROSECONDS;
+	int child_return = -1;
+	int waiting_checks = 0;
+	while (true)
+	{
+		pid_t result = waitpid(child_pid, &child_return, WNOHANG);
+		if (result == child_pid || (result < 0 && errno != EINTR))
+		{
+			break;
+		}
+
+		// Only end a child found waiting on consecutive checks, as one check can catch it finishing a read
+		waiting_checks = is_child_waiting_for_input(child_pid, input) ? waiting_checks + 1 : 0;
+		if (waiting_checks >= SCRIPTED_INPUT_WAITING_CHECKS)
+		{
+			// Report the wait unless the child exited on its own in the meantime
+			kill(child_pid, SIGKILL);
+			TEMP_FAILURE_RETRY(waitpid(child_pid, &child_return, 0));
+			if (WIFSIGNALED(child_return) && WTERMSIG(child_return) == SIGKILL)
+			{
+				child_return = W_EXITCODE(EXIT_WAITING_FOR_INPUT, 0);
+			}
+			break;
+		}
+		if (deadline >= 0 && get_monotonic_milliseconds() >= deadline)
+		{
+			child_return = kill_timed_out_child(child_pid);
+			break;
+		}
+
+		// Sleep until the child exits or it is time to check again
+		if (pid_fd >= 0)
+		{
+			struct pollfd poll_fd = { pid_fd, POLLIN, 0 };
+			struct timespec timeout = { 0, interval * 1000 };
+			ppoll(&poll_fd, 1, &timeout, NULL);
+		}
+		else
+		{
+			usleep((useconds_t) interval);
+		}
+		interval = interval * 2 > SCRIPTED_INPUT_MAX_CHECK_MICROSECONDS ? SCRIPTED_INPUT_MAX_CHECK_MICROSECONDS : interval * 2;
+	}
+
+	if (pid_fd >= 0)
+	{
+		close(pid_fd);
+	}
+
+	return child_return;
 }
 
 // NOLINTEND
\ No newline at end of file
@@ -2,7 +2,7 @@
  * @file ctest.h
  * @brief Header file for WVU CTest testing framework
  * @author Brian Powell
- * @version 1.23
+ * @version 1.24
  *
  * Place this file in the same directory as your own source code and add it to your project.
  *
@@ -38,6 +38,7 @@
 #include <stdio.h>
 #include "unity.h"
 #include <signal.h>
+#include <pthread.h>
 
  // Define constants
 #define EXIT_TEST_FAILED 99
@@ -50,13 +51,26 @@
 #define EXIT_UNEXPECTED_NULL 92
 #define EXIT_INVALID_POINTER 91
 #define EXIT_READ_ONLY_POINTER 90
+#define EXIT_TIMED_OUT 89
+#define EXIT_WAITING_FOR_INPUT 88
 
 // Define timeout for waiting for forked processes when testing functions
 #ifndef TIMEOUT_SECONDS
     #define TIMEOUT_SECONDS 2
 #endif
 
-// Define number of microseconds to sleep when waiting for forked processes
+// Define timeout in milliseconds for waiting for forked processes, which takes precedence over TIMEOUT_SECONDS
+#ifndef TIMEOUT_MILLISECONDS
+    #define TIMEOUT_MILLISECONDS (TIMEOUT_SECONDS * 1000)
+#endif
+
+// Define timeout in milliseconds for forked processes reading scripted input, which are killed sooner if they block
+// reading more input than the script holds
+#ifndef INPUT_TIMEOUT_MILLISECONDS
+    #define INPUT_TIMEOUT_MILLISECONDS 1000
+#endif
+
+// Define number of microseconds to sleep when waiting for forked processes on systems without pidfd_open or signalfd
 #ifndef SLEEP_MICROSECONDS
     #define SLEEP_MICROSECONDS 5 // Default: 5
 #endif
@@ -66,6 +80,36 @@
     #define WAIT_FOR_FORKED_PROCESS_WITHOUT_LOOPING 0 // False
 #endif
 
+// Define size and number of the shared memory slots CALL_FUNCTION_*_WITH_RETURN children return values in
+#ifndef RESULT_SLOT_SIZE
+    #define RESULT_SLOT_SIZE 256
+#endif
+#ifndef RESULT_SLOT_COUNT
+    #define RESULT_SLOT_COUNT 64
+#endif
+
+// Define how the overridden allocation functions poison new memory, an enum malloc_poisoning, changeable at run time
+// with set_malloc_poisoning
+#ifndef MALLOC_POISONING
+    #define MALLOC_POISONING MALLOC_POISON_FULL // Default: MALLOC_POISON_FULL, as earlier versions did
+#endif
+
+// Define number of bytes poisoned at the start of each allocation with MALLOC_POISON_PREFIX
+#ifndef MALLOC_POISON_PREFIX_BYTES
+    #define MALLOC_POISON_PREFIX_BYTES 64
+#endif
+
+// Define number of slots in the table of live allocations, a power of 2; allocations beyond it are not tracked
+#ifndef ALLOCATION_TABLE_SIZE
+    #define ALLOCATION_TABLE_SIZE 65536
+#endif
+
+// Define whether CALL_FUNCTION_* macros fork from a pre-forked fork server once it is started - 0: False, 1: True
+// Every function called this way must be declared with FORK_SERVER_FUNCTION or FORK_SERVER_VOID_FUNCTION
+#ifndef USE_FORK_SERVER
+    #define USE_FORK_SERVER 0 // False
+#endif
+
 /*
  * Settings for text matching
 */
@@ -79,6 +123,76 @@ enum text_matching {
 	IGNORE_PUNCTUATION = 64
 };
 
+/*
+ * Poisoning of memory returned by the overridden malloc, realloc, reallocarray, posix_memalign, aligned_alloc, memalign
+ * and valloc; calloc always returns zeros, and the aligned allocators never return guarded memory
+*/
+enum malloc_poisoning {
+	MALLOC_POISON_NONE, // Leave memory as the allocator returned it
+	MALLOC_POISON_PREFIX, // Set the first MALLOC_POISON_PREFIX_BYTES bytes to 0xFF
+	MALLOC_POISON_FULL, // Set every byte to 0xFF
+	MALLOC_POISON_GUARD_PAGE // Set every byte to 0xFF and end the memory at an inaccessible page, so overruns crash
+};
+
+/*
+ * Allocations counted by the overridden allocation functions since begin_allocation_tracking
+*/
+struct allocation_statistics {
+	size_t allocations; // Blocks returned by malloc, calloc, realloc, reallocarray, posix_memalign, aligned_alloc, memalign and valloc
+	size_t frees; // Blocks released by free or realloc
+	size_t live_bytes; // Bytes allocated and not yet freed by the whole process
+	size_t peak_bytes; // Highest value of live_bytes
+	size_t leaked_allocations; // Blocks allocated and not yet freed
+	size_t leaked_bytes; // Bytes of the blocks allocated and not yet freed
+	size_t untracked_allocations; // Blocks not counted because the table of live allocations was full
+};
+
+/*
+ * Checks run on a return value in the child forked by the fork server, matching the CALL_FUNCTION_* macros
+*/
+enum fork_server_check {
+	FORK_SERVER_CHECK_NONE,
+	FORK_SERVER_CHECK_POINTER_NO_VALIDATION,
+	FORK_SERVER_CHECK_POINTER,
+	FORK_SERVER_CHECK_POINTER_NOT_NULL,
+	FORK_SERVER_CHECK_STRING,
+	FORK_SERVER_CHECK_WRITEABLE_STRING
+};
+
+/**
+ * @brief Function run in a child forked by the fork server, declared by FORK_SERVER_FUNCTION
+ * @param arguments Packed arguments of the call
+ * @param result Buffer receiving the return value
+ * @return 0 on success, or an EXIT_* status for the child
+ */
+typedef int (*fork_server_function)(const void* arguments, void* result);
+
+/*
+ * Output captured in memory, in a memory file or in a pipe drained by a reader thread, by open_output_capture or
+ * start_output_capture; keep it at the same address until finish_output_capture, as the reader thread writes to it
+*/
+struct output_capture {
+	int fd; // Descriptor output is written to: a memory file, or the write end of a pipe
+	int read_fd; // Descriptor output is read back from: the same memory file, or the read end of the pipe
+	int saved_stdout; // Copy of stdout while it is redirected to fd, otherwise -1
+	int saved_stderr; // Copy of stderr while it is redirected to fd, otherwise -1
+	bool has_reader; // Whether reader is draining the pipe
+	pthread_t reader; // Thread draining the pipe into buffer, so writers never block on a full pipe
+	char* buffer; // Output drained from the pipe
+	size_t length; // Bytes of output in buffer
+	size_t capacity; // Bytes allocated for buffer
+	int error; // errno of a failed read or allocation in the reader thread, otherwise 0
+};
+
+/*
+ * Scripted input for a child's stdin, a pipe holding the whole script whose write end stays open, so a child that reads
+ * past the script blocks instead of seeing the end of the input
+*/
+struct scripted_input {
+	int read_fd; // Read end of the pipe, for the child to dup2 over its stdin
+	int write_fd; // Write end of the pipe, held open until close_scripted_input
+};
+
 // Define macros
 /**
  * @brief Macro for calling function that returns a double in a forked process
@@ -106,6 +220,7 @@ enum text_matching {
 #define CALL_FUNCTION_PRIMITIVE(function_name, type_name, args...) \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
+    FORK_SERVER_BRANCH(function_name, FORK_SERVER_CHECK_NONE, args); \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
     { \
@@ -139,7 +254,9 @@ do { \
 type_name return_value_##function_name; \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
-    key_t shm_key = (key_t) rand(); \
+    FORK_SERVER_BRANCH_WITH_RETURN(function_name, type_name, args); \
+    type_name* sharedPtr = (type_name*) get_result_slot(sizeof(type_name)); \
+    TEST_ASSERT_NOT_NULL_MESSAGE(sharedPtr, "Shared memory could not be created."); \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
     { \
@@ -147,16 +264,6 @@ do { \
     } \
     if (child_pid == 0) \
     { \
-        int shm_id = shmget(shm_key, sizeof(type_name), IPC_CREAT | 0666); \
-		if (shm_id == -1) \
-		{ \
-			exit(EXIT_SHM_FAILED); \
-		} \
-		type_name* sharedPtr = (type_name*) shmat(shm_id, NULL, 0); \
-		if (sharedPtr == (void*) -1) \
-		{ \
-            exit(EXIT_SHM_FAILED); \
-        } \
         type_name result = (type_name) function_name(args); \
         if (not_implemented_##function_name) \
         { \
@@ -164,7 +271,6 @@ do { \
         } \
         \
         memcpy(sharedPtr, &result, sizeof(type_name)); \
-        shmdt(sharedPtr); \
         \
         WAIT_FOR_CHILDREN(function_name); \
         \
@@ -172,27 +278,19 @@ do { \
     } \
     else \
     { \
-        int shm_id = shmget(shm_key, sizeof(type_name), IPC_CREAT | 0666); \
-        TEST_ASSERT_NOT_EQUAL_MESSAGE(shm_id, -1, "Shared memory could not be created."); \
-        \
-		type_name* sharedPtr = (type_name*) shmat(shm_id, NULL, 0); \
-        TEST_ASSERT_NOT_EQUAL_MESSAGE(sharedPtr, (void*) -1, "Shared memory could not be attached."); \
-        \
         WAIT_FOR_CHILD_PID(child_pid, function_name); \
         \
 		memcpy(&return_value_##function_name, sharedPtr, sizeof(type_name)); \
-        \
-		shmdt(sharedPtr); \
-		shmctl(shm_id, IPC_RMID, NULL); \
     } \
 } while(0)
 
-    /**
-     * @brief Macro for calling function that returns a pointer in a forked process, without any validation of the pointer
-     */
+/**
+ * @brief Macro for calling function that returns a pointer in a forked process, without any validation of the pointer
+ */
 #define CALL_FUNCTION_POINTER_NO_VALIDATION(function_name, args...) \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
+    FORK_SERVER_BRANCH(function_name, FORK_SERVER_CHECK_POINTER_NO_VALIDATION, args); \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
     { \
@@ -238,6 +336,7 @@ do { \
 #define CALL_FUNCTION_POINTER(function_name, args...) \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
+    FORK_SERVER_BRANCH(function_name, FORK_SERVER_CHECK_POINTER, args); \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
     { \
@@ -287,6 +386,7 @@ do { \
 #define CALL_FUNCTION_POINTER_NOT_NULL(function_name, args...) \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
+    FORK_SERVER_BRANCH(function_name, FORK_SERVER_CHECK_POINTER_NOT_NULL, args); \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
     { \
@@ -338,7 +438,8 @@ do { \
 void* return_value_##function_name = NULL; \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
-    key_t shm_key = (key_t) rand(); \
+    void** sharedPtr = (void**) get_result_slot(sizeof(void*)); \
+    TEST_ASSERT_NOT_NULL_MESSAGE(sharedPtr, "Shared memory could not be created."); \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
     { \
@@ -346,16 +447,6 @@ do { \
     } \
     if (child_pid == 0) \
     { \
-        int shm_id = shmget(shm_key, sizeof(void*), IPC_CREAT | 0666); \
-		if (shm_id == -1) \
-		{ \
-			exit(EXIT_SHM_FAILED); \
-		} \
-		type_name* sharedPtr = (type_name*) shmat(shm_id, NULL, 0); \
-		if (sharedPtr == (void*) -1) \
-		{ \
-            exit(EXIT_SHM_FAILED); \
-        } \
         void* result = (void*) function_name(args); \
         if (not_implemented_##function_name) \
         { \
@@ -363,7 +454,6 @@ do { \
         } \
         \
         memcpy(sharedPtr, &result, sizeof(void*)); \
-        shmdt(sharedPtr); \
         \
         WAIT_FOR_CHILDREN(function_name); \
         \
@@ -371,18 +461,9 @@ do { \
     } \
     else \
     { \
-        int shm_id = shmget(shm_key, sizeof(void*), IPC_CREAT | 0666); \
-        TEST_ASSERT_NOT_EQUAL_MESSAGE(shm_id, -1, "Shared memory could not be created."); \
-        \
-		void* sharedPtr = (void*) shmat(shm_id, NULL, 0); \
-        TEST_ASSERT_NOT_EQUAL_MESSAGE(sharedPtr, (void*) -1, "Shared memory could not be attached."); \
-        \
         WAIT_FOR_CHILD_PID(child_pid, function_name); \
 		\
 		memcpy(&return_value_##function_name, sharedPtr, sizeof(void*)); \
-        \
-		shmdt(sharedPtr); \
-		shmctl(shm_id, IPC_RMID, NULL); \
     } \
 } while(0)
 
@@ -392,6 +473,7 @@ do { \
 #define CALL_FUNCTION_STRING(function_name, args...) \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
+    FORK_SERVER_BRANCH(function_name, FORK_SERVER_CHECK_STRING, args); \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
     { \
@@ -445,6 +527,7 @@ do { \
 #define CALL_FUNCTION_WRITEABLE_STRING(function_name, args...) \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
+    FORK_SERVER_BRANCH(function_name, FORK_SERVER_CHECK_WRITEABLE_STRING, args); \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
     { \
@@ -504,7 +587,8 @@ do { \
 char* return_value_##function_name = NULL; \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
-    key_t shm_key = (key_t) rand(); \
+    char* sharedPtr = (char*) get_result_slot(string_size); \
+    TEST_ASSERT_NOT_NULL_MESSAGE(sharedPtr, "Shared memory could not be created."); \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
     { \
@@ -512,23 +596,13 @@ do { \
     } \
     if (child_pid == 0) \
     { \
-        int shm_id = shmget(shm_key, sizeof(string_size), IPC_CREAT | 0666); \
-		if (shm_id == -1) \
-		{ \
-			exit(EXIT_SHM_FAILED); \
-		} \
-		char* sharedPtr = (char*) shmat(shm_id, NULL, 0); \
-		if (sharedPtr == (void*) -1) \
-		{ \
-            exit(EXIT_SHM_FAILED); \
-        } \
         char* result = (char*) function_name(args); \
         if (not_implemented_##function_name) \
         { \
             exit(EXIT_NOT_IMPLEMENTED); \
         } \
         \
-        if (!is_pointer_valid(resultPtr)) \
+        if (!is_pointer_valid(result)) \
         { \
             exit(EXIT_INVALID_POINTER); \
         } \
@@ -538,28 +612,18 @@ do { \
         free(result); \
         result = NULL; \
 		\
-        shmdt(sharedPtr); \
-        \
         WAIT_FOR_CHILDREN(function_name); \
         \
         exit(0); \
     } \
     else \
     { \
-        int shm_id = shmget(shm_key, sizeof(void*), IPC_CREAT | 0666); \
-        TEST_ASSERT_NOT_EQUAL_MESSAGE(shm_id, -1, "Shared memory could not be created."); \
-		\
-		char* sharedPtr = (char*) shmat(shm_id, NULL, 0); \
-        TEST_ASSERT_NOT_EQUAL_MESSAGE(sharedPtr, (void*) -1, "Shared memory could not be attached."); \
-		\
         WAIT_FOR_CHILD_PID(child_pid, function_name); \
 		\
         return_value_##function_name = malloc(string_size); \
         TEST_ASSERT_NOT_NULL_MESSAGE(return_value_##function_name, "Memory could not be allocated for return value."); \
-		strncpy(return_value_##function_name, sharedPtr, string_size); \
-		\
-		shmdt(sharedPtr); \
-		shmctl(shm_id, IPC_RMID, NULL); \
+		memcpy(return_value_##function_name, sharedPtr, string_size); \
+		return_value_##function_name[(string_size) - 1] = '\0'; \
     } \
 } while(0)
 
@@ -570,7 +634,8 @@ do { \
 char* return_value_##function_name = NULL; \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
-    key_t shm_key = (key_t) rand(); \
+    char* sharedPtr = (char*) get_result_slot(string_size); \
+    TEST_ASSERT_NOT_NULL_MESSAGE(sharedPtr, "Shared memory could not be created."); \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
     { \
@@ -578,27 +643,17 @@ do { \
     } \
     if (child_pid == 0) \
     { \
-        int shm_id = shmget(shm_key, sizeof(string_size), IPC_CREAT | 0666); \
-		if (shm_id == -1) \
-		{ \
-			exit(EXIT_SHM_FAILED); \
-		} \
-		char* sharedPtr = (char*) shmat(shm_id, NULL, 0); \
-		if (sharedPtr == (void*) -1) \
-		{ \
-            exit(EXIT_SHM_FAILED); \
-        } \
         char* result = (char*) function_name(args); \
         if (not_implemented_##function_name) \
         { \
             exit(EXIT_NOT_IMPLEMENTED); \
         } \
         \
-        if (!is_pointer_valid(resultPtr)) \
+        if (!is_pointer_valid(result)) \
         { \
             exit(EXIT_INVALID_POINTER); \
         } \
-        if (is_pointer_read_only(resultPtr)) \
+        if (is_pointer_read_only(result)) \
         { \
             exit(EXIT_READ_ONLY_POINTER); \
         } \
@@ -608,28 +663,18 @@ do { \
         free(result); \
         result = NULL; \
 		\
-        shmdt(sharedPtr); \
-        \
         WAIT_FOR_CHILDREN(function_name); \
         \
         exit(0); \
     } \
     else \
     { \
-        int shm_id = shmget(shm_key, sizeof(void*), IPC_CREAT | 0666); \
-        TEST_ASSERT_NOT_EQUAL_MESSAGE(shm_id, -1, "Shared memory could not be created."); \
-		\
-		char* sharedPtr = (char*) shmat(shm_id, NULL, 0); \
-        TEST_ASSERT_NOT_EQUAL_MESSAGE(sharedPtr, (void*) -1, "Shared memory could not be attached."); \
-		\
         WAIT_FOR_CHILD_PID(child_pid, function_name); \
 		\
         return_value_##function_name = malloc(string_size); \
         TEST_ASSERT_NOT_NULL_MESSAGE(return_value_##function_name, "Memory could not be allocated for return value."); \
-		strncpy(return_value_##function_name, sharedPtr, string_size); \
-		\
-		shmdt(sharedPtr); \
-		shmctl(shm_id, IPC_RMID, NULL); \
+		memcpy(return_value_##function_name, sharedPtr, string_size); \
+		return_value_##function_name[(string_size) - 1] = '\0'; \
     } \
 } while(0)
 
@@ -659,6 +704,7 @@ do { \
 #define CALL_FUNCTION_VOID(function_name, args...) \
 do { \
     TEST_ASSERT_FALSE_MESSAGE(not_implemented_##function_name, "The " #function_name " function has not been implemented."); \
+    FORK_SERVER_BRANCH_VOID(function_name, args); \
     \
     pid_t child_pid = fork(); \
     if (child_pid < 0) \
@@ -686,38 +732,153 @@ do { \
 } while(0)
 
 /**
- * @brief Macro for waiting for a child process to terminate
+ * @brief Macro for counting the parameter types given to FORK_SERVER_FUNCTION, up to 8
  */
-#define WAIT_FOR_CHILD_PID(child_pid, function_name) \
-time_t start_time = time(NULL); \
-int child_return = -1; \
-\
-do \
+#define FORK_SERVER_ARGUMENT_COUNT(types...) FORK_SERVER_ARGUMENT_COUNT_(_, ##types, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define FORK_SERVER_ARGUMENT_COUNT_(_, _1, _2, _3, _4, _5, _6, _7, _8, count, ...) count
+
+/**
+ * @brief Macro for selecting the variant of a helper macro for a number of parameters
+ */
+#define FORK_SERVER_SELECT(prefix, count) FORK_SERVER_SELECT_(prefix, count)
+#define FORK_SERVER_SELECT_(prefix, count) prefix##count
+
+/**
+ * @brief Macro for declaring one structure member per parameter type
+ */
+#define FORK_SERVER_FIELDS(types...) FORK_SERVER_SELECT(FORK_SERVER_FIELDS_, FORK_SERVER_ARGUMENT_COUNT(types))(types)
+#define FORK_SERVER_FIELDS_0()
+#define FORK_SERVER_FIELDS_1(t1) t1 argument_1;
+#define FORK_SERVER_FIELDS_2(t1, t2) FORK_SERVER_FIELDS_1(t1) t2 argument_2;
+#define FORK_SERVER_FIELDS_3(t1, t2, t3) FORK_SERVER_FIELDS_2(t1, t2) t3 argument_3;
+#define FORK_SERVER_FIELDS_4(t1, t2, t3, t4) FORK_SERVER_FIELDS_3(t1, t2, t3) t4 argument_4;
+#define FORK_SERVER_FIELDS_5(t1, t2, t3, t4, t5) FORK_SERVER_FIELDS_4(t1, t2, t3, t4) t5 argument_5;
+#define FORK_SERVER_FIELDS_6(t1, t2, t3, t4, t5, t6) FORK_SERVER_FIELDS_5(t1, t2, t3, t4, t5) t6 argument_6;
+#define FORK_SERVER_FIELDS_7(t1, t2, t3, t4, t5, t6, t7) FORK_SERVER_FIELDS_6(t1, t2, t3, t4, t5, t6) t7 argument_7;
+#define FORK_SERVER_FIELDS_8(t1, t2, t3, t4, t5, t6, t7, t8) FORK_SERVER_FIELDS_7(t1, t2, t3, t4, t5, t6, t7) t8 argument_8;
+
+/**
+ * @brief Macro for passing the members of a packed argument structure to a function
+ */
+#define FORK_SERVER_UNPACK(arguments, types...) FORK_SERVER_SELECT(FORK_SERVER_UNPACK_, FORK_SERVER_ARGUMENT_COUNT(types))(arguments)
+#define FORK_SERVER_UNPACK_0(arguments)
+#define FORK_SERVER_UNPACK_1(arguments) (arguments)->argument_1
+#define FORK_SERVER_UNPACK_2(arguments) FORK_SERVER_UNPACK_1(arguments), (arguments)->argument_2
+#define FORK_SERVER_UNPACK_3(arguments) FORK_SERVER_UNPACK_2(arguments), (arguments)->argument_3
+#define FORK_SERVER_UNPACK_4(arguments) FORK_SERVER_UNPACK_3(arguments), (arguments)->argument_4
+#define FORK_SERVER_UNPACK_5(arguments) FORK_SERVER_UNPACK_4(arguments), (arguments)->argument_5
+#define FORK_SERVER_UNPACK_6(arguments) FORK_SERVER_UNPACK_5(arguments), (arguments)->argument_6
+#define FORK_SERVER_UNPACK_7(arguments) FORK_SERVER_UNPACK_6(arguments), (arguments)->argument_7
+#define FORK_SERVER_UNPACK_8(arguments) FORK_SERVER_UNPACK_7(arguments), (arguments)->argument_8
+
+/**
+ * @brief Macro for declaring a function returning a value that CALL_FUNCTION_* macros may call through the fork server
+ *
+ * Use at file scope after not_implemented_<function_name> is declared. Arguments are copied into the child by value,
+ * so pointer arguments must point to memory that already existed when the fork server was started.
+ */
+#define FORK_SERVER_FUNCTION(function_name, return_type, parameter_types...) \
+struct fork_server_arguments_##function_name { FORK_SERVER_FIELDS(parameter_types) }; \
+typedef return_type fork_server_return_##function_name; \
+static int fork_server_call_##function_name(const void* arguments, void* result) \
 { \
-    pid_t result; \
-    if (WAIT_FOR_FORKED_PROCESS_WITHOUT_LOOPING == 0) \
+    const struct fork_server_arguments_##function_name* unpacked = arguments; \
+    (void) unpacked; \
+    if (!TEST_PROTECT()) \
     { \
-        while (true) \
-        { \
-            result = waitpid(child_pid, &child_return, WNOHANG); \
-			if (result == child_pid) \
-			{ \
-				break; \
-			} \
-			if (time(NULL) - start_time > TIMEOUT_SECONDS) \
-			{ \
-				kill(child_pid, SIGKILL); \
-				TEST_FAIL_MESSAGE("The " #function_name " function took too long to execute."); \
-			} \
-                usleep(SLEEP_MICROSECONDS); \
-		} \
+        return EXIT_TEST_FAILED; \
     } \
-    else \
+    return_type value = function_name(FORK_SERVER_UNPACK(unpacked, parameter_types)); \
+    memcpy(result, &value, sizeof(return_type)); \
+    return not_implemented_##function_name ? EXIT_NOT_IMPLEMENTED : 0; \
+}
+
+/**
+ * @brief Macro for declaring a function returning nothing that CALL_FUNCTION_VOID may call through the fork server
+ */
+#define FORK_SERVER_VOID_FUNCTION(function_name, parameter_types...) \
+struct fork_server_arguments_##function_name { FORK_SERVER_FIELDS(parameter_types) }; \
+static int fork_server_call_##function_name(const void* arguments, void* result) \
+{ \
+    const struct fork_server_arguments_##function_name* unpacked = arguments; \
+    (void) unpacked; \
+    (void) result; \
+    if (!TEST_PROTECT()) \
     { \
-		result = waitpid(child_pid, &child_return, 0); \
+        return EXIT_TEST_FAILED; \
     } \
-} while (!WIFEXITED(child_return) && (errno == EINTR)); \
-if (WEXITSTATUS(child_return) == EXIT_TEST_FAILED) \
+    function_name(FORK_SERVER_UNPACK(unpacked, parameter_types)); \
+    return not_implemented_##function_name ? EXIT_NOT_IMPLEMENTED : 0; \
+}
+
+/**
+ * @brief Macro for calling a function in a child forked by the fork server and checking how the child finished
+ */
+#define CALL_FUNCTION_IN_FORK_SERVER(function_name, check, result, result_size, args...) \
+do { \
+    struct fork_server_arguments_##function_name fork_server_arguments = { args }; \
+    int child_return = call_in_fork_server(fork_server_call_##function_name, check, &fork_server_arguments, sizeof(fork_server_arguments), result, result_size, TIMEOUT_MILLISECONDS); \
+    CHECK_CHILD_RETURN(child_return, function_name); \
+} while(0)
+
+#if USE_FORK_SERVER
+/**
+ * @brief Macro for leaving a CALL_FUNCTION_* macro after calling the function through the fork server, if it is running
+ */
+#define FORK_SERVER_BRANCH(function_name, check, args...) \
+    if (is_fork_server_running()) \
+    { \
+        CALL_FUNCTION_IN_FORK_SERVER(function_name, check, NULL, sizeof(fork_server_return_##function_name), args); \
+        break; \
+    }
+
+/**
+ * @brief Macro for leaving CALL_FUNCTION_VOID after calling the function through the fork server, if it is running
+ */
+#define FORK_SERVER_BRANCH_VOID(function_name, args...) \
+    if (is_fork_server_running()) \
+    { \
+        CALL_FUNCTION_IN_FORK_SERVER(function_name, FORK_SERVER_CHECK_NONE, NULL, 0, args); \
+        break; \
+    }
+
+/**
+ * @brief Macro for leaving a CALL_FUNCTION_*_WITH_RETURN macro after calling the function through the fork server, if it is running
+ */
+#define FORK_SERVER_BRANCH_WITH_RETURN(function_name, type_name, args...) \
+    if (is_fork_server_running()) \
+    { \
+        fork_server_return_##function_name fork_server_result; \
+        CALL_FUNCTION_IN_FORK_SERVER(function_name, FORK_SERVER_CHECK_NONE, &fork_server_result, sizeof(fork_server_result), args); \
+        return_value_##function_name = (type_name) fork_server_result; \
+        break; \
+    }
+#else
+#define FORK_SERVER_BRANCH(function_name, check, args...)
+#define FORK_SERVER_BRANCH_VOID(function_name, args...)
+#define FORK_SERVER_BRANCH_WITH_RETURN(function_name, type_name, args...)
+#endif
+
+/**
+ * @brief Macro for waiting for a child process to terminate, killing it after TIMEOUT_MILLISECONDS
+ */
+#define WAIT_FOR_CHILD_PID(child_pid, function_name) \
+int child_return = wait_for_child_pid(child_pid, WAIT_FOR_FORKED_PROCESS_WITHOUT_LOOPING ? -1 : TIMEOUT_MILLISECONDS); \
+CHECK_CHILD_RETURN(child_return, function_name)
+
+/**
+ * @brief Macro for failing the test according to the status of a finished child process
+ */
+#define CHECK_CHILD_RETURN(child_return, function_name) \
+if (WEXITSTATUS(child_return) == EXIT_TIMED_OUT) \
+{ \
+    TEST_FAIL_MESSAGE("The " #function_name " function took too long to execute."); \
+} \
+else if (WEXITSTATUS(child_return) == EXIT_WAITING_FOR_INPUT) \
+{ \
+    TEST_FAIL_MESSAGE("The " #function_name " function was still waiting for input after reading all of it."); \
+} \
+else if (WEXITSTATUS(child_return) == EXIT_TEST_FAILED) \
 { \
     Unity.CurrentTestFailed = 1; \
     TEST_ABORT(); \
@@ -763,7 +924,7 @@ else if (child_return != 0) \
 { \
     crashes_##function_name = true; \
     TEST_FAIL_MESSAGE("The " #function_name " function or one of the functions it called crashed or encountered an irrecoverable error."); \
-} \
+}
 
 /**
  * @brief Macro for waiting for all children to finish, returning the value from the specific child PID
@@ -990,16 +1151,23 @@ bool does_file_contain(const char* pattern, const char* path);
 /**
  * @brief Determines if the captured output contains the specified regex pattern
  * @param pattern Pattern to test
- * @return True if the file contains the pattern, false otherwise
+ * @return True if the captured output contains the pattern, false otherwise
  */
 bool does_captured_output_contain(const char* pattern);
 
 /**
- * @brief Gets captured output
- * @return Captured output or NULL if there was none
+ * @brief Gets output captured in memory by this process and the processes forked from it, in the order it was written
+ * @return New dynamically allocated copy of the captured output, or NULL if it could not be allocated
  */
 char* get_captured_output(void);
 
+/**
+ * @brief Appends output captured since the last flush to the CAPTURE_OUTPUT file, which is also done at exit
+ *
+ * Only the process that started capturing appends, so forked children's output is written by their ancestor.
+ */
+void flush_captured_output(void);
+
 /**
  * @brief Get the directory part of a path
  * @param path Path to extract directory from
@@ -1102,4 +1270,145 @@ int robust_nanosleep(int seconds, long nanoseconds);
  */
 char* fix_string_null_termination(const char* string);
 
+/**
+ * @brief Starts the fork server, a small process forked now that forks a child for each call made through it
+ *
+ * Forking the whole test process copies its page tables, which grow with everything the tests have allocated. The fork
+ * server keeps the small footprint of the process at the time it was started, so its children are cheap to fork, and
+ * each call is still isolated in its own child. Start it early, before the tests allocate much memory.
+ *
+ * @return True if the fork server is running, false if it could not be started
+ */
+bool start_fork_server(void);
+
+/**
+ * @brief Stops the fork server
+ */
+void stop_fork_server(void);
+
+/**
+ * @brief Determines if the fork server is running for this process
+ * @return True if the fork server was started by this process and has not stopped, false otherwise
+ */
+bool is_fork_server_running(void);
+
+/**
+ * @brief Gets shared memory for a child forked by a CALL_FUNCTION_*_WITH_RETURN macro to write its return value to
+ *
+ * The slots come from one slab of anonymous shared memory mapped on first use in each process, and are handed out in
+ * turn, so a call makes no system calls of its own and nothing is left behind in the system's IPC namespace. A slot
+ * is valid until the process has handed out the slab's other slots, or, for values over the slot size, until the next
+ * larger one is requested.
+ *
+ * @param size Size of the return value
+ * @return Zeroed shared memory of at least size bytes, or NULL if it could not be mapped
+ */
+void* get_result_slot(size_t size);
+
+/**
+ * @brief Waits for a child process without using the CPU, with pidfd_open, a signalfd for SIGCHLD, or polling waitpid
+ * @param child_pid Child to wait for
+ * @param timeout_milliseconds Milliseconds to wait before killing the child, or a negative number to wait indefinitely
+ * @return Status of the child as returned by waitpid, or an exit status of EXIT_TIMED_OUT if it was killed for taking too long
+ */
+int wait_for_child_pid(pid_t child_pid, int timeout_milliseconds);
+
+/**
+ * @brief Calls a function in a child forked by the fork server, with stdin, stdout and stderr of this process
+ * @param function Function declared with FORK_SERVER_FUNCTION or FORK_SERVER_VOID_FUNCTION
+ * @param check Checks to run in the child on the return value
+ * @param arguments Packed arguments
+ * @param argument_size Size of the packed arguments
+ * @param result Buffer receiving the return value, or NULL to discard it
+ * @param result_size Size of the return value
+ * @param timeout_milliseconds Milliseconds to wait before killing the child
+ * @return Status of the child as returned by waitpid, with an exit status of EXIT_TIMED_OUT if it was killed for taking
+ * too long or EXIT_FORK_FAILED if the fork server could not run it
+ */
+int call_in_fork_server(fork_server_function function, enum fork_server_check check, const void* arguments, size_t argument_size, void* result, size_t result_size, int timeout_milliseconds);
+
+/**
+ * @brief Opens an in-memory capture for output without redirecting anything
+ *
+ * Each capture has its own anonymous memory file, or its own pipe where memfd_create is not available, so nothing is
+ * created in the current directory and captures in concurrent tests cannot see each other's output. A child forked
+ * afterwards can dup2 capture->fd over its stdout and stderr, and the parent reads the output with
+ * finish_output_capture once the child has exited.
+ *
+ * @param capture Capture to open
+ * @return True on success, false if the capture could not be opened
+ */
+bool open_output_capture(struct output_capture* capture);
+
+/**
+ * @brief Opens an in-memory capture and redirects stdout and stderr of this process to it
+ * @param capture Capture to start
+ * @return True on success, false if the capture could not be opened, leaving stdout and stderr as they were
+ */
+bool start_output_capture(struct output_capture* capture);
+
+/**
+ * @brief Restores stdout and stderr if they were redirected, closes the capture and returns the captured output
+ * @param capture Capture opened with open_output_capture or start_output_capture
+ * @param length Receives the number of bytes captured, or NULL
+ * @return New dynamically allocated, null-terminated string of the output, or NULL if it could not be read
+ */
+char* finish_output_capture(struct output_capture* capture, size_t* length);
+
+/**
+ * @brief Sets how the overridden allocation functions poison new memory
+ * @param poisoning Poisoning for allocations made from now on
+ * @param prefix_bytes Number of bytes poisoned with MALLOC_POISON_PREFIX
+ */
+void set_malloc_poisoning(enum malloc_poisoning poisoning, size_t prefix_bytes);
+
+/**
+ * @brief Starts counting allocations for a test, from which get_allocation_statistics and report_allocation_leaks count
+ *
+ * Every block is recorded in a lock-free open-addressing table keyed by its address, with its size and the address of
+ * the code that allocated it, so counting costs a few atomic operations instead of a pass over the memory.
+ */
+void begin_allocation_tracking(void);
+
+/**
+ * @brief Gets the allocations counted since begin_allocation_tracking, or since the process started
+ * @param statistics Statistics to fill
+ */
+void get_allocation_statistics(struct allocation_statistics* statistics);
+
+/**
+ * @brief Prints each block allocated since begin_allocation_tracking and not yet freed, with the code that allocated it
+ * @param stream Stream to print to
+ * @return Number of blocks not yet freed
+ */
+size_t report_allocation_leaks(FILE* stream);
+
+/**
+ * @brief Opens a pipe holding scripted input for a child forked afterwards to read as its stdin
+ * @param input Scripted input to open
+ * @param script Input for the child, which must fit in the pipe
+ * @return True on success, false if the pipe could not be created or the script does not fit
+ */
+bool open_scripted_input(struct scripted_input* input, const char* script);
+
+/**
+ * @brief Closes both ends of the pipe of scripted input
+ * @param input Scripted input opened with open_scripted_input
+ */
+void close_scripted_input(struct scripted_input* input);
+
+/**
+ * @brief Waits for a child reading scripted input to exit or to block reading stdin once the script is used up
+ *
+ * A child blocked in read on stdin with nothing left in the pipe can never continue, so it is killed as soon as that is
+ * seen in /proc/<pid>/syscall, or in /proc/<pid>/wchan where the system call is not shown, instead of at the deadline.
+ *
+ * @param child_pid Child to wait for, with the read end of input as its stdin
+ * @param input Scripted input of the child
+ * @param timeout_milliseconds Milliseconds to wait before killing the child, or a negative number to wait indefinitely
+ * @return Status of the child as returned by waitpid, or an exit status of EXIT_WAITING_FOR_INPUT if it was killed for
+ * waiting for more input or EXIT_TIMED_OUT if it was killed for taking too long
+ */
+int wait_for_child_pid_reading_input(pid_t child_pid, const struct scripted_input* input, int timeout_milliseconds);
+
 // NOLINTEND
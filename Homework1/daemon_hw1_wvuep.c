@@ -0,0 +1,70 @@
+/**
+ * @file daemon_hw1_wvuep.c
+ * @brief Resident projection server for CS 350 Homework #1: WVU Enrollment Problem
+ * @author Rashaan Clay
+ *
+ * Build together with hw1_wvuep.c, series_hw1_wvuep.c and server_hw1_wvuep.c, without
+ * main_hw1_wvuep.c. Run with the socket path as the only argument; SIGINT or SIGTERM stops the
+ * server and removes the socket.
+ */
+
+// Use GNU source for sigaction
+#define _GNU_SOURCE // NOLINT(*-reserved-identifier)
+
+#include "server_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+/**
+ * @brief Socket path used when none is given
+ */
+#define DAEMON_DEFAULT_SOCKET_PATH "/tmp/hw1_wvuep.sock"
+
+/**
+ * @brief Server stopped by the signal handler
+ */
+static struct projection_server daemon_server;
+
+/**
+ * @brief Stop the server when a termination signal arrives
+ * @param signal_number Signal received
+ */
+static void daemon_handle_signal(int signal_number)
+{
+	(void)signal_number;
+	projection_server_stop(&daemon_server);
+}
+
+/**
+ * @brief Program entry point
+ * @param argc Number of arguments
+ * @param argv Arguments; argv[1] is the socket path
+ * @return Status code
+ */
+int main(int argc, char** argv)
+{
+	const char* path = argc > 1 ? argv[1] : DAEMON_DEFAULT_SOCKET_PATH;
+	if (!projection_server_open(&daemon_server, path))
+	{
+		return EXIT_FAILURE;
+	}
+
+	// Stop cleanly on termination signals
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = daemon_handle_signal;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+
+	// Serve until stopped
+	printf("Serving enrollment projections on %s\n", path);
+	fflush(stdout);
+	bool stopped = projection_server_run(&daemon_server);
+	printf("Answered %zu requests, %zu from the cache\n", daemon_server.requests, daemon_server.cache_hits);
+	projection_server_close(&daemon_server);
+
+	return stopped ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file engine_hw1_wvuep.c
+ * @brief Source code file for the multi-campus projection engine for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * Each task handles one tile of PROJECTION_TILE_CAMPUSES adjacent campuses. The task keeps one
+ * projection series per campus (12 KiB for a full tile, small enough for L1 cache) and walks
+ * the rows in order, writing the tile's part of each row as one contiguous run. Tiles start
+ * on cache line boundaries, so no two threads write to the same cache line.
+ */
+
+#include "engine_hw1_wvuep.h"
+#include "batch_hw1_wvuep.h"
+#include "series_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/**
+ * @brief Default number of campuses a campus table allocates room for
+ */
+#define CAMPUS_TABLE_DEFAULT_CAPACITY 64
+
+/**
+ * @brief Size of a cache line in bytes
+ */
+#define PROJECTION_CACHE_LINE 64
+
+/**
+ * @brief Number of ints in a cache line, the unit rows are padded to
+ */
+#define PROJECTION_CACHE_LINE_INTS (PROJECTION_CACHE_LINE / sizeof(int))
+
+/**
+ * @brief Data shared by the tasks of one projection
+ */
+struct projection_job {
+	const struct campus_table* campuses; /**< Campuses to project */
+	struct projection_matrix* matrix; /**< Matrix receiving results */
+};
+
+/**
+ * @brief Resize a campus table's columns
+ * @param campuses Table to resize
+ * @param capacity New number of campuses the columns can hold
+ * @return True on success, false if memory could not be allocated
+ */
+static bool campus_table_resize(struct campus_table* campuses, size_t capacity)
+{
+	// Resize each column, keeping the ones that succeed so the table stays consistent
+	int** columns[] = { &campuses->initial_enrollments, &campuses->initial_years, &campuses->target_enrollments, &campuses->target_years };
+	for (size_t i = 0; i < sizeof(columns) / sizeof(columns[0]); i++)
+	{
+		int* column = realloc(*columns[i], capacity * sizeof(int));
+		if (column == NULL)
+		{
+			fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+			return false;
+		}
+		*columns[i] = column;
+	}
+	campuses->capacity = capacity;
+
+	return true;
+}
+
+bool campus_table_init(struct campus_table* campuses, size_t capacity)
+{
+	memset(campuses, 0, sizeof(*campuses));
+
+	// Allocate the columns
+	if (capacity == 0)
+	{
+		capacity = CAMPUS_TABLE_DEFAULT_CAPACITY;
+	}
+	if (!campus_table_resize(campuses, capacity))
+	{
+		campus_table_free(campuses);
+		return false;
+	}
+
+	return true;
+}
+
+bool campus_table_reserve(struct campus_table* campuses, size_t capacity)
+{
+	// Only grow, never shrink
+	if (capacity <= campuses->capacity)
+	{
+		return true;
+	}
+
+	return campus_table_resize(campuses, capacity);
+}
+
+bool campus_table_add(struct campus_table* campuses, int initial_enrollment, int initial_year, int target_enrollment, int target_year)
+{
+	// Double the columns when they are full
+	if (campuses->count == campuses->capacity && !campus_table_resize(campuses, campuses->capacity == 0 ? CAMPUS_TABLE_DEFAULT_CAPACITY : campuses->capacity * 2))
+	{
+		return false;
+	}
+
+	// Store the campus in each column
+	campuses->initial_enrollments[campuses->count] = initial_enrollment;
+	campuses->initial_years[campuses->count] = initial_year;
+	campuses->target_enrollments[campuses->count] = target_enrollment;
+	campuses->target_years[campuses->count] = target_year;
+	campuses->count++;
+
+	return true;
+}
+
+void campus_table_free(struct campus_table* campuses)
+{
+	free(campuses->initial_enrollments);
+	free(campuses->initial_years);
+	free(campuses->target_enrollments);
+	free(campuses->target_years);
+	memset(campuses, 0, sizeof(*campuses));
+}
+
+bool projection_matrix_init(struct projection_matrix* matrix, size_t campus_count, int first_year, int last_year)
+{
+	memset(matrix, 0, sizeof(*matrix));
+
+	// Reject an empty year range
+	if (last_year < first_year)
+	{
+		fprintf(stderr, "Could not create projection matrix: last year %d is before first year %d.\n", last_year, first_year);
+		return false;
+	}
+
+	// Pad rows to whole cache lines so tiles never share a line
+	matrix->first_year = first_year;
+	matrix->last_year = last_year;
+	matrix->year_count = (size_t)((long long)last_year - first_year + 1);
+	matrix->campus_count = campus_count;
+	matrix->stride = (campus_count + PROJECTION_CACHE_LINE_INTS - 1) / PROJECTION_CACHE_LINE_INTS * PROJECTION_CACHE_LINE_INTS;
+
+	// Allocate results, with at least one cache line so aligned_alloc gets a valid size
+	size_t estimate_count = matrix->year_count * matrix->stride;
+	if (matrix->stride != 0 && estimate_count / matrix->stride != matrix->year_count)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(ENOMEM));
+		return false;
+	}
+	size_t estimate_bytes = estimate_count == 0 ? PROJECTION_CACHE_LINE : estimate_count * sizeof(int);
+	matrix->growth_rates = malloc((campus_count == 0 ? 1 : campus_count) * sizeof(double));
+	matrix->estimates = aligned_alloc(PROJECTION_CACHE_LINE, estimate_bytes);
+	if (matrix->growth_rates == NULL || matrix->estimates == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		projection_matrix_free(matrix);
+		return false;
+	}
+
+	return true;
+}
+
+void projection_matrix_free(struct projection_matrix* matrix)
+{
+	free(matrix->growth_rates);
+	free(matrix->estimates);
+	memset(matrix, 0, sizeof(*matrix));
+}
+
+/**
+ * @brief Project one tile of campuses for every year in the matrix
+ * @param context Pointer to the projection_job
+ * @param task_index Index of the campus tile
+ * @param worker_index Unused
+ */
+static void project_campus_tile(void* context, size_t task_index, unsigned int worker_index)
+{
+	(void)worker_index;
+	const struct projection_job* job = context;
+	const struct campus_table* campuses = job->campuses;
+	struct projection_matrix* matrix = job->matrix;
+
+	// Find the campuses in this tile
+	size_t first_campus = task_index * PROJECTION_TILE_CAMPUSES;
+	size_t campus_count = campuses->count - first_campus;
+	if (campus_count > PROJECTION_TILE_CAMPUSES)
+	{
+		campus_count = PROJECTION_TILE_CAMPUSES;
+	}
+
+	// Calculate the tile's growth rates with the vector kernel
+	double* growth_rates = matrix->growth_rates + first_campus;
+	calculate_growth_rates(campuses->initial_enrollments + first_campus, campuses->target_enrollments + first_campus, campuses->initial_years + first_campus, campuses->target_years + first_campus, growth_rates, campus_count);
+
+	// Start one series per campus at the first year of the matrix
+	struct enrollment_series series[PROJECTION_TILE_CAMPUSES];
+	for (size_t i = 0; i < campus_count; i++)
+	{
+		enrollment_series_init(&series[i], campuses->initial_enrollments[first_campus + i], growth_rates[i], campuses->initial_years[first_campus + i]);
+		enrollment_series_seek(&series[i], matrix->first_year);
+	}
+
+	// Fill the tile's part of each row, keeping the series state in cache across rows
+	for (size_t row = 0; row < matrix->year_count; row++)
+	{
+		int* estimates = matrix->estimates + row * matrix->stride + first_campus;
+		for (size_t i = 0; i < campus_count; i++)
+		{
+			estimates[i] = enrollment_series_next(&series[i]);
+		}
+	}
+}
+
+void project_campuses(struct worker_pool* pool, const struct campus_table* campuses, struct projection_matrix* matrix)
+{
+	struct projection_job job = { campuses, matrix };
+	size_t tile_count = (campuses->count + PROJECTION_TILE_CAMPUSES - 1) / PROJECTION_TILE_CAMPUSES;
+
+	// Run on the calling thread without a pool
+	if (pool == NULL)
+	{
+		for (size_t i = 0; i < tile_count; i++)
+		{
+			project_campus_tile(&job, i, 0);
+		}
+		return;
+	}
+
+	worker_pool_run(pool, project_campus_tile, &job, tile_count);
+}
@@ -0,0 +1,126 @@
+/**
+ * @file engine_hw1_wvuep.h
+ * @brief Header file for the multi-campus projection engine for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * Campuses are stored column by column (all initial enrollments together, all initial years
+ * together, and so on). The engine computes every campus' growth rate and its estimates for a
+ * range of years into a years-by-campuses matrix, split across a worker pool in tiles.
+ */
+
+#pragma once
+
+#include "pool_hw1_wvuep.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Number of campuses in one tile
+ *
+ * Must be a multiple of 16 so tiles start on cache line boundaries. A tile's series state and
+ * a row segment of estimates fit in L1 cache together.
+ */
+#ifndef PROJECTION_TILE_CAMPUSES
+	#define PROJECTION_TILE_CAMPUSES 256
+#endif
+
+/**
+ * @brief Campuses stored in columns
+ */
+struct campus_table {
+	size_t count; /**< Number of campuses */
+	size_t capacity; /**< Number of campuses the columns can hold */
+	int* initial_enrollments; /**< Enrollment in each campus' initial year */
+	int* initial_years; /**< Year for each campus' initial enrollment */
+	int* target_enrollments; /**< Each campus' target enrollment */
+	int* target_years; /**< Year for each campus' target enrollment */
+};
+
+/**
+ * @brief Growth rates and estimates for a campus table
+ *
+ * The estimate for a year and campus is estimates[(year - first_year) * stride + campus]. Each
+ * row holds one year for every campus.
+ */
+struct projection_matrix {
+	int first_year; /**< Year of the first row */
+	int last_year; /**< Year of the last row */
+	size_t year_count; /**< Number of rows */
+	size_t campus_count; /**< Number of campuses */
+	size_t stride; /**< Distance between rows in ints, campus_count rounded up to a cache line */
+	double* growth_rates; /**< Growth rate of each campus */
+	int* estimates; /**< Estimates, one row per year */
+};
+
+/**
+ * @brief Initialize an empty campus table
+ * @param campuses Table to initialize
+ * @param capacity Number of campuses to allocate room for, or 0 for a default
+ * @return True on success, false if memory could not be allocated
+ */
+bool campus_table_init(struct campus_table* campuses, size_t capacity);
+
+/**
+ * @brief Make sure a campus table can hold at least capacity campuses without growing
+ * @param campuses Table to grow
+ * @param capacity Number of campuses the columns must hold
+ * @return True on success, false if memory could not be allocated
+ */
+bool campus_table_reserve(struct campus_table* campuses, size_t capacity);
+
+/**
+ * @brief Add a campus to a campus table, growing its columns if needed
+ * @param campuses Table to add to
+ * @param initial_enrollment Enrollment in initial_year
+ * @param initial_year Year for initial enrollment
+ * @param target_enrollment Target enrollment
+ * @param target_year Year for target enrollment
+ * @return True on success, false if memory could not be allocated
+ */
+bool campus_table_add(struct campus_table* campuses, int initial_enrollment, int initial_year, int target_enrollment, int target_year);
+
+/**
+ * @brief Free a campus table's columns
+ * @param campuses Table to free
+ */
+void campus_table_free(struct campus_table* campuses);
+
+/**
+ * @brief Allocate a projection matrix
+ * @param matrix Matrix to initialize
+ * @param campus_count Number of campuses
+ * @param first_year First year to estimate
+ * @param last_year Last year to estimate, not before first_year
+ * @return True on success, false if the range is empty or memory could not be allocated
+ */
+bool projection_matrix_init(struct projection_matrix* matrix, size_t campus_count, int first_year, int last_year);
+
+/**
+ * @brief Free a projection matrix
+ * @param matrix Matrix to free
+ */
+void projection_matrix_free(struct projection_matrix* matrix);
+
+/**
+ * @brief Get the row of estimates for a year
+ * @param matrix Matrix to read
+ * @param year Year between first_year and last_year
+ * @return Pointer to campus_count estimates
+ */
+static inline int* projection_matrix_row(const struct projection_matrix* matrix, int year)
+{
+	return matrix->estimates + (size_t)((long long)year - matrix->first_year) * matrix->stride;
+}
+
+/**
+ * @brief Calculate growth rates and estimates for every campus
+ *
+ * Growth rates come from calculate_growth_rates. Each estimate equals
+ * calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, year) for the
+ * campus' growth rate in the matrix. Results do not depend on the number of threads.
+ *
+ * @param pool Pool to run on, or NULL to run on the calling thread
+ * @param campuses Campuses to project
+ * @param matrix Matrix initialized for campuses->count campuses
+ */
+void project_campuses(struct worker_pool* pool, const struct campus_table* campuses, struct projection_matrix* matrix);
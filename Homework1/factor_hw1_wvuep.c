@@ -0,0 +1,299 @@
+/**
+ * @file factor_hw1_wvuep.c
+ * @brief Source code file for the precomputed growth factor table for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * Between grid rates r0 and r1 = r0 + 1 bp, a factor f(r) = (1 + r)^n is interpolated with the
+ * cubic Hermite polynomial through f(r0), f(r1) and the slopes n f / (1 + r) at both ends. Its
+ * error is at most h^4 / 384 times the fourth derivative, about 1e-9 of the factor for n = 200,
+ * h = 1 bp and a rate of -20%, and much less for shorter horizons, so rounded estimates almost
+ * never move.
+ */
+
+#include "factor_hw1_wvuep.h"
+#include "hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Compute 1 / (1 + rate) / 10000 for every rate of a table
+ * @param table Table with its grid set
+ * @return True on success, false if memory could not be allocated
+ */
+static bool growth_factor_table_init_slopes(struct growth_factor_table* table)
+{
+	table->slope_scales = malloc(table->rate_count * sizeof(double));
+	if (table->slope_scales == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return false;
+	}
+	for (size_t i = 0; i < table->rate_count; i++)
+	{
+		table->slope_scales[i] = 1.0 / (1 + (table->min_basis_points + (int)i) / GROWTH_FACTOR_BASIS_POINTS) / GROWTH_FACTOR_BASIS_POINTS;
+	}
+
+	return true;
+}
+
+bool growth_factor_table_init(struct growth_factor_table* table, int min_basis_points, int max_basis_points, size_t year_count)
+{
+	memset(table, 0, sizeof(*table));
+
+	// Rates must keep 1 + rate positive
+	if (min_basis_points <= -(int)GROWTH_FACTOR_BASIS_POINTS || max_basis_points < min_basis_points || year_count == 0 || year_count > INT32_MAX)
+	{
+		fprintf(stderr, "Could not create growth factor table: invalid grid.\n");
+		return false;
+	}
+	table->min_basis_points = min_basis_points;
+	table->max_basis_points = max_basis_points;
+	table->rate_count = (size_t)((long long)max_basis_points - min_basis_points + 1);
+	table->year_count = year_count;
+
+	// Allocate the factors
+	table->owned_factors = malloc(table->rate_count * year_count * sizeof(double));
+	if (table->owned_factors == NULL || !growth_factor_table_init_slopes(table))
+	{
+		if (table->owned_factors == NULL)
+		{
+			fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		}
+		growth_factor_table_free(table);
+		return false;
+	}
+	table->factors = table->owned_factors;
+
+	// Compute every factor with pow, so rates on the grid match calculate_enrollment_estimate exactly
+	for (size_t i = 0; i < table->rate_count; i++)
+	{
+		double growth_rate = (min_basis_points + (int)i) / GROWTH_FACTOR_BASIS_POINTS;
+		double* factors = table->owned_factors + i * year_count;
+		for (size_t years = 0; years < year_count; years++)
+		{
+			factors[years] = pow(1 + growth_rate, (int)years);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Write all bytes to a file descriptor, continuing after partial writes and interruptions
+ * @param fd File descriptor to write to
+ * @param data Bytes to write
+ * @param length Number of bytes
+ * @return True on success, false if write failed
+ */
+static bool growth_factor_write_all(int fd, const void* data, size_t length)
+{
+	const char* bytes = data;
+	while (length > 0)
+	{
+		ssize_t result = write(fd, bytes, length);
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return false;
+		}
+		bytes += result;
+		length -= (size_t)result;
+	}
+
+	return true;
+}
+
+bool growth_factor_table_save(const struct growth_factor_table* table, const char* path)
+{
+	// Describe the grid, with the factors right after the header
+	struct growth_factor_file_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, GROWTH_FACTOR_FILE_MAGIC, sizeof(GROWTH_FACTOR_FILE_MAGIC));
+	header.version = GROWTH_FACTOR_FILE_VERSION;
+	header.header_size = sizeof(header);
+	header.byte_order = GROWTH_FACTOR_FILE_BYTE_ORDER;
+	header.min_basis_points = table->min_basis_points;
+	header.max_basis_points = table->max_basis_points;
+	header.year_count = (uint32_t)table->year_count;
+	header.factors_offset = sizeof(header);
+
+	// Create the file
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Could not open %s: %s.\n", path, strerror(errno));
+		return false;
+	}
+
+	// Write it, keeping the error from write rather than from close
+	bool written = growth_factor_write_all(fd, &header, sizeof(header)) && growth_factor_write_all(fd, table->factors, table->rate_count * table->year_count * sizeof(double));
+	if (!written)
+	{
+		fprintf(stderr, "Could not write %s: %s.\n", path, strerror(errno));
+	}
+	if (close(fd) != 0 && written)
+	{
+		fprintf(stderr, "Could not write %s: %s.\n", path, strerror(errno));
+		written = false;
+	}
+
+	return written;
+}
+
+/**
+ * @brief Check that a mapped growth factor file has a supported header and factors that fit in it
+ * @param header Header at the start of the file
+ * @param length Length of the file in bytes
+ * @return Description of the problem, or NULL if the file is valid
+ */
+static const char* growth_factor_check_header(const struct growth_factor_file_header* header, size_t length)
+{
+	if (length < sizeof(*header) || memcmp(header->magic, GROWTH_FACTOR_FILE_MAGIC, sizeof(GROWTH_FACTOR_FILE_MAGIC)) != 0)
+	{
+		return "not a growth factor file";
+	}
+	if (header->byte_order != GROWTH_FACTOR_FILE_BYTE_ORDER)
+	{
+		return "written with a different byte order";
+	}
+	if (header->version != GROWTH_FACTOR_FILE_VERSION || header->header_size < sizeof(*header))
+	{
+		return "unsupported format version";
+	}
+
+	// The grid must be valid and its factors must lie inside the file, computed without overflow
+	uint64_t rate_count = (uint64_t)((long long)header->max_basis_points - header->min_basis_points + 1);
+	if (header->min_basis_points <= -(int)GROWTH_FACTOR_BASIS_POINTS || header->max_basis_points < header->min_basis_points || header->year_count == 0 || header->year_count > INT32_MAX ||
+		header->factors_offset % sizeof(double) != 0 || header->factors_offset < header->header_size || header->factors_offset > length ||
+		rate_count > (length - header->factors_offset) / sizeof(double) / header->year_count)
+	{
+		return "truncated or corrupt";
+	}
+
+	return NULL;
+}
+
+bool growth_factor_table_load(struct growth_factor_table* table, const char* path)
+{
+	memset(table, 0, sizeof(*table));
+
+	// Open the file and find its size
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Could not open %s: %s.\n", path, strerror(errno));
+		return false;
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0)
+	{
+		fprintf(stderr, "Could not get size of %s: %s.\n", path, strerror(errno));
+		close(fd);
+		return false;
+	}
+	if ((size_t)status.st_size < sizeof(struct growth_factor_file_header))
+	{
+		fprintf(stderr, "Could not read %s: not a growth factor file.\n", path);
+		close(fd);
+		return false;
+	}
+
+	// Map the file read-only; the mapping stays valid after the descriptor is closed
+	size_t length = (size_t)status.st_size;
+	void* mapping = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		fprintf(stderr, "Could not map %s: %s.\n", path, strerror(errno));
+		return false;
+	}
+
+	// Check the header before trusting the grid
+	const struct growth_factor_file_header* header = mapping;
+	const char* problem = growth_factor_check_header(header, length);
+	if (problem != NULL)
+	{
+		fprintf(stderr, "Could not read %s: %s.\n", path, problem);
+		munmap(mapping, length);
+		return false;
+	}
+
+	// Point at the factors
+	table->mapping = mapping;
+	table->length = length;
+	table->min_basis_points = header->min_basis_points;
+	table->max_basis_points = header->max_basis_points;
+	table->rate_count = (size_t)((long long)header->max_basis_points - header->min_basis_points + 1);
+	table->year_count = header->year_count;
+	table->factors = (const double*)((const char*)mapping + header->factors_offset);
+	if (!growth_factor_table_init_slopes(table))
+	{
+		growth_factor_table_free(table);
+		return false;
+	}
+
+	return true;
+}
+
+void growth_factor_table_free(struct growth_factor_table* table)
+{
+	free(table->owned_factors);
+	free(table->slope_scales);
+	if (table->mapping != NULL)
+	{
+		munmap(table->mapping, table->length);
+	}
+	memset(table, 0, sizeof(*table));
+}
+
+int calculate_enrollment_estimate_table(const struct growth_factor_table* table, int initial_enrollment, double growth_rate, int initial_year, int estimate_year)
+{
+	return (int)round(initial_enrollment * growth_factor_table_factor(table, growth_rate, estimate_year - initial_year));
+}
+
+double growth_factor_table_max_error(const struct growth_factor_table* table)
+{
+	// Compare at the midpoint between each pair of adjacent rates, where the interpolation error peaks
+	double max_error = 0.0;
+	for (size_t lower = 0; lower + 1 < table->rate_count; lower++)
+	{
+		double growth_rate = (table->min_basis_points + (int)lower + 0.5) / GROWTH_FACTOR_BASIS_POINTS;
+		for (size_t years = 0; years < table->year_count; years++)
+		{
+			double exact = pow(1 + growth_rate, (int)years);
+			double error = fabs(growth_factor_table_factor(table, growth_rate, (int)years) / exact - 1);
+			if (error > max_error)
+			{
+				max_error = error;
+			}
+		}
+	}
+
+	return max_error;
+}
+
+int growth_factor_table_max_deviation(const struct growth_factor_table* table, int initial_enrollment, double growth_rate, int initial_year, int end_year)
+{
+	int max_deviation = 0;
+	for (int year = initial_year; year <= end_year; year++)
+	{
+		int deviation = abs(calculate_enrollment_estimate_table(table, initial_enrollment, growth_rate, initial_year, year) - calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, year));
+		if (deviation > max_deviation)
+		{
+			max_deviation = deviation;
+		}
+	}
+
+	return max_deviation;
+}
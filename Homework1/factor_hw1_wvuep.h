@@ -0,0 +1,206 @@
+/**
+ * @file factor_hw1_wvuep.h
+ * @brief Header file for the precomputed growth factor table for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * A growth factor table holds pow(1 + rate, years) for every rate on a basis point grid and
+ * every horizon below year_count, so an estimate needs a lookup instead of a pow. Rates on the
+ * grid return exactly the value of pow; rates between grid points use cubic Hermite
+ * interpolation with the exact derivative years * factor / (1 + rate), whose relative error
+ * stays below about 1e-9 on the default grid. Rates and horizons outside the table fall back to
+ * pow, so the table can be used for any query.
+ *
+ * Tables are computed at startup or mapped from a file written by growth_factor_table_save:
+ *
+ *     header                     struct growth_factor_file_header, 48 bytes
+ *     factors                    float64[year_count] per rate, from min_basis_points up
+ *
+ * Rows hold every horizon for one rate, so the estimates for consecutive years of one campus
+ * read two rows in order.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * @brief Number of basis points in 1
+ */
+#define GROWTH_FACTOR_BASIS_POINTS 10000.0
+
+/**
+ * @brief Distance from a grid rate, in basis points, below which a rate is checked for being on the grid
+ */
+#define GROWTH_FACTOR_GRID_TOLERANCE 1e-6
+
+/**
+ * @brief Lowest rate in a default table, -20%
+ */
+#define GROWTH_FACTOR_DEFAULT_MIN_BASIS_POINTS -2000
+
+/**
+ * @brief Highest rate in a default table, 20%
+ */
+#define GROWTH_FACTOR_DEFAULT_MAX_BASIS_POINTS 2000
+
+/**
+ * @brief Number of horizons in a default table, 0 through 199 years
+ */
+#define GROWTH_FACTOR_DEFAULT_YEARS 200
+
+/**
+ * @brief Bytes at the start of every growth factor file
+ */
+#define GROWTH_FACTOR_FILE_MAGIC "WVUFACT"
+
+/**
+ * @brief Format version written by growth_factor_table_save
+ */
+#define GROWTH_FACTOR_FILE_VERSION 1
+
+/**
+ * @brief Value stored in the header to detect files written with a different byte order
+ */
+#define GROWTH_FACTOR_FILE_BYTE_ORDER 0x01020304u
+
+/**
+ * @brief Header at the start of a growth factor file
+ */
+struct growth_factor_file_header {
+	char magic[8]; /**< GROWTH_FACTOR_FILE_MAGIC, null-terminated */
+	uint32_t version; /**< Format version */
+	uint32_t header_size; /**< Size of this header in bytes */
+	uint32_t byte_order; /**< GROWTH_FACTOR_FILE_BYTE_ORDER in the writer's byte order */
+	int32_t min_basis_points; /**< Rate of the first row in basis points */
+	int32_t max_basis_points; /**< Rate of the last row in basis points */
+	uint32_t year_count; /**< Number of horizons in each row */
+	uint64_t factors_offset; /**< File offset of the first row */
+	uint64_t reserved; /**< Zero */
+};
+
+/**
+ * @brief Growth factors for a grid of rates and horizons
+ */
+struct growth_factor_table {
+	int min_basis_points; /**< Rate of the first row in basis points */
+	int max_basis_points; /**< Rate of the last row in basis points */
+	size_t rate_count; /**< Number of rows */
+	size_t year_count; /**< Number of horizons in each row */
+	const double* factors; /**< Row per rate, pow(1 + rate, years) for years 0 through year_count - 1 */
+	double* slope_scales; /**< 1 / (1 + rate) / 10000 for each rate, turning a factor into its slope per basis point */
+	double* owned_factors; /**< Factors computed by growth_factor_table_init, or NULL if mapped */
+	void* mapping; /**< Mapped file, or NULL if computed */
+	size_t length; /**< Length of the mapping in bytes */
+};
+
+/**
+ * @brief Compute a growth factor table
+ * @param table Table to initialize
+ * @param min_basis_points Lowest rate in basis points, above -10000
+ * @param max_basis_points Highest rate in basis points, not below min_basis_points
+ * @param year_count Number of horizons, at least 1
+ * @return True on success, false if the grid is invalid or memory could not be allocated
+ */
+bool growth_factor_table_init(struct growth_factor_table* table, int min_basis_points, int max_basis_points, size_t year_count);
+
+/**
+ * @brief Write a growth factor table to a file
+ * @param table Table to write
+ * @param path Path of the file to create or replace
+ * @return True on success, false if the file could not be written
+ */
+bool growth_factor_table_save(const struct growth_factor_table* table, const char* path);
+
+/**
+ * @brief Map a growth factor table from a file written by growth_factor_table_save
+ * @param table Table to initialize
+ * @param path Path of the file
+ * @return True on success, false if the file could not be mapped or is not a valid growth factor file
+ */
+bool growth_factor_table_load(struct growth_factor_table* table, const char* path);
+
+/**
+ * @brief Free or unmap a growth factor table
+ * @param table Table to free
+ */
+void growth_factor_table_free(struct growth_factor_table* table);
+
+/**
+ * @brief Get pow(1 + growth_rate, years) from the table
+ *
+ * Inline so that loops over many queries overlap their table reads.
+ *
+ * @param table Growth factor table
+ * @param growth_rate Annual growth rate
+ * @param years Number of years, negative or beyond the table computed with pow
+ * @return Growth factor
+ */
+static inline double growth_factor_table_factor(const struct growth_factor_table* table, double growth_rate, int years)
+{
+	// Horizons and rates outside the table use pow; the negated comparison also catches NaN
+	double position = growth_rate * GROWTH_FACTOR_BASIS_POINTS - table->min_basis_points;
+	if (years < 0 || (size_t)years >= table->year_count || !(position >= 0.0) || !(position < (double)((ptrdiff_t)table->rate_count - 1)))
+	{
+		return pow(1 + growth_rate, years);
+	}
+
+	// Find the rates around the rate; signed conversions are single instructions
+	ptrdiff_t lower = (ptrdiff_t)position;
+	double s = position - (double)lower;
+	const double* factors = table->factors + (size_t)lower * table->year_count + years;
+
+	// Rates on the grid read their factor directly; only rates next to a grid point need the exact check
+	if (s < GROWTH_FACTOR_GRID_TOLERANCE || s > 1 - GROWTH_FACTOR_GRID_TOLERANCE)
+	{
+		ptrdiff_t nearest = s < 0.5 ? lower : lower + 1;
+		if ((table->min_basis_points + nearest) / GROWTH_FACTOR_BASIS_POINTS == growth_rate)
+		{
+			return factors[nearest == lower ? 0 : table->year_count];
+		}
+	}
+
+	// Cubic Hermite interpolation with the exact slopes, with h00 f0 + h01 f1 written as f0 + h01 (f1 - f0)
+	double f0 = factors[0];
+	double f1 = factors[table->year_count];
+	double d0 = years * f0 * table->slope_scales[lower];
+	double d1 = years * f1 * table->slope_scales[lower + 1];
+	double s2 = s * s;
+	double s3 = s2 * s;
+	return f0 + (s3 - 2 * s2 + s) * d0 + (3 * s2 - 2 * s3) * (f1 - f0) + (s3 - s2) * d1;
+}
+
+/**
+ * @brief Calculate the estimated enrollment in estimate_year with a growth factor table
+ * @param table Growth factor table
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Required annual growth rate
+ * @param initial_year Year for initial enrollment
+ * @param estimate_year Year for which to calculate enrollment estimate
+ * @return Estimated enrollment, equal to calculate_enrollment_estimate for rates on the grid
+ */
+int calculate_enrollment_estimate_table(const struct growth_factor_table* table, int initial_enrollment, double growth_rate, int initial_year, int estimate_year);
+
+/**
+ * @brief Find the largest relative interpolation error of the table against pow
+ *
+ * Checks the midpoint between every pair of adjacent rates for every horizon, where the
+ * interpolation error is largest.
+ *
+ * @param table Growth factor table
+ * @return Largest |table factor / pow - 1|
+ */
+double growth_factor_table_max_error(const struct growth_factor_table* table);
+
+/**
+ * @brief Find the largest difference between table and exact estimates over a range of years
+ * @param table Growth factor table
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Required annual growth rate
+ * @param initial_year Year for initial enrollment
+ * @param end_year Last year to compare
+ * @return Largest |calculate_enrollment_estimate_table - calculate_enrollment_estimate|, usually 0
+ */
+int growth_factor_table_max_deviation(const struct growth_factor_table* table, int initial_enrollment, double growth_rate, int initial_year, int end_year);
@@ -0,0 +1,342 @@
+/**
+ * @file fixedpoint_hw1_wvuep.c
+ * @brief Source code file for deterministic fixed-point enrollment projections for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * Products and quotients of Q32.32 numbers are formed exactly in 128 bits before rounding, so
+ * the only rounding is the documented half-up step. The growth factor is the largest one whose
+ * power by squaring stays at or below the target ratio, found by a search over that monotonic
+ * power. The search starts from a pow guess to save steps, but only integer comparisons decide
+ * where it ends, so the factor does not depend on the C library either. The estimates for
+ * consecutive years then cost one product each.
+ */
+
+#include "fixedpoint_hw1_wvuep.h"
+#include "hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+
+/**
+ * @brief Half of the last fraction bit, added before truncating to round half up
+ */
+#define FIXED_POINT_HALF ((uint64_t)1 << (FIXED_POINT_FRACTION_BITS - 1))
+
+/**
+ * @brief Year from which measure_fixed_point_divergence projects
+ */
+#define FIXED_POINT_DIVERGENCE_YEAR 2024
+
+/**
+ * @brief Multiply two Q32.32 numbers, rounding half up and saturating at UINT64_MAX
+ * @param a First factor
+ * @param b Second factor
+ * @return Rounded product
+ */
+static uint64_t fixed_multiply(uint64_t a, uint64_t b)
+{
+	unsigned __int128 product = ((unsigned __int128)a * b + FIXED_POINT_HALF) >> FIXED_POINT_FRACTION_BITS;
+	return product > UINT64_MAX ? UINT64_MAX : (uint64_t)product;
+}
+
+/**
+ * @brief Divide two Q32.32 numbers, rounding half up and saturating at UINT64_MAX
+ * @param a Dividend
+ * @param b Divisor; 0 saturates
+ * @return Rounded quotient
+ */
+static uint64_t fixed_divide(uint64_t a, uint64_t b)
+{
+	if (b == 0)
+	{
+		return UINT64_MAX;
+	}
+	unsigned __int128 quotient = (((unsigned __int128)a << FIXED_POINT_FRACTION_BITS) + b / 2) / b;
+	return quotient > UINT64_MAX ? UINT64_MAX : (uint64_t)quotient;
+}
+
+/**
+ * @brief Raise a Q32.32 number to a power by squaring, rounding every product
+ * @param base Number to raise
+ * @param exponent Power, at least 1
+ * @return Rounded power, monotonic in base
+ */
+static uint64_t fixed_power(uint64_t base, unsigned int exponent)
+{
+	uint64_t result = FIXED_POINT_ONE;
+	while (exponent != 0)
+	{
+		if ((exponent & 1) != 0)
+		{
+			result = fixed_multiply(result, base);
+		}
+		exponent >>= 1;
+		if (exponent != 0)
+		{
+			base = fixed_multiply(base, base);
+		}
+	}
+
+	return result;
+}
+
+/**
+ * @brief Scale an enrollment by a Q32.32 factor
+ * @param enrollment Enrollment to scale
+ * @param factor Growth factor over the whole horizon
+ * @return Product rounded half away from zero and saturated to the range of int
+ */
+static int fixed_scale_enrollment(int enrollment, uint64_t factor)
+{
+	// Round the magnitude so that negative enrollments round like round() does
+	uint64_t magnitude = enrollment < 0 ? (uint64_t)(-(long long)enrollment) : (uint64_t)enrollment;
+	unsigned __int128 scaled = ((unsigned __int128)magnitude * factor + FIXED_POINT_HALF) >> FIXED_POINT_FRACTION_BITS;
+	int result = scaled > INT_MAX ? INT_MAX : (int)scaled;
+
+	return enrollment < 0 ? -result : result;
+}
+
+/**
+ * @brief Guess the Q32.32 root of a ratio in double precision
+ * @param numerator Numerator of the ratio
+ * @param denominator Denominator of the ratio, greater than 0
+ * @param steps Degree of the root, at least 1
+ * @return Approximate root, only used as a starting point
+ */
+static uint64_t fixed_root_guess(uint64_t numerator, uint64_t denominator, unsigned int steps)
+{
+	double guess = pow((double)numerator / (double)denominator, 1.0 / steps) * (double)FIXED_POINT_ONE;
+	if (!(guess > 0.0))
+	{
+		return 0;
+	}
+
+	return guess < 0x1p63 ? (uint64_t)guess : (uint64_t)1 << 63;
+}
+
+/**
+ * @brief Find the largest Q32.32 factor whose power does not exceed a ratio
+ *
+ * Gallops away from the guess with doubling strides until the answer is bracketed, then
+ * bisects. Only comparisons of integer powers decide the result, so it does not depend on the
+ * guess; a close guess just needs fewer powers.
+ *
+ * @param ratio Ratio in Q32.32
+ * @param steps Degree of the root, at least 1
+ * @param guess Starting point
+ * @return Largest factor with fixed_power(factor, steps) <= ratio
+ */
+static uint64_t fixed_root_floor(uint64_t ratio, unsigned int steps, uint64_t guess)
+{
+	// Keep fixed_power(low) <= ratio < fixed_power(high), with 2^64 standing for a power above every ratio
+	unsigned __int128 low = 0;
+	unsigned __int128 high = (unsigned __int128)1 << 64;
+	unsigned __int128 stride = 1;
+	if (fixed_power(guess, steps) <= ratio)
+	{
+		low = guess;
+		while (low + stride < high && fixed_power((uint64_t)(low + stride), steps) <= ratio)
+		{
+			low += stride;
+			stride <<= 1;
+		}
+		if (low + stride < high)
+		{
+			high = low + stride;
+		}
+	}
+	else
+	{
+		high = guess;
+		while (stride <= high && fixed_power((uint64_t)(high - stride), steps) > ratio)
+		{
+			high -= stride;
+			stride <<= 1;
+		}
+		if (stride <= high)
+		{
+			low = high - stride;
+		}
+	}
+
+	// Bisect the bracket
+	while (high - low > 1)
+	{
+		unsigned __int128 middle = low + (high - low) / 2;
+		if (fixed_power((uint64_t)middle, steps) <= ratio)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return (uint64_t)low;
+}
+
+bool calculate_fixed_growth_factor(int initial_enrollment, int target_enrollment, int initial_year, int target_year, uint64_t* growth_factor)
+{
+	// Going back in time inverts the ratio, so its numerator must not be 0 either
+	long long years = (long long)target_year - initial_year;
+	if (initial_enrollment <= 0 || target_enrollment < 0 || years == 0 || (years < 0 && target_enrollment == 0))
+	{
+		return false;
+	}
+
+	// Only a factor of 0 reaches a target of 0; the search would stop at the largest power that rounds to 0
+	if (target_enrollment == 0)
+	{
+		*growth_factor = 0;
+		return true;
+	}
+	uint64_t numerator = (uint64_t)(years > 0 ? target_enrollment : initial_enrollment);
+	uint64_t denominator = (uint64_t)(years > 0 ? initial_enrollment : target_enrollment);
+	unsigned int steps = (unsigned int)(years > 0 ? years : -years);
+
+	// The ratio fits in 63 bits because both enrollments are below 2^31
+	uint64_t ratio = (uint64_t)(((unsigned __int128)numerator << FIXED_POINT_FRACTION_BITS) + denominator / 2) / denominator;
+
+	// Search for the largest factor whose power does not exceed the ratio, starting from a guess
+	uint64_t factor = fixed_root_floor(ratio, steps, fixed_root_guess(numerator, denominator, steps));
+
+	// The next factor overshoots; take it if it lands closer to the ratio
+	if (factor != UINT64_MAX && fixed_power(factor + 1, steps) - ratio < ratio - fixed_power(factor, steps))
+	{
+		factor++;
+	}
+
+	*growth_factor = factor;
+	return true;
+}
+
+double fixed_growth_factor_to_rate(uint64_t growth_factor)
+{
+	// Subtract in integers first so that factors near 1 keep every bit
+	if (growth_factor >= FIXED_POINT_ONE)
+	{
+		return (double)(growth_factor - FIXED_POINT_ONE) / (double)FIXED_POINT_ONE;
+	}
+
+	return -(double)(FIXED_POINT_ONE - growth_factor) / (double)FIXED_POINT_ONE;
+}
+
+int calculate_fixed_enrollment_estimate(int initial_enrollment, uint64_t growth_factor, int initial_year, int estimate_year)
+{
+	// Step the recurrence forward or backward to the estimate year
+	uint64_t factor = FIXED_POINT_ONE;
+	for (int year = initial_year; year < estimate_year; year++)
+	{
+		factor = fixed_multiply(factor, growth_factor);
+	}
+	for (int year = initial_year; year > estimate_year; year--)
+	{
+		factor = fixed_divide(factor, growth_factor);
+	}
+
+	return fixed_scale_enrollment(initial_enrollment, factor);
+}
+
+size_t calculate_fixed_enrollment_estimates(int initial_enrollment, uint64_t growth_factor, int initial_year, int end_year, int* estimates)
+{
+	// Nothing to estimate if the range is empty
+	if (end_year < initial_year)
+	{
+		return 0;
+	}
+
+	// One product per year, the same steps calculate_fixed_enrollment_estimate takes
+	size_t count = (size_t)((long long)end_year - initial_year + 1);
+	uint64_t factor = FIXED_POINT_ONE;
+	for (size_t i = 0; i < count; i++)
+	{
+		estimates[i] = fixed_scale_enrollment(initial_enrollment, factor);
+		factor = fixed_multiply(factor, growth_factor);
+	}
+
+	return count;
+}
+
+bool measure_fixed_point_divergence(int min_initial_enrollment, int max_initial_enrollment, int min_target_enrollment, int max_target_enrollment, int enrollment_step, int max_years, struct fixed_point_divergence* divergence)
+{
+	memset(divergence, 0, sizeof(*divergence));
+	if (min_initial_enrollment <= 0 || min_target_enrollment < 0 || enrollment_step <= 0 || max_years <= 0 || max_years > INT_MAX - FIXED_POINT_DIVERGENCE_YEAR)
+	{
+		fprintf(stderr, "Could not measure divergence: invalid grid.\n");
+		return false;
+	}
+
+	// Allocate room for the estimates of one projection
+	int* estimates = malloc(((size_t)max_years + 1) * sizeof(int));
+	if (estimates == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return false;
+	}
+
+	// Project every point of the grid both ways in time
+	for (int initial_enrollment = min_initial_enrollment; initial_enrollment <= max_initial_enrollment; initial_enrollment += enrollment_step)
+	{
+		for (int target_enrollment = min_target_enrollment; target_enrollment <= max_target_enrollment; target_enrollment += enrollment_step)
+		{
+			for (int years = -max_years; years <= max_years; years++)
+			{
+				// Compare the growth rates
+				uint64_t growth_factor;
+				if (years == 0 || !calculate_fixed_growth_factor(initial_enrollment, target_enrollment, FIXED_POINT_DIVERGENCE_YEAR, FIXED_POINT_DIVERGENCE_YEAR + years, &growth_factor))
+				{
+					continue;
+				}
+				double growth_rate = calculate_growth_rate(initial_enrollment, target_enrollment, FIXED_POINT_DIVERGENCE_YEAR, FIXED_POINT_DIVERGENCE_YEAR + years);
+				double rate_difference = fabs(fixed_growth_factor_to_rate(growth_factor) - growth_rate);
+				if (rate_difference > divergence->max_rate_difference)
+				{
+					divergence->max_rate_difference = rate_difference;
+				}
+				divergence->projections++;
+
+				// Compare the estimates up to a later target year, each path with its own growth rate
+				size_t count = calculate_fixed_enrollment_estimates(initial_enrollment, growth_factor, FIXED_POINT_DIVERGENCE_YEAR, FIXED_POINT_DIVERGENCE_YEAR + years, estimates);
+				for (size_t i = 0; i < count; i++)
+				{
+					int difference = abs(estimates[i] - calculate_enrollment_estimate(initial_enrollment, growth_rate, FIXED_POINT_DIVERGENCE_YEAR, FIXED_POINT_DIVERGENCE_YEAR + (int)i));
+					if (difference != 0)
+					{
+						divergence->differing_estimates++;
+					}
+					if (difference > divergence->max_estimate_difference)
+					{
+						divergence->max_estimate_difference = difference;
+					}
+				}
+				divergence->estimates += count;
+			}
+
+			// Stop before the step overflows
+			if (target_enrollment > INT_MAX - enrollment_step)
+			{
+				break;
+			}
+		}
+		if (initial_enrollment > INT_MAX - enrollment_step)
+		{
+			break;
+		}
+	}
+
+	free(estimates);
+	return true;
+}
+
+void print_fixed_point_divergence(const struct fixed_point_divergence* divergence)
+{
+	printf("Fixed-point projections compared: %zu\n", divergence->projections);
+	printf("Largest growth rate difference: %.3e\n", divergence->max_rate_difference);
+	printf("Estimates differing: %zu of %zu (%.4f%%)\n", divergence->differing_estimates, divergence->estimates, divergence->estimates == 0 ? 0.0 : 100.0 * (double)divergence->differing_estimates / (double)divergence->estimates);
+	printf("Largest estimate difference: %d\n", divergence->max_estimate_difference);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file fixedpoint_hw1_wvuep.h
+ * @brief Header file for deterministic fixed-point enrollment projections for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * calculate_growth_rate and calculate_enrollment_estimate depend on the pow and round of the C
+ * library in use, so two builds may disagree on a projection. The fixed-point path replaces them
+ * with integer arithmetic only: the growth factor 1 + rate is a Q32.32 number held in a uint64_t,
+ * and the factor for year k follows the recurrence
+ *
+ *     P(0) = 1,  P(k + 1) = round(P(k) * factor),  P(k - 1) = round(P(k) / factor)
+ *
+ * with every product and quotient rounded half up to 32 fraction bits. Each result is therefore
+ * bit-identical on every x86-64 build, whatever the compiler flags or C library. Estimates match
+ * the double-precision path except for rare differences of 1 where an exact product lies near a
+ * half; measure_fixed_point_divergence counts them.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Number of fraction bits in a fixed-point growth factor
+ */
+#define FIXED_POINT_FRACTION_BITS 32
+
+/**
+ * @brief Fixed-point growth factor of 1, a growth rate of 0
+ */
+#define FIXED_POINT_ONE ((uint64_t)1 << FIXED_POINT_FRACTION_BITS)
+
+/**
+ * @brief Differences between the fixed-point and double-precision paths over a range of projections
+ */
+struct fixed_point_divergence {
+	size_t projections; /**< Number of growth rates compared */
+	size_t estimates; /**< Number of estimates compared */
+	size_t differing_estimates; /**< Number of estimates that differ from calculate_enrollment_estimate */
+	int max_estimate_difference; /**< Largest |fixed-point estimate - double-precision estimate| */
+	double max_rate_difference; /**< Largest |fixed-point growth rate - calculate_growth_rate| */
+};
+
+/**
+ * @brief Calculate the annual growth factor needed to reach target_enrollment, in Q32.32
+ *
+ * Finds the factor whose fixed-point power over the years between initial_year and target_year
+ * is closest to target_enrollment / initial_enrollment. A target of 0 gives a factor of 0, a
+ * growth rate of -1, as calculate_growth_rate does.
+ *
+ * @param initial_enrollment Enrollment in initial_year, greater than 0
+ * @param target_enrollment Target enrollment for target_year, not negative; greater than 0 if target_year is before initial_year
+ * @param initial_year Year for initial enrollment
+ * @param target_year Year for target enrollment, not initial_year
+ * @param growth_factor Receives 1 + growth rate in Q32.32
+ * @return True on success, false if the parameters are invalid
+ */
+bool calculate_fixed_growth_factor(int initial_enrollment, int target_enrollment, int initial_year, int target_year, uint64_t* growth_factor);
+
+/**
+ * @brief Convert a Q32.32 growth factor to a growth rate
+ * @param growth_factor 1 + growth rate in Q32.32
+ * @return Growth rate, exact to the precision of a double
+ */
+double fixed_growth_factor_to_rate(uint64_t growth_factor);
+
+/**
+ * @brief Calculate the estimated enrollment in estimate_year with fixed-point arithmetic
+ *
+ * Takes |estimate_year - initial_year| steps of the recurrence; use
+ * calculate_fixed_enrollment_estimates for consecutive years.
+ *
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_factor 1 + growth rate in Q32.32
+ * @param initial_year Year for initial enrollment
+ * @param estimate_year Year for which to calculate enrollment estimate
+ * @return Estimated enrollment, rounded half away from zero and saturated to the range of int
+ */
+int calculate_fixed_enrollment_estimate(int initial_enrollment, uint64_t growth_factor, int initial_year, int estimate_year);
+
+/**
+ * @brief Calculate the fixed-point estimate for each year between initial_year and end_year
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_factor 1 + growth rate in Q32.32
+ * @param initial_year Year for initial enrollment
+ * @param end_year Last year to estimate
+ * @param estimates Output array with room for end_year - initial_year + 1 estimates
+ * @return Number of estimates written (0 if end_year is before initial_year)
+ */
+size_t calculate_fixed_enrollment_estimates(int initial_enrollment, uint64_t growth_factor, int initial_year, int end_year, int* estimates);
+
+/**
+ * @brief Compare the fixed-point and double-precision paths over a grid of projections
+ *
+ * Every initial and target enrollment on the grid is projected from 2024 to each target year
+ * up to max_years before and after it. The growth rates of every projection are compared, and
+ * the estimates for every year from 2024 to the target year of every later target.
+ *
+ * @param min_initial_enrollment Lowest initial enrollment, greater than 0
+ * @param max_initial_enrollment Highest initial enrollment
+ * @param min_target_enrollment Lowest target enrollment, not negative
+ * @param max_target_enrollment Highest target enrollment
+ * @param enrollment_step Distance between enrollments on the grid, greater than 0
+ * @param max_years Largest distance between the initial and target years, greater than 0
+ * @param divergence Receives the differences
+ * @return True on success, false if the grid is invalid or memory could not be allocated
+ */
+bool measure_fixed_point_divergence(int min_initial_enrollment, int max_initial_enrollment, int min_target_enrollment, int max_target_enrollment, int enrollment_step, int max_years, struct fixed_point_divergence* divergence);
+
+/**
+ * @brief Print a divergence report
+ * @param divergence Differences measured by measure_fixed_point_divergence
+ */
+void print_fixed_point_divergence(const struct fixed_point_divergence* divergence);
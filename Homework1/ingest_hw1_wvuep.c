@@ -0,0 +1,543 @@
+/**
+ * @file ingest_hw1_wvuep.c
+ * @brief Source code file for memory-mapped CSV ingest of campus enrollment histories for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * The text is split into chunks that start right after a line ending. A first pass counts the
+ * lines in each chunk, which gives every chunk a slot range in the campus table columns, and a
+ * second pass parses each chunk straight into its slots. Skipped lines leave gaps that are
+ * closed at the end. Both passes run on the worker pool.
+ *
+ * Ordinary rows are parsed without a branch per byte: 32 bytes are compared against digits,
+ * commas and line endings at once, the field boundaries are read from the resulting bit masks,
+ * and each field's digits are combined from one 64-bit load with three multiplications. The
+ * fields are independent of each other, so their conversions overlap. Rows the fast path does
+ * not handle (signs, long values, the last few bytes of the text) use a digit-by-digit parser.
+ */
+
+#include "ingest_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Number of chunks per worker, so workers that finish early can take more chunks
+ */
+#define CSV_CHUNKS_PER_WORKER 4
+
+/**
+ * @brief Number of integer columns in a row
+ */
+#define CSV_FIELDS 4
+
+/**
+ * @brief Most digits in an int
+ */
+#define CSV_MAX_DIGITS 10
+
+/**
+ * @brief Eight '0' characters in a 64-bit word
+ */
+#define CSV_ZEROS 0x3030303030303030ULL
+
+/**
+ * @brief Bytes csv_parse_row_fast may read from the start of a line: two 16-byte loads plus an
+ * eight-byte load starting at the last possible field
+ */
+#define CSV_FAST_ROW_READ 40
+
+/**
+ * @brief Eight newline characters in a 64-bit word
+ */
+#define CSV_NEWLINES 0x0A0A0A0A0A0A0A0AULL
+
+/**
+ * @brief One in every byte of a 64-bit word
+ */
+#define CSV_ONES 0x0101010101010101ULL
+
+/**
+ * @brief Low seven bits of every byte in a 64-bit word
+ */
+#define CSV_LOW_BITS 0x7F7F7F7F7F7F7F7FULL
+
+/**
+ * @brief A range of lines parsed by one task
+ */
+struct csv_chunk {
+	const char* begin; /**< First byte of the chunk, the start of a line */
+	const char* end; /**< One past the last byte of the chunk */
+	size_t first_row; /**< First campus table slot for the chunk's rows */
+	size_t lines; /**< Number of lines in the chunk, the most rows it can produce */
+	size_t rows; /**< Number of rows parsed */
+	size_t malformed_rows; /**< Number of malformed rows */
+	size_t first_malformed_offset; /**< Byte offset of the first malformed row */
+};
+
+/**
+ * @brief Data shared by the tasks of one ingest
+ */
+struct csv_job {
+	const char* data; /**< Start of the CSV text */
+	const char* limit; /**< End of the CSV text, the furthest any load may read */
+	struct csv_chunk* chunks; /**< Chunks of the text */
+	struct campus_table* campuses; /**< Table receiving rows */
+};
+
+/**
+ * @brief Parse an optionally negative decimal int one digit at a time
+ * @param cursor Position to parse from, moved past the digits on success
+ * @param end End of the chunk being parsed
+ * @param value Parsed value
+ * @return True if at least one digit was parsed and the value fits in an int, false otherwise
+ */
+static inline bool csv_parse_int(const char** cursor, const char* end, int* value)
+{
+	const char* position = *cursor;
+	bool negative = position < end && *position == '-';
+	position += negative;
+
+	// Accumulate digits, stopping one past the most an int can have
+	uint64_t magnitude = 0;
+	size_t digits = 0;
+	while (position + digits < end && (unsigned char)(position[digits] - '0') < 10 && digits <= CSV_MAX_DIGITS)
+	{
+		magnitude = magnitude * 10 + (uint64_t)(position[digits] - '0');
+		digits++;
+	}
+
+	// Reject missing digits and values outside int
+	if (digits == 0 || digits > CSV_MAX_DIGITS || magnitude > (uint64_t)INT_MAX + negative)
+	{
+		return false;
+	}
+
+	*value = negative ? (int)(0 - magnitude) : (int)magnitude;
+	*cursor = position + digits;
+
+	return true;
+}
+
+/**
+ * @brief Parse one row of four comma-separated ints and its line ending
+ * @param line Start of the line
+ * @param end End of the chunk being parsed
+ * @param values Parsed values
+ * @return Start of the next line if the line is a valid row, NULL otherwise
+ */
+static const char* csv_parse_row(const char* line, const char* end, int values[CSV_FIELDS])
+{
+	const char* position = line;
+	for (int i = 0; i < CSV_FIELDS; i++)
+	{
+		if (!csv_parse_int(&position, end, &values[i]))
+		{
+			return NULL;
+		}
+
+		// Fields are separated by commas
+		if (i < CSV_FIELDS - 1)
+		{
+			if (position >= end || *position != ',')
+			{
+				return NULL;
+			}
+			position++;
+		}
+	}
+
+	// The row must end here, allowing a carriage return before the newline
+	if (position < end && *position == '\r')
+	{
+		position++;
+	}
+	if (position == end)
+	{
+		return end;
+	}
+	return *position == '\n' ? position + 1 : NULL;
+}
+
+#if defined(__SSE2__)
+/**
+ * @brief Get the value of one to eight ASCII digits without a branch per digit
+ * @param digits First digit, with at least eight readable bytes
+ * @param length Number of digits, from 1 to 8
+ * @return Value of the digits
+ */
+static inline int csv_digits_value(const char* digits, unsigned int length)
+{
+	// Move the digits to the top of a word (first digit lowest) and fill the bottom with '0'
+	uint64_t word;
+	memcpy(&word, digits, sizeof(word));
+	unsigned int shift = (8 - length) * 8;
+	word = (word << shift) | ((CSV_ZEROS >> (63 - shift)) >> 1);
+
+	// Combine pairs, then quads, then the two halves with three multiplications
+	word -= CSV_ZEROS;
+	word = (word * 10) + (word >> 8);
+	return (int)((((word & 0x000000FF000000FFULL) * 0x000F424000000064ULL) + (((word >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL)) >> 32);
+}
+
+/**
+ * @brief Get a bit mask of the bytes in 32 bytes of text that equal a character
+ * @param low First 16 bytes
+ * @param high Next 16 bytes
+ * @param character Character to find
+ * @return Bit i is set if byte i equals character
+ */
+static inline uint32_t csv_match_mask(__m128i low, __m128i high, char character)
+{
+	__m128i pattern = _mm_set1_epi8(character);
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(low, pattern)) | ((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(high, pattern)) << 16);
+}
+
+/**
+ * @brief Parse an ordinary row with vector compares instead of scanning byte by byte
+ *
+ * Handles rows of four non-negative fields of one to eight digits, ending in "\n" or "\r\n"
+ * within 32 bytes. Anything else is left to csv_parse_row.
+ *
+ * @param line Start of the line, with at least CSV_FAST_ROW_READ readable bytes
+ * @param values Parsed values
+ * @return Start of the next line if the row was parsed, NULL otherwise
+ */
+static inline const char* csv_parse_row_fast(const char* line, int values[CSV_FIELDS])
+{
+	// Classify 32 bytes at once
+	__m128i low = _mm_loadu_si128((const __m128i*)line);
+	__m128i high = _mm_loadu_si128((const __m128i*)(line + 16));
+	uint32_t newlines = csv_match_mask(low, high, '\n');
+	uint32_t commas = csv_match_mask(low, high, ',');
+	uint32_t carriage_returns = csv_match_mask(low, high, '\r');
+	__m128i below_zero = _mm_set1_epi8('0' - 1);
+	__m128i above_nine = _mm_set1_epi8('9' + 1);
+	uint32_t digits = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(low, below_zero), _mm_cmplt_epi8(low, above_nine))) | ((uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(high, below_zero), _mm_cmplt_epi8(high, above_nine))) << 16);
+
+	// Find the row's content, before the newline and an optional carriage return
+	if (newlines == 0)
+	{
+		return NULL;
+	}
+	unsigned int line_length = (unsigned int)__builtin_ctz(newlines);
+	if (line_length == 0)
+	{
+		return NULL;
+	}
+	unsigned int content_length = line_length - ((carriage_returns >> (line_length - 1)) & 1);
+	uint32_t content = (1u << content_length) - 1;
+
+	// The content must be digits and exactly three commas
+	commas &= content;
+	if (((digits | commas) & content) != content || commas == 0)
+	{
+		return NULL;
+	}
+	unsigned int first_comma = (unsigned int)__builtin_ctz(commas);
+	commas &= commas - 1;
+	if (commas == 0)
+	{
+		return NULL;
+	}
+	unsigned int second_comma = (unsigned int)__builtin_ctz(commas);
+	commas &= commas - 1;
+	if (commas == 0 || (commas & (commas - 1)) != 0)
+	{
+		return NULL;
+	}
+	unsigned int third_comma = (unsigned int)__builtin_ctz(commas);
+
+	// Every field must have one to eight digits
+	unsigned int lengths[CSV_FIELDS] = { first_comma, second_comma - first_comma - 1, third_comma - second_comma - 1, content_length - third_comma - 1 };
+	if (lengths[0] - 1 >= 8 || lengths[1] - 1 >= 8 || lengths[2] - 1 >= 8 || lengths[3] - 1 >= 8)
+	{
+		return NULL;
+	}
+
+	// Convert the fields independently of each other
+	values[0] = csv_digits_value(line, lengths[0]);
+	values[1] = csv_digits_value(line + first_comma + 1, lengths[1]);
+	values[2] = csv_digits_value(line + second_comma + 1, lengths[2]);
+	values[3] = csv_digits_value(line + third_comma + 1, lengths[3]);
+
+	return line + line_length + 1;
+}
+#endif
+
+/**
+ * @brief Check if a line has no characters other than a carriage return
+ * @param line Start of the line
+ * @param line_end End of the line
+ * @return True if the line is blank, false otherwise
+ */
+static inline bool csv_line_is_blank(const char* line, const char* line_end)
+{
+	return line == line_end || (*line == '\r' && line + 1 == line_end);
+}
+
+/**
+ * @brief Count the lines in a chunk
+ * @param context Pointer to the csv_job
+ * @param task_index Index of the chunk
+ * @param worker_index Unused
+ */
+static void csv_count_chunk(void* context, size_t task_index, unsigned int worker_index)
+{
+	(void)worker_index;
+	const struct csv_job* job = context;
+	struct csv_chunk* chunk = &job->chunks[task_index];
+
+	// Count newlines a word at a time; a byte of the XOR is zero exactly where the text has a newline, and
+	// the marked high bits are summed with a multiply instead of a popcount instruction the target may lack
+	size_t lines = 0;
+	const char* position = chunk->begin;
+	for (; chunk->end - position >= 8; position += 8)
+	{
+		uint64_t word;
+		memcpy(&word, position, sizeof(word));
+		uint64_t values = word ^ CSV_NEWLINES;
+		uint64_t zeros = ~(((values & CSV_LOW_BITS) + CSV_LOW_BITS) | values | CSV_LOW_BITS);
+		lines += (size_t)(((zeros >> 7) * CSV_ONES) >> 56);
+	}
+	for (; position < chunk->end; position++)
+	{
+		lines += *position == '\n';
+	}
+
+	// Count a final line without a newline
+	chunk->lines = lines + (chunk->end > chunk->begin && chunk->end[-1] != '\n');
+}
+
+/**
+ * @brief Parse the rows of a chunk into its campus table slots
+ * @param context Pointer to the csv_job
+ * @param task_index Index of the chunk
+ * @param worker_index Unused
+ */
+static void csv_parse_chunk(void* context, size_t task_index, unsigned int worker_index)
+{
+	(void)worker_index;
+	const struct csv_job* job = context;
+	struct csv_chunk* chunk = &job->chunks[task_index];
+	struct campus_table* campuses = job->campuses;
+
+	size_t row = chunk->first_row;
+	const char* line = chunk->begin;
+	while (line < chunk->end)
+	{
+		// Store valid rows, which the parsers end at their newline
+		int values[CSV_FIELDS];
+		const char* next_line = NULL;
+#if defined(__SSE2__)
+		if (job->limit - line >= CSV_FAST_ROW_READ)
+		{
+			next_line = csv_parse_row_fast(line, values);
+		}
+#endif
+		if (next_line == NULL)
+		{
+			next_line = csv_parse_row(line, chunk->end, values);
+		}
+		if (next_line != NULL)
+		{
+			campuses->initial_enrollments[row] = values[0];
+			campuses->target_enrollments[row] = values[1];
+			campuses->initial_years[row] = values[2];
+			campuses->target_years[row] = values[3];
+			row++;
+			line = next_line;
+			continue;
+		}
+
+		// Find the end of anything else and count it if it is not blank
+		const char* line_end = memchr(line, '\n', (size_t)(chunk->end - line));
+		if (line_end == NULL)
+		{
+			line_end = chunk->end;
+		}
+		if (!csv_line_is_blank(line, line_end))
+		{
+			if (chunk->malformed_rows == 0)
+			{
+				chunk->first_malformed_offset = (size_t)(line - job->data);
+			}
+			chunk->malformed_rows++;
+		}
+		line = line_end + 1;
+	}
+	chunk->rows = row - chunk->first_row;
+}
+
+/**
+ * @brief Find the start of the line after a position, or the position itself if it starts a line
+ * @param data Start of the text
+ * @param position Position to start from
+ * @param end End of the text
+ * @return Start of a line, or end
+ */
+static const char* csv_next_line(const char* data, const char* position, const char* end)
+{
+	if (position == data || position >= end || position[-1] == '\n')
+	{
+		return position < end ? position : end;
+	}
+
+	const char* newline = memchr(position, '\n', (size_t)(end - position));
+	return newline == NULL ? end : newline + 1;
+}
+
+bool parse_campus_csv(const char* data, size_t length, struct worker_pool* pool, struct campus_table* campuses, struct csv_ingest_stats* stats)
+{
+	const char* end = data + length;
+	const char* begin = data;
+
+	// Skip a header line
+	if (begin < end && *begin != '-' && (unsigned char)(*begin - '0') >= 10 && *begin != '\n' && *begin != '\r')
+	{
+		begin = csv_next_line(data, begin + 1, end);
+	}
+
+	// Split the text into line-aligned chunks, enough for every worker to take several
+	unsigned int workers = pool == NULL ? 1 : pool->thread_count;
+	size_t chunk_count = (size_t)(end - begin) / CSV_CHUNK_BYTES + 1;
+	if (chunk_count < (size_t)workers * CSV_CHUNKS_PER_WORKER && pool != NULL)
+	{
+		chunk_count = (size_t)workers * CSV_CHUNKS_PER_WORKER;
+	}
+	struct csv_chunk* chunks = calloc(chunk_count, sizeof(struct csv_chunk));
+	if (chunks == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return false;
+	}
+	size_t chunk_bytes = (size_t)(end - begin) / chunk_count + 1;
+	const char* chunk_begin = begin;
+	for (size_t i = 0; i < chunk_count; i++)
+	{
+		chunks[i].begin = chunk_begin;
+		chunks[i].end = i == chunk_count - 1 ? end : csv_next_line(data, chunk_begin + chunk_bytes < end ? chunk_begin + chunk_bytes : end, end);
+		chunk_begin = chunks[i].end;
+	}
+
+	struct csv_job job = { data, end, chunks, campuses };
+
+	// Count lines to give each chunk its own slots after the rows already in the table
+	if (pool == NULL)
+	{
+		for (size_t i = 0; i < chunk_count; i++)
+		{
+			csv_count_chunk(&job, i, 0);
+		}
+	}
+	else
+	{
+		worker_pool_run(pool, csv_count_chunk, &job, chunk_count);
+	}
+	size_t slots = campuses->count;
+	for (size_t i = 0; i < chunk_count; i++)
+	{
+		chunks[i].first_row = slots;
+		slots += chunks[i].lines;
+	}
+	if (!campus_table_reserve(campuses, slots))
+	{
+		free(chunks);
+		return false;
+	}
+
+	// Parse every chunk into its slots
+	if (pool == NULL)
+	{
+		for (size_t i = 0; i < chunk_count; i++)
+		{
+			csv_parse_chunk(&job, i, 0);
+		}
+	}
+	else
+	{
+		worker_pool_run(pool, csv_parse_chunk, &job, chunk_count);
+	}
+
+	// Close the gaps left by skipped lines and total the counts
+	struct csv_ingest_stats totals = { length, 0, 0, 0 };
+	size_t row = campuses->count;
+	for (size_t i = 0; i < chunk_count; i++)
+	{
+		if (row != chunks[i].first_row && chunks[i].rows != 0)
+		{
+			memmove(campuses->initial_enrollments + row, campuses->initial_enrollments + chunks[i].first_row, chunks[i].rows * sizeof(int));
+			memmove(campuses->target_enrollments + row, campuses->target_enrollments + chunks[i].first_row, chunks[i].rows * sizeof(int));
+			memmove(campuses->initial_years + row, campuses->initial_years + chunks[i].first_row, chunks[i].rows * sizeof(int));
+			memmove(campuses->target_years + row, campuses->target_years + chunks[i].first_row, chunks[i].rows * sizeof(int));
+		}
+		row += chunks[i].rows;
+
+		if (chunks[i].malformed_rows != 0 && totals.malformed_rows == 0)
+		{
+			totals.first_malformed_offset = chunks[i].first_malformed_offset;
+		}
+		totals.malformed_rows += chunks[i].malformed_rows;
+	}
+	totals.rows = row - campuses->count;
+	campuses->count = row;
+	if (stats != NULL)
+	{
+		*stats = totals;
+	}
+
+	free(chunks);
+
+	return true;
+}
+
+bool load_campus_csv(const char* path, struct worker_pool* pool, struct campus_table* campuses, struct csv_ingest_stats* stats)
+{
+	// Open the file and find its size
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Could not open %s: %s.\n", path, strerror(errno));
+		return false;
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0)
+	{
+		fprintf(stderr, "Could not get size of %s: %s.\n", path, strerror(errno));
+		close(fd);
+		return false;
+	}
+
+	// An empty file cannot be mapped and has no rows
+	size_t length = (size_t)status.st_size;
+	if (length == 0)
+	{
+		close(fd);
+		return parse_campus_csv("", 0, pool, campuses, stats);
+	}
+
+	// Map the file read-only; the mapping stays valid after the descriptor is closed
+	char* data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		fprintf(stderr, "Could not map %s: %s.\n", path, strerror(errno));
+		return false;
+	}
+	madvise(data, length, MADV_WILLNEED);
+
+	bool result = parse_campus_csv(data, length, pool, campuses, stats);
+	munmap(data, length);
+
+	return result;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file ingest_hw1_wvuep.h
+ * @brief Header file for memory-mapped CSV ingest of campus enrollment histories for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * Each CSV row holds one campus as four integers in the order calculate_growth_rate takes them:
+ *
+ *     initial_enrollment,target_enrollment,initial_year,target_year
+ *
+ * Rows end with "\n" or "\r\n", and the last row may have no line ending. A first line that
+ * does not start with a digit or '-' is taken as a header and skipped, as are blank lines.
+ * Rows are parsed straight from the mapped file into the columns of a campus table, which
+ * project_campuses or calculate_growth_rates can use directly.
+ */
+
+#pragma once
+
+#include "engine_hw1_wvuep.h"
+#include "pool_hw1_wvuep.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Smallest number of bytes in one parsing chunk
+ */
+#ifndef CSV_CHUNK_BYTES
+	#define CSV_CHUNK_BYTES (4 * 1024 * 1024)
+#endif
+
+/**
+ * @brief Counts collected while ingesting a CSV file
+ */
+struct csv_ingest_stats {
+	size_t bytes; /**< Number of bytes read */
+	size_t rows; /**< Number of rows added to the campus table */
+	size_t malformed_rows; /**< Number of non-blank rows that were not four integers */
+	size_t first_malformed_offset; /**< Byte offset of the first malformed row, if there is one */
+};
+
+/**
+ * @brief Parse CSV text and append its rows to a campus table
+ *
+ * Rows are kept in file order. Malformed rows are skipped and counted in stats.
+ *
+ * @param data CSV text, which does not need to be null-terminated
+ * @param length Number of bytes of CSV text
+ * @param pool Pool to parse on, or NULL to parse on the calling thread
+ * @param campuses Initialized table to append rows to
+ * @param stats Counts for the text, or NULL
+ * @return True on success, false if memory could not be allocated
+ */
+bool parse_campus_csv(const char* data, size_t length, struct worker_pool* pool, struct campus_table* campuses, struct csv_ingest_stats* stats);
+
+/**
+ * @brief Map a CSV file into memory and append its rows to a campus table
+ * @param path Path of the CSV file
+ * @param pool Pool to parse on, or NULL to parse on the calling thread
+ * @param campuses Initialized table to append rows to
+ * @param stats Counts for the file, or NULL
+ * @return True on success, false if the file could not be mapped or memory could not be allocated
+ */
+bool load_campus_csv(const char* path, struct worker_pool* pool, struct campus_table* campuses, struct csv_ingest_stats* stats);
@@ -0,0 +1,446 @@
+/**
+ * @file microbench_hw1_wvuep.c
+ * @brief Microbenchmarks for the functions of hw1_wvuep.h for CS 350 Homework #1: WVU Enrollment Problem
+ * @author Rashaan Clay
+ *
+ * Build together with hw1_wvuep.c only, without main_hw1_wvuep.c. Each benchmark calls one
+ * function of hw1_wvuep.h many times per run, after a few warmup runs that are not recorded, and
+ * reports the median time per call with the median absolute deviation (MAD) over the runs. Unlike
+ * the fastest run kept by bench_hw1_wvuep.c, the median and MAD are stable enough under noise to
+ * compare versions, so results can be appended to a CSV file under a label for each version.
+ *
+ * Usage: microbench [--runs N] [--warmup N] [--csv PATH] [--label NAME]
+ *
+ * PATH "-" writes the CSV to stdout; otherwise rows are appended to PATH, with a header if the
+ * file is empty.
+ */
+
+// Use GNU source for clock_gettime and memfd_create
+#define _GNU_SOURCE // NOLINT(*-reserved-identifier)
+
+#include "hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/**
+ * @brief Number of recorded runs of each benchmark when --runs is not given
+ */
+#define MICROBENCH_DEFAULT_RUNS 25
+
+/**
+ * @brief Number of unrecorded warmup runs of each benchmark when --warmup is not given
+ */
+#define MICROBENCH_DEFAULT_WARMUP 3
+
+/**
+ * @brief Number of random scenarios cycled through by the scalar benchmarks, a power of 2
+ */
+#define MICROBENCH_SCENARIOS 4096
+
+/**
+ * @brief Initial year of every scenario
+ */
+#define MICROBENCH_INITIAL_YEAR 2024
+
+/**
+ * @brief Last year printed by the print_enrollment_estimates benchmarks
+ */
+#define MICROBENCH_PRINT_END_YEAR 2054
+
+/**
+ * @brief Where stdout goes while a benchmark runs
+ */
+enum microbench_output {
+	MICROBENCH_OUTPUT_NONE, /**< Left alone; the benchmark prints nothing */
+	MICROBENCH_OUTPUT_DEV_NULL, /**< Redirected to /dev/null */
+	MICROBENCH_OUTPUT_MEMFD /**< Redirected to an anonymous memory file, emptied before each run */
+};
+
+/**
+ * @brief One benchmarked function
+ */
+struct microbench_case {
+	const char* name; /**< Name reported in the table and the CSV, without commas */
+	size_t calls; /**< Number of calls per run */
+	enum microbench_output output; /**< Destination of stdout during the runs */
+	void (*run)(size_t calls); /**< Makes the calls */
+};
+
+/**
+ * @brief Summary of the recorded runs of one benchmark, in nanoseconds per call
+ */
+struct microbench_result {
+	double median; /**< Median over the runs */
+	double mad; /**< Median absolute deviation from the median */
+	double min; /**< Fastest run */
+	double max; /**< Slowest run */
+};
+
+/**
+ * @brief Random scenarios shared by the scalar benchmarks, filled once before any run
+ */
+static struct {
+	int initial_enrollments[MICROBENCH_SCENARIOS]; /**< Enrollment in the initial year */
+	int target_enrollments[MICROBENCH_SCENARIOS]; /**< Target enrollment */
+	int target_years[MICROBENCH_SCENARIOS]; /**< Target or estimate year */
+	double growth_rates[MICROBENCH_SCENARIOS]; /**< Growth rates spread over every description */
+} microbench_scenarios;
+
+/**
+ * @brief Accumulates every result so the compiler cannot drop the calls
+ */
+static volatile double microbench_sink;
+
+/**
+ * @brief Get the current time from a monotonic clock
+ * @return Time in seconds
+ */
+static double microbench_get_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Fill the shared scenarios with planning-sweep style values
+ */
+static void microbench_fill_scenarios(void)
+{
+	for (size_t i = 0; i < MICROBENCH_SCENARIOS; i++)
+	{
+		microbench_scenarios.initial_enrollments[i] = rand() % 30000 + 10000; // NOLINT(*-msc50-cpp)
+		microbench_scenarios.target_enrollments[i] = rand() % 60000 + 1000; // NOLINT(*-msc50-cpp)
+		microbench_scenarios.target_years[i] = MICROBENCH_INITIAL_YEAR + rand() % 50 + 1; // NOLINT(*-msc50-cpp)
+		microbench_scenarios.growth_rates[i] = (double)(rand() % 800 - 200) * 1e-4; // NOLINT(*-msc50-cpp)
+	}
+}
+
+/**
+ * @brief Call calculate_growth_rate
+ * @param calls Number of calls
+ */
+static void microbench_calculate_growth_rate(size_t calls)
+{
+	double sum = 0.0;
+	for (size_t i = 0; i < calls; i++)
+	{
+		size_t s = i & (MICROBENCH_SCENARIOS - 1);
+		sum += calculate_growth_rate(microbench_scenarios.initial_enrollments[s], microbench_scenarios.target_enrollments[s], MICROBENCH_INITIAL_YEAR, microbench_scenarios.target_years[s]);
+	}
+	microbench_sink += sum;
+}
+
+/**
+ * @brief Call calculate_enrollment_estimate
+ * @param calls Number of calls
+ */
+static void microbench_calculate_enrollment_estimate(size_t calls)
+{
+	long long sum = 0;
+	for (size_t i = 0; i < calls; i++)
+	{
+		size_t s = i & (MICROBENCH_SCENARIOS - 1);
+		sum += calculate_enrollment_estimate(microbench_scenarios.initial_enrollments[s], microbench_scenarios.growth_rates[s], MICROBENCH_INITIAL_YEAR, microbench_scenarios.target_years[s]);
+	}
+	microbench_sink += (double)sum;
+}
+
+/**
+ * @brief Call get_growth_rate_description
+ * @param calls Number of calls
+ */
+static void microbench_get_growth_rate_description(size_t calls)
+{
+	size_t sum = 0;
+	for (size_t i = 0; i < calls; i++)
+	{
+		sum += (unsigned char)get_growth_rate_description(microbench_scenarios.growth_rates[i & (MICROBENCH_SCENARIOS - 1)])[0];
+	}
+	microbench_sink += (double)sum;
+}
+
+/**
+ * @brief Call print_enrollment_estimates for one campus table each
+ * @param calls Number of calls
+ */
+static void microbench_print_enrollment_estimates(size_t calls)
+{
+	for (size_t i = 0; i < calls; i++)
+	{
+		size_t s = i & (MICROBENCH_SCENARIOS - 1);
+		print_enrollment_estimates(microbench_scenarios.initial_enrollments[s], microbench_scenarios.growth_rates[s], MICROBENCH_INITIAL_YEAR, MICROBENCH_PRINT_END_YEAR);
+	}
+}
+
+/**
+ * @brief Benchmarks in the order they run
+ */
+static const struct microbench_case microbench_cases[] = {
+	{ "calculate_growth_rate", 200000, MICROBENCH_OUTPUT_NONE, microbench_calculate_growth_rate },
+	{ "calculate_enrollment_estimate", 200000, MICROBENCH_OUTPUT_NONE, microbench_calculate_enrollment_estimate },
+	{ "get_growth_rate_description", 1000000, MICROBENCH_OUTPUT_NONE, microbench_get_growth_rate_description },
+	{ "print_enrollment_estimates>/dev/null", 200, MICROBENCH_OUTPUT_DEV_NULL, microbench_print_enrollment_estimates },
+	{ "print_enrollment_estimates>memfd", 200, MICROBENCH_OUTPUT_MEMFD, microbench_print_enrollment_estimates },
+};
+
+/**
+ * @brief Compare two doubles for qsort
+ * @param a First double
+ * @param b Second double
+ * @return Negative, zero or positive as a is less than, equal to or greater than b
+ */
+static int microbench_compare_doubles(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Find the median of an array, sorting it
+ * @param values Values to sort
+ * @param count Number of values, greater than 0
+ * @return Median, the mean of the middle two for an even count
+ */
+static double microbench_median(double* values, size_t count)
+{
+	qsort(values, count, sizeof(double), microbench_compare_doubles);
+	return count % 2 == 1 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2.0;
+}
+
+/**
+ * @brief Summarize the time per call of the recorded runs
+ * @param samples Nanoseconds per call of each run, reordered
+ * @param runs Number of runs, greater than 0
+ * @param result Receives the summary
+ */
+static void microbench_summarize(double* samples, size_t runs, struct microbench_result* result)
+{
+	// Sorting for the median also gives the extremes
+	result->median = microbench_median(samples, runs);
+	result->min = samples[0];
+	result->max = samples[runs - 1];
+
+	// The MAD is the median of the distances from the median
+	for (size_t i = 0; i < runs; i++)
+	{
+		samples[i] = samples[i] > result->median ? samples[i] - result->median : result->median - samples[i];
+	}
+	result->mad = microbench_median(samples, runs);
+}
+
+/**
+ * @brief Run one benchmark with its warmup and recorded runs
+ * @param bench Benchmark to run
+ * @param warmup Number of unrecorded runs
+ * @param runs Number of recorded runs, greater than 0
+ * @param result Receives the summary
+ * @return True on success, false if memory could not be allocated or stdout could not be redirected
+ */
+static bool microbench_run_case(const struct microbench_case* bench, size_t warmup, size_t runs, struct microbench_result* result)
+{
+	double* samples = malloc(runs * sizeof(double));
+	if (samples == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return false;
+	}
+
+	// Send stdout to the benchmark's destination while timing
+	int output_fd = -1;
+	int saved_stdout = -1;
+	if (bench->output != MICROBENCH_OUTPUT_NONE)
+	{
+		output_fd = bench->output == MICROBENCH_OUTPUT_MEMFD ? memfd_create("microbench_hw1_wvuep", MFD_CLOEXEC) : open("/dev/null", O_WRONLY | O_CLOEXEC);
+		saved_stdout = dup(STDOUT_FILENO);
+		if (output_fd < 0 || saved_stdout < 0 || dup2(output_fd, STDOUT_FILENO) < 0)
+		{
+			fprintf(stderr, "Could not redirect output: %s.\n", strerror(errno));
+			if (output_fd >= 0)
+			{
+				close(output_fd);
+			}
+			if (saved_stdout >= 0)
+			{
+				close(saved_stdout);
+			}
+			free(samples);
+			return false;
+		}
+	}
+
+	// Time every run, recording the ones after the warmup
+	for (size_t run = 0; run < warmup + runs; run++)
+	{
+		// Empty the memory file so every run writes to the same fresh pages
+		if (bench->output == MICROBENCH_OUTPUT_MEMFD)
+		{
+			(void)ftruncate(output_fd, 0);
+			lseek(output_fd, 0, SEEK_SET);
+		}
+
+		double start = microbench_get_time();
+		bench->run(bench->calls);
+		double elapsed = microbench_get_time() - start;
+		if (run >= warmup)
+		{
+			samples[run - warmup] = elapsed / (double)bench->calls * 1e9;
+		}
+	}
+
+	// Redirect output to original destination
+	if (bench->output != MICROBENCH_OUTPUT_NONE)
+	{
+		fflush(stdout);
+		dup2(saved_stdout, STDOUT_FILENO);
+		close(saved_stdout);
+		close(output_fd);
+	}
+
+	microbench_summarize(samples, runs, result);
+	free(samples);
+	return true;
+}
+
+/**
+ * @brief Parse a count given on the command line
+ * @param text Argument text
+ * @param minimum Smallest count accepted
+ * @param value Receives the count
+ * @return True if text is a whole number of at least minimum
+ */
+static bool microbench_parse_count(const char* text, long minimum, size_t* value)
+{
+	char* end;
+	errno = 0;
+	long parsed = strtol(text, &end, 10);
+	if (errno != 0 || end == text || *end != '\0' || parsed < minimum)
+	{
+		return false;
+	}
+	*value = (size_t)parsed;
+	return true;
+}
+
+/**
+ * @brief Print the command line syntax
+ * @param program Name the program was run as
+ */
+static void microbench_print_usage(const char* program)
+{
+	fprintf(stderr, "Usage: %s [--runs N] [--warmup N] [--csv PATH] [--label NAME]\n", program);
+}
+
+/**
+ * @brief Program entry point
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Status code
+ */
+int main(int argc, char** argv)
+{
+	size_t runs = MICROBENCH_DEFAULT_RUNS;
+	size_t warmup = MICROBENCH_DEFAULT_WARMUP;
+	const char* csv_path = NULL;
+	const char* label = "current";
+
+	// Read options, each followed by its value
+	for (int i = 1; i < argc; i++)
+	{
+		const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+		bool valid = value != NULL;
+		if (valid && strcmp(argv[i], "--runs") == 0)
+		{
+			valid = microbench_parse_count(value, 1, &runs);
+		}
+		else if (valid && strcmp(argv[i], "--warmup") == 0)
+		{
+			valid = microbench_parse_count(value, 0, &warmup);
+		}
+		else if (valid && strcmp(argv[i], "--csv") == 0)
+		{
+			csv_path = value;
+		}
+		else if (valid && strcmp(argv[i], "--label") == 0 && strchr(value, ',') == NULL)
+		{
+			label = value;
+		}
+		else
+		{
+			valid = false;
+		}
+
+		if (!valid)
+		{
+			microbench_print_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		i++;
+	}
+
+	// Turn off buffering like run_tests does, so printed output costs what it does in the program
+	setbuf(stdout, NULL);
+	setbuf(stderr, NULL);
+
+	// Seed random number generator with a fixed value so runs are comparable
+	srand(350);
+	microbench_fill_scenarios();
+
+	// Open the CSV file, appending to earlier versions' rows
+	FILE* csv = NULL;
+	if (csv_path != NULL)
+	{
+		csv = strcmp(csv_path, "-") == 0 ? stdout : fopen(csv_path, "a");
+		if (csv == NULL)
+		{
+			fprintf(stderr, "Could not open %s: %s.\n", csv_path, strerror(errno));
+			return EXIT_FAILURE;
+		}
+		if (csv == stdout || (fseek(csv, 0, SEEK_END) == 0 && ftell(csv) == 0))
+		{
+			fputs("label,benchmark,calls,runs,median_ns,mad_ns,min_ns,max_ns\n", csv);
+		}
+	}
+
+	// Keep the table off stdout when the CSV goes there
+	FILE* report = csv == stdout ? stderr : stdout;
+	fprintf(report, "%zu runs after %zu warmup runs, in ns/call\n", runs, warmup);
+	fprintf(report, "%-38s %12s %10s %7s %12s\n", "Benchmark", "Median", "MAD", "MAD %", "Min");
+
+	// Run every benchmark, reporting as each one finishes
+	bool succeeded = true;
+	for (size_t i = 0; i < sizeof(microbench_cases) / sizeof(microbench_cases[0]); i++)
+	{
+		const struct microbench_case* bench = &microbench_cases[i];
+		struct microbench_result result;
+		if (!microbench_run_case(bench, warmup, runs, &result))
+		{
+			succeeded = false;
+			continue;
+		}
+
+		fprintf(report, "%-38s %12.2f %10.2f %6.2f%% %12.2f\n", bench->name, result.median, result.mad, result.mad / result.median * 100.0, result.min);
+		if (csv != NULL)
+		{
+			fprintf(csv, "%s,%s,%zu,%zu,%.3f,%.3f,%.3f,%.3f\n", label, bench->name, bench->calls, runs, result.median, result.mad, result.min, result.max);
+		}
+	}
+
+	// Close the CSV file
+	if (csv != NULL && csv != stdout && fclose(csv) != 0)
+	{
+		fprintf(stderr, "Could not write %s: %s.\n", csv_path, strerror(errno));
+		succeeded = false;
+	}
+
+	return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
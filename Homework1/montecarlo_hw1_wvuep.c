@@ -0,0 +1,319 @@
+/**
+ * @file montecarlo_hw1_wvuep.c
+ * @brief Source code file for Monte Carlo uncertainty bands for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * Paths are simulated in log space, so each year adds one normal draw to a running log
+ * enrollment and no pow or exp is needed per sample. Random numbers come from Philox4x32-10
+ * with the seed as key and (path, year pair) as counter; one call yields two uniforms, which
+ * Box-Muller turns into the draws for two consecutive years.
+ *
+ * Paths are split into blocks of MONTE_CARLO_BLOCK_PATHS. A task walks its block one year at a
+ * time, keeping the block's log enrollments in an array, and counts each one into its worker's
+ * sketch for that year. A sketch is a histogram over log enrollment with buckets of width
+ * log((1 + a) / (1 - a)), where a is MONTE_CARLO_RELATIVE_ACCURACY, so reporting a bucket's
+ * midpoint in relative terms is within a of every value in it. Sketches are merged by adding
+ * counts, which gives the same result whatever the order.
+ */
+
+#include "montecarlo_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+/**
+ * @brief 2 pi, spelled out because M_PI is not standard C
+ */
+#define MONTE_CARLO_TWO_PI 6.283185307179586
+
+/**
+ * @brief Multiplier of the first Philox word
+ */
+#define PHILOX_M0 0xD2511F53u
+
+/**
+ * @brief Multiplier of the second Philox word
+ */
+#define PHILOX_M1 0xCD9E8D57u
+
+/**
+ * @brief Key increment for the first key word (golden ratio)
+ */
+#define PHILOX_W0 0x9E3779B9u
+
+/**
+ * @brief Key increment for the second key word (sqrt(3) - 1)
+ */
+#define PHILOX_W1 0xBB67AE85u
+
+/**
+ * @brief Number of Philox rounds
+ */
+#define PHILOX_ROUNDS 10
+
+/**
+ * @brief Data shared by the tasks of one simulation
+ */
+struct monte_carlo_job {
+	double initial_log; /**< Log of the initial enrollment */
+	double drift; /**< Mean of each year's log growth factor */
+	double volatility; /**< Standard deviation of each year's log growth factor */
+	size_t simulated_years; /**< Number of years after the initial year */
+	size_t path_count; /**< Number of paths */
+	uint32_t key[2]; /**< Philox key made from the seed */
+	size_t bucket_count; /**< Number of buckets in a sketch */
+	double inverse_bucket_width; /**< Buckets per unit of log enrollment */
+	uint32_t* sketches; /**< Per worker, per simulated year, bucket_count counts */
+};
+
+void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4])
+{
+	uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+	uint32_t k0 = key[0], k1 = key[1];
+
+	// Each round multiplies two words, mixes the halves of the products with the key and bumps the key
+	for (int round = 0; round < PHILOX_ROUNDS; round++)
+	{
+		uint64_t product0 = (uint64_t)PHILOX_M0 * c0;
+		uint64_t product1 = (uint64_t)PHILOX_M1 * c2;
+		c0 = (uint32_t)(product1 >> 32) ^ c1 ^ k0;
+		c1 = (uint32_t)product1;
+		c2 = (uint32_t)(product0 >> 32) ^ c3 ^ k1;
+		c3 = (uint32_t)product0;
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+
+	output[0] = c0;
+	output[1] = c1;
+	output[2] = c2;
+	output[3] = c3;
+}
+
+/**
+ * @brief Draw two independent standard normal values for one path and year pair
+ * @param key Philox key made from the seed
+ * @param path Path index
+ * @param pair Index of the pair of years
+ * @param normals Two normal values
+ */
+static inline void monte_carlo_normals(const uint32_t key[2], size_t path, size_t pair, double normals[2])
+{
+	uint32_t counter[4] = { (uint32_t)path, (uint32_t)((uint64_t)path >> 32), (uint32_t)pair, (uint32_t)((uint64_t)pair >> 32) };
+	uint32_t words[4];
+	philox4x32(counter, key, words);
+
+	// Build uniforms from 53 bits each, the first in (0, 1] so its log is finite
+	uint64_t bits0 = ((uint64_t)words[0] << 32 | words[1]) >> 11;
+	uint64_t bits1 = ((uint64_t)words[2] << 32 | words[3]) >> 11;
+	double uniform0 = (double)(bits0 + 1) * 0x1.0p-53;
+	double uniform1 = (double)bits1 * 0x1.0p-53;
+
+	// Box-Muller transform
+	double radius = sqrt(-2.0 * log(uniform0));
+	double angle = MONTE_CARLO_TWO_PI * uniform1;
+	normals[0] = radius * cos(angle);
+	normals[1] = radius * sin(angle);
+}
+
+/**
+ * @brief Count a log enrollment into a sketch
+ * @param job Simulation data
+ * @param sketch Sketch for one year
+ * @param log_enrollment Log enrollment to count
+ */
+static inline void monte_carlo_count(const struct monte_carlo_job* job, uint32_t* sketch, double log_enrollment)
+{
+	double position = (log_enrollment - MONTE_CARLO_MIN_LOG) * job->inverse_bucket_width;
+	if (position < 0.0)
+	{
+		position = 0.0;
+	}
+	if (position > (double)(job->bucket_count - 1))
+	{
+		position = (double)(job->bucket_count - 1);
+	}
+	sketch[(size_t)position]++;
+}
+
+/**
+ * @brief Simulate one block of paths and count them into the worker's sketches
+ * @param context Pointer to the monte_carlo_job
+ * @param task_index Index of the block
+ * @param worker_index Index of the worker, selecting its sketches
+ */
+static void simulate_path_block(void* context, size_t task_index, unsigned int worker_index)
+{
+	const struct monte_carlo_job* job = context;
+	uint32_t* sketches = job->sketches + (size_t)worker_index * job->simulated_years * job->bucket_count;
+
+	// Find the paths in this block
+	size_t first_path = task_index * MONTE_CARLO_BLOCK_PATHS;
+	size_t path_count = job->path_count - first_path;
+	if (path_count > MONTE_CARLO_BLOCK_PATHS)
+	{
+		path_count = MONTE_CARLO_BLOCK_PATHS;
+	}
+
+	// Every path starts at the initial enrollment
+	double log_enrollments[MONTE_CARLO_BLOCK_PATHS];
+	for (size_t i = 0; i < path_count; i++)
+	{
+		log_enrollments[i] = job->initial_log;
+	}
+
+	// Advance the block two years at a time, so only two years' sketches are in use at once
+	for (size_t year = 0; year < job->simulated_years; year += 2)
+	{
+		uint32_t* first_sketch = sketches + year * job->bucket_count;
+		uint32_t* second_sketch = year + 1 < job->simulated_years ? first_sketch + job->bucket_count : NULL;
+		for (size_t i = 0; i < path_count; i++)
+		{
+			double normals[2];
+			monte_carlo_normals(job->key, first_path + i, year / 2, normals);
+
+			double log_enrollment = log_enrollments[i] + job->drift + job->volatility * normals[0];
+			monte_carlo_count(job, first_sketch, log_enrollment);
+			if (second_sketch != NULL)
+			{
+				log_enrollment += job->drift + job->volatility * normals[1];
+				monte_carlo_count(job, second_sketch, log_enrollment);
+			}
+			log_enrollments[i] = log_enrollment;
+		}
+	}
+}
+
+/**
+ * @brief Find a quantile in a merged sketch
+ * @param sketch Counts of one year
+ * @param bucket_count Number of buckets
+ * @param bucket_width Width of a bucket in log enrollment
+ * @param rank Rank of the value to find, from 1 to the number of paths
+ * @return Value representing the bucket holding that rank
+ */
+static double monte_carlo_quantile(const uint32_t* sketch, size_t bucket_count, double bucket_width, uint64_t rank)
+{
+	// Walk the cumulative counts up to the rank
+	uint64_t seen = 0;
+	size_t bucket = 0;
+	while (bucket < bucket_count - 1)
+	{
+		seen += sketch[bucket];
+		if (seen >= rank)
+		{
+			break;
+		}
+		bucket++;
+	}
+
+	// A bucket covers [e^lower, gamma e^lower), as its index is a floor; 2 gamma e^lower / (gamma + 1) is within the relative accuracy of both ends
+	double gamma = exp(bucket_width);
+	return exp(MONTE_CARLO_MIN_LOG + (double)bucket * bucket_width) * 2.0 * gamma / (gamma + 1.0);
+}
+
+/**
+ * @brief Get the rank of a quantile among a number of values
+ * @param quantile Quantile between 0 and 1
+ * @param count Number of values
+ * @return Rank from 1 to count
+ */
+static uint64_t monte_carlo_rank(double quantile, size_t count)
+{
+	uint64_t rank = (uint64_t)ceil(quantile * (double)count);
+	return rank == 0 ? 1 : rank;
+}
+
+bool simulate_enrollment_bands(struct worker_pool* pool, int initial_enrollment, double growth_rate, int initial_year, int end_year, double volatility, size_t path_count, uint64_t seed, struct enrollment_bands* bands)
+{
+	memset(bands, 0, sizeof(*bands));
+
+	// Check the parameters
+	if (initial_enrollment <= 0 || !(growth_rate > -1.0) || !isfinite(growth_rate) || end_year < initial_year || !(volatility >= 0.0) || !isfinite(volatility) || path_count == 0 || path_count > UINT32_MAX)
+	{
+		fprintf(stderr, "Could not simulate enrollment bands: invalid parameters.\n");
+		return false;
+	}
+
+	// Allocate the bands and one set of sketches per worker
+	struct monte_carlo_job job;
+	memset(&job, 0, sizeof(job));
+	double bucket_width = log((1.0 + MONTE_CARLO_RELATIVE_ACCURACY) / (1.0 - MONTE_CARLO_RELATIVE_ACCURACY));
+	unsigned int worker_count = pool == NULL ? 1 : pool->thread_count;
+	bands->first_year = initial_year;
+	bands->year_count = (size_t)((long long)end_year - initial_year + 1);
+	job.simulated_years = bands->year_count - 1;
+	job.bucket_count = (size_t)ceil((MONTE_CARLO_MAX_LOG - MONTE_CARLO_MIN_LOG) / bucket_width) + 1;
+	job.sketches = calloc((size_t)worker_count * job.simulated_years * job.bucket_count + 1, sizeof(uint32_t));
+	bands->p5 = malloc(bands->year_count * sizeof(double));
+	bands->p50 = malloc(bands->year_count * sizeof(double));
+	bands->p95 = malloc(bands->year_count * sizeof(double));
+	if (job.sketches == NULL || bands->p5 == NULL || bands->p50 == NULL || bands->p95 == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		free(job.sketches);
+		enrollment_bands_free(bands);
+		return false;
+	}
+
+	// Simulate every block of paths
+	job.initial_log = log((double)initial_enrollment);
+	job.drift = log1p(growth_rate);
+	job.volatility = volatility;
+	job.path_count = path_count;
+	job.key[0] = (uint32_t)seed;
+	job.key[1] = (uint32_t)(seed >> 32);
+	job.inverse_bucket_width = 1.0 / bucket_width;
+	size_t block_count = (path_count + MONTE_CARLO_BLOCK_PATHS - 1) / MONTE_CARLO_BLOCK_PATHS;
+	if (job.simulated_years > 0)
+	{
+		if (pool == NULL)
+		{
+			for (size_t i = 0; i < block_count; i++)
+			{
+				simulate_path_block(&job, i, 0);
+			}
+		}
+		else
+		{
+			worker_pool_run(pool, simulate_path_block, &job, block_count);
+		}
+	}
+
+	// Merge the workers' sketches into the first worker's
+	size_t sketch_size = job.simulated_years * job.bucket_count;
+	for (unsigned int worker = 1; worker < worker_count; worker++)
+	{
+		const uint32_t* sketches = job.sketches + (size_t)worker * sketch_size;
+		for (size_t i = 0; i < sketch_size; i++)
+		{
+			job.sketches[i] += sketches[i];
+		}
+	}
+
+	// The initial year is known exactly; read the later years from the sketches
+	bands->p5[0] = bands->p50[0] = bands->p95[0] = initial_enrollment;
+	uint64_t ranks[3] = { monte_carlo_rank(0.05, path_count), monte_carlo_rank(0.50, path_count), monte_carlo_rank(0.95, path_count) };
+	for (size_t year = 0; year < job.simulated_years; year++)
+	{
+		const uint32_t* sketch = job.sketches + year * job.bucket_count;
+		bands->p5[year + 1] = monte_carlo_quantile(sketch, job.bucket_count, bucket_width, ranks[0]);
+		bands->p50[year + 1] = monte_carlo_quantile(sketch, job.bucket_count, bucket_width, ranks[1]);
+		bands->p95[year + 1] = monte_carlo_quantile(sketch, job.bucket_count, bucket_width, ranks[2]);
+	}
+
+	free(job.sketches);
+
+	return true;
+}
+
+void enrollment_bands_free(struct enrollment_bands* bands)
+{
+	free(bands->p5);
+	free(bands->p50);
+	free(bands->p95);
+	memset(bands, 0, sizeof(*bands));
+}
@@ -0,0 +1,86 @@
+/**
+ * @file montecarlo_hw1_wvuep.h
+ * @brief Header file for Monte Carlo uncertainty bands for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * Simulates enrollment paths whose annual growth factor varies around 1 + growth_rate and
+ * reports the 5th, 50th and 95th percentile enrollment for each year. Each year's log growth
+ * factor is normally distributed with mean log(1 + growth_rate) and standard deviation
+ * volatility, so the median path follows calculate_enrollment_estimate.
+ *
+ * Results depend only on the seed and the inputs, never on the number of threads: every path
+ * draws its random numbers from a counter-based generator keyed by the seed and indexed by
+ * path and year, and the quantile sketches are merged by adding integer counts.
+ */
+
+#pragma once
+
+#include "pool_hw1_wvuep.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Relative accuracy of the quantile sketch (0.5%)
+ *
+ * Each reported percentile is within this relative distance of the matching order statistic
+ * of the simulated enrollments.
+ */
+#define MONTE_CARLO_RELATIVE_ACCURACY 0.005
+
+/**
+ * @brief Smallest log enrollment the sketch resolves; smaller values count in the first bucket
+ */
+#define MONTE_CARLO_MIN_LOG -8.0
+
+/**
+ * @brief Largest log enrollment the sketch resolves; larger values count in the last bucket
+ */
+#define MONTE_CARLO_MAX_LOG 29.0
+
+/**
+ * @brief Number of paths simulated by one task
+ */
+#ifndef MONTE_CARLO_BLOCK_PATHS
+	#define MONTE_CARLO_BLOCK_PATHS 4096
+#endif
+
+/**
+ * @brief Percentile bands for each year of a simulation
+ */
+struct enrollment_bands {
+	int first_year; /**< Year of the first entry, the initial year */
+	size_t year_count; /**< Number of years */
+	double* p5; /**< 5th percentile enrollment for each year */
+	double* p50; /**< Median enrollment for each year */
+	double* p95; /**< 95th percentile enrollment for each year */
+};
+
+/**
+ * @brief Simulate enrollment paths and compute percentile bands for each year
+ * @param pool Pool to simulate on, or NULL to simulate on the calling thread
+ * @param initial_enrollment Enrollment in initial_year, greater than 0
+ * @param growth_rate Required annual growth rate, greater than -1
+ * @param initial_year Year for initial enrollment
+ * @param end_year Last year to report, not before initial_year
+ * @param volatility Standard deviation of each year's log growth factor
+ * @param path_count Number of paths to simulate, from 1 to UINT32_MAX
+ * @param seed Seed selecting the random numbers
+ * @param bands Bands to fill; free with enrollment_bands_free
+ * @return True on success, false if the parameters are invalid or memory could not be allocated
+ */
+bool simulate_enrollment_bands(struct worker_pool* pool, int initial_enrollment, double growth_rate, int initial_year, int end_year, double volatility, size_t path_count, uint64_t seed, struct enrollment_bands* bands);
+
+/**
+ * @brief Free the arrays of percentile bands
+ * @param bands Bands to free
+ */
+void enrollment_bands_free(struct enrollment_bands* bands);
+
+/**
+ * @brief Generate four random 32-bit words with the Philox4x32-10 counter-based generator
+ * @param counter Counter selecting the output, such as a path and year
+ * @param key Key selecting the stream, such as a seed
+ * @param output Four random words
+ */
+void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4]);
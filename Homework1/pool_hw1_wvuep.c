@@ -0,0 +1,185 @@
+/**
+ * @file pool_hw1_wvuep.c
+ * @brief Source code file for the worker thread pool used by the CS 350 Homework #1 engines
+ * @author Rashaan Clay
+ */
+
+#include "pool_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+/**
+ * @brief Arguments for a pool thread
+ */
+struct worker_thread_arguments {
+	struct worker_pool* pool; /**< Pool the thread belongs to */
+	unsigned int worker_index; /**< Index of the thread's worker */
+};
+
+unsigned int worker_pool_default_thread_count(void)
+{
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return processors > 0 ? (unsigned int)processors : 1;
+}
+
+/**
+ * @brief Run tasks from the current run until none are left
+ * @param pool Pool to take tasks from
+ * @param worker_index Index of the worker running the tasks
+ */
+static void worker_pool_drain(struct worker_pool* pool, unsigned int worker_index)
+{
+	size_t task_index;
+	while ((task_index = atomic_fetch_add_explicit(&pool->next_task, 1, memory_order_relaxed)) < pool->task_count)
+	{
+		pool->task(pool->context, task_index, worker_index);
+	}
+}
+
+/**
+ * @brief Main function of a pool thread
+ * @param arguments Pointer to a malloced worker_thread_arguments, freed by the thread
+ * @return NULL
+ */
+static void* worker_pool_thread(void* arguments)
+{
+	// Copy arguments and free them
+	struct worker_thread_arguments* thread_arguments = arguments;
+	struct worker_pool* pool = thread_arguments->pool;
+	unsigned int worker_index = thread_arguments->worker_index;
+	free(thread_arguments);
+
+	unsigned long seen_generation = 0;
+	pthread_mutex_lock(&pool->mutex);
+	while (true)
+	{
+		// Wait for a new run or for the pool to stop
+		while (!pool->stopping && pool->generation == seen_generation)
+		{
+			pthread_cond_wait(&pool->start_condition, &pool->mutex);
+		}
+		if (pool->stopping)
+		{
+			break;
+		}
+		seen_generation = pool->generation;
+
+		// Work without holding the lock
+		pthread_mutex_unlock(&pool->mutex);
+		worker_pool_drain(pool, worker_index);
+		pthread_mutex_lock(&pool->mutex);
+
+		// Let the caller know when the last thread is done
+		pool->active_workers--;
+		if (pool->active_workers == 0)
+		{
+			pthread_cond_signal(&pool->done_condition);
+		}
+	}
+	pthread_mutex_unlock(&pool->mutex);
+
+	return NULL;
+}
+
+bool worker_pool_init(struct worker_pool* pool, unsigned int thread_count)
+{
+	// Use one worker per processor by default
+	if (thread_count == 0)
+	{
+		thread_count = worker_pool_default_thread_count();
+	}
+
+	memset(pool, 0, sizeof(*pool));
+	pool->thread_count = thread_count;
+	atomic_init(&pool->next_task, 0);
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->start_condition, NULL);
+	pthread_cond_init(&pool->done_condition, NULL);
+
+	// The calling thread is worker 0, so only thread_count - 1 threads are created
+	if (thread_count == 1)
+	{
+		return true;
+	}
+	pool->threads = malloc((thread_count - 1) * sizeof(pthread_t));
+	if (pool->threads == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		pool->thread_count = 1;
+		return false;
+	}
+
+	for (unsigned int i = 1; i < thread_count; i++)
+	{
+		struct worker_thread_arguments* arguments = malloc(sizeof(*arguments));
+		int result = arguments == NULL ? ENOMEM : 0;
+		if (arguments != NULL)
+		{
+			arguments->pool = pool;
+			arguments->worker_index = i;
+			result = pthread_create(&pool->threads[i - 1], NULL, worker_pool_thread, arguments);
+		}
+		if (result != 0)
+		{
+			// Stop the threads that were created
+			fprintf(stderr, "Could not create worker thread: %s.\n", strerror(result));
+			free(arguments);
+			pool->thread_count = i;
+			worker_pool_free(pool);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void worker_pool_run(struct worker_pool* pool, worker_task task, void* context, size_t task_count)
+{
+	// Publish the run and wake the pool threads
+	pthread_mutex_lock(&pool->mutex);
+	pool->task = task;
+	pool->context = context;
+	pool->task_count = task_count;
+	atomic_store_explicit(&pool->next_task, 0, memory_order_relaxed);
+	pool->active_workers = pool->thread_count - 1;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start_condition);
+	pthread_mutex_unlock(&pool->mutex);
+
+	// Work on the calling thread too
+	worker_pool_drain(pool, 0);
+
+	// Wait for the pool threads to finish their last tasks
+	pthread_mutex_lock(&pool->mutex);
+	while (pool->active_workers > 0)
+	{
+		pthread_cond_wait(&pool->done_condition, &pool->mutex);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+void worker_pool_free(struct worker_pool* pool)
+{
+	// Tell the threads to stop and wait for them
+	pthread_mutex_lock(&pool->mutex);
+	pool->stopping = true;
+	pthread_cond_broadcast(&pool->start_condition);
+	pthread_mutex_unlock(&pool->mutex);
+
+	for (unsigned int i = 1; i < pool->thread_count; i++)
+	{
+		pthread_join(pool->threads[i - 1], NULL);
+	}
+
+	// Free memory
+	free(pool->threads);
+	pool->threads = NULL;
+	pool->thread_count = 0;
+	pthread_mutex_destroy(&pool->mutex);
+	pthread_cond_destroy(&pool->start_condition);
+	pthread_cond_destroy(&pool->done_condition);
+}
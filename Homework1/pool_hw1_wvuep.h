@@ -0,0 +1,71 @@
+/**
+ * @file pool_hw1_wvuep.h
+ * @brief Header file for the worker thread pool used by the CS 350 Homework #1 engines
+ * @author Rashaan Clay
+ *
+ * A pool runs a task function over a range of task indexes. Indexes are handed out one at a
+ * time, so workers that finish early take more of the remaining tasks. The calling thread
+ * works as worker 0, so a pool of one thread runs everything on the caller.
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Function run for each task index
+ * @param context Caller data passed to worker_pool_run
+ * @param task_index Index of the task to run, in [0, task_count)
+ * @param worker_index Index of the worker running the task, in [0, thread_count)
+ */
+typedef void (*worker_task)(void* context, size_t task_index, unsigned int worker_index);
+
+/**
+ * @brief Pool of worker threads
+ */
+struct worker_pool {
+	pthread_t* threads; /**< Threads for workers 1 through thread_count - 1 */
+	unsigned int thread_count; /**< Number of workers, including the calling thread */
+	pthread_mutex_t mutex; /**< Protects the fields below */
+	pthread_cond_t start_condition; /**< Signaled when a new run starts or the pool stops */
+	pthread_cond_t done_condition; /**< Signaled when the last pool thread finishes a run */
+	unsigned long generation; /**< Incremented for every run */
+	unsigned int active_workers; /**< Pool threads still working on the current run */
+	bool stopping; /**< Set when the pool is being freed */
+	worker_task task; /**< Task function for the current run */
+	void* context; /**< Caller data for the current run */
+	size_t task_count; /**< Number of tasks in the current run */
+	atomic_size_t next_task; /**< Next task index to hand out */
+};
+
+/**
+ * @brief Get the number of online processors
+ * @return Number of processors, at least 1
+ */
+unsigned int worker_pool_default_thread_count(void);
+
+/**
+ * @brief Start a worker pool
+ * @param pool Pool to initialize
+ * @param thread_count Number of workers including the calling thread, or 0 for one per processor
+ * @return True on success, false if the threads could not be created
+ */
+bool worker_pool_init(struct worker_pool* pool, unsigned int thread_count);
+
+/**
+ * @brief Run a task for every index in [0, task_count) and wait for all of them to finish
+ * @param pool Pool to run on
+ * @param task Task function
+ * @param context Caller data passed to every task
+ * @param task_count Number of tasks
+ */
+void worker_pool_run(struct worker_pool* pool, worker_task task, void* context, size_t task_count);
+
+/**
+ * @brief Stop the pool's threads and free its memory
+ * @param pool Pool to free
+ */
+void worker_pool_free(struct worker_pool* pool);
@@ -0,0 +1,269 @@
+/**
+ * @file results_hw1_wvuep.c
+ * @brief Source code file for the binary projection results format for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * Projection matrices hold one row per year, while results files hold one column per campus,
+ * so the writer transposes blocks of campuses into a buffer of about a megabyte and writes each
+ * block with one call.
+ */
+
+#include "results_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Number of estimates transposed into the write buffer at a time
+ */
+#define RESULTS_BLOCK_ESTIMATES (256 * 1024)
+
+/**
+ * @brief Round an offset up to a multiple of 8 bytes
+ * @param offset Offset to round
+ * @return Rounded offset
+ */
+static uint64_t results_align8(uint64_t offset)
+{
+	return (offset + 7) & ~(uint64_t)7;
+}
+
+/**
+ * @brief Write all bytes to a file descriptor, continuing after partial writes and interruptions
+ * @param fd File descriptor to write to
+ * @param data Bytes to write
+ * @param length Number of bytes
+ * @return True on success, false if write failed
+ */
+static bool results_write_all(int fd, const void* data, size_t length)
+{
+	const char* bytes = data;
+	while (length > 0)
+	{
+		ssize_t result = write(fd, bytes, length);
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return false;
+		}
+		bytes += result;
+		length -= (size_t)result;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Write the header and columns of a results file
+ * @param fd File descriptor to write to
+ * @param matrix Matrix to write
+ * @param header Header describing the matrix
+ * @return True on success, false if memory could not be allocated or write failed
+ */
+static bool results_write_columns(int fd, const struct projection_matrix* matrix, const struct projection_file_header* header)
+{
+	static const char padding[8] = { 0 };
+
+	// Allocate a buffer for the year column and then for blocks of estimate columns
+	size_t block_campuses = RESULTS_BLOCK_ESTIMATES / matrix->year_count;
+	if (block_campuses == 0)
+	{
+		block_campuses = 1;
+	}
+	size_t buffer_count = block_campuses * matrix->year_count;
+	int32_t* buffer = malloc(buffer_count * sizeof(int32_t));
+	if (buffer == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return false;
+	}
+
+	// Write the header and year column
+	for (size_t i = 0; i < matrix->year_count; i++)
+	{
+		buffer[i] = (int32_t)((long long)matrix->first_year + (long long)i);
+	}
+	bool written = results_write_all(fd, header, sizeof(*header)) && results_write_all(fd, buffer, matrix->year_count * sizeof(int32_t));
+
+	// Pad to the growth rates and write them
+	size_t rates_padding = (size_t)(header->growth_rates_offset - header->years_offset - matrix->year_count * sizeof(int32_t));
+	written = written && results_write_all(fd, padding, rates_padding) && results_write_all(fd, matrix->growth_rates, matrix->campus_count * sizeof(double));
+
+	// Transpose blocks of campuses from rows into columns and write each block
+	for (size_t first_campus = 0; written && first_campus < matrix->campus_count; first_campus += block_campuses)
+	{
+		size_t campus_count = matrix->campus_count - first_campus;
+		if (campus_count > block_campuses)
+		{
+			campus_count = block_campuses;
+		}
+
+		for (size_t year = 0; year < matrix->year_count; year++)
+		{
+			const int* row = matrix->estimates + year * matrix->stride + first_campus;
+			for (size_t campus = 0; campus < campus_count; campus++)
+			{
+				buffer[campus * matrix->year_count + year] = row[campus];
+			}
+		}
+		written = results_write_all(fd, buffer, campus_count * matrix->year_count * sizeof(int32_t));
+	}
+
+	free(buffer);
+
+	return written;
+}
+
+bool write_projection_file(const char* path, const struct projection_matrix* matrix)
+{
+	// The year count must fit in the header
+	if (matrix->year_count > UINT32_MAX)
+	{
+		fprintf(stderr, "Could not write %s: too many years.\n", path);
+		return false;
+	}
+
+	// Lay out the columns after the header
+	struct projection_file_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PROJECTION_FILE_MAGIC, sizeof(PROJECTION_FILE_MAGIC));
+	header.version = PROJECTION_FILE_VERSION;
+	header.header_size = sizeof(header);
+	header.byte_order = PROJECTION_FILE_BYTE_ORDER;
+	header.first_year = matrix->first_year;
+	header.year_count = (uint32_t)matrix->year_count;
+	header.campus_count = matrix->campus_count;
+	header.years_offset = sizeof(header);
+	header.growth_rates_offset = results_align8(header.years_offset + (uint64_t)matrix->year_count * sizeof(int32_t));
+	header.estimates_offset = header.growth_rates_offset + (uint64_t)matrix->campus_count * sizeof(double);
+
+	// Create the file
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Could not open %s: %s.\n", path, strerror(errno));
+		return false;
+	}
+
+	// Write it, keeping the error from write rather than from close
+	bool written = results_write_columns(fd, matrix, &header);
+	if (!written)
+	{
+		fprintf(stderr, "Could not write %s: %s.\n", path, strerror(errno));
+	}
+	if (close(fd) != 0 && written)
+	{
+		fprintf(stderr, "Could not write %s: %s.\n", path, strerror(errno));
+		written = false;
+	}
+
+	return written;
+}
+
+/**
+ * @brief Check that a mapped results file has a supported header and columns that fit in it
+ * @param header Header at the start of the file
+ * @param length Length of the file in bytes
+ * @return Description of the problem, or NULL if the file is valid
+ */
+static const char* results_check_header(const struct projection_file_header* header, size_t length)
+{
+	if (length < sizeof(*header) || memcmp(header->magic, PROJECTION_FILE_MAGIC, sizeof(PROJECTION_FILE_MAGIC)) != 0)
+	{
+		return "not a projection results file";
+	}
+	if (header->byte_order != PROJECTION_FILE_BYTE_ORDER)
+	{
+		return "written with a different byte order";
+	}
+	if (header->version != PROJECTION_FILE_VERSION || header->header_size < sizeof(*header))
+	{
+		return "unsupported format version";
+	}
+
+	// Each column must be aligned and lie inside the file, computed without overflow
+	uint64_t year_bytes = (uint64_t)header->year_count * sizeof(int32_t);
+	if (header->years_offset % sizeof(int32_t) != 0 || header->growth_rates_offset % sizeof(double) != 0 || header->estimates_offset % sizeof(int32_t) != 0 ||
+		header->years_offset < header->header_size || header->years_offset > length || year_bytes > length - header->years_offset ||
+		header->growth_rates_offset > length || header->campus_count > (length - header->growth_rates_offset) / sizeof(double) ||
+		header->estimates_offset > length || (header->year_count != 0 && header->campus_count > (length - header->estimates_offset) / year_bytes))
+	{
+		return "truncated or corrupt";
+	}
+
+	return NULL;
+}
+
+bool projection_file_open(struct projection_file* file, const char* path)
+{
+	memset(file, 0, sizeof(*file));
+
+	// Open the file and find its size
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Could not open %s: %s.\n", path, strerror(errno));
+		return false;
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0)
+	{
+		fprintf(stderr, "Could not get size of %s: %s.\n", path, strerror(errno));
+		close(fd);
+		return false;
+	}
+	if ((size_t)status.st_size < sizeof(struct projection_file_header))
+	{
+		fprintf(stderr, "Could not read %s: not a projection results file.\n", path);
+		close(fd);
+		return false;
+	}
+
+	// Map the file read-only; the mapping stays valid after the descriptor is closed
+	size_t length = (size_t)status.st_size;
+	void* mapping = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		fprintf(stderr, "Could not map %s: %s.\n", path, strerror(errno));
+		return false;
+	}
+
+	// Check the header before trusting any offsets
+	const struct projection_file_header* header = mapping;
+	const char* problem = results_check_header(header, length);
+	if (problem != NULL)
+	{
+		fprintf(stderr, "Could not read %s: %s.\n", path, problem);
+		munmap(mapping, length);
+		return false;
+	}
+
+	// Point at the columns
+	file->mapping = mapping;
+	file->length = length;
+	file->header = header;
+	file->years = (const int32_t*)((const char*)mapping + header->years_offset);
+	file->growth_rates = (const double*)((const char*)mapping + header->growth_rates_offset);
+	file->estimates = (const int32_t*)((const char*)mapping + header->estimates_offset);
+
+	return true;
+}
+
+void projection_file_close(struct projection_file* file)
+{
+	if (file->mapping != NULL)
+	{
+		munmap(file->mapping, file->length);
+	}
+	memset(file, 0, sizeof(*file));
+}
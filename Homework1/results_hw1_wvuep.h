@@ -0,0 +1,111 @@
+/**
+ * @file results_hw1_wvuep.h
+ * @brief Header file for the binary projection results format for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * A results file holds a projection matrix in columns:
+ *
+ *     header                     struct projection_file_header, 64 bytes
+ *     years                      int32[year_count], first_year through last_year
+ *     growth rates               float64[campus_count], aligned to 8 bytes
+ *     estimates                  int32[year_count] per campus, one column after another
+ *
+ * Values are stored in the byte order of the machine that wrote the file, which the header
+ * records. A reader maps the file and finds any campus and year by offset, without parsing.
+ */
+
+#pragma once
+
+#include "engine_hw1_wvuep.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Bytes at the start of every results file
+ */
+#define PROJECTION_FILE_MAGIC "WVUPROJ"
+
+/**
+ * @brief Format version written by write_projection_file
+ */
+#define PROJECTION_FILE_VERSION 1
+
+/**
+ * @brief Value stored in the header to detect files written with a different byte order
+ */
+#define PROJECTION_FILE_BYTE_ORDER 0x01020304u
+
+/**
+ * @brief Header at the start of a results file
+ */
+struct projection_file_header {
+	char magic[8]; /**< PROJECTION_FILE_MAGIC, null-terminated */
+	uint32_t version; /**< Format version */
+	uint32_t header_size; /**< Size of this header in bytes */
+	uint32_t byte_order; /**< PROJECTION_FILE_BYTE_ORDER in the writer's byte order */
+	int32_t first_year; /**< Year of the first estimate in each column */
+	uint32_t year_count; /**< Number of years in each column */
+	uint32_t reserved; /**< Zero */
+	uint64_t campus_count; /**< Number of campuses */
+	uint64_t years_offset; /**< File offset of the year column */
+	uint64_t growth_rates_offset; /**< File offset of the growth rate column */
+	uint64_t estimates_offset; /**< File offset of the first campus' estimate column */
+};
+
+/**
+ * @brief Results file mapped for reading
+ */
+struct projection_file {
+	void* mapping; /**< Mapped file */
+	size_t length; /**< Length of the mapping in bytes */
+	const struct projection_file_header* header; /**< Header at the start of the mapping */
+	const int32_t* years; /**< Year column */
+	const double* growth_rates; /**< Growth rate column */
+	const int32_t* estimates; /**< Estimate columns, year_count values per campus */
+};
+
+/**
+ * @brief Write a projection matrix to a results file
+ * @param path Path of the file to create or replace
+ * @param matrix Matrix to write, with fewer than 2^32 years
+ * @return True on success, false if the file could not be written
+ */
+bool write_projection_file(const char* path, const struct projection_matrix* matrix);
+
+/**
+ * @brief Map a results file and check its header
+ * @param file File to initialize
+ * @param path Path of the file
+ * @return True on success, false if the file could not be mapped or is not a valid results file
+ */
+bool projection_file_open(struct projection_file* file, const char* path);
+
+/**
+ * @brief Unmap a results file
+ * @param file File to close
+ */
+void projection_file_close(struct projection_file* file);
+
+/**
+ * @brief Get the estimate column of a campus
+ * @param file Open results file
+ * @param campus Campus index, less than campus_count
+ * @return Pointer to year_count estimates, starting at first_year
+ */
+static inline const int32_t* projection_file_campus(const struct projection_file* file, size_t campus)
+{
+	return file->estimates + campus * file->header->year_count;
+}
+
+/**
+ * @brief Get the estimate for one campus and year
+ * @param file Open results file
+ * @param campus Campus index, less than campus_count
+ * @param year Year covered by the file
+ * @return Estimated enrollment
+ */
+static inline int projection_file_estimate(const struct projection_file* file, size_t campus, int year)
+{
+	return projection_file_campus(file, campus)[(long long)year - file->header->first_year];
+}
@@ -0,0 +1,463 @@
+/**
+ * @file runner_hw1_wvuep.c
+ * @brief Parallel and sharded Unity test runner for CS 350 Homework #1: WVU Enrollment Problem
+ * @author Rashaan Clay
+ */
+
+// Use GNU source for memfd_create
+#define _GNU_SOURCE // NOLINT(*-reserved-identifier)
+
+#include "runner_hw1_wvuep.h"
+#include "ctest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+/**
+ * @brief Largest command line read by read_test_runner_options
+ */
+#define TEST_RUNNER_MAX_COMMAND_LINE 65536
+
+/**
+ * @brief Test cases of a shard, grouped in steps
+ */
+struct test_shard {
+	size_t* cases; /**< Indexes of the test cases in the shard, in table order */
+	size_t case_count; /**< Number of test cases in the shard */
+	size_t* step_starts; /**< Position in cases of the first test case of each step, followed by case_count */
+	size_t step_count; /**< Number of steps in the shard */
+};
+
+/**
+ * @brief Progress of a test case run by a worker
+ */
+enum test_case_state {
+	TEST_CASE_PENDING, /**< Not yet taken by a worker */
+	TEST_CASE_RUNNING, /**< Taken by a worker that has not finished it, so the worker died if this is left */
+	TEST_CASE_DONE /**< Finished, with its counts set */
+};
+
+/**
+ * @brief Counts of a test case, in memory shared with the workers
+ */
+struct test_case_result {
+	atomic_int state; /**< Progress of the test case, an enum test_case_state */
+	UNITY_COUNTER_TYPE tests; /**< Tests counted by Unity */
+	UNITY_COUNTER_TYPE failures; /**< Failures counted by Unity */
+	UNITY_COUNTER_TYPE ignores; /**< Ignored tests counted by Unity */
+};
+
+/**
+ * @brief Memory shared between run_test_cases and its workers
+ */
+struct test_runner_shared {
+	atomic_size_t next_step; /**< Next step of the shard to hand out */
+	struct test_case_result results[]; /**< Counts of each test case in the shard */
+};
+
+/**
+ * @brief Parse a positive number
+ * @param text Text to parse
+ * @param value Receives the number
+ * @return True on success, false if the text is not a number that fits in an unsigned int
+ */
+static bool parse_test_runner_number(const char* text, unsigned int* value)
+{
+	char* end;
+	errno = 0;
+	unsigned long parsed = strtoul(text, &end, 10);
+	if (errno != 0 || end == text || *end != '\0' || text[0] == '-' || parsed > 0xFFFFFFFFUL)
+	{
+		return false;
+	}
+	*value = (unsigned int)parsed;
+
+	return true;
+}
+
+bool parse_test_runner_arguments(int argc, char** argv, struct test_runner_options* options)
+{
+	// Start from one job and one shard
+	struct test_runner_options parsed = { 1, 1, 1 };
+	options->jobs = parsed.jobs;
+	options->shard_index = parsed.shard_index;
+	options->shard_count = parsed.shard_count;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--jobs") == 0)
+		{
+			// Number of workers, or 0 for one per processor
+			if (i + 1 >= argc || !parse_test_runner_number(argv[++i], &parsed.jobs))
+			{
+				return false;
+			}
+			if (parsed.jobs == 0)
+			{
+				long processors = sysconf(_SC_NPROCESSORS_ONLN);
+				parsed.jobs = processors > 0 ? (unsigned int)processors : 1;
+			}
+		}
+		else if (strcmp(argv[i], "--shard") == 0)
+		{
+			// Shard as i/n with 1 <= i <= n
+			if (i + 1 >= argc)
+			{
+				return false;
+			}
+			char* slash = strchr(argv[++i], '/');
+			if (slash == NULL)
+			{
+				return false;
+			}
+			*slash = '\0';
+			bool valid = parse_test_runner_number(argv[i], &parsed.shard_index) && parse_test_runner_number(slash + 1, &parsed.shard_count);
+			*slash = '/';
+			if (!valid || parsed.shard_index < 1 || parsed.shard_index > parsed.shard_count)
+			{
+				return false;
+			}
+		}
+	}
+
+	*options = parsed;
+
+	return true;
+}
+
+bool read_test_runner_options(struct test_runner_options* options)
+{
+	// Default to one job and one shard if the command line cannot be read
+	options->jobs = 1;
+	options->shard_index = 1;
+	options->shard_count = 1;
+	int fd = open("/proc/self/cmdline", O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		return true;
+	}
+
+	// Read the arguments, which are separated by null characters
+	char* command_line = malloc(TEST_RUNNER_MAX_COMMAND_LINE + 1);
+	char** argv = malloc((TEST_RUNNER_MAX_COMMAND_LINE / 2 + 1) * sizeof(char*));
+	if (command_line == NULL || argv == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		free(command_line);
+		free(argv);
+		close(fd);
+		return true;
+	}
+	size_t length = 0;
+	ssize_t bytes_read;
+	while (length < TEST_RUNNER_MAX_COMMAND_LINE && (bytes_read = read(fd, command_line + length, TEST_RUNNER_MAX_COMMAND_LINE - length)) > 0)
+	{
+		length += (size_t)bytes_read;
+	}
+	close(fd);
+	command_line[length] = '\0';
+
+	// Split the arguments
+	int argc = 0;
+	for (size_t position = 0; position < length; position += strlen(command_line + position) + 1)
+	{
+		argv[argc++] = command_line + position;
+	}
+	bool succeeded = parse_test_runner_arguments(argc, argv, options);
+
+	// Free memory
+	free(command_line);
+	free(argv);
+
+	return succeeded;
+}
+
+bool is_test_step_in_shard(size_t step, const struct test_runner_options* options)
+{
+	return step % options->shard_count == options->shard_index - 1;
+}
+
+/**
+ * @brief Print the header of the step a test case belongs to, if it was not the last one printed
+ * @param cases Table of test cases
+ * @param index Index of the test case
+ * @param last_header Header printed last, or NULL if none has been printed; updated
+ */
+static void print_test_case_header(const struct test_case* cases, size_t index, const char** last_header)
+{
+	// Find the header of the step, which is on its first test case
+	size_t step = index;
+	while (step > 0 && cases[step].header == NULL)
+	{
+		step--;
+	}
+	const char* header = cases[step].header;
+	if (header == NULL || header == *last_header)
+	{
+		return;
+	}
+
+	// Separate steps with a blank line
+	if (*last_header != NULL)
+	{
+		puts("");
+	}
+	puts(header);
+	*last_header = header;
+}
+
+/**
+ * @brief Run the steps handed out to a worker process, then exit
+ * @param cases Table of test cases
+ * @param shard Test cases of the shard
+ * @param shared Memory shared with run_test_cases
+ * @param output_fds Memory file for the output of each test case in the shard
+ */
+static void run_test_worker(const struct test_case* cases, const struct test_shard* shard, struct test_runner_shared* shared, const int* output_fds)
+{
+	// Fork test children from this worker's own fork server
+	start_fork_server();
+
+	while (true)
+	{
+		// Take the next step, whose test cases run in order as they may share files and state
+		size_t step = atomic_fetch_add(&shared->next_step, 1);
+		if (step >= shard->step_count)
+		{
+			break;
+		}
+		for (size_t position = shard->step_starts[step]; position < shard->step_starts[step + 1]; position++)
+		{
+			struct test_case_result* result = &shared->results[position];
+			atomic_store(&result->state, TEST_CASE_RUNNING);
+
+			// Run the test case with stdout and stderr in its memory file
+			dup2(output_fds[position], STDOUT_FILENO);
+			dup2(output_fds[position], STDERR_FILENO);
+			UNITY_COUNTER_TYPE tests = Unity.NumberOfTests;
+			UNITY_COUNTER_TYPE failures = Unity.TestFailures;
+			UNITY_COUNTER_TYPE ignores = Unity.TestIgnores;
+			const struct test_case* test_case = &cases[shard->cases[position]];
+			UnityDefaultTestRun(test_case->function, test_case->name, test_case->line);
+			fflush(stdout);
+			fflush(stderr);
+
+			// Record its counts
+			result->tests = Unity.NumberOfTests - tests;
+			result->failures = Unity.TestFailures - failures;
+			result->ignores = Unity.TestIgnores - ignores;
+			atomic_store(&result->state, TEST_CASE_DONE);
+		}
+	}
+
+	stop_fork_server();
+	_exit(0);
+}
+
+/**
+ * @brief Report a test case whose worker died or could not be started as failed
+ * @param test_case Test case
+ * @param message Failure message
+ */
+static void fail_test_case(const struct test_case* test_case, const char* message)
+{
+	Unity.CurrentTestName = test_case->name;
+	Unity.CurrentTestLineNumber = (UNITY_LINE_TYPE)test_case->line;
+	Unity.NumberOfTests++;
+	Unity.CurrentTestFailed = 0;
+	Unity.CurrentTestIgnored = 0;
+	if (TEST_PROTECT())
+	{
+		UnityFail(message, (UNITY_LINE_TYPE)test_case->line);
+	}
+	UnityConcludeTest();
+}
+
+/**
+ * @brief Copy the output of a test case to stdout
+ * @param fd Memory file holding the output
+ */
+static void copy_test_case_output(int fd)
+{
+	char buffer[4096];
+	ssize_t bytes_read;
+	lseek(fd, 0, SEEK_SET);
+	while ((bytes_read = read(fd, buffer, sizeof(buffer))) > 0)
+	{
+		for (ssize_t written = 0, result; written < bytes_read; written += result)
+		{
+			result = write(STDOUT_FILENO, buffer + written, (size_t)(bytes_read - written));
+			if (result < 0)
+			{
+				return;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Run the steps of a shard on worker processes and report them in table order
+ * @param cases Table of test cases
+ * @param shard Test cases of the shard
+ * @param jobs Number of worker processes
+ * @return True if the test cases were run, false if the workers could not be set up and nothing was run
+ */
+static bool run_test_cases_parallel(const struct test_case* cases, const struct test_shard* shard, unsigned int jobs)
+{
+	// Share the counts with the workers
+	size_t shared_size = sizeof(struct test_runner_shared) + shard->case_count * sizeof(struct test_case_result);
+	struct test_runner_shared* shared = mmap(NULL, shared_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	int* output_fds = malloc(shard->case_count * sizeof(int));
+	if (shared == MAP_FAILED || output_fds == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		if (shared != MAP_FAILED)
+		{
+			munmap(shared, shared_size);
+		}
+		free(output_fds);
+		return false;
+	}
+	atomic_init(&shared->next_step, 0);
+	for (size_t position = 0; position < shard->case_count; position++)
+	{
+		atomic_init(&shared->results[position].state, TEST_CASE_PENDING);
+	}
+
+	// Give each test case a memory file for its output
+	size_t opened = 0;
+	while (opened < shard->case_count && (output_fds[opened] = memfd_create("runner_hw1_wvuep", MFD_CLOEXEC)) >= 0)
+	{
+		opened++;
+	}
+	if (opened < shard->case_count)
+	{
+		fprintf(stderr, "Could not create test output file: %s.\n", strerror(errno));
+		while (opened > 0)
+		{
+			close(output_fds[--opened]);
+		}
+		free(output_fds);
+		munmap(shared, shared_size);
+		return false;
+	}
+
+	// Start workers until every step is taken, replacing workers that died
+	fflush(stdout);
+	fflush(stderr);
+	pid_t* workers = malloc(jobs * sizeof(pid_t));
+	size_t taken = 0;
+	while (workers != NULL && taken < shard->step_count)
+	{
+		unsigned int started = 0;
+		for (unsigned int i = 0; i < jobs && i < shard->step_count - taken; i++)
+		{
+			pid_t pid = fork();
+			if (pid == 0)
+			{
+				run_test_worker(cases, shard, shared, output_fds);
+			}
+			if (pid > 0)
+			{
+				workers[started++] = pid;
+			}
+		}
+		for (unsigned int i = 0; i < started; i++)
+		{
+			TEMP_FAILURE_RETRY(waitpid(workers[i], NULL, 0));
+		}
+
+		// Stop if no worker could take a step
+		size_t next_step = atomic_load(&shared->next_step);
+		next_step = next_step < shard->step_count ? next_step : shard->step_count;
+		if (next_step == taken)
+		{
+			fprintf(stderr, "Could not start test workers: %s.\n", strerror(errno));
+			break;
+		}
+		taken = next_step;
+	}
+	free(workers);
+
+	// Report the test cases in table order
+	const char* last_header = NULL;
+	for (size_t position = 0; position < shard->case_count; position++)
+	{
+		const struct test_case* test_case = &cases[shard->cases[position]];
+		const struct test_case_result* result = &shared->results[position];
+		print_test_case_header(cases, shard->cases[position], &last_header);
+		copy_test_case_output(output_fds[position]);
+		close(output_fds[position]);
+		int state = atomic_load(&result->state);
+		if (state == TEST_CASE_DONE)
+		{
+			Unity.NumberOfTests += result->tests;
+			Unity.TestFailures += result->failures;
+			Unity.TestIgnores += result->ignores;
+		}
+		else
+		{
+			fail_test_case(test_case, state == TEST_CASE_RUNNING ? "The test worker process crashed." : "The test was not run.");
+		}
+	}
+
+	// Free memory
+	free(output_fds);
+	munmap(shared, shared_size);
+
+	return true;
+}
+
+void run_test_cases(const struct test_case* cases, size_t count, const struct test_runner_options* options)
+{
+	// Select the steps of the shard; a step starts at each header, and cases before the first header form a step
+	struct test_shard shard = { NULL, 0, NULL, 0 };
+	shard.cases = malloc((count > 0 ? count : 1) * sizeof(size_t));
+	shard.step_starts = malloc((count + 1) * sizeof(size_t));
+	if (shard.cases == NULL || shard.step_starts == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		free(shard.cases);
+		free(shard.step_starts);
+		return;
+	}
+	size_t step = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (i > 0 && cases[i].header != NULL)
+		{
+			step++;
+		}
+		if (is_test_step_in_shard(step, options))
+		{
+			if (i == 0 || cases[i].header != NULL)
+			{
+				shard.step_starts[shard.step_count++] = shard.case_count;
+			}
+			shard.cases[shard.case_count++] = i;
+		}
+	}
+	shard.step_starts[shard.step_count] = shard.case_count;
+
+	// Run them on workers, or in order in this process
+	if (options->jobs <= 1 || shard.step_count <= 1 || !run_test_cases_parallel(cases, &shard, options->jobs))
+	{
+		const char* last_header = NULL;
+		for (size_t position = 0; position < shard.case_count; position++)
+		{
+			const struct test_case* test_case = &cases[shard.cases[position]];
+			print_test_case_header(cases, shard.cases[position], &last_header);
+			UnityDefaultTestRun(test_case->function, test_case->name, test_case->line);
+		}
+	}
+
+	// Free memory
+	free(shard.cases);
+	free(shard.step_starts);
+}
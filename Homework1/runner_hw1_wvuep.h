@@ -0,0 +1,88 @@
+/**
+ * @file runner_hw1_wvuep.h
+ * @brief Header file for the parallel and sharded Unity test runner for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * run_tests lists its tests in a table of test cases, each optionally starting a step with the
+ * lines printed before it. With one job the cases run in order in this process, exactly as a
+ * list of RUN_TEST calls does. With more jobs the steps are handed out one at a time to worker
+ * processes, which run the cases of a step in order, since they may share files, shared memory
+ * keys and not_implemented_* flags. Each case writes its output, stdout and stderr together, to
+ * its own memory file, and its counts to shared memory, so the output and the Unity summary come
+ * out in table order however the steps were scheduled. A case whose worker dies is reported as
+ * failed, and the rest of its step as not run.
+ *
+ * A shard runs every n-th step of the table, so n machines given shards 1/n through n/n run the
+ * whole suite between them. main_hw1_wvuep.c does not pass its arguments on, so the options are
+ * read from the command line of the process:
+ *
+ *   hw1 --jobs 4           run on 4 worker processes
+ *   hw1 --shard 2/3        run the second of three shards
+ */
+
+#pragma once
+
+#include "unity.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Macro for a test case in a table for run_test_cases
+ */
+#define TEST_CASE(function) { NULL, function, #function, __LINE__ }
+
+/**
+ * @brief Macro for a test case starting a step, printed with a blank line before it
+ */
+#define TEST_STEP(header, function) { header, function, #function, __LINE__ }
+
+/**
+ * @brief Test case in a table for run_test_cases
+ */
+struct test_case {
+	const char* header; /**< Lines printed before the test, or NULL */
+	UnityTestFunction function; /**< Test function */
+	const char* name; /**< Name of the test function */
+	int line; /**< Line reported by Unity for the test */
+};
+
+/**
+ * @brief Options for run_test_cases
+ */
+struct test_runner_options {
+	unsigned int jobs; /**< Number of worker processes, or 1 to run in this process */
+	unsigned int shard_index; /**< Shard to run, from 1 through shard_count */
+	unsigned int shard_count; /**< Number of shards the table is split into */
+};
+
+/**
+ * @brief Parse runner options from command-line arguments, ignoring arguments for other purposes
+ * @param argc Number of arguments
+ * @param argv Arguments, where --jobs N and --shard i/n are recognized
+ * @param options Options to fill, set to one job and one shard for options not given
+ * @return True on success, false if an option has an invalid value
+ */
+bool parse_test_runner_arguments(int argc, char** argv, struct test_runner_options* options);
+
+/**
+ * @brief Read runner options from the command line of this process
+ * @param options Options to fill, set to one job and one shard if there are none or they are invalid
+ * @return True on success, false if an option has an invalid value
+ */
+bool read_test_runner_options(struct test_runner_options* options);
+
+/**
+ * @brief Check whether a step belongs to the shard selected by the options
+ * @param step Index of the step in the table, counting the steps that start with a header
+ * @param options Runner options
+ * @return True if the shard runs the step
+ */
+bool is_test_step_in_shard(size_t step, const struct test_runner_options* options);
+
+/**
+ * @brief Run the test cases of a shard between UNITY_BEGIN and UNITY_END, adding them to the Unity counts
+ * @param cases Table of test cases
+ * @param count Number of test cases
+ * @param options Runner options
+ */
+void run_test_cases(const struct test_case* cases, size_t count, const struct test_runner_options* options);
@@ -0,0 +1,137 @@
+/**
+ * @file schedule_hw1_wvuep.c
+ * @brief Source code file for piecewise growth schedules for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * Each prefix factor is the previous one multiplied by pow(1 + rate, segment length), the same
+ * products in the same order as recomputing the schedule from initial_year, so cached and
+ * recomputed estimates are identical.
+ */
+
+#include "schedule_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+/**
+ * @brief Number of segments a schedule allocates room for at first
+ */
+#define GROWTH_SCHEDULE_INITIAL_CAPACITY 8
+
+/**
+ * @brief Resize a growth schedule's arrays
+ * @param schedule Schedule to resize
+ * @param capacity New number of segments the arrays can hold
+ * @return True on success, false if memory could not be allocated
+ */
+static bool growth_schedule_resize(struct growth_schedule* schedule, size_t capacity)
+{
+	// Resize each array, keeping the ones that succeed so the schedule stays consistent
+	int* start_years = realloc(schedule->start_years, capacity * sizeof(int));
+	if (start_years != NULL)
+	{
+		schedule->start_years = start_years;
+	}
+	double* growth_rates = realloc(schedule->growth_rates, capacity * sizeof(double));
+	if (growth_rates != NULL)
+	{
+		schedule->growth_rates = growth_rates;
+	}
+	double* prefix_factors = realloc(schedule->prefix_factors, capacity * sizeof(double));
+	if (prefix_factors != NULL)
+	{
+		schedule->prefix_factors = prefix_factors;
+	}
+	if (start_years == NULL || growth_rates == NULL || prefix_factors == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return false;
+	}
+	schedule->capacity = capacity;
+
+	return true;
+}
+
+bool growth_schedule_init(struct growth_schedule* schedule, int initial_enrollment, double growth_rate, int initial_year)
+{
+	memset(schedule, 0, sizeof(*schedule));
+
+	// Allocate the arrays
+	if (!growth_schedule_resize(schedule, GROWTH_SCHEDULE_INITIAL_CAPACITY))
+	{
+		growth_schedule_free(schedule);
+		return false;
+	}
+
+	// The first segment starts at the initial enrollment
+	schedule->initial_enrollment = initial_enrollment;
+	schedule->initial_year = initial_year;
+	schedule->start_years[0] = initial_year;
+	schedule->growth_rates[0] = growth_rate;
+	schedule->prefix_factors[0] = 1.0;
+	schedule->count = 1;
+
+	return true;
+}
+
+bool growth_schedule_append(struct growth_schedule* schedule, int start_year, double growth_rate)
+{
+	// Segments must start in increasing years
+	size_t last = schedule->count - 1;
+	if (start_year <= schedule->start_years[last])
+	{
+		fprintf(stderr, "Could not add segment: start year %d is not after %d.\n", start_year, schedule->start_years[last]);
+		return false;
+	}
+
+	// Double the arrays when they are full
+	if (schedule->count == schedule->capacity && !growth_schedule_resize(schedule, schedule->capacity * 2))
+	{
+		return false;
+	}
+
+	// Extend the cache by the growth over the previous last segment
+	schedule->start_years[schedule->count] = start_year;
+	schedule->growth_rates[schedule->count] = growth_rate;
+	schedule->prefix_factors[schedule->count] = schedule->prefix_factors[last] * pow(1 + schedule->growth_rates[last], start_year - schedule->start_years[last]);
+	schedule->count++;
+
+	return true;
+}
+
+void growth_schedule_free(struct growth_schedule* schedule)
+{
+	free(schedule->start_years);
+	free(schedule->growth_rates);
+	free(schedule->prefix_factors);
+	memset(schedule, 0, sizeof(*schedule));
+}
+
+int calculate_scheduled_enrollment_estimate(const struct growth_schedule* schedule, int estimate_year)
+{
+	// Find the last segment starting in or before estimate_year, checking the last segment first since later years are the common case
+	size_t segment = schedule->count - 1;
+	if (estimate_year < schedule->start_years[segment])
+	{
+		size_t low = 0;
+		while (low < segment)
+		{
+			size_t middle = low + (segment - low) / 2;
+			if (schedule->start_years[middle + 1] <= estimate_year)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				segment = middle;
+			}
+		}
+	}
+
+	// Grow from the cached factor at the segment's start; years before initial_year use the first segment
+	double growth_factor = schedule->prefix_factors[segment] * pow(1 + schedule->growth_rates[segment], estimate_year - schedule->start_years[segment]);
+	return (int)round(schedule->initial_enrollment * growth_factor);
+}
@@ -0,0 +1,68 @@
+/**
+ * @file schedule_hw1_wvuep.h
+ * @brief Header file for piecewise growth schedules for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * A growth schedule replaces the single growth_rate of calculate_enrollment_estimate with a
+ * list of segments, each applying its own rate from its start year until the next segment
+ * starts. The first segment starts at initial_year and also covers years before it; the last
+ * segment continues forever.
+ *
+ * The schedule caches the growth factor from initial_year to the start of every segment, so
+ * an estimate costs a binary search over the segments and one pow, and appending a segment
+ * extends the cache with one more factor.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Enrollment schedule with a growth rate per range of years
+ */
+struct growth_schedule {
+	int initial_enrollment; /**< Enrollment in initial_year */
+	int initial_year; /**< Year for initial enrollment, the start of the first segment */
+	size_t count; /**< Number of segments */
+	size_t capacity; /**< Number of segments the arrays can hold */
+	int* start_years; /**< First year each segment applies to, strictly increasing */
+	double* growth_rates; /**< Annual growth rate of each segment */
+	double* prefix_factors; /**< Growth factor from initial_year to the start of each segment */
+};
+
+/**
+ * @brief Start a growth schedule with one segment
+ * @param schedule Schedule to initialize
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Annual growth rate from initial_year until the next segment
+ * @param initial_year Year for initial enrollment
+ * @return True on success, false if memory could not be allocated
+ */
+bool growth_schedule_init(struct growth_schedule* schedule, int initial_enrollment, double growth_rate, int initial_year);
+
+/**
+ * @brief Add a segment after the last one
+ * @param schedule Schedule to extend
+ * @param start_year First year the segment applies to, after the last segment's start year
+ * @param growth_rate Annual growth rate from start_year on
+ * @return True on success, false if start_year is not after the last segment or memory could not be allocated
+ */
+bool growth_schedule_append(struct growth_schedule* schedule, int start_year, double growth_rate);
+
+/**
+ * @brief Free the arrays of a growth schedule
+ * @param schedule Schedule to free
+ */
+void growth_schedule_free(struct growth_schedule* schedule);
+
+/**
+ * @brief Calculate the estimated enrollment in estimate_year following a growth schedule
+ *
+ * With a single segment this returns the same value as calculate_enrollment_estimate.
+ *
+ * @param schedule Growth schedule
+ * @param estimate_year Year for which to calculate enrollment estimate
+ * @return Estimated enrollment
+ */
+int calculate_scheduled_enrollment_estimate(const struct growth_schedule* schedule, int estimate_year);
@@ -0,0 +1,308 @@
+/**
+ * @file sensitivity_hw1_wvuep.c
+ * @brief Source code file for growth rate sensitivities of enrollment estimates for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * The range kernel holds the growth factors of four consecutive years in one vector, set from
+ * one pow every SENSITIVITY_ANCHOR_INTERVAL years and multiplied by (1 + rate)^4 in between. Each
+ * factor gives both the estimate and, times k / (1 + rate), the sensitivity. Estimates are
+ * rounded with the 1.5 * 2^52 trick, which matches round except at exact halves; like the
+ * projection series, an estimate whose fraction lies within the accumulated error of one half
+ * is recomputed with calculate_enrollment_estimate, so every estimate is exact.
+ *
+ * The grid kernel works across rates instead: row k is row k - 1 times 1 + rate, and its
+ * sensitivities are k times row k - 1, four rates per vector.
+ */
+
+#include "sensitivity_hw1_wvuep.h"
+#include "hw1_wvuep.h"
+#include "vector_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+/**
+ * @brief Alignment and padding of grid rows in bytes
+ */
+#define SENSITIVITY_CACHE_LINE 64
+
+/**
+ * @brief Number of doubles in a grid cache line
+ */
+#define SENSITIVITY_CACHE_LINE_DOUBLES (SENSITIVITY_CACHE_LINE / sizeof(double))
+
+/**
+ * @brief Largest magnitude rounded by the kernel without deferring to calculate_enrollment_estimate
+ */
+#define SENSITIVITY_MAX_ESTIMATE 2147483000.0
+
+/**
+ * @brief Relative error allowed per multiplication by (1 + rate)^4 since the last anchor
+ *
+ * Four times the 2^-53 rounding error of one multiplication: one for the product and up to
+ * three carried by the fourth power itself.
+ */
+#define SENSITIVITY_ERROR_PER_STEP 0x1p-51
+
+/**
+ * @brief Extra steps of error added for the anchor, its lane offsets, the pow in calculate_enrollment_estimate and the product with the initial enrollment
+ */
+#define SENSITIVITY_ERROR_BASE_STEPS 6
+
+/**
+ * @brief Calculate the estimate and sensitivity of one year with pow
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Annual growth rate
+ * @param initial_year Year for initial enrollment
+ * @param years Years after initial_year
+ * @param estimate Receives the estimate
+ * @param sensitivity Receives the sensitivity
+ */
+static void sensitivity_scalar(int initial_enrollment, double growth_rate, int initial_year, size_t years, int* estimate, double* sensitivity)
+{
+	*estimate = calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, initial_year + (int)years);
+	*sensitivity = years == 0 ? 0.0 : (double)years * initial_enrollment * pow(1 + growth_rate, (int)years - 1);
+}
+
+/**
+ * @brief Calculate estimates and sensitivities for every full group of four years
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Annual growth rate, with 1 + growth_rate finite and not 0
+ * @param initial_year Year for initial enrollment
+ * @param count Number of years
+ * @param estimates Output estimates
+ * @param sensitivities Output sensitivities
+ * @return Number of years processed
+ */
+static inline __attribute__((always_inline)) size_t sensitivity_kernel(int initial_enrollment, double growth_rate, int initial_year, size_t count, int* estimates, double* sensitivities)
+{
+	// The factor for four years ahead and the division by 1 + rate are shared by every lane
+	double growth_factor = 1 + growth_rate;
+	double inverse_factor = 1.0 / growth_factor;
+	double step_factor = (growth_factor * growth_factor) * (growth_factor * growth_factor);
+	const vector_double sign_mask = (vector_double)(vector_int64){ 0x7fffffffffffffffLL, 0x7fffffffffffffffLL, 0x7fffffffffffffffLL, 0x7fffffffffffffffLL };
+	const vector_double lane_factors = { 1.0, growth_factor, growth_factor * growth_factor, growth_factor * growth_factor * growth_factor };
+	vector_double years = { 0.0, 1.0, 2.0, 3.0 };
+	vector_double factors = { 0.0 };
+	int steps = SENSITIVITY_ANCHOR_INTERVAL / VECTOR_DOUBLE_LANES;
+
+	size_t i = 0;
+	for (; i + VECTOR_DOUBLE_LANES <= count; i += VECTOR_DOUBLE_LANES)
+	{
+		// Re-anchor the factors with one pow for the first lane and the lane offsets for the others
+		if (steps >= SENSITIVITY_ANCHOR_INTERVAL / VECTOR_DOUBLE_LANES)
+		{
+			factors = pow(growth_factor, (int)i) * lane_factors;
+			steps = 0;
+		}
+
+		// Share each factor between the estimate and the sensitivity
+		vector_double estimate = initial_enrollment * factors;
+		vector_double sensitivity = estimate * years * inverse_factor;
+		memcpy(sensitivities + i, &sensitivity, sizeof(sensitivity));
+
+		// Round to nearest and keep the lanes whose fraction is clearly away from one half (NaN fails the range check)
+		vector_double rounded = (estimate + ROUNDING_MAGIC) - ROUNDING_MAGIC;
+		vector_double magnitude = (vector_double)((vector_int64)estimate & (vector_int64)sign_mask);
+		vector_double distance = (vector_double)((vector_int64)(estimate - rounded) & (vector_int64)sign_mask);
+		vector_double error_bound = magnitude * SENSITIVITY_ERROR_PER_STEP * (double)(steps + SENSITIVITY_ERROR_BASE_STEPS);
+		vector_int64 exact = (magnitude < SENSITIVITY_MAX_ESTIMATE) & (0.5 - distance > error_bound);
+		vector_int32 rounded_estimates = __builtin_convertvector((vector_double)((vector_int64)rounded & exact), vector_int32);
+		memcpy(estimates + i, &rounded_estimates, sizeof(rounded_estimates));
+
+		// Recompute the lanes near one half with calculate_enrollment_estimate
+		if (!(exact[0] & exact[1] & exact[2] & exact[3]))
+		{
+			for (int lane = 0; lane < VECTOR_DOUBLE_LANES; lane++)
+			{
+				if (!exact[lane])
+				{
+					estimates[i + lane] = calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, initial_year + (int)i + lane);
+				}
+			}
+		}
+
+		// Advance four years
+		factors *= step_factor;
+		years += (double)VECTOR_DOUBLE_LANES;
+		steps++;
+	}
+
+	return i;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @brief Sensitivity kernel compiled for AVX2
+ */
+__attribute__((target("avx2"))) static size_t sensitivity_kernel_avx2(int initial_enrollment, double growth_rate, int initial_year, size_t count, int* estimates, double* sensitivities)
+{
+	return sensitivity_kernel(initial_enrollment, growth_rate, initial_year, count, estimates, sensitivities);
+}
+#endif
+
+/**
+ * @brief Sensitivity kernel compiled for the baseline instruction set (SSE2 on x86-64)
+ */
+static size_t sensitivity_kernel_baseline(int initial_enrollment, double growth_rate, int initial_year, size_t count, int* estimates, double* sensitivities)
+{
+	return sensitivity_kernel(initial_enrollment, growth_rate, initial_year, count, estimates, sensitivities);
+}
+
+size_t calculate_enrollment_sensitivities(int initial_enrollment, double growth_rate, int initial_year, int end_year, int* estimates, double* sensitivities)
+{
+	// Nothing to estimate if the range is empty
+	if (end_year < initial_year)
+	{
+		return 0;
+	}
+	size_t count = (size_t)((long long)end_year - initial_year + 1);
+
+	// Select the widest kernel the CPU supports; a growth factor of 0 or infinity has no useful inverse
+	size_t processed = 0;
+	double growth_factor = 1 + growth_rate;
+	if (growth_factor != 0.0 && isfinite(growth_factor))
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		if (__builtin_cpu_supports("avx2"))
+		{
+			processed = sensitivity_kernel_avx2(initial_enrollment, growth_rate, initial_year, count, estimates, sensitivities);
+		}
+		else
+#endif
+		{
+			processed = sensitivity_kernel_baseline(initial_enrollment, growth_rate, initial_year, count, estimates, sensitivities);
+		}
+	}
+
+	// Use pow for the remaining years
+	for (size_t i = processed; i < count; i++)
+	{
+		sensitivity_scalar(initial_enrollment, growth_rate, initial_year, i, &estimates[i], &sensitivities[i]);
+	}
+
+	return count;
+}
+
+bool sensitivity_grid_init(struct sensitivity_grid* grid, double min_rate, double rate_step, size_t rate_count, int first_year, int last_year)
+{
+	memset(grid, 0, sizeof(*grid));
+
+	// Reject an empty year range
+	if (last_year < first_year)
+	{
+		fprintf(stderr, "Could not create sensitivity grid: last year %d is before first year %d.\n", last_year, first_year);
+		return false;
+	}
+
+	// Pad rows to whole cache lines so every row starts aligned for the vector kernel
+	grid->first_year = first_year;
+	grid->last_year = last_year;
+	grid->year_count = (size_t)((long long)last_year - first_year + 1);
+	grid->rate_count = rate_count;
+	grid->stride = (rate_count + SENSITIVITY_CACHE_LINE_DOUBLES - 1) / SENSITIVITY_CACHE_LINE_DOUBLES * SENSITIVITY_CACHE_LINE_DOUBLES;
+
+	// Allocate the rates and both matrices, with at least one cache line so aligned_alloc gets a valid size
+	size_t value_count = grid->year_count * grid->stride;
+	if (grid->stride != 0 && value_count / grid->stride != grid->year_count)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(ENOMEM));
+		return false;
+	}
+	size_t rate_bytes = grid->stride == 0 ? SENSITIVITY_CACHE_LINE : grid->stride * sizeof(double);
+	size_t value_bytes = value_count == 0 ? SENSITIVITY_CACHE_LINE : value_count * sizeof(double);
+	grid->growth_rates = aligned_alloc(SENSITIVITY_CACHE_LINE, rate_bytes);
+	grid->estimates = aligned_alloc(SENSITIVITY_CACHE_LINE, value_bytes);
+	grid->sensitivities = aligned_alloc(SENSITIVITY_CACHE_LINE, value_bytes);
+	if (grid->growth_rates == NULL || grid->estimates == NULL || grid->sensitivities == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		sensitivity_grid_free(grid);
+		return false;
+	}
+
+	// Space the rates evenly, repeating the last rate in the padding
+	for (size_t i = 0; i < grid->stride; i++)
+	{
+		grid->growth_rates[i] = min_rate + (double)(i < rate_count ? i : rate_count - 1) * rate_step;
+	}
+
+	return true;
+}
+
+void sensitivity_grid_free(struct sensitivity_grid* grid)
+{
+	free(grid->growth_rates);
+	free(grid->estimates);
+	free(grid->sensitivities);
+	memset(grid, 0, sizeof(*grid));
+}
+
+/**
+ * @brief Fill every row of a sensitivity grid after the first from the row before it
+ * @param grid Grid whose first row is filled
+ */
+static inline __attribute__((always_inline)) void sensitivity_grid_kernel(struct sensitivity_grid* grid)
+{
+	for (size_t row = 1; row < grid->year_count; row++)
+	{
+		const double* previous = grid->estimates + (row - 1) * grid->stride;
+		double* estimates = grid->estimates + row * grid->stride;
+		double* sensitivities = grid->sensitivities + row * grid->stride;
+		double years = (double)row;
+
+		// Rows are whole cache lines, so the padding is processed with the real rates
+		for (size_t i = 0; i < grid->stride; i += VECTOR_DOUBLE_LANES)
+		{
+			vector_double growth_rate;
+			vector_double estimate;
+			memcpy(&growth_rate, grid->growth_rates + i, sizeof(growth_rate));
+			memcpy(&estimate, previous + i, sizeof(estimate));
+			vector_double sensitivity = estimate * years;
+			estimate *= 1.0 + growth_rate;
+			memcpy(estimates + i, &estimate, sizeof(estimate));
+			memcpy(sensitivities + i, &sensitivity, sizeof(sensitivity));
+		}
+	}
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @brief Grid kernel compiled for AVX2
+ */
+__attribute__((target("avx2"))) static void sensitivity_grid_kernel_avx2(struct sensitivity_grid* grid)
+{
+	sensitivity_grid_kernel(grid);
+}
+#endif
+
+/**
+ * @brief Grid kernel compiled for the baseline instruction set (SSE2 on x86-64)
+ */
+static void sensitivity_grid_kernel_baseline(struct sensitivity_grid* grid)
+{
+	sensitivity_grid_kernel(grid);
+}
+
+void calculate_sensitivity_grid(struct sensitivity_grid* grid, int initial_enrollment)
+{
+	// The first year is the initial enrollment at every rate, with no sensitivity
+	for (size_t i = 0; i < grid->stride; i++)
+	{
+		grid->estimates[i] = initial_enrollment;
+		grid->sensitivities[i] = 0.0;
+	}
+
+	// Select the widest kernel the CPU supports
+#if defined(__x86_64__) || defined(__i386__)
+	if (__builtin_cpu_supports("avx2"))
+	{
+		sensitivity_grid_kernel_avx2(grid);
+		return;
+	}
+#endif
+	sensitivity_grid_kernel_baseline(grid);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file sensitivity_hw1_wvuep.h
+ * @brief Header file for growth rate sensitivities of enrollment estimates for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * The estimate for year k after initial_year is initial_enrollment * (1 + rate)^k, so its
+ * derivative with respect to the rate is k * initial_enrollment * (1 + rate)^(k - 1), the same
+ * power divided by 1 + rate. Sensitivities are given per unit of growth rate; multiply by 1e-4
+ * for the change in enrollment per basis point.
+ *
+ * calculate_enrollment_sensitivities gives rounded estimates and their sensitivities for a range
+ * of years. A sensitivity grid sweeps a range of rates over a range of years for heatmaps, with
+ * unrounded estimates.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Number of years between re-anchoring the running growth factors with pow, a multiple of 4
+ */
+#ifndef SENSITIVITY_ANCHOR_INTERVAL
+	#define SENSITIVITY_ANCHOR_INTERVAL 32
+#endif
+
+/**
+ * @brief Unrounded estimates and sensitivities for a grid of growth rates and years
+ *
+ * The values for a year and rate are at [(year - first_year) * stride + rate_index], where the
+ * rate is growth_rates[rate_index]. Each row holds one year for every rate.
+ */
+struct sensitivity_grid {
+	int first_year; /**< Year of the first row, the initial year of the projection */
+	int last_year; /**< Year of the last row */
+	size_t year_count; /**< Number of rows */
+	size_t rate_count; /**< Number of rates */
+	size_t stride; /**< Distance between rows in doubles, rate_count rounded up to a cache line */
+	double* growth_rates; /**< Rate of each column */
+	double* estimates; /**< Unrounded estimates, one row per year */
+	double* sensitivities; /**< Derivatives of the estimates with respect to the rate, one row per year */
+};
+
+/**
+ * @brief Calculate the estimate and its sensitivity to the growth rate for each year between initial_year and end_year
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Required annual growth rate
+ * @param initial_year Year for initial enrollment
+ * @param end_year Last year to estimate
+ * @param estimates Output array with room for end_year - initial_year + 1 estimates, each equal to calculate_enrollment_estimate
+ * @param sensitivities Output array with room for end_year - initial_year + 1 derivatives of the unrounded estimate with respect to growth_rate
+ * @return Number of years written (0 if end_year is before initial_year)
+ */
+size_t calculate_enrollment_sensitivities(int initial_enrollment, double growth_rate, int initial_year, int end_year, int* estimates, double* sensitivities);
+
+/**
+ * @brief Allocate a sensitivity grid for evenly spaced growth rates
+ * @param grid Grid to initialize
+ * @param min_rate Rate of the first column
+ * @param rate_step Difference between the rates of adjacent columns
+ * @param rate_count Number of rates
+ * @param first_year Initial year of the projection
+ * @param last_year Last year to estimate, not before first_year
+ * @return True on success, false if the year range is empty or memory could not be allocated
+ */
+bool sensitivity_grid_init(struct sensitivity_grid* grid, double min_rate, double rate_step, size_t rate_count, int first_year, int last_year);
+
+/**
+ * @brief Free a sensitivity grid
+ * @param grid Grid to free
+ */
+void sensitivity_grid_free(struct sensitivity_grid* grid);
+
+/**
+ * @brief Fill a sensitivity grid for an initial enrollment in the grid's first year
+ *
+ * Each row is computed from the previous one: the estimate grows by 1 + rate and the
+ * sensitivity is k times the previous estimate, so no pow is needed. The relative error of an
+ * entry grows by about one rounding per year.
+ *
+ * @param grid Grid to fill
+ * @param initial_enrollment Enrollment in the grid's first year
+ */
+void calculate_sensitivity_grid(struct sensitivity_grid* grid, int initial_enrollment);
@@ -0,0 +1,143 @@
+/**
+ * @file series_hw1_wvuep.c
+ * @brief Source code file for incremental enrollment projection series for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * The running factor is multiplied by the growth factor once per year and reset to the exact
+ * pow value every ENROLLMENT_SERIES_ANCHOR_INTERVAL years, so its relative drift from pow is
+ * bounded by the number of multiplications since the last anchor. An estimate is only taken
+ * from the running factor when it is far enough from a rounding boundary (k + 0.5) that the
+ * drift cannot change the rounded result; otherwise calculate_enrollment_estimate is called.
+ */
+
+#include "series_hw1_wvuep.h"
+#include "hw1_wvuep.h"
+#include <stdio.h>
+#include <math.h>
+
+/**
+ * @brief Largest magnitude converted from the running estimate without deferring to calculate_enrollment_estimate
+ */
+#define SERIES_MAX_ESTIMATE 2147483000.0
+
+/**
+ * @brief Relative error allowed per multiplication since the last anchor
+ *
+ * Twice the 2^-53 rounding error of one multiplication, which also covers pow's one-ULP error.
+ */
+#define SERIES_ERROR_PER_STEP 0x1p-52
+
+/**
+ * @brief Extra steps of error added for the anchor and the product with the initial enrollment
+ */
+#define SERIES_ERROR_BASE_STEPS 8
+
+void enrollment_series_init(struct enrollment_series* series, int initial_enrollment, double growth_rate, int initial_year)
+{
+	// Store parameters
+	series->initial_enrollment = initial_enrollment;
+	series->growth_rate = growth_rate;
+	series->growth_factor = 1 + growth_rate;
+	series->initial_year = initial_year;
+
+	// Start at initial_year with the factor anchored to pow(growth_factor, 0)
+	series->year = initial_year;
+	series->running_factor = 1.0;
+	series->years_since_anchor = 0;
+}
+
+void enrollment_series_seek(struct enrollment_series* series, int year)
+{
+	// Force the next estimate to re-anchor at the new year
+	series->year = year;
+	series->years_since_anchor = ENROLLMENT_SERIES_ANCHOR_INTERVAL;
+}
+
+/**
+ * @brief Get the estimate for the series' current year and advance, inlined into the table loops
+ * @param series Series to advance
+ * @return Same value as calculate_enrollment_estimate for the series' current year
+ */
+static inline int series_next(struct enrollment_series* series)
+{
+	// Re-anchor the running factor with the exact pow value when the interval has elapsed
+	if (series->years_since_anchor >= ENROLLMENT_SERIES_ANCHOR_INTERVAL)
+	{
+		series->running_factor = pow(series->growth_factor, series->year - series->initial_year);
+		series->years_since_anchor = 0;
+	}
+
+	// Estimate from the running factor
+	int estimate_enrollment;
+	double estimate = series->initial_enrollment * series->running_factor;
+	double magnitude = fabs(estimate);
+
+	// Use the estimate only when drift cannot move it across a rounding boundary (NaN fails the range check)
+	if (magnitude < SERIES_MAX_ESTIMATE)
+	{
+		// Split into whole and fractional parts with an inline conversion instead of calling floor or round
+		long long whole = (long long)magnitude;
+		double fraction = magnitude - (double)whole;
+		double error_bound = magnitude * SERIES_ERROR_PER_STEP * (series->years_since_anchor + SERIES_ERROR_BASE_STEPS);
+		if (fabs(fraction - 0.5) > error_bound)
+		{
+			// Round half away from zero, matching round
+			long long rounded = whole + (fraction > 0.5);
+			estimate_enrollment = (int)(estimate < 0 ? -rounded : rounded);
+		}
+		else
+		{
+			estimate_enrollment = calculate_enrollment_estimate(series->initial_enrollment, series->growth_rate, series->initial_year, series->year);
+		}
+	}
+	else
+	{
+		estimate_enrollment = calculate_enrollment_estimate(series->initial_enrollment, series->growth_rate, series->initial_year, series->year);
+	}
+
+	// Advance to the next year
+	series->running_factor *= series->growth_factor;
+	series->years_since_anchor++;
+	series->year++;
+
+	return estimate_enrollment;
+}
+
+int enrollment_series_next(struct enrollment_series* series)
+{
+	return series_next(series);
+}
+
+size_t calculate_enrollment_estimates(int initial_enrollment, double growth_rate, int initial_year, int end_year, int* estimates)
+{
+	// Nothing to estimate if the range is empty
+	if (end_year < initial_year)
+	{
+		return 0;
+	}
+
+	// Run the series across the full range
+	struct enrollment_series series;
+	enrollment_series_init(&series, initial_enrollment, growth_rate, initial_year);
+
+	size_t count = (size_t)((long long)end_year - initial_year + 1);
+	for (size_t i = 0; i < count; i++)
+	{
+		estimates[i] = series_next(&series);
+	}
+
+	return count;
+}
+
+void print_enrollment_estimate_series(int initial_enrollment, double growth_rate, int initial_year, int end_year)
+{
+	// Start the series at initial_year
+	struct enrollment_series series;
+	enrollment_series_init(&series, initial_enrollment, growth_rate, initial_year);
+
+	for (int i = initial_year; i <= end_year; i++)
+	{
+		printf("%d enrollment estimate: %d\n", i, series_next(&series));
+	}
+}
@@ -0,0 +1,82 @@
+/**
+ * @file series_hw1_wvuep.h
+ * @brief Header file for incremental enrollment projection series for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * A projection series produces the estimate for consecutive years by keeping a running growth
+ * factor instead of calling pow for every year. Every estimate is identical to the one returned
+ * by calculate_enrollment_estimate for the same year.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * @brief Number of years between re-anchoring the running growth factor with pow
+ */
+#ifndef ENROLLMENT_SERIES_ANCHOR_INTERVAL
+	#define ENROLLMENT_SERIES_ANCHOR_INTERVAL 32
+#endif
+
+/**
+ * @brief State of a projection series between calls to enrollment_series_next
+ */
+struct enrollment_series {
+	int initial_enrollment; /**< Enrollment in initial_year */
+	double growth_rate; /**< Annual growth rate */
+	double growth_factor; /**< 1 + growth_rate, computed once */
+	int initial_year; /**< Year for initial enrollment */
+	int year; /**< Year returned by the next call to enrollment_series_next */
+	double running_factor; /**< Approximation of growth_factor^(year - initial_year) */
+	int years_since_anchor; /**< Multiplications applied to running_factor since it was last set with pow */
+};
+
+/**
+ * @brief Start a projection series at initial_year
+ * @param series Series to initialize
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Required annual growth rate
+ * @param initial_year Year for initial enrollment
+ */
+void enrollment_series_init(struct enrollment_series* series, int initial_enrollment, double growth_rate, int initial_year);
+
+/**
+ * @brief Move a projection series to any year, before or after initial_year
+ *
+ * The next call to enrollment_series_next re-anchors the running factor with pow.
+ *
+ * @param series Series to move
+ * @param year Year returned by the next call to enrollment_series_next
+ */
+void enrollment_series_seek(struct enrollment_series* series, int year);
+
+/**
+ * @brief Get the estimate for the series' current year and advance to the next year
+ * @param series Series to advance
+ * @return Same value as calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, year)
+ */
+int enrollment_series_next(struct enrollment_series* series);
+
+/**
+ * @brief Calculate the estimated enrollment for each year between initial_year and end_year
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Required annual growth rate
+ * @param initial_year Year for initial enrollment
+ * @param end_year Last year to estimate
+ * @param estimates Output array with room for end_year - initial_year + 1 estimates
+ * @return Number of estimates written (0 if end_year is before initial_year)
+ */
+size_t calculate_enrollment_estimates(int initial_enrollment, double growth_rate, int initial_year, int end_year, int* estimates);
+
+/**
+ * @brief Print the estimated enrollment for each year between initial_year and end_year using a projection series
+ *
+ * Produces the same output as print_enrollment_estimates.
+ *
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Required annual growth rate
+ * @param initial_year Year for initial enrollment
+ * @param end_year Last year for printing enrollment
+ */
+void print_enrollment_estimate_series(int initial_enrollment, double growth_rate, int initial_year, int end_year);
@@ -0,0 +1,595 @@
+/**
+ * @file server_hw1_wvuep.c
+ * @brief Source code file for the projection query server for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * The event loop is level-triggered. A readable connection gets one read into its input
+ * buffer, every complete request in the buffer is answered into its output buffer, and the
+ * output is sent until the socket would block. While output is left over the connection waits
+ * only for writability, so a client that does not read its answers stops being read from
+ * instead of growing the server's buffers.
+ */
+
+// Use GNU source for accept4
+#define _GNU_SOURCE // NOLINT(*-reserved-identifier)
+
+#include "server_hw1_wvuep.h"
+#include "hw1_wvuep.h"
+#include "series_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/**
+ * @brief Number of requests a connection reads at a time
+ */
+#define PROJECTION_SERVER_READ_REQUESTS 64
+
+/**
+ * @brief Number of events taken from epoll at a time
+ */
+#define PROJECTION_SERVER_MAX_EVENTS 64
+
+/**
+ * @brief Number of pending connections the listening socket queues
+ */
+#define PROJECTION_SERVER_BACKLOG 128
+
+/**
+ * @brief Size of the longest answer in bytes
+ */
+#define PROJECTION_RESPONSE_MAX_SIZE (sizeof(struct projection_response) + PROJECTION_SERVER_MAX_YEARS * sizeof(int32_t))
+
+/**
+ * @brief Client connection with its unprocessed input and unsent output
+ */
+struct projection_connection {
+	int fd; /**< Connected socket */
+	struct projection_connection* previous; /**< Previous connection in the server's list */
+	struct projection_connection* next; /**< Next connection in the server's list */
+	char input[PROJECTION_SERVER_READ_REQUESTS * sizeof(struct projection_request)]; /**< Bytes of requests not yet answered */
+	size_t input_length; /**< Number of bytes in input */
+	char* output; /**< Answers not yet sent */
+	size_t output_length; /**< Number of bytes in output */
+	size_t output_sent; /**< Number of bytes of output already sent */
+	size_t output_capacity; /**< Number of bytes output can hold */
+};
+
+bool projection_server_open(struct projection_server* server, const char* path)
+{
+	memset(server, 0, sizeof(*server));
+	server->listen_fd = server->epoll_fd = server->wake_fd = -1;
+
+	// The path must fit in a socket address
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(address.sun_path) || strlen(path) >= sizeof(server->path))
+	{
+		fprintf(stderr, "Could not open projection server: socket path %s is too long.\n", path);
+		return false;
+	}
+	strcpy(address.sun_path, path);
+
+	// Allocate the cache
+	server->cache = calloc(PROJECTION_CACHE_SLOTS, sizeof(struct projection_cache_entry));
+	if (server->cache == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return false;
+	}
+
+	// Replace a socket left by an earlier server, but never another kind of file
+	struct stat status;
+	if (lstat(path, &status) == 0 && S_ISSOCK(status.st_mode))
+	{
+		unlink(path);
+	}
+
+	// Listen on the socket and watch it and the wake-up descriptor
+	server->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (server->listen_fd < 0 || bind(server->listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0)
+	{
+		fprintf(stderr, "Could not open projection server on %s: %s.\n", path, strerror(errno));
+		projection_server_close(server);
+		return false;
+	}
+	strcpy(server->path, path);
+	server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	server->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	struct epoll_event listen_event = { .events = EPOLLIN, .data.ptr = &server->listen_fd };
+	struct epoll_event wake_event = { .events = EPOLLIN, .data.ptr = &server->wake_fd };
+	if (listen(server->listen_fd, PROJECTION_SERVER_BACKLOG) != 0 || server->epoll_fd < 0 || server->wake_fd < 0 ||
+		epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd, &listen_event) != 0 || epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->wake_fd, &wake_event) != 0)
+	{
+		fprintf(stderr, "Could not open projection server on %s: %s.\n", path, strerror(errno));
+		projection_server_close(server);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Close a connection and remove it from the server's list
+ * @param server Server owning the connection
+ * @param connection Connection to close
+ */
+static void projection_connection_close(struct projection_server* server, struct projection_connection* connection)
+{
+	if (connection->previous != NULL)
+	{
+		connection->previous->next = connection->next;
+	}
+	else
+	{
+		server->connections = connection->next;
+	}
+	if (connection->next != NULL)
+	{
+		connection->next->previous = connection->previous;
+	}
+
+	// Closing the socket also removes it from epoll
+	close(connection->fd);
+	free(connection->output);
+	free(connection);
+}
+
+void projection_server_close(struct projection_server* server)
+{
+	while (server->connections != NULL)
+	{
+		projection_connection_close(server, server->connections);
+	}
+	if (server->listen_fd >= 0)
+	{
+		close(server->listen_fd);
+	}
+	if (server->epoll_fd >= 0)
+	{
+		close(server->epoll_fd);
+	}
+	if (server->wake_fd >= 0)
+	{
+		close(server->wake_fd);
+	}
+	if (server->path[0] != '\0')
+	{
+		unlink(server->path);
+	}
+	if (server->cache != NULL)
+	{
+		for (size_t i = 0; i < PROJECTION_CACHE_SLOTS; i++)
+		{
+			free(server->cache[i].response);
+		}
+		free(server->cache);
+	}
+	memset(server, 0, sizeof(*server));
+	server->listen_fd = server->epoll_fd = server->wake_fd = -1;
+}
+
+void projection_server_stop(struct projection_server* server)
+{
+	// write is async-signal-safe; a full counter still wakes the loop
+	uint64_t one = 1;
+	ssize_t written = write(server->wake_fd, &one, sizeof(one));
+	(void)written;
+}
+
+/**
+ * @brief Check the parameters of a request
+ * @param request Request to check
+ * @return True if the request can be answered
+ */
+static bool projection_request_valid(const struct projection_request* request)
+{
+	long long year_count = (long long)request->last_year - request->first_year + 1;
+
+	return request->initial_enrollment > 0 && request->target_enrollment >= 0 && request->target_year != request->initial_year && year_count >= 1 && year_count <= PROJECTION_SERVER_MAX_YEARS;
+}
+
+/**
+ * @brief Project a request into an answer
+ * @param request Valid request
+ * @param response Buffer of at least PROJECTION_RESPONSE_MAX_SIZE bytes, aligned for a projection_response
+ * @return Length of the answer in bytes
+ */
+static size_t projection_answer(const struct projection_request* request, char* response)
+{
+	struct projection_response* header = (struct projection_response*)response;
+	int32_t* estimates = (int32_t*)(header + 1);
+
+	// Calculate the rate and walk a series over the requested years
+	header->status = PROJECTION_STATUS_OK;
+	header->year_count = (uint32_t)((long long)request->last_year - request->first_year + 1);
+	header->growth_rate = calculate_growth_rate(request->initial_enrollment, request->target_enrollment, request->initial_year, request->target_year);
+	struct enrollment_series series;
+	enrollment_series_init(&series, request->initial_enrollment, header->growth_rate, request->initial_year);
+	enrollment_series_seek(&series, request->first_year);
+	for (uint32_t i = 0; i < header->year_count; i++)
+	{
+		estimates[i] = enrollment_series_next(&series);
+	}
+
+	return sizeof(*header) + header->year_count * sizeof(int32_t);
+}
+
+/**
+ * @brief Hash a request to pick its cache slot
+ * @param request Request to hash
+ * @return Slot index below PROJECTION_CACHE_SLOTS
+ */
+static size_t projection_cache_slot(const struct projection_request* request)
+{
+	// Mix each field into the hash with a multiply and take the high bits
+	const int32_t fields[] = { request->initial_enrollment, request->target_enrollment, request->initial_year, request->target_year, request->first_year, request->last_year };
+	uint64_t hash = 0;
+	for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+	{
+		hash = (hash ^ (uint32_t)fields[i]) * 0x9E3779B97F4A7C15u;
+	}
+
+	return (size_t)(hash >> 32) & (PROJECTION_CACHE_SLOTS - 1);
+}
+
+/**
+ * @brief Make room for more output on a connection
+ * @param connection Connection to grow
+ * @param length Number of bytes about to be appended
+ * @return True on success, false if memory could not be allocated
+ */
+static bool projection_connection_reserve(struct projection_connection* connection, size_t length)
+{
+	// Drop bytes already sent before growing
+	if (connection->output_sent > 0)
+	{
+		memmove(connection->output, connection->output + connection->output_sent, connection->output_length - connection->output_sent);
+		connection->output_length -= connection->output_sent;
+		connection->output_sent = 0;
+	}
+	if (connection->output_length + length <= connection->output_capacity)
+	{
+		return true;
+	}
+
+	size_t capacity = connection->output_capacity == 0 ? PROJECTION_RESPONSE_MAX_SIZE : connection->output_capacity;
+	while (capacity < connection->output_length + length)
+	{
+		capacity *= 2;
+	}
+	char* output = realloc(connection->output, capacity);
+	if (output == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return false;
+	}
+	connection->output = output;
+	connection->output_capacity = capacity;
+
+	return true;
+}
+
+/**
+ * @brief Answer one request into a connection's output, from the cache when possible
+ * @param server Server owning the cache
+ * @param connection Connection to answer on
+ * @param request Request to answer
+ * @return True on success, false if memory could not be allocated
+ */
+static bool projection_server_answer(struct projection_server* server, struct projection_connection* connection, const struct projection_request* request)
+{
+	server->requests++;
+
+	// Answer invalid requests with just a status
+	if (!projection_request_valid(request))
+	{
+		struct projection_response invalid = { PROJECTION_STATUS_INVALID, 0, 0.0 };
+		if (!projection_connection_reserve(connection, sizeof(invalid)))
+		{
+			return false;
+		}
+		memcpy(connection->output + connection->output_length, &invalid, sizeof(invalid));
+		connection->output_length += sizeof(invalid);
+		return true;
+	}
+
+	// Fill the request's slot on a miss, replacing whatever answer was there
+	struct projection_cache_entry* entry = &server->cache[projection_cache_slot(request)];
+	if (entry->length != 0 && memcmp(&entry->request, request, sizeof(*request)) == 0)
+	{
+		server->cache_hits++;
+	}
+	else
+	{
+		if (entry->response == NULL)
+		{
+			entry->response = malloc(PROJECTION_RESPONSE_MAX_SIZE);
+			if (entry->response == NULL)
+			{
+				fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+				return false;
+			}
+		}
+		entry->request = *request;
+		entry->length = projection_answer(request, entry->response);
+	}
+
+	// Copy the cached answer into the output
+	if (!projection_connection_reserve(connection, entry->length))
+	{
+		return false;
+	}
+	memcpy(connection->output + connection->output_length, entry->response, entry->length);
+	connection->output_length += entry->length;
+
+	return true;
+}
+
+/**
+ * @brief Send as much of a connection's output as the socket takes and choose the events to wait for
+ * @param server Server owning the connection
+ * @param connection Connection to flush
+ * @return True on success, false if the connection failed and was closed
+ */
+static bool projection_connection_flush(struct projection_server* server, struct projection_connection* connection)
+{
+	while (connection->output_sent < connection->output_length)
+	{
+		ssize_t sent = send(connection->fd, connection->output + connection->output_sent, connection->output_length - connection->output_sent, MSG_NOSIGNAL);
+		if (sent < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				break;
+			}
+			projection_connection_close(server, connection);
+			return false;
+		}
+		connection->output_sent += (size_t)sent;
+	}
+
+	// Read more requests only once every answer is sent
+	struct epoll_event event = { .events = EPOLLIN, .data.ptr = connection };
+	if (connection->output_sent < connection->output_length)
+	{
+		event.events = EPOLLOUT;
+	}
+	else
+	{
+		connection->output_length = connection->output_sent = 0;
+	}
+	if (epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, connection->fd, &event) != 0)
+	{
+		projection_connection_close(server, connection);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Read from a connection and answer every complete request
+ * @param server Server owning the connection
+ * @param connection Readable connection
+ */
+static void projection_connection_read(struct projection_server* server, struct projection_connection* connection)
+{
+	ssize_t bytes_read = read(connection->fd, connection->input + connection->input_length, sizeof(connection->input) - connection->input_length);
+	if (bytes_read < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+	{
+		return;
+	}
+	if (bytes_read <= 0)
+	{
+		// End of stream or an error closes the connection
+		projection_connection_close(server, connection);
+		return;
+	}
+	connection->input_length += (size_t)bytes_read;
+
+	// Answer the complete requests and keep a partial one for the next read
+	size_t offset = 0;
+	while (connection->input_length - offset >= sizeof(struct projection_request))
+	{
+		struct projection_request request;
+		memcpy(&request, connection->input + offset, sizeof(request));
+		if (!projection_server_answer(server, connection, &request))
+		{
+			projection_connection_close(server, connection);
+			return;
+		}
+		offset += sizeof(request);
+	}
+	memmove(connection->input, connection->input + offset, connection->input_length - offset);
+	connection->input_length -= offset;
+
+	projection_connection_flush(server, connection);
+}
+
+/**
+ * @brief Accept every pending connection
+ * @param server Server whose listening socket is readable
+ */
+static void projection_server_accept(struct projection_server* server)
+{
+	while (true)
+	{
+		int fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+			{
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				fprintf(stderr, "Could not accept connection: %s.\n", strerror(errno));
+			}
+			return;
+		}
+
+		// Track the connection and wait for its requests
+		struct projection_connection* connection = calloc(1, sizeof(*connection));
+		struct epoll_event event = { .events = EPOLLIN, .data.ptr = connection };
+		if (connection == NULL || epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+		{
+			fprintf(stderr, "Could not accept connection: %s.\n", strerror(errno));
+			free(connection);
+			close(fd);
+			continue;
+		}
+		connection->fd = fd;
+		connection->next = server->connections;
+		if (server->connections != NULL)
+		{
+			server->connections->previous = connection;
+		}
+		server->connections = connection;
+	}
+}
+
+bool projection_server_run(struct projection_server* server)
+{
+	struct epoll_event events[PROJECTION_SERVER_MAX_EVENTS];
+	while (true)
+	{
+		int event_count = epoll_wait(server->epoll_fd, events, PROJECTION_SERVER_MAX_EVENTS, -1);
+		if (event_count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			fprintf(stderr, "Could not wait for events: %s.\n", strerror(errno));
+			return false;
+		}
+
+		for (int i = 0; i < event_count; i++)
+		{
+			void* source = events[i].data.ptr;
+			if (source == &server->wake_fd)
+			{
+				// Consume the wake-up so the next run does not stop at once
+				uint64_t count;
+				ssize_t bytes_read = read(server->wake_fd, &count, sizeof(count));
+				(void)bytes_read;
+				return true;
+			}
+			if (source == &server->listen_fd)
+			{
+				projection_server_accept(server);
+				continue;
+			}
+
+			// Errors and hang-ups show up as a failed read or send
+			struct projection_connection* connection = source;
+			if (events[i].events & EPOLLOUT)
+			{
+				projection_connection_flush(server, connection);
+			}
+			else
+			{
+				projection_connection_read(server, connection);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Transfer all bytes over a socket, continuing after partial transfers and interruptions
+ * @param fd Socket
+ * @param data Bytes to send or buffer to receive into
+ * @param length Number of bytes
+ * @param sending True to send, false to receive
+ * @return True on success, false if the transfer failed or the stream ended
+ */
+static bool projection_client_transfer(int fd, void* data, size_t length, bool sending)
+{
+	char* bytes = data;
+	while (length > 0)
+	{
+		ssize_t result = sending ? send(fd, bytes, length, MSG_NOSIGNAL) : recv(fd, bytes, length, 0);
+		if (result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (result <= 0)
+		{
+			return false;
+		}
+		bytes += result;
+		length -= (size_t)result;
+	}
+
+	return true;
+}
+
+bool projection_client_connect(struct projection_client* client, const char* path)
+{
+	client->fd = -1;
+
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(address.sun_path))
+	{
+		fprintf(stderr, "Could not connect to projection server: socket path %s is too long.\n", path);
+		return false;
+	}
+	strcpy(address.sun_path, path);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0 || connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0)
+	{
+		fprintf(stderr, "Could not connect to projection server on %s: %s.\n", path, strerror(errno));
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return false;
+	}
+	client->fd = fd;
+
+	return true;
+}
+
+bool projection_client_query(struct projection_client* client, const struct projection_request* request, struct projection_response* response, int32_t* estimates, size_t capacity)
+{
+	// Send the request and read the start of the answer
+	if (!projection_client_transfer(client->fd, (void*)request, sizeof(*request), true) || !projection_client_transfer(client->fd, response, sizeof(*response), false))
+	{
+		return false;
+	}
+
+	// Read the estimates
+	if (response->year_count > capacity)
+	{
+		fprintf(stderr, "Could not read projection: %u estimates do not fit in %zu.\n", response->year_count, capacity);
+		return false;
+	}
+
+	return projection_client_transfer(client->fd, estimates, response->year_count * sizeof(int32_t), false);
+}
+
+void projection_client_close(struct projection_client* client)
+{
+	if (client->fd >= 0)
+	{
+		close(client->fd);
+	}
+	client->fd = -1;
+}
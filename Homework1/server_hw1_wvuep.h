@@ -0,0 +1,151 @@
+/**
+ * @file server_hw1_wvuep.h
+ * @brief Header file for the projection query server for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * A projection server listens on a Unix domain stream socket and answers binary projection
+ * requests with an epoll event loop on one thread. A request is a struct projection_request;
+ * the answer is a struct projection_response followed by year_count int32 estimates for
+ * first_year through last_year. Clients may send several requests before reading the answers,
+ * which come back in order. Values use the byte order of the machine, since both ends are local.
+ *
+ * Answers are memoized in a direct-mapped cache keyed on the whole request, so repeated
+ * requests are copied from the cache instead of being projected again.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Most years a request may ask for
+ */
+#define PROJECTION_SERVER_MAX_YEARS 1024
+
+/**
+ * @brief Number of answers the server's cache holds, a power of 2
+ */
+#ifndef PROJECTION_CACHE_SLOTS
+	#define PROJECTION_CACHE_SLOTS 4096
+#endif
+
+/**
+ * @brief Projection request sent by a client
+ */
+struct projection_request {
+	int32_t initial_enrollment; /**< Enrollment in initial_year, greater than 0 */
+	int32_t target_enrollment; /**< Target enrollment for target_year */
+	int32_t initial_year; /**< Year for initial enrollment */
+	int32_t target_year; /**< Year for target enrollment, not initial_year */
+	int32_t first_year; /**< First year to estimate */
+	int32_t last_year; /**< Last year to estimate, at most PROJECTION_SERVER_MAX_YEARS - 1 after first_year */
+};
+
+/**
+ * @brief Outcome of a request
+ */
+enum projection_status {
+	PROJECTION_STATUS_OK, /**< The estimates follow */
+	PROJECTION_STATUS_INVALID, /**< The request's parameters are invalid; no estimates follow */
+};
+
+/**
+ * @brief Start of the server's answer to a request
+ */
+struct projection_response {
+	int32_t status; /**< enum projection_status */
+	uint32_t year_count; /**< Number of int32 estimates that follow */
+	double growth_rate; /**< Growth rate calculated from the request */
+};
+
+/**
+ * @brief Client connection with its unprocessed input and unsent output
+ */
+struct projection_connection;
+
+/**
+ * @brief Cached answer to one request
+ */
+struct projection_cache_entry {
+	struct projection_request request; /**< Request answered */
+	size_t length; /**< Length of the answer in bytes, 0 if the slot is empty */
+	char* response; /**< Answer, a projection_response and its estimates */
+};
+
+/**
+ * @brief Projection server
+ */
+struct projection_server {
+	int listen_fd; /**< Listening socket */
+	int epoll_fd; /**< Event loop */
+	int wake_fd; /**< Event descriptor written by projection_server_stop */
+	char path[108]; /**< Path of the socket, removed when the server is closed */
+	struct projection_connection* connections; /**< Open client connections */
+	struct projection_cache_entry* cache; /**< PROJECTION_CACHE_SLOTS cached answers */
+	size_t requests; /**< Number of requests answered */
+	size_t cache_hits; /**< Number of requests answered from the cache */
+};
+
+/**
+ * @brief Client connection to a projection server
+ */
+struct projection_client {
+	int fd; /**< Connected socket */
+};
+
+/**
+ * @brief Create a projection server listening on a Unix domain socket
+ *
+ * A socket left at path by an earlier server is replaced.
+ *
+ * @param server Server to initialize
+ * @param path Path of the socket, shorter than 108 bytes
+ * @return True on success, false if the socket could not be created or memory could not be allocated
+ */
+bool projection_server_open(struct projection_server* server, const char* path);
+
+/**
+ * @brief Answer requests until projection_server_stop is called
+ * @param server Open server
+ * @return True if the server was stopped, false if the event loop failed
+ */
+bool projection_server_run(struct projection_server* server);
+
+/**
+ * @brief Make projection_server_run return; safe to call from another thread or a signal handler
+ * @param server Open server
+ */
+void projection_server_stop(struct projection_server* server);
+
+/**
+ * @brief Close every connection and the socket, remove the socket's path and free the cache
+ * @param server Server to close
+ */
+void projection_server_close(struct projection_server* server);
+
+/**
+ * @brief Connect to a projection server
+ * @param client Client to initialize
+ * @param path Path of the server's socket
+ * @return True on success, false if the connection failed
+ */
+bool projection_client_connect(struct projection_client* client, const char* path);
+
+/**
+ * @brief Send a request and wait for its answer
+ * @param client Connected client
+ * @param request Request to send
+ * @param response Start of the answer
+ * @param estimates Array receiving the estimates
+ * @param capacity Number of estimates the array can hold, at least the number of years requested
+ * @return True on success, false if the connection failed or the answer did not fit
+ */
+bool projection_client_query(struct projection_client* client, const struct projection_request* request, struct projection_response* response, int32_t* estimates, size_t capacity);
+
+/**
+ * @brief Close a client connection
+ * @param client Client to close
+ */
+void projection_client_close(struct projection_client* client);
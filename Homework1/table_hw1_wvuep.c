@@ -0,0 +1,256 @@
+/**
+ * @file table_hw1_wvuep.c
+ * @brief Source code file for buffered enrollment estimate tables for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * print_enrollment_estimates calls printf once per year, and with stdout unbuffered each line
+ * becomes its own write system call. These functions format whole tables into memory with a
+ * hand-written integer formatter and hand the result to the kernel in one write.
+ */
+
+#include "table_hw1_wvuep.h"
+#include "hw1_wvuep.h"
+#include "series_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+/**
+ * @brief Size of the stack buffer print_enrollment_estimates_buffered tries before allocating
+ */
+#define TABLE_STACK_BUFFER_SIZE 4096
+
+/**
+ * @brief Text between the year and the estimate on each line
+ */
+#define TABLE_LINE_TEXT " enrollment estimate: "
+
+/**
+ * @brief Decimal digits of 00 through 99, used to format two digits per division
+ */
+static const char digit_pairs[200] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+bool table_buffer_init(struct table_buffer* buffer, char* storage, size_t capacity)
+{
+	buffer->length = 0;
+
+	// Use caller-provided memory as-is
+	if (storage != NULL)
+	{
+		buffer->data = storage;
+		buffer->capacity = capacity;
+		buffer->owns_data = false;
+		return true;
+	}
+
+	// Allocate an arena that grows as tables are appended
+	if (capacity == 0)
+	{
+		capacity = TABLE_STACK_BUFFER_SIZE;
+	}
+	buffer->data = malloc(capacity);
+	if (buffer->data == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		buffer->capacity = 0;
+		buffer->owns_data = false;
+		return false;
+	}
+	buffer->capacity = capacity;
+	buffer->owns_data = true;
+
+	return true;
+}
+
+void table_buffer_free(struct table_buffer* buffer)
+{
+	// Only free memory the buffer allocated
+	if (buffer->owns_data)
+	{
+		free(buffer->data);
+	}
+
+	buffer->data = NULL;
+	buffer->length = 0;
+	buffer->capacity = 0;
+	buffer->owns_data = false;
+}
+
+size_t format_int(char* output, int value)
+{
+	// Work with the magnitude as unsigned so INT_MIN does not overflow
+	unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+
+	// Fill digits from the right, two at a time
+	char digits[10];
+	char* end = digits + sizeof(digits);
+	char* start = end;
+	while (magnitude >= 100)
+	{
+		unsigned int pair = magnitude % 100;
+		magnitude /= 100;
+		start -= 2;
+		memcpy(start, digit_pairs + 2 * pair, 2);
+	}
+	if (magnitude >= 10)
+	{
+		start -= 2;
+		memcpy(start, digit_pairs + 2 * magnitude, 2);
+	}
+	else
+	{
+		*--start = (char)('0' + magnitude);
+	}
+
+	// Copy sign and digits to output
+	size_t length = 0;
+	if (value < 0)
+	{
+		output[length++] = '-';
+	}
+	memcpy(output + length, start, (size_t)(end - start));
+
+	return length + (size_t)(end - start);
+}
+
+/**
+ * @brief Make sure a buffer has room for additional bytes, growing an arena if needed
+ * @param buffer Buffer to check
+ * @param additional Number of bytes about to be appended
+ * @return True if there is room, false otherwise
+ */
+static bool table_buffer_reserve(struct table_buffer* buffer, size_t additional)
+{
+	// Check if the text already fits
+	if (additional <= buffer->capacity - buffer->length)
+	{
+		return true;
+	}
+
+	// Caller-provided memory cannot grow
+	if (!buffer->owns_data)
+	{
+		return false;
+	}
+
+	// Grow the arena to at least double its size
+	size_t required = buffer->length + additional;
+	if (required < buffer->length)
+	{
+		return false;
+	}
+	size_t capacity = buffer->capacity * 2;
+	if (capacity < required)
+	{
+		capacity = required;
+	}
+
+	char* data = realloc(buffer->data, capacity);
+	if (data == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return false;
+	}
+	buffer->data = data;
+	buffer->capacity = capacity;
+
+	return true;
+}
+
+bool table_buffer_append_enrollment_estimates(struct table_buffer* buffer, int initial_enrollment, double growth_rate, int initial_year, int end_year)
+{
+	// Nothing to append if the range is empty
+	if (end_year < initial_year)
+	{
+		return true;
+	}
+
+	// Reserve room for the longest possible lines so the loop needs no bounds checks
+	size_t lines = (size_t)((long long)end_year - initial_year + 1);
+	if (lines > (size_t)-1 / TABLE_MAX_LINE_LENGTH || !table_buffer_reserve(buffer, lines * TABLE_MAX_LINE_LENGTH))
+	{
+		return false;
+	}
+
+	// Format each line with the same values print_enrollment_estimates prints
+	struct enrollment_series series;
+	enrollment_series_init(&series, initial_enrollment, growth_rate, initial_year);
+
+	char* output = buffer->data + buffer->length;
+	for (int i = initial_year; ; i++)
+	{
+		output += format_int(output, i);
+		memcpy(output, TABLE_LINE_TEXT, sizeof(TABLE_LINE_TEXT) - 1);
+		output += sizeof(TABLE_LINE_TEXT) - 1;
+		output += format_int(output, enrollment_series_next(&series));
+		*output++ = '\n';
+
+		// Stop without incrementing past end_year, which may be INT_MAX
+		if (i == end_year)
+		{
+			break;
+		}
+	}
+	buffer->length = (size_t)(output - buffer->data);
+
+	return true;
+}
+
+bool table_buffer_flush(struct table_buffer* buffer, int fd)
+{
+	// Write everything, continuing after partial writes and interruptions
+	size_t written = 0;
+	while (written < buffer->length)
+	{
+		ssize_t result = write(fd, buffer->data + written, buffer->length - written);
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			fprintf(stderr, "Could not write table: %s.\n", strerror(errno));
+			return false;
+		}
+		written += (size_t)result;
+	}
+
+	// Empty the buffer for the next tables
+	buffer->length = 0;
+
+	return true;
+}
+
+void print_enrollment_estimates_buffered(int initial_enrollment, double growth_rate, int initial_year, int end_year)
+{
+	// Format small tables on the stack
+	char storage[TABLE_STACK_BUFFER_SIZE];
+	struct table_buffer buffer;
+	table_buffer_init(&buffer, storage, sizeof(storage));
+	if (!table_buffer_append_enrollment_estimates(&buffer, initial_enrollment, growth_rate, initial_year, end_year))
+	{
+		// Format larger tables in an arena, printing line by line if it cannot be allocated
+		if (!table_buffer_init(&buffer, NULL, 0) || !table_buffer_append_enrollment_estimates(&buffer, initial_enrollment, growth_rate, initial_year, end_year))
+		{
+			table_buffer_free(&buffer);
+			print_enrollment_estimates(initial_enrollment, growth_rate, initial_year, end_year);
+			return;
+		}
+	}
+
+	// Keep output printed earlier through stdio ahead of the table
+	fflush(stdout);
+
+	// Write the whole table at once
+	table_buffer_flush(&buffer, STDOUT_FILENO);
+	table_buffer_free(&buffer);
+}
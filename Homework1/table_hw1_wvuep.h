@@ -0,0 +1,93 @@
+/**
+ * @file table_hw1_wvuep.h
+ * @brief Header file for buffered enrollment estimate tables for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * Tables are formatted into a memory buffer with the same text print_enrollment_estimates
+ * produces, then written to a file descriptor with a single write call. Several tables can
+ * be appended to one buffer before it is flushed.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Largest number of bytes one "YYYY enrollment estimate: N" line can take
+ *
+ * Two 11-character ints (including sign), 22 characters of text and a newline.
+ */
+#define TABLE_MAX_LINE_LENGTH 45
+
+/**
+ * @brief Text buffer that tables are formatted into
+ */
+struct table_buffer {
+	char* data; /**< Formatted text, not null-terminated */
+	size_t length; /**< Number of bytes of formatted text */
+	size_t capacity; /**< Number of bytes data can hold */
+	bool owns_data; /**< True if data was allocated by the buffer and may grow */
+};
+
+/**
+ * @brief Initialize a table buffer
+ * @param buffer Buffer to initialize
+ * @param storage Caller-provided memory to format into, or NULL to allocate a growable arena
+ * @param capacity Size of storage in bytes, or initial arena size if storage is NULL
+ * @return True on success, false if the arena could not be allocated
+ */
+bool table_buffer_init(struct table_buffer* buffer, char* storage, size_t capacity);
+
+/**
+ * @brief Free memory owned by a table buffer
+ * @param buffer Buffer to free
+ */
+void table_buffer_free(struct table_buffer* buffer);
+
+/**
+ * @brief Format an integer in decimal without calling printf
+ * @param output Destination with room for at least 11 characters
+ * @param value Value to format
+ * @return Number of characters written (no null terminator is written)
+ */
+size_t format_int(char* output, int value);
+
+/**
+ * @brief Append the enrollment estimate table for years initial_year through end_year
+ *
+ * The table is either appended completely or not at all.
+ *
+ * @param buffer Buffer to append to
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Required annual growth rate
+ * @param initial_year Year for initial enrollment
+ * @param end_year Last year for printing enrollment
+ * @return True on success, false if a caller-provided buffer is too small or the arena cannot grow
+ */
+bool table_buffer_append_enrollment_estimates(struct table_buffer* buffer, int initial_enrollment, double growth_rate, int initial_year, int end_year);
+
+/**
+ * @brief Write the buffered text to a file descriptor and empty the buffer
+ *
+ * Uses one write call unless the descriptor accepts only part of the text.
+ *
+ * @param buffer Buffer to flush
+ * @param fd File descriptor to write to
+ * @return True on success, false if write failed
+ */
+bool table_buffer_flush(struct table_buffer* buffer, int fd);
+
+/**
+ * @brief Print the estimated enrollment for each year between initial_year and end_year with a single write
+ *
+ * Produces the same output as print_enrollment_estimates. Pending stdout output is flushed first
+ * so the table appears in order. If the buffer cannot be allocated, the table is printed with
+ * print_enrollment_estimates instead.
+ *
+ * @param initial_enrollment Enrollment in initial_year
+ * @param growth_rate Required annual growth rate
+ * @param initial_year Year for initial enrollment
+ * @param end_year Last year for printing enrollment
+ */
+void print_enrollment_estimates_buffered(int initial_enrollment, double growth_rate, int initial_year, int end_year);
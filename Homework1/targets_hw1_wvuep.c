@@ -0,0 +1,258 @@
+/**
+ * @file targets_hw1_wvuep.c
+ * @brief Source code file for non-interactive target enrollment input for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * @details
+ * The stream is read in TARGET_READ_BUFFER_SIZE blocks and parsed in place. The parser keeps its
+ * state between blocks, so a token split across two reads needs no copying, and runs of digits
+ * are consumed by a tight inner loop rather than one pass through the state machine per byte.
+ */
+
+#include "targets_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/**
+ * @brief Number of targets and rejections allocated room for at first
+ */
+#define TARGET_INITIAL_CAPACITY 64
+
+/**
+ * @brief Magnitude above which further digits cannot bring a token back into int range
+ */
+#define TARGET_MAGNITUDE_CAP ((uint64_t)INT_MAX + 1)
+
+/**
+ * @brief Parser state kept between blocks of the stream
+ */
+struct target_parser {
+	struct target_enrollments* targets; /**< Result being filled */
+	size_t offset; /**< Byte offset of the next character */
+	size_t line; /**< Line of the next character */
+	size_t column; /**< Column of the next character */
+	bool in_token; /**< True while inside a token */
+	bool negative; /**< True if the current token started with '-' */
+	bool not_a_number; /**< True if the current token has a character other than a leading sign and digits */
+	size_t digits; /**< Number of digits in the current token */
+	uint64_t magnitude; /**< Value of the current token's digits, capped at TARGET_MAGNITUDE_CAP + 1 */
+	struct target_token_rejection start; /**< Position of the current token */
+};
+
+/**
+ * @brief Check if a character separates tokens, like isspace in the C locale
+ * @param character Character to check
+ * @return True for space, tab, newline, vertical tab, form feed and carriage return
+ */
+static inline bool target_is_space(char character)
+{
+	return character == ' ' || (unsigned char)(character - '\t') <= '\r' - '\t';
+}
+
+/**
+ * @brief Append a value to a growable array, doubling it when full
+ * @param array Pointer to the array
+ * @param count Pointer to the number of elements
+ * @param capacity Pointer to the number of elements the array can hold
+ * @param element_size Size of one element
+ * @param element Element to append
+ * @return True on success, false if memory could not be allocated
+ */
+static bool target_append(void** array, size_t* count, size_t* capacity, size_t element_size, const void* element)
+{
+	if (*count == *capacity)
+	{
+		size_t new_capacity = *capacity == 0 ? TARGET_INITIAL_CAPACITY : *capacity * 2;
+		void* new_array = realloc(*array, new_capacity * element_size);
+		if (new_array == NULL)
+		{
+			fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+			return false;
+		}
+		*array = new_array;
+		*capacity = new_capacity;
+	}
+
+	memcpy((char*)*array + *count * element_size, element, element_size);
+	(*count)++;
+
+	return true;
+}
+
+/**
+ * @brief Accept or reject the token that just ended
+ * @param parser Parser state
+ * @return True on success, false if memory could not be allocated
+ */
+static bool target_finish_token(struct target_parser* parser)
+{
+	struct target_enrollments* targets = parser->targets;
+	parser->in_token = false;
+
+	// Classify the token the way the prompt would treat the answer
+	if (parser->not_a_number || parser->digits == 0)
+	{
+		parser->start.problem = TARGET_TOKEN_NOT_A_NUMBER;
+	}
+	else if (parser->magnitude > (uint64_t)INT_MAX + parser->negative)
+	{
+		parser->start.problem = TARGET_TOKEN_OUT_OF_RANGE;
+	}
+	else if (parser->negative && parser->magnitude != 0)
+	{
+		parser->start.problem = TARGET_TOKEN_NEGATIVE;
+	}
+	else
+	{
+		int value = (int)parser->magnitude;
+		return target_append((void**)&targets->targets, &targets->count, &targets->capacity, sizeof(int), &value);
+	}
+
+	return target_append((void**)&targets->rejections, &targets->rejection_count, &targets->rejection_capacity, sizeof(struct target_token_rejection), &parser->start);
+}
+
+/**
+ * @brief Parse a block of the stream
+ * @param parser Parser state
+ * @param data Block of the stream
+ * @param length Number of bytes in the block
+ * @return True on success, false if memory could not be allocated
+ */
+static bool target_parse_block(struct target_parser* parser, const char* data, size_t length)
+{
+	size_t i = 0;
+	while (i < length)
+	{
+		char character = data[i];
+
+		// Whitespace ends a token and moves the position
+		if (target_is_space(character))
+		{
+			if (parser->in_token && !target_finish_token(parser))
+			{
+				return false;
+			}
+			if (character == '\n')
+			{
+				parser->line++;
+				parser->column = 1;
+			}
+			else
+			{
+				parser->column++;
+			}
+			parser->offset++;
+			i++;
+			continue;
+		}
+
+		// Start a token, taking a leading sign
+		size_t token_start = i;
+		if (!parser->in_token)
+		{
+			parser->in_token = true;
+			parser->negative = false;
+			parser->not_a_number = false;
+			parser->digits = 0;
+			parser->magnitude = 0;
+			parser->start.offset = parser->offset;
+			parser->start.line = parser->line;
+			parser->start.column = parser->column;
+			if (character == '-' || character == '+')
+			{
+				parser->negative = character == '-';
+				i++;
+			}
+		}
+
+		// Consume a run of digits without going back through the checks above
+		uint64_t magnitude = parser->magnitude;
+		size_t run_start = i;
+		while (i < length && (unsigned char)(data[i] - '0') < 10)
+		{
+			magnitude = magnitude * 10 + (uint64_t)(data[i] - '0');
+			if (magnitude > TARGET_MAGNITUDE_CAP)
+			{
+				magnitude = TARGET_MAGNITUDE_CAP + 1;
+			}
+			i++;
+		}
+		parser->magnitude = magnitude;
+		parser->digits += i - run_start;
+
+		// Anything else up to the next whitespace makes the token invalid
+		while (i < length && !target_is_space(data[i]) && (unsigned char)(data[i] - '0') >= 10)
+		{
+			parser->not_a_number = true;
+			i++;
+		}
+
+		parser->offset += i - token_start;
+		parser->column += i - token_start;
+	}
+
+	return true;
+}
+
+bool read_target_enrollments(int fd, struct target_enrollments* targets)
+{
+	memset(targets, 0, sizeof(*targets));
+	struct target_parser parser;
+	memset(&parser, 0, sizeof(parser));
+	parser.targets = targets;
+	parser.line = 1;
+	parser.column = 1;
+
+	char* buffer = malloc(TARGET_READ_BUFFER_SIZE);
+	if (buffer == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+		return false;
+	}
+
+	// Parse each block as it arrives, retrying interrupted reads
+	bool success = true;
+	while (success)
+	{
+		ssize_t bytes_read = read(fd, buffer, TARGET_READ_BUFFER_SIZE);
+		if (bytes_read < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			fprintf(stderr, "Could not read target enrollments: %s.\n", strerror(errno));
+			success = false;
+		}
+		else if (bytes_read == 0)
+		{
+			// End of stream ends the last token
+			success = !parser.in_token || target_finish_token(&parser);
+			break;
+		}
+		else
+		{
+			success = target_parse_block(&parser, buffer, (size_t)bytes_read);
+		}
+	}
+
+	free(buffer);
+	if (!success)
+	{
+		target_enrollments_free(targets);
+	}
+
+	return success;
+}
+
+void target_enrollments_free(struct target_enrollments* targets)
+{
+	free(targets->targets);
+	free(targets->rejections);
+	memset(targets, 0, sizeof(*targets));
+}
@@ -0,0 +1,71 @@
+/**
+ * @file targets_hw1_wvuep.h
+ * @brief Header file for non-interactive target enrollment input for CS 350 Homework #1
+ * @author Rashaan Clay
+ *
+ * Reads every target enrollment from a stream at once, for scripts that would otherwise answer
+ * prompt_target_enrollment one value at a time. Tokens are separated by whitespace and are
+ * validated the way the prompt validates answers: negative values are rejected, and tokens that
+ * are not integers are reported with their position. prompt_target_enrollment is unchanged.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Number of bytes read from the stream at a time
+ */
+#ifndef TARGET_READ_BUFFER_SIZE
+	#define TARGET_READ_BUFFER_SIZE 65536
+#endif
+
+/**
+ * @brief Reasons a token was not accepted as a target enrollment
+ */
+enum target_token_problem {
+	TARGET_TOKEN_NEGATIVE, /**< An integer below zero, which the prompt would ask for again */
+	TARGET_TOKEN_NOT_A_NUMBER, /**< Not an optionally signed run of digits */
+	TARGET_TOKEN_OUT_OF_RANGE, /**< Digits whose value does not fit in an int */
+};
+
+/**
+ * @brief Position and reason of a token that was not accepted
+ */
+struct target_token_rejection {
+	enum target_token_problem problem; /**< Why the token was rejected */
+	size_t offset; /**< Byte offset of the token's first character in the stream */
+	size_t line; /**< Line of the token, starting at 1 */
+	size_t column; /**< Column of the token's first character, starting at 1 */
+};
+
+/**
+ * @brief Target enrollments read from a stream
+ */
+struct target_enrollments {
+	int* targets; /**< Accepted targets in stream order */
+	size_t count; /**< Number of accepted targets */
+	size_t capacity; /**< Number of targets the array can hold */
+	struct target_token_rejection* rejections; /**< Rejected tokens in stream order */
+	size_t rejection_count; /**< Number of rejected tokens */
+	size_t rejection_capacity; /**< Number of rejections the array can hold */
+};
+
+/**
+ * @brief Read whitespace-separated target enrollments until the end of a stream
+ *
+ * Reads the descriptor directly, bypassing stdio, so it should not be mixed with scanf on the
+ * same stream.
+ *
+ * @param fd File descriptor to read, such as STDIN_FILENO or a pipe
+ * @param targets Targets to fill; initialized by this function and freed with target_enrollments_free
+ * @return True on success, false if the stream could not be read or memory could not be allocated
+ */
+bool read_target_enrollments(int fd, struct target_enrollments* targets);
+
+/**
+ * @brief Free the arrays of a target enrollments result
+ * @param targets Targets to free
+ */
+void target_enrollments_free(struct target_enrollments* targets);
@@ -0,0 +1,138 @@
+/**
+ * @file test_capture_hw1_wvuep.c
+ * @brief Tests of ctest CAPTURE_OUTPUT for CS 350 Homework #1: WVU Enrollment Problem
+ * @author Rashaan Clay
+ *
+ * Build together with unity.c and ctest.c compiled with CAPTURE_OUTPUT defined to the name of the
+ * capture file, as the Makefile does for the test_capture program. The overridden output functions
+ * then capture everything this program prints, so these tests cannot be part of test_hw1_wvuep.c.
+ */
+
+// Use GNU source for kill
+#define _GNU_SOURCE // NOLINT(*-reserved-identifier)
+
+// Set timeout for forked processes
+#define TIMEOUT_SECONDS 15
+
+#include "ctest.h"
+#include "unity.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#ifndef CAPTURE_OUTPUT
+#error "Define CAPTURE_OUTPUT to the name of the capture file when building test_capture_hw1_wvuep.c"
+#endif
+
+/**
+ * @brief Tracks if the helper_print_child_output function has been implemented, for CALL_FUNCTION_VOID
+ */
+static bool not_implemented_helper_print_child_output = false;
+
+/**
+ * @brief Tracks if the helper_print_child_output function has crashed, for CALL_FUNCTION_VOID
+ */
+static bool crashes_helper_print_child_output = false;
+
+void setUp(void)
+{
+	// set up test environment
+}
+
+void tearDown(void)
+{
+	// clean up test environment
+}
+
+/**
+ * @brief Function under test that prints a line in the forked child
+ */
+static void helper_print_child_output(void)
+{
+	printf("child output\n");
+}
+
+/**
+ * @brief Determines if the captured output contains the text, copying it for the check
+ * @param text Text to look for
+ * @return True if the text was captured, false otherwise
+ */
+static bool helper_captured_output_contains(const char* text)
+{
+	char* output = get_captured_output();
+	bool contains = output != NULL && strstr(output, text) != NULL;
+	free(output);
+
+	return contains;
+}
+
+static void test_capture_forked_function_output(void)
+{
+	// Output of a function called in a forked child comes back between its parent's lines
+	printf("parent before\n");
+	CALL_FUNCTION_VOID(helper_print_child_output);
+	printf("parent after\n");
+	TEST_ASSERT_TRUE_MESSAGE(helper_captured_output_contains("parent before\nchild output\nparent after\n"), "Output of the forked function was not captured in order.");
+}
+
+static void test_capture_output_of_killed_children(void)
+{
+	// A child leaving through _exit keeps its output
+	pid_t pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		puts("exited child");
+		_exit(0);
+	}
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(wait_for_child_pid(pid, TIMEOUT_MILLISECONDS)), "Child did not exit.");
+
+	// So does a child killed at its timeout
+	pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		fprintf(stdout, "killed child %d\n", 42);
+		while (true)
+		{
+			pause();
+		}
+	}
+	TEST_ASSERT_EQUAL_INT_MESSAGE(EXIT_TIMED_OUT, WEXITSTATUS(wait_for_child_pid(pid, 100)), "Child was not killed at its timeout.");
+	TEST_ASSERT_TRUE_MESSAGE(helper_captured_output_contains("exited child\nkilled child 42\n"), "Output of children that did not return from main was lost.");
+}
+
+static void test_capture_output_file(void)
+{
+	// The file holds the parent's and the children's output in the order it was written
+	flush_captured_output();
+	char* file_contents = read_file(CAPTURE_OUTPUT);
+	char* output = get_captured_output();
+	TEST_ASSERT_NOT_NULL_MESSAGE(file_contents, "Capture file could not be read.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(output, "Captured output could not be copied.");
+	TEST_ASSERT_EQUAL_STRING_MESSAGE(output, file_contents, "Capture file does not match the captured output.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(strstr(file_contents, "parent before\nchild output\nparent after\n"), "Capture file does not hold the forked function's output in order.");
+	free(file_contents);
+	free(output);
+}
+
+/**
+ * @brief Program entry point
+ * @return Number of failed tests
+ */
+int main(void)
+{
+	// Start from an empty capture file
+	remove(CAPTURE_OUTPUT);
+
+	UNITY_BEGIN();
+	puts("Running CAPTURE_OUTPUT tests...");
+	RUN_TEST(test_capture_forked_function_output);
+	RUN_TEST(test_capture_output_of_killed_children);
+	RUN_TEST(test_capture_output_file);
+
+	return UNITY_END();
+}
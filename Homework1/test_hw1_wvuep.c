@@ -25,16 +25,41 @@
 // Set timeout for forked processes
 #define TIMEOUT_SECONDS 15
 
+// Run CALL_FUNCTION_* children from the fork server while it is running
+#define USE_FORK_SERVER 1 // True
+
 #include "hw1_wvuep.h"
+#include "batch_hw1_wvuep.h"
+#include "series_hw1_wvuep.h"
+#include "table_hw1_wvuep.h"
+#include "engine_hw1_wvuep.h"
+#include "ingest_hw1_wvuep.h"
+#include "results_hw1_wvuep.h"
+#include "targets_hw1_wvuep.h"
+#include "montecarlo_hw1_wvuep.h"
+#include "schedule_hw1_wvuep.h"
+#include "server_hw1_wvuep.h"
+#include "factor_hw1_wvuep.h"
+#include "fixedpoint_hw1_wvuep.h"
+#include "backfit_hw1_wvuep.h"
+#include "sensitivity_hw1_wvuep.h"
+#include "runner_hw1_wvuep.h"
 #include "ctest.h"
 #include "test_hw1_wvuep.h"
 #include <fcntl.h>
 #include <unistd.h>
 #include <string.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <limits.h>
+#include <math.h>
 #include <sys/wait.h>
 #include <sys/shm.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <pthread.h>
 #include <signal.h>
 #include <time.h>
 
@@ -114,6 +139,14 @@ static bool crashes_calculate_enrollment_estimate = false;
  */
 static bool crashes_print_enrollment_estimates = false;
 
+// Declare the functions called by the CALL_FUNCTION_* macros for the fork server
+FORK_SERVER_FUNCTION(get_programmer_name, const char*)
+FORK_SERVER_FUNCTION(calculate_growth_rate, double, int, int, int, int)
+FORK_SERVER_FUNCTION(get_growth_rate_description, const char*, double)
+FORK_SERVER_VOID_FUNCTION(print_growth_rate, double)
+FORK_SERVER_FUNCTION(calculate_enrollment_estimate, int, int, double, int, int)
+FORK_SERVER_VOID_FUNCTION(print_enrollment_estimates, int, double, int, int)
+
 // Provide weak versions of functions from hw1_wvuep.h
 // Do not modify these functions. They will be superseded by the actual functions in hw1_wvuep.c.
 int __attribute__((weak)) prompt_target_enrollment(int target_year)
@@ -186,72 +219,108 @@ const char* __attribute__((weak)) get_programmer_name(void)
 	return UNIMPLEMENTED_RETURN_POINTER;
 }
 
+/**
+ * @brief Tests run by run_tests, in order, with the header of each step on its first test
+ */
+static const struct test_case test_cases[] = {
+	TEST_STEP("Step 2a: Running file Doxygen test...", test_2a_file_doxygen),
+	TEST_STEP("Step 2b: Running #include test...\n"
+		"This test does not check that you have included all required files. Be sure to review compiler output for potential missing #include files.", test_2b_include_hw1_wvuep_h),
+	TEST_STEP("Step 2c: Running get_programmer_name tests...", test_2c_get_programmer_name),
+	TEST_STEP("Step 2d: Running prompt_target_enrollment tests...", test_2d_prompt_target_enrollment_prompt),
+	TEST_CASE(test_2d_prompt_target_enrollment_nonnumeric),
+	TEST_CASE(test_2d_prompt_target_enrollment_zero),
+	TEST_CASE(test_2d_prompt_target_enrollment_negative),
+	TEST_CASE(test_2d_prompt_target_enrollment_positive),
+	TEST_STEP("Step 2e: Running calculate_growth_rate tests...", test_2e_calculate_growth_rate_zero),
+	TEST_CASE(test_2e_calculate_growth_rate_positive),
+	TEST_CASE(test_2e_calculate_growth_rate_negative),
+	TEST_STEP("Step 2f: Running get_growth_rate_description tests...", test_2f_get_growth_rate_description_negative),
+	TEST_CASE(test_2f_get_growth_rate_description_reasonable),
+	TEST_CASE(test_2f_get_growth_rate_description_ambitious),
+	TEST_CASE(test_2f_get_growth_rate_description_high),
+	TEST_CASE(test_2f_get_growth_rate_description_unreasonable),
+	TEST_STEP("Step 2g: Running print_growth_rate tests...", test_2g_print_growth_rate),
+	TEST_STEP("Step 2h: Running calculate_enrollment_estimate tests...", test_2h_calculate_enrollment_estimate),
+	TEST_STEP("Step 2i: Running print_enrollment_estimates tests...", test_2i_print_enrollment_estimates_first),
+	TEST_CASE(test_2i_print_enrollment_estimates_last),
+	TEST_STEP("Step 3a: Running calculate_growth_rates tests...", test_3a_calculate_growth_rates),
+	TEST_CASE(test_3a_calculate_growth_rates_special_cases),
+	TEST_STEP("Step 3b: Running calculate_enrollment_estimates tests...", test_3b_calculate_enrollment_estimates),
+	TEST_CASE(test_3b_calculate_enrollment_estimates_long_horizon),
+	TEST_STEP("Step 3c: Running buffered table tests...", test_3c_format_int),
+	TEST_CASE(test_3c_table_buffer_append_enrollment_estimates),
+	TEST_CASE(test_3c_print_enrollment_estimates_buffered),
+	TEST_STEP("Step 3d: Running multi-campus projection engine tests...", test_3d_project_campuses),
+	TEST_CASE(test_3d_project_campuses_thread_counts),
+	TEST_STEP("Step 3e: Running CSV ingest tests...", test_3e_parse_campus_csv),
+	TEST_CASE(test_3e_load_campus_csv),
+	TEST_STEP("Step 3f: Running binary results file tests...", test_3f_write_projection_file),
+	TEST_CASE(test_3f_projection_file_open_invalid),
+	TEST_STEP("Step 3g: Running classify_growth_rates tests...", test_3g_classify_growth_rates),
+	TEST_CASE(test_3g_classify_growth_rates_special_cases),
+	TEST_STEP("Step 3h: Running read_target_enrollments tests...", test_3h_read_target_enrollments),
+	TEST_CASE(test_3h_read_target_enrollments_large),
+	TEST_STEP("Step 3i: Running Monte Carlo uncertainty band tests...", test_3i_simulate_enrollment_bands),
+	TEST_CASE(test_3i_simulate_enrollment_bands_thread_counts),
+	TEST_STEP("Step 3j: Running growth schedule tests...", test_3j_calculate_scheduled_enrollment_estimate),
+	TEST_CASE(test_3j_growth_schedule_append),
+	TEST_STEP("Step 3k: Running projection server tests...", test_3k_projection_server),
+	TEST_CASE(test_3k_projection_server_clients),
+	TEST_STEP("Step 3l: Running growth factor table tests...", test_3l_growth_factor_table),
+	TEST_CASE(test_3l_growth_factor_table_file),
+	TEST_STEP("Step 3m: Running fixed-point projection tests...", test_3m_fixed_point_projection),
+	TEST_CASE(test_3m_fixed_point_divergence),
+	TEST_STEP("Step 3n: Running growth rate backfit tests...", test_3n_fit_growth_rate),
+	TEST_CASE(test_3n_fit_growth_rates),
+	TEST_STEP("Step 3o: Running growth rate sensitivity tests...", test_3o_calculate_enrollment_sensitivities),
+	TEST_CASE(test_3o_sensitivity_grid),
+	TEST_STEP("Step 3p: Running fork server tests...", test_3p_fork_server_call),
+	TEST_CASE(test_3p_fork_server_failures),
+	TEST_STEP("Step 3q: Running child wait tests...", test_3q_wait_for_child_pid),
+	TEST_CASE(test_3q_wait_for_child_pid_timeout),
+	TEST_STEP("Step 3r: Running parallel test runner tests...", test_3r_run_test_cases_parallel),
+	TEST_CASE(test_3r_test_runner_options),
+	TEST_STEP("Step 3s: Running shared memory result slot tests...", test_3s_call_function_with_return),
+	TEST_CASE(test_3s_get_result_slot),
+	TEST_STEP("Step 3t: Running in-memory output capture tests...", test_3t_start_output_capture),
+	TEST_CASE(test_3t_open_output_capture),
+	TEST_STEP("Step 3u: Running scripted input tests...", test_3u_wait_for_child_pid_reading_input),
+	TEST_CASE(test_3u_wait_for_child_pid_reading_input_timeout),
+	TEST_STEP("Step 3v: Running allocation tracking tests...", test_3v_allocation_statistics),
+	TEST_CASE(test_3v_malloc_poisoning),
+};
+
 void run_tests(void)
 {
 	// Turn off buffering to avoid problems with redirected output
 	setbuf(stdout, NULL);
 	setbuf(stderr, NULL);
 
+	// Fork test children from a small process instead of this one; the plain fork is used if it cannot start
+	start_fork_server();
+
 	// Display status
 	puts("");
 	puts("==========");
 	puts("Running tests...");
 	puts("");
 
-	// Run tests
+	// Run tests, in parallel or one shard of them if requested on the command line
+	struct test_runner_options options;
+	if (!read_test_runner_options(&options))
+	{
+		fprintf(stderr, "Invalid --jobs or --shard option; running all tests in order.\n");
+	}
 	UNITY_BEGIN();
-
-	puts("Step 2a: Running file Doxygen test...");
-	RUN_TEST(test_2a_file_doxygen);
-
-	puts("");
-	puts("Step 2b: Running #include test...");
-	puts("This test does not check that you have included all required files. Be sure to review compiler output for potential missing #include files.");
-	RUN_TEST(test_2b_include_hw1_wvuep_h);
-
-	puts("");
-	puts("Step 2c: Running get_programmer_name tests...");
-	RUN_TEST(test_2c_get_programmer_name);
-
-	puts("");
-	puts("Step 2d: Running prompt_target_enrollment tests...");
-	RUN_TEST(test_2d_prompt_target_enrollment_prompt);
-	RUN_TEST(test_2d_prompt_target_enrollment_nonnumeric);
-	RUN_TEST(test_2d_prompt_target_enrollment_zero);
-	RUN_TEST(test_2d_prompt_target_enrollment_negative);
-	RUN_TEST(test_2d_prompt_target_enrollment_positive);
-
-	puts("");
-	puts("Step 2e: Running calculate_growth_rate tests...");
-	RUN_TEST(test_2e_calculate_growth_rate_zero);
-	RUN_TEST(test_2e_calculate_growth_rate_positive);
-	RUN_TEST(test_2e_calculate_growth_rate_negative);
-
-	puts("");
-	puts("Step 2f: Running get_growth_rate_description tests...");
-	RUN_TEST(test_2f_get_growth_rate_description_negative);
-	RUN_TEST(test_2f_get_growth_rate_description_reasonable);
-	RUN_TEST(test_2f_get_growth_rate_description_ambitious);
-	RUN_TEST(test_2f_get_growth_rate_description_high);
-	RUN_TEST(test_2f_get_growth_rate_description_unreasonable);
-
-	puts("");
-	puts("Step 2g: Running print_growth_rate tests...");
-	RUN_TEST(test_2g_print_growth_rate);
-
-	puts("");
-	puts("Step 2h: Running calculate_enrollment_estimate tests...");
-	RUN_TEST(test_2h_calculate_enrollment_estimate);
-
-	puts("");
-	puts("Step 2i: Running print_enrollment_estimates tests...");
-	RUN_TEST(test_2i_print_enrollment_estimates_first);
-	RUN_TEST(test_2i_print_enrollment_estimates_last);
-
+	run_test_cases(test_cases, sizeof(test_cases) / sizeof(test_cases[0]), &options);
 	puts("");
 
 	UNITY_END();
 
+	// Stop the fork server
+	stop_fork_server();
+
 	// Display message about evaluating with different unit tests 
 	puts("");
 	puts("Your instructor may evaluate your program with different unit tests than were provided to you.");
@@ -264,12 +333,14 @@ void run_tests(void)
 
 void setUp(void)
 {
-	// set up test environment
+	// Count allocations from the start of each test
+	begin_allocation_tracking();
 }
 
 void tearDown(void)
 {
-	// clean up test environment
+	// Restore poisoning in case a test changed it
+	set_malloc_poisoning(MALLOC_POISONING, MALLOC_POISON_PREFIX_BYTES);
 }
 
 void suiteSetUp(void)
@@ -568,54 +639,26 @@ void test_2h_calculate_enrollment_estimate(void)
 
 void test_2i_print_enrollment_estimates_first(void)
 {
-	// Define filename to use
-	char* filename = "test_print_enrollment_estimates_first.txt";
-
-	// Create file to store output
-	int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
-
-	// Redirect stdout to file
-	int saved_stdout = dup(STDOUT_FILENO);
-	int saved_stderr = dup(STDERR_FILENO);
-	dup2(fd, STDOUT_FILENO);
-	dup2(fd, STDERR_FILENO);
+	// Capture output in memory
+	struct output_capture capture;
+	if (!start_output_capture(&capture))
+	{
+		TEST_FAIL_MESSAGE("Failed to capture output");
+	}
 
 	// Run function directly due to stdout capture issues with helper function
 	print_enrollment_estimates(29107, 0.05, 2020, 2035);
 
-	// Flush output
-	fflush(stdout);
-	fflush(stderr);
-
-	// Redirect output to original destinations
-	dup2(saved_stdout, STDOUT_FILENO);
-	dup2(saved_stderr, STDERR_FILENO);
-
-	// Close file
-	close(fd);
-
-	// Open file for reading
-	FILE* file = fopen(filename, "r");
-	if (file == NULL)
+	// Restore output and get what was captured
+	char* output = finish_output_capture(&capture, NULL);
+	if (output == NULL)
 	{
-		// Remove file
-		unlink(filename);
-
-		TEST_FAIL_MESSAGE("Failed to open file for reading");
+		TEST_FAIL_MESSAGE("Failed to read captured output");
 	}
 
-	// Read first line
-	char buffer[100];
-	fgets(buffer, 100, file);
-
-	// Close file
-	fclose(file);
-
-	// Remove file
-	unlink(filename);
-
-	// Get trimmed string
-	char* trimmedPtr = test_support_trim(buffer);
+	// Get trimmed first line
+	char* trimmedPtr = test_support_trim_line(output, false);
+	free(output);
 
 	// Check that the unimplemented message is not returned
 	if (strcmp(trimmedPtr, "print_enrollment_estimates is not implemented") == 0)
@@ -635,57 +678,26 @@ void test_2i_print_enrollment_estimates_first(void)
 
 void test_2i_print_enrollment_estimates_last(void)
 {
-	// Define filename to use
-	char* filename = "test_print_enrollment_estimates_last.txt";
-
-	// Create file to store output
-	int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
-
-	// Redirect stdout to file
-	int saved_stdout = dup(STDOUT_FILENO);
-	int saved_stderr = dup(STDERR_FILENO);
-	dup2(fd, STDOUT_FILENO);
-	dup2(fd, STDERR_FILENO);
+	// Capture output in memory
+	struct output_capture capture;
+	if (!start_output_capture(&capture))
+	{
+		TEST_FAIL_MESSAGE("Failed to capture output");
+	}
 
 	// Run function directly due to stdout capture issues with helper function
 	print_enrollment_estimates(29107, 0.05, 2020, 2035);
 
-	// Flush output
-	fflush(stdout);
-	fflush(stderr);
-
-	// Redirect output to original destinations
-	dup2(saved_stdout, STDOUT_FILENO);
-	dup2(saved_stderr, STDERR_FILENO);
-
-	// Close file
-	close(fd);
-
-	// Open file for reading
-	FILE* file = fopen(filename, "r");
-	if (file == NULL)
-	{
-		// Remove file
-		unlink(filename);
-
-		TEST_FAIL_MESSAGE("Failed to open file for reading");
-	}
-
-	// Read all lines until last line
-	char buffer[100];
-	while (fgets(buffer, 100, file) != NULL)
+	// Restore output and get what was captured
+	char* output = finish_output_capture(&capture, NULL);
+	if (output == NULL)
 	{
-		// Do nothing - keep looping until final line
+		TEST_FAIL_MESSAGE("Failed to read captured output");
 	}
 
-	// Close file
-	fclose(file);
-
-	// Remove file
-	unlink(filename);
-
-	// Get trimmed string
-	char* trimmedPtr = test_support_trim(buffer);
+	// Get trimmed last line
+	char* trimmedPtr = test_support_trim_line(output, true);
+	free(output);
 
 	// Check that the unimplemented message is not returned
 	if (strcmp(trimmedPtr, "print_enrollment_estimates is not implemented") == 0)
@@ -705,54 +717,26 @@ void test_2i_print_enrollment_estimates_last(void)
 
 void test_2g_print_growth_rate(void)
 {
-	// Define filename to use
-	char* filename = "test_print_growth_rate.txt";
-
-	// Create file to store output
-	int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
-
-	// Redirect stdout to file
-	int saved_stdout = dup(STDOUT_FILENO);
-	int saved_stderr = dup(STDERR_FILENO);
-	dup2(fd, STDOUT_FILENO);
-	dup2(fd, STDERR_FILENO);
+	// Capture output in memory
+	struct output_capture capture;
+	if (!start_output_capture(&capture))
+	{
+		TEST_FAIL_MESSAGE("Failed to capture output");
+	}
 
 	// Run function directly due to stdout capture issues with helper function
 	print_growth_rate(0.025);
 
-	// Flush output
-	fflush(stdout);
-	fflush(stderr);
-
-	// Redirect output to original destinations
-	dup2(saved_stdout, STDOUT_FILENO);
-	dup2(saved_stderr, STDERR_FILENO);
-
-	// Close file
-	close(fd);
-
-	// Open file for reading
-	FILE* file = fopen(filename, "r");
-	if (file == NULL)
+	// Restore output and get what was captured
+	char* output = finish_output_capture(&capture, NULL);
+	if (output == NULL)
 	{
-		// Remove file
-		unlink(filename);
-
-		TEST_FAIL_MESSAGE("Failed to open file for reading");
+		TEST_FAIL_MESSAGE("Failed to read captured output");
 	}
 
-	// Read first line
-	char buffer[100];
-	fgets(buffer, 100, file);
-
-	// Close file
-	fclose(file);
-
-	// Remove file
-	unlink(filename);
-
-	// Get trimmed string
-	char* trimmedPtr = test_support_trim(buffer);
+	// Get trimmed first line
+	char* trimmedPtr = test_support_trim_line(output, false);
+	free(output);
 
 	// Check that the unimplemented message is not returned
 	if (strcmp(trimmedPtr, "print_growth_rate is not implemented") == 0)
@@ -775,11 +759,20 @@ void test_2d_prompt_target_enrollment_prompt(void)
 	// Ensure function has been implemented
 	TEST_ASSERT_FALSE_MESSAGE(not_implemented_prompt_target_enrollment, "prompt_target_enrollment has not been implemented.");
 
-	// Define filenames to use
-	char* filename = "test_prompt_target_enrollment_prompt.txt";
+	// Open empty pipe for input and in-memory capture to store output
+	struct scripted_input input;
+	if (!open_scripted_input(&input, ""))
+	{
+		TEST_FAIL_MESSAGE("Failed to open pipe for input");
+	}
+	struct output_capture capture;
+	if (!open_output_capture(&capture))
+	{
+		// Close pipe
+		close_scripted_input(&input);
 
-	// Create file to store output
-	int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		TEST_FAIL_MESSAGE("Failed to capture output");
+	}
 
 	// Select a random year for prompt
 	int prompt_year = rand() % 100 + 2000; // NOLINT(*-msc50-cpp)
@@ -789,6 +782,8 @@ void test_2d_prompt_target_enrollment_prompt(void)
 	if (pid < 0)
 	{
 		// Failed to fork child
+		free(finish_output_capture(&capture, NULL));
+		close_scripted_input(&input);
 		TEST_FAIL_MESSAGE("Failed to fork child process");
 	}
 	else if (pid == 0)
@@ -799,11 +794,12 @@ void test_2d_prompt_target_enrollment_prompt(void)
 		setbuf(stdout, NULL);
 		setbuf(stderr, NULL);
 
-		// Redirect stdout to file
+		// Redirect stdout to capture and stdin from pipe
 		int saved_stdout = dup(STDOUT_FILENO);
 		int saved_stderr = dup(STDERR_FILENO);
-		dup2(fd, STDOUT_FILENO);
-		dup2(fd, STDERR_FILENO);
+		dup2(capture.fd, STDOUT_FILENO);
+		dup2(capture.fd, STDERR_FILENO);
+		dup2(input.read_fd, STDIN_FILENO);
 
 		// Run function
 		helper_prompt_target_enrollment(prompt_year);
@@ -816,12 +812,6 @@ void test_2d_prompt_target_enrollment_prompt(void)
 		dup2(saved_stdout, STDOUT_FILENO);
 		dup2(saved_stderr, STDERR_FILENO);
 
-		// Close file
-		close(fd);
-
-		// Remove files
-		unlink(filename);
-
 		// Exit child process with status 255 if function was not implemented
 		if (not_implemented_prompt_target_enrollment)
 		{
@@ -837,49 +827,32 @@ void test_2d_prompt_target_enrollment_prompt(void)
 	{
 		// Running as parent process
 
-		// Sleep for 100 milliseconds
-		struct timespec sleep_time = { 0, 100000000 };
-		nanosleep(&sleep_time, NULL);
+		// Wait for child process to complete or to wait for input after the prompt
+		int status = wait_for_child_pid_reading_input(pid, &input, INPUT_TIMEOUT_MILLISECONDS);
+		close_scripted_input(&input);
 
-		// Attempt to kill child in case it is still running
-		kill(pid, SIGKILL);
-
-		// Wait for child process to complete
-		int status;
-		waitpid(pid, &status, 0);
+		// Get captured output
+		char* output = finish_output_capture(&capture, NULL);
 
 		// Check to see if the function was not implemented
 		if (WEXITSTATUS(status) == 255)
 		{
 			// Record as not implemented
 			not_implemented_prompt_target_enrollment = true;
+			free(output);
 
 			TEST_FAIL_MESSAGE("prompt_target_enrollment has not been implemented.");
 		}
 
-		// Open file for reading
-		FILE* output_file = fopen(filename, "r");
-		if (output_file == NULL)
+		// Ensure output was captured
+		if (output == NULL)
 		{
-			// Remove file
-			unlink(filename);
-
-			TEST_FAIL_MESSAGE("Failed to open file for reading.");
+			TEST_FAIL_MESSAGE("Failed to read captured output.");
 		}
 
-		// Read first line
-		char buffer[100];
-		fgets(buffer, 100, output_file);
-
-		// Close file
-		fclose(output_file);
-		output_file = NULL;
-
-		// Remove file
-		unlink(filename);
-
-		// Get trimmed string
-		char* trimmedPtr = test_support_trim(buffer);
+		// Get trimmed first line
+		char* trimmedPtr = test_support_trim_line(output, false);
+		free(output);
 
 		// Check that the unimplemented message is not returned
 		if (strcmp(trimmedPtr, "prompt_target_enrollment is not implemented") == 0)
@@ -912,37 +885,29 @@ void test_2d_prompt_target_enrollment_negative(void)
 	int year = 2022;
 	int enrollment = rand() % 30000 + 10000; // Number between [10000, 40000) NOLINT(*-msc50-cpp)
 
-	// Define filenames to use
-	char* input_filename = "test_prompt_target_enrollment_negative_input.txt";
-	char* output_filename = "test_prompt_target_enrollment_negative_output.txt";
-
 	// Define shared key
 	int key = 1863;
 
-	// Write input file
-	FILE* input_file = fopen(input_filename, "w");
-	if (input_file == NULL)
-	{
-		// Remove file
-		unlink(input_filename);
+	// Script input, including generating random numbers
+	char script[100];
+	int first_number = -1 * (rand() % 100) - 1; // NOLINT(*-msc50-cpp)
+	int second_number = -1 * (rand() % 100) - 1; // NOLINT(*-msc50-cpp)
+	snprintf(script, sizeof(script), "%d\n%d\n%d\n", first_number, second_number, enrollment);
 
-		TEST_FAIL_MESSAGE("Failed to open file for writing");
+	// Open pipe holding input and in-memory capture to store output
+	struct scripted_input input;
+	if (!open_scripted_input(&input, script))
+	{
+		TEST_FAIL_MESSAGE("Failed to open pipe for input");
 	}
+	struct output_capture capture;
+	if (!open_output_capture(&capture))
+	{
+		// Close pipe
+		close_scripted_input(&input);
 
-	// Write input to file, including generating random numbers
-	int rand_number = -1 * (rand() % 100) - 1; // NOLINT(*-msc50-cpp)
-	fprintf(input_file, "%d\n", rand_number);
-	rand_number = -1 * (rand() % 100) - 1; // NOLINT(*-msc50-cpp)
-	fprintf(input_file, "%d\n", rand_number);
-	fprintf(input_file, "%d\n", enrollment);
-
-	// Close input file
-	fclose(input_file);
-	input_file = NULL;
-
-	// Create file to store output
-	int output_fd = open(output_filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
-	int input_fd = open(input_filename, O_RDONLY, 0666);
+		TEST_FAIL_MESSAGE("Failed to capture output");
+	}
 
 	// Setup shared memory for getting results from child process
 	int shm_id = shmget(key, sizeof(int), SHM_R | SHM_W | IPC_CREAT);
@@ -953,21 +918,21 @@ void test_2d_prompt_target_enrollment_negative(void)
 	pid_t pid = fork();
 	if (pid < 0)
 	{
-		// Remove files
-		unlink(input_filename);
-		unlink(output_filename);
+		// Discard captured output and close pipe
+		free(finish_output_capture(&capture, NULL));
+		close_scripted_input(&input);
 
 		TEST_FAIL_MESSAGE("Failed to fork child process");
 	}
 	else if (pid == 0)
 	{
-		// Redirect stdout to file
+		// Redirect stdout to capture and stdin from pipe
 		int saved_stdout = dup(STDOUT_FILENO);
 		int saved_stderr = dup(STDERR_FILENO);
 		int saved_stdin = dup(STDIN_FILENO);
-		dup2(output_fd, STDOUT_FILENO);
-		dup2(output_fd, STDERR_FILENO);
-		dup2(input_fd, STDIN_FILENO);
+		dup2(capture.fd, STDOUT_FILENO);
+		dup2(capture.fd, STDERR_FILENO);
+		dup2(input.read_fd, STDIN_FILENO);
 
 		// Get result from function
 		*sharedPtr = helper_prompt_target_enrollment(year);
@@ -981,14 +946,6 @@ void test_2d_prompt_target_enrollment_negative(void)
 		dup2(saved_stderr, STDERR_FILENO);
 		dup2(saved_stdin, STDIN_FILENO);
 
-		// Close file
-		close(output_fd);
-		close(input_fd);
-
-		// Remove files
-		unlink(output_filename);
-		unlink(input_filename);
-
 		// Clean up shared memory
 		shmdt(sharedPtr);
 		shmctl(shm_id, IPC_RMID, NULL);
@@ -1006,16 +963,12 @@ void test_2d_prompt_target_enrollment_negative(void)
 	}
 	else
 	{
-		// Sleep for 100 milliseconds
-		struct timespec sleep_time = { 0, 100000000 };
-		nanosleep(&sleep_time, NULL);
+		// Wait for child process to complete or to wait for more input than was scripted
+		int status = wait_for_child_pid_reading_input(pid, &input, INPUT_TIMEOUT_MILLISECONDS);
+		close_scripted_input(&input);
 
-		// Attempt to kill child in case it is still running
-		kill(pid, SIGKILL);
-
-		// Wait for child process to complete
-		int status;
-		waitpid(pid, &status, 0);
+		// Discard captured output
+		free(finish_output_capture(&capture, NULL));
 
 		// Check to see if the function was not implemented
 		if (WEXITSTATUS(status) == 255)
@@ -1047,35 +1000,27 @@ void test_2d_prompt_target_enrollment_zero(void)
 	int year = 2032;
 	int enrollment = rand() % 30000 + 10000; // Number between [10000, 40000) NOLINT(*-msc50-cpp)
 
-	// Define filenames to use
-	char* input_filename = "test_prompt_target_enrollment_zero_input.txt";
-	char* output_filename = "test_prompt_target_enrollment_zero_output.txt";
-
 	// Define shared key
 	int key = 1863;
 
-	// Write input file
-	FILE* input_file = fopen(input_filename, "w");
-	if (input_file == NULL)
-	{
-		// Remove file
-		unlink(input_filename);
+	// Script input
+	char script[100];
+	snprintf(script, sizeof(script), "0\n0\n%d\n", enrollment);
 
-		TEST_FAIL_MESSAGE("Failed to open file for writing.");
+	// Open pipe holding input and in-memory capture to store output
+	struct scripted_input input;
+	if (!open_scripted_input(&input, script))
+	{
+		TEST_FAIL_MESSAGE("Failed to open pipe for input");
 	}
+	struct output_capture capture;
+	if (!open_output_capture(&capture))
+	{
+		// Close pipe
+		close_scripted_input(&input);
 
-	// Write input to file
-	fprintf(input_file, "0\n");
-	fprintf(input_file, "0\n");
-	fprintf(input_file, "%d\n", enrollment);
-
-	// Close input file
-	fclose(input_file);
-	input_file = NULL;
-
-	// Create file to store output
-	int output_fd = open(output_filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
-	int input_fd = open(input_filename, O_RDONLY, 0666);
+		TEST_FAIL_MESSAGE("Failed to capture output");
+	}
 
 	// Setup shared memory for getting results from child process
 	int shm_id = shmget(key, sizeof(int), SHM_R | SHM_W | IPC_CREAT);
@@ -1086,21 +1031,21 @@ void test_2d_prompt_target_enrollment_zero(void)
 	pid_t pid = fork();
 	if (pid < 0)
 	{
-		// Remove files
-		unlink(input_filename);
-		unlink(output_filename);
+		// Discard captured output and close pipe
+		free(finish_output_capture(&capture, NULL));
+		close_scripted_input(&input);
 
 		TEST_FAIL_MESSAGE("Failed to fork child process.");
 	}
 	else if (pid == 0)
 	{
-		// Redirect stdout to file
+		// Redirect stdout to capture and stdin from pipe
 		int saved_stdout = dup(STDOUT_FILENO);
 		int saved_stderr = dup(STDERR_FILENO);
 		int saved_stdin = dup(STDIN_FILENO);
-		dup2(output_fd, STDOUT_FILENO);
-		dup2(output_fd, STDERR_FILENO);
-		dup2(input_fd, STDIN_FILENO);
+		dup2(capture.fd, STDOUT_FILENO);
+		dup2(capture.fd, STDERR_FILENO);
+		dup2(input.read_fd, STDIN_FILENO);
 
 		// Get result from function
 		*sharedPtr = helper_prompt_target_enrollment(year);
@@ -1114,14 +1059,6 @@ void test_2d_prompt_target_enrollment_zero(void)
 		dup2(saved_stderr, STDERR_FILENO);
 		dup2(saved_stdin, STDIN_FILENO);
 
-		// Close file
-		close(output_fd);
-		close(input_fd);
-
-		// Remove files
-		unlink(output_filename);
-		unlink(input_filename);
-
 		// Clean up shared memory
 		shmdt(sharedPtr);
 		shmctl(shm_id, IPC_RMID, NULL);
@@ -1139,16 +1076,12 @@ void test_2d_prompt_target_enrollment_zero(void)
 	}
 	else
 	{
-		// Sleep for 100 milliseconds
-		struct timespec sleep_time = { 0, 100000000 };
-		nanosleep(&sleep_time, NULL);
+		// Wait for child process to complete or to wait for more input than was scripted
+		int status = wait_for_child_pid_reading_input(pid, &input, INPUT_TIMEOUT_MILLISECONDS);
+		close_scripted_input(&input);
 
-		// Attempt to kill child in case it is still running
-		kill(pid, SIGKILL);
-
-		// Wait for child process to complete
-		int status;
-		waitpid(pid, &status, 0);
+		// Discard captured output
+		free(finish_output_capture(&capture, NULL));
 
 		// Check to see if the function was not implemented
 		if (WEXITSTATUS(status) == 255)
@@ -1180,33 +1113,27 @@ void test_2d_prompt_target_enrollment_positive(void)
 	int year = 2037;
 	int enrollment = rand() % 30000 + 10000; // Number between [10000, 40000) NOLINT(*-msc50-cpp)
 
-	// Define filenames to use
-	char* input_filename = "test_prompt_target_enrollment_positive_input.txt";
-	char* output_filename = "test_prompt_target_enrollment_positive_output.txt";
-
 	// Define shared key
 	int key = 1863;
 
-	// Write input file
-	FILE* input_file = fopen(input_filename, "w");
-	if (input_file == NULL)
-	{
-		// Remove file
-		unlink(input_filename);
+	// Script input
+	char script[100];
+	snprintf(script, sizeof(script), "%d\n", enrollment);
 
-		TEST_FAIL_MESSAGE("Failed to open file for writing.");
+	// Open pipe holding input and in-memory capture to store output
+	struct scripted_input input;
+	if (!open_scripted_input(&input, script))
+	{
+		TEST_FAIL_MESSAGE("Failed to open pipe for input");
 	}
+	struct output_capture capture;
+	if (!open_output_capture(&capture))
+	{
+		// Close pipe
+		close_scripted_input(&input);
 
-	// Write input to file
-	fprintf(input_file, "%d\n", enrollment);
-
-	// Close input file
-	fclose(input_file);
-	input_file = NULL;
-
-	// Create file to store output
-	int output_fd = open(output_filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
-	int input_fd = open(input_filename, O_RDONLY, 0666);
+		TEST_FAIL_MESSAGE("Failed to capture output");
+	}
 
 	// Setup shared memory for getting results from child process
 	int shm_id = shmget(key, sizeof(int), SHM_R | SHM_W | IPC_CREAT);
@@ -1217,22 +1144,22 @@ void test_2d_prompt_target_enrollment_positive(void)
 	pid_t pid = fork();
 	if (pid < 0)
 	{
-		// Remove files
-		unlink(input_filename);
-		unlink(output_filename);
+		// Discard captured output and close pipe
+		free(finish_output_capture(&capture, NULL));
+		close_scripted_input(&input);
 
 		TEST_FAIL_MESSAGE("Failed to fork child process.");
 	}
 	else if (pid == 0)
 	{
 
-		// Redirect stdout to file
+		// Redirect stdout to capture and stdin from pipe
 		int saved_stdout = dup(STDOUT_FILENO);
 		int saved_stderr = dup(STDERR_FILENO);
 		int saved_stdin = dup(STDIN_FILENO);
-		dup2(output_fd, STDOUT_FILENO);
-		dup2(output_fd, STDERR_FILENO);
-		dup2(input_fd, STDIN_FILENO);
+		dup2(capture.fd, STDOUT_FILENO);
+		dup2(capture.fd, STDERR_FILENO);
+		dup2(input.read_fd, STDIN_FILENO);
 
 		// Get result from function
 		*sharedPtr = helper_prompt_target_enrollment(year);
@@ -1246,14 +1173,6 @@ void test_2d_prompt_target_enrollment_positive(void)
 		dup2(saved_stderr, STDERR_FILENO);
 		dup2(saved_stdin, STDIN_FILENO);
 
-		// Close file
-		close(output_fd);
-		close(input_fd);
-
-		// Remove files
-		unlink(output_filename);
-		unlink(input_filename);
-
 		// Clean up shared memory
 		shmdt(sharedPtr);
 		shmctl(shm_id, IPC_RMID, NULL);
@@ -1271,16 +1190,12 @@ void test_2d_prompt_target_enrollment_positive(void)
 	}
 	else
 	{
-		// Sleep for 100 milliseconds
-		struct timespec sleep_time = { 0, 100000000 };
-		nanosleep(&sleep_time, NULL);
+		// Wait for child process to complete or to wait for more input than was scripted
+		int status = wait_for_child_pid_reading_input(pid, &input, INPUT_TIMEOUT_MILLISECONDS);
+		close_scripted_input(&input);
 
-		// Attempt to kill child in case it is still running
-		kill(pid, SIGKILL);
-
-		// Wait for child process to complete
-		int status;
-		waitpid(pid, &status, 0);
+		// Discard captured output
+		free(finish_output_capture(&capture, NULL));
 
 		// Check to see if the function was not implemented
 		if (WEXITSTATUS(status) == 255)
@@ -1312,32 +1227,27 @@ void test_2d_prompt_target_enrollment_nonnumeric(void)
 	int year = 2024;
 	int enrollment = 29862;
 
-	// Define filenames to use
-	char* input_filename = "test_prompt_target_enrollment_alphabetic_input.txt";
-	char* output_filename = "test_prompt_target_enrollment_alphabetic_output.txt";
-
 	// Define shared key
 	int key = 1863;
 
-	// Write input file
-	FILE* input_file = fopen(input_filename, "w");
-	if (input_file == NULL)
+	// Script input
+	char script[100];
+	snprintf(script, sizeof(script), "abc\ndef\n%d\n", enrollment);
+
+	// Open pipe holding input and in-memory capture to store output
+	struct scripted_input input;
+	if (!open_scripted_input(&input, script))
 	{
-		TEST_FAIL_MESSAGE("Failed to open file for writing.");
+		TEST_FAIL_MESSAGE("Failed to open pipe for input");
 	}
+	struct output_capture capture;
+	if (!open_output_capture(&capture))
+	{
+		// Close pipe
+		close_scripted_input(&input);
 
-	// Write input to file
-	fprintf(input_file, "abc\n");
-	fprintf(input_file, "def\n");
-	fprintf(input_file, "%d\n", enrollment);
-
-	// Close input file
-	fclose(input_file);
-	input_file = NULL;
-
-	// Create file to store output
-	int output_fd = open(output_filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
-	int input_fd = open(input_filename, O_RDONLY, 0666);
+		TEST_FAIL_MESSAGE("Failed to capture output");
+	}
 
 	// Setup shared memory for getting results from child process
 	int shm_id = shmget(key, sizeof(int), SHM_R | SHM_W | IPC_CREAT);
@@ -1348,17 +1258,20 @@ void test_2d_prompt_target_enrollment_nonnumeric(void)
 	pid_t pid = fork();
 	if (pid < 0)
 	{
+		// Discard captured output
+		free(finish_output_capture(&capture, NULL));
+
 		TEST_FAIL_MESSAGE("Failed to fork child process.");
 	}
 	else if (pid == 0)
 	{
-		// Redirect stdout to file
+		// Redirect stdout to capture and stdin from pipe
 		int saved_stdout = dup(STDOUT_FILENO);
 		int saved_stderr = dup(STDERR_FILENO);
 		int saved_stdin = dup(STDIN_FILENO);
-		dup2(output_fd, STDOUT_FILENO);
-		dup2(output_fd, STDERR_FILENO);
-		dup2(input_fd, STDIN_FILENO);
+		dup2(capture.fd, STDOUT_FILENO);
+		dup2(capture.fd, STDERR_FILENO);
+		dup2(input.read_fd, STDIN_FILENO);
 
 		// Get result from function
 		*sharedPtr = helper_prompt_target_enrollment(year);
@@ -1372,14 +1285,6 @@ void test_2d_prompt_target_enrollment_nonnumeric(void)
 		dup2(saved_stderr, STDERR_FILENO);
 		dup2(saved_stdin, STDIN_FILENO);
 
-		// Close file
-		close(output_fd);
-		close(input_fd);
-
-		// Remove files
-		unlink(output_filename);
-		unlink(input_filename);
-
 		// Clean up shared memory
 		shmdt(sharedPtr);
 		shmctl(shm_id, IPC_RMID, NULL);
@@ -1398,16 +1303,12 @@ void test_2d_prompt_target_enrollment_nonnumeric(void)
 	}
 	else
 	{
-		// Sleep for 100 milliseconds
-		struct timespec sleep_time = { 0, 100000000 };
-		nanosleep(&sleep_time, NULL);
+		// Wait for child process to complete or to wait for more input than was scripted
+		int status = wait_for_child_pid_reading_input(pid, &input, INPUT_TIMEOUT_MILLISECONDS);
+		close_scripted_input(&input);
 
-		// Attempt to kill child in case it is still running
-		kill(pid, SIGKILL);
-
-		// Wait for child process to complete
-		int status;
-		waitpid(pid, &status, 0);
+		// Discard captured output
+		free(finish_output_capture(&capture, NULL));
 
 		// Check to see if the function was not implemented
 		if (WEXITSTATUS(status) == 255)
@@ -1429,108 +1330,2047 @@ void test_2d_prompt_target_enrollment_nonnumeric(void)
 	}
 }
 
-// ReSharper disable once CppDFAConstantFunctionResult
-const char* helper_get_programmer_name(void)
+void test_3a_calculate_growth_rates(void)
 {
-	// Check if function works in forked process
-	CALL_FUNCTION_STRING(get_programmer_name);
+	// Build random scenarios with spans of 5 to 50 years (rates within the documented bound's range), using a count that leaves a partial vector at the end
+	const size_t count = 100003;
+	int* initial_enrollments = malloc(count * sizeof(int));
+	int* target_enrollments = malloc(count * sizeof(int));
+	int* initial_years = malloc(count * sizeof(int));
+	int* target_years = malloc(count * sizeof(int));
+	double* growth_rates = malloc(count * sizeof(double));
+	TEST_ASSERT_NOT_NULL_MESSAGE(initial_enrollments, "Memory could not be allocated for initial enrollments.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(target_enrollments, "Memory could not be allocated for target enrollments.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(initial_years, "Memory could not be allocated for initial years.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(target_years, "Memory could not be allocated for target years.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(growth_rates, "Memory could not be allocated for growth rates.");
+
+	for (size_t i = 0; i < count; i++)
+	{
+		initial_enrollments[i] = rand() % 30000 + 10000; // NOLINT(*-msc50-cpp)
+		target_enrollments[i] = rand() % 60000 + 1000; // NOLINT(*-msc50-cpp)
+		initial_years[i] = rand() % 50 + 2000; // NOLINT(*-msc50-cpp)
+		target_years[i] = initial_years[i] + (rand() % 2 == 0 ? 1 : -1) * (rand() % 46 + 5); // NOLINT(*-msc50-cpp)
+	}
 
-	// Return programmer name
-	return get_programmer_name();
+	// Calculate all growth rates at once
+	calculate_growth_rates(initial_enrollments, target_enrollments, initial_years, target_years, growth_rates, count);
+
+	// Compare each rate with the scalar function, allowing GROWTH_RATES_MAX_ULP units of 1 + |rate|
+	for (size_t i = 0; i < count; i++)
+	{
+		double expected = calculate_growth_rate(initial_enrollments[i], target_enrollments[i], initial_years[i], target_years[i]);
+		double scale = 1.0 + fabs(expected);
+		double tolerance = GROWTH_RATES_MAX_ULP * (nextafter(scale, INFINITY) - scale);
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(tolerance, expected, growth_rates[i], "Batch growth rate differs from calculate_growth_rate by more than GROWTH_RATES_MAX_ULP.");
+	}
 
+	// Free memory
+	free(initial_enrollments);
+	free(target_enrollments);
+	free(initial_years);
+	free(target_years);
+	free(growth_rates);
 }
 
-int helper_prompt_target_enrollment(int target_year)
+void test_3a_calculate_growth_rates_special_cases(void)
 {
-	// Do not call function in a forked process because of corruption of input stream
+	// Scenarios with equal years, zero or negative enrollments, mixed with ordinary scenarios
+	int initial_enrollments[] = { 30000, 0, 25000, 30000, -25000, 25000, 30000, 0, 29107 };
+	int target_enrollments[] = { 39930, 30000, 24010, 30000, -24010, -24010, 40000, 0, 60511 };
+	int initial_years[] = { 2030, 2022, 2024, 2022, 2024, 2024, 2030, 2030, 2020 };
+	int target_years[] = { 2033, 2023, 2026, 2022, 2026, 2025, 2030, 2031, 2035 };
+	const size_t count = sizeof(initial_enrollments) / sizeof(initial_enrollments[0]);
+	double growth_rates[sizeof(initial_enrollments) / sizeof(initial_enrollments[0])];
+
+	// Calculate all growth rates at once
+	calculate_growth_rates(initial_enrollments, target_enrollments, initial_years, target_years, growth_rates, count);
+
+	// Scenarios the kernel cannot handle must match the scalar function exactly, including infinities and NaN
+	for (size_t i = 0; i < count; i++)
+	{
+		double expected = calculate_growth_rate(initial_enrollments[i], target_enrollments[i], initial_years[i], target_years[i]);
+		if (isnan(expected))
+		{
+			TEST_ASSERT_DOUBLE_IS_NAN(growth_rates[i]);
+		}
+		else
+		{
+			double scale = 1.0 + fabs(expected);
+			double tolerance = GROWTH_RATES_MAX_ULP * (nextafter(scale, INFINITY) - scale);
+			TEST_ASSERT_DOUBLE_WITHIN(tolerance, expected, growth_rates[i]);
+		}
+	}
+}
 
-	// Assume that we don't crash
-	crashes_prompt_target_enrollment = false;
+void test_3b_calculate_enrollment_estimates(void)
+{
+	// 20000 random scenarios of 100 years each compare 2,000,000 estimates
+	const int scenarios = 20000;
+	const int years = 100;
+	int estimates[100];
 
-	// Prompt for target enrollment
-	return prompt_target_enrollment(target_year);
+	for (int scenario = 0; scenario < scenarios; scenario++)
+	{
+		// Random enrollment and a growth rate between -10% and 10%
+		int initial_enrollment = rand() % 100000 + 1; // NOLINT(*-msc50-cpp)
+		double growth_rate = ((double)rand() / RAND_MAX - 0.5) * 0.2; // NOLINT(*-msc50-cpp)
+		int initial_year = rand() % 100 + 1950; // NOLINT(*-msc50-cpp)
+		int end_year = initial_year + years - 1;
+
+		// Generate the series and compare every year with calculate_enrollment_estimate
+		size_t count = calculate_enrollment_estimates(initial_enrollment, growth_rate, initial_year, end_year, estimates);
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(years, count, "calculate_enrollment_estimates did not return one estimate per year.");
+		for (int i = 0; i < years; i++)
+		{
+			if (estimates[i] != calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, initial_year + i))
+			{
+				TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, initial_year + i), estimates[i], "Series estimate differs from calculate_enrollment_estimate.");
+			}
+		}
+	}
+
+	// Empty range
+	TEST_ASSERT_EQUAL_size_t(0, calculate_enrollment_estimates(29107, 0.05, 2035, 2020, estimates));
 }
 
-double helper_calculate_growth_rate(int initial_enrollment, int target_enrollment, int initial_year, int target_year)
+void test_3b_calculate_enrollment_estimates_long_horizon(void)
 {
-	// Check if function works in forked process
-	CALL_FUNCTION_DOUBLE(calculate_growth_rate, initial_enrollment, target_enrollment, initial_year, target_year);
+	// Sensitivity-run horizons of 10,000 years with small rates, including ones that overflow int
+	const int years = 10000;
+	int* estimates = malloc((size_t)years * sizeof(int));
+	TEST_ASSERT_NOT_NULL_MESSAGE(estimates, "Memory could not be allocated for estimates.");
 
-	// Return growth rate
-	return calculate_growth_rate(initial_enrollment, target_enrollment, initial_year, target_year);
+	double growth_rates[] = { 0.0, 0.0001, -0.0001, 0.0005, -0.0005, 0.002, 0.05 };
+	for (size_t rate = 0; rate < sizeof(growth_rates) / sizeof(growth_rates[0]); rate++)
+	{
+		// Generate the series and compare every year with calculate_enrollment_estimate
+		calculate_enrollment_estimates(25994, growth_rates[rate], 2024, 2024 + years - 1, estimates);
+		for (int i = 0; i < years; i++)
+		{
+			if (estimates[i] != calculate_enrollment_estimate(25994, growth_rates[rate], 2024, 2024 + i))
+			{
+				TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_enrollment_estimate(25994, growth_rates[rate], 2024, 2024 + i), estimates[i], "Series estimate differs from calculate_enrollment_estimate.");
+			}
+		}
+	}
+
+	// Free memory
+	free(estimates);
 }
 
-const char* helper_get_growth_rate_description(double growth_rate)
+void test_3c_format_int(void)
 {
-	// Check if function works in forked process
-	CALL_FUNCTION_STRING(get_growth_rate_description, growth_rate);
+	// Compare edge values and random values with snprintf
+	int values[] = { 0, 7, 10, 99, 100, 999, 1000, -1, -10, -100, 123456789, INT_MAX, INT_MIN };
+	char expected[16];
+	char actual[16];
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]) + 10000; i++)
+	{
+		int value = i < sizeof(values) / sizeof(values[0]) ? values[i] : rand() - RAND_MAX / 2; // NOLINT(*-msc50-cpp)
+		int expected_length = snprintf(expected, sizeof(expected), "%d", value);
+		size_t actual_length = format_int(actual, value);
+		actual[actual_length] = '\0';
 
-	// Return growth rate description
-	return get_growth_rate_description(growth_rate);
+		TEST_ASSERT_EQUAL_size_t((size_t)expected_length, actual_length);
+		TEST_ASSERT_EQUAL_STRING(expected, actual);
+	}
 }
 
-void helper_print_growth_rate(double growth_rate)
+void test_3c_table_buffer_append_enrollment_estimates(void)
 {
-	// Check if function works in forked process
-	CALL_FUNCTION_VOID(print_growth_rate, growth_rate);
+	// Format several random tables into one arena
+	struct table_buffer buffer;
+	TEST_ASSERT_TRUE_MESSAGE(table_buffer_init(&buffer, NULL, 64), "Table buffer could not be allocated.");
 
-	// Print growth rate
-	print_growth_rate(growth_rate);
+	// Build the expected text with printf formatting of calculate_enrollment_estimate values
+	size_t expected_capacity = 1 << 20;
+	char* expected = malloc(expected_capacity);
+	TEST_ASSERT_NOT_NULL_MESSAGE(expected, "Memory could not be allocated for expected output.");
+	size_t expected_length = 0;
+
+	for (int table = 0; table < 100; table++)
+	{
+		int initial_enrollment = rand() % 100000 - 1000; // NOLINT(*-msc50-cpp)
+		double growth_rate = ((double)rand() / RAND_MAX - 0.5) * 0.2; // NOLINT(*-msc50-cpp)
+		int initial_year = rand() % 4000 - 2000; // NOLINT(*-msc50-cpp)
+		int end_year = initial_year + rand() % 60 - 5; // NOLINT(*-msc50-cpp)
+
+		TEST_ASSERT_TRUE(table_buffer_append_enrollment_estimates(&buffer, initial_enrollment, growth_rate, initial_year, end_year));
+		for (int i = initial_year; i <= end_year; i++)
+		{
+			expected_length += (size_t)snprintf(expected + expected_length, expected_capacity - expected_length, "%d enrollment estimate: %d\n", i, calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, i));
+		}
+	}
+
+	// Compare byte for byte
+	TEST_ASSERT_EQUAL_size_t(expected_length, buffer.length);
+	TEST_ASSERT_EQUAL_MEMORY(expected, buffer.data, expected_length);
+
+	// A caller-provided buffer that is too small is left unchanged
+	char storage[64];
+	struct table_buffer small_buffer;
+	table_buffer_init(&small_buffer, storage, sizeof(storage));
+	TEST_ASSERT_FALSE(table_buffer_append_enrollment_estimates(&small_buffer, 29107, 0.05, 2020, 2035));
+	TEST_ASSERT_EQUAL_size_t(0, small_buffer.length);
+
+	// Free memory
+	free(expected);
+	table_buffer_free(&buffer);
 }
 
-// ReSharper disable once CppDFAConstantFunctionResult
-int helper_calculate_enrollment_estimate(int initial_enrollment, double growth_rate, int initial_year, int estimate_year)
+/**
+ * @brief Capture what a table printing function writes to stdout through a pipe
+ * @param print_function Function to call
+ * @param output Destination for the captured text, null-terminated
+ * @param output_size Size of output in bytes
+ * @return Number of bytes captured
+ */
+static size_t capture_table_output(void (*print_function)(int, double, int, int), char* output, size_t output_size)
 {
-	// Check if function works in forked process
-	CALL_FUNCTION_INT(calculate_enrollment_estimate, initial_enrollment, growth_rate, initial_year, estimate_year);
+	// Redirect stdout into a pipe
+	int pipe_fds[2];
+	if (pipe(pipe_fds) != 0)
+	{
+		return 0;
+	}
+	int saved_stdout = dup(STDOUT_FILENO);
+	dup2(pipe_fds[1], STDOUT_FILENO);
 
-	// Return enrollment estimate
-	return calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, estimate_year);
+	// Print the table
+	print_function(29107, 0.05, 2020, 2035);
+	fflush(stdout);
+
+	// Redirect output to original destination
+	dup2(saved_stdout, STDOUT_FILENO);
+	close(saved_stdout);
+	close(pipe_fds[1]);
+
+	// Read everything that was written
+	size_t length = 0;
+	ssize_t bytes_read;
+	while (length < output_size - 1 && (bytes_read = read(pipe_fds[0], output + length, output_size - 1 - length)) > 0)
+	{
+		length += (size_t)bytes_read;
+	}
+	output[length] = '\0';
+	close(pipe_fds[0]);
+
+	return length;
 }
 
-void helper_print_enrollment_estimates(int initial_enrollment, double growth_rate, int initial_year, int end_year)
+void test_3c_print_enrollment_estimates_buffered(void)
 {
-	// Check if function works in forked process
-	CALL_FUNCTION_VOID(print_enrollment_estimates, initial_enrollment, growth_rate, initial_year, end_year);
-
-	// Print enrollment estimates
-	print_enrollment_estimates(initial_enrollment, growth_rate, initial_year, end_year);
+	// Capture both functions' output
+	char expected[2048];
+	char actual[2048];
+	size_t expected_length = capture_table_output(print_enrollment_estimates, expected, sizeof(expected));
+	size_t actual_length = capture_table_output(print_enrollment_estimates_buffered, actual, sizeof(actual));
+
+	// Output must be byte-identical
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(0, expected_length, "print_enrollment_estimates output could not be captured.");
+	TEST_ASSERT_EQUAL_size_t(expected_length, actual_length);
+	TEST_ASSERT_EQUAL_STRING(expected, actual);
 }
 
-char* test_support_trim(const char* string)
+void test_3d_project_campuses(void)
 {
-	// Start at beginning of string and find first non-space character
-	size_t first_nonspace = 0;
-	while (first_nonspace < strlen(string) && isspace(string[first_nonspace]))
+	// Build campuses with different initial years, using a count that leaves a partial tile at the end
+	const size_t count = 3 * PROJECTION_TILE_CAMPUSES + 37;
+	struct campus_table campuses;
+	TEST_ASSERT_TRUE_MESSAGE(campus_table_init(&campuses, 0), "Campus table could not be initialized.");
+	for (size_t i = 0; i < count; i++)
 	{
-		// Increment position
-		first_nonspace++;
+		int initial_year = rand() % 20 + 2015; // NOLINT(*-msc50-cpp)
+		TEST_ASSERT_TRUE_MESSAGE(campus_table_add(&campuses, rand() % 30000 + 10000, initial_year, rand() % 60000 + 1000, initial_year + rand() % 46 + 5), "Campus could not be added."); // NOLINT(*-msc50-cpp)
 	}
 
-	// Determine if there is anything non-whitespace left in the string
-	if (first_nonspace == strlen(string))
-	{
-		// String is all whitespace, so return null-terminated string
-		char* emptyPtr = malloc(sizeof(char) * 1);
-		if (emptyPtr == NULL) {
-			return NULL;
-		}
+	// Project years before and after the initial years on a pool with more than one worker
+	struct projection_matrix matrix;
+	TEST_ASSERT_TRUE_MESSAGE(projection_matrix_init(&matrix, count, 2010, 2080), "Projection matrix could not be initialized.");
+	struct worker_pool pool;
+	TEST_ASSERT_TRUE_MESSAGE(worker_pool_init(&pool, 3), "Worker pool could not be started.");
+	project_campuses(&pool, &campuses, &matrix);
+	worker_pool_free(&pool);
 
-		// Null terminate string
-		emptyPtr[0] = '\0';
+	// Compare each rate with the scalar function and each estimate with calculate_enrollment_estimate for that rate
+	for (size_t i = 0; i < count; i++)
+	{
+		double expected = calculate_growth_rate(campuses.initial_enrollments[i], campuses.target_enrollments[i], campuses.initial_years[i], campuses.target_years[i]);
+		double scale = 1.0 + fabs(expected);
+		double tolerance = GROWTH_RATES_MAX_ULP * (nextafter(scale, INFINITY) - scale);
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(tolerance, expected, matrix.growth_rates[i], "Engine growth rate differs from calculate_growth_rate by more than GROWTH_RATES_MAX_ULP.");
 
-		return emptyPtr;
+		for (int year = matrix.first_year; year <= matrix.last_year; year++)
+		{
+			int expected_estimate = calculate_enrollment_estimate(campuses.initial_enrollments[i], matrix.growth_rates[i], campuses.initial_years[i], year);
+			TEST_ASSERT_EQUAL_INT_MESSAGE(expected_estimate, projection_matrix_row(&matrix, year)[i], "Engine estimate differs from calculate_enrollment_estimate.");
+		}
 	}
 
-	// Start at end of string and find last non-space character
-	size_t last_nonspace = strlen(string) - 1;
-	while (last_nonspace >= first_nonspace && isspace(string[last_nonspace]))
+	// Free memory
+	projection_matrix_free(&matrix);
+	campus_table_free(&campuses);
+}
+
+void test_3d_project_campuses_thread_counts(void)
+{
+	// Build campuses
+	const size_t count = 5 * PROJECTION_TILE_CAMPUSES + 1;
+	struct campus_table campuses;
+	TEST_ASSERT_TRUE_MESSAGE(campus_table_init(&campuses, count), "Campus table could not be initialized.");
+	for (size_t i = 0; i < count; i++)
 	{
-		// Decrement position
-		last_nonspace--;
+		TEST_ASSERT_TRUE_MESSAGE(campus_table_add(&campuses, rand() % 30000 + 10000, 2024, rand() % 60000 + 1000, 2024 + rand() % 50 + 1), "Campus could not be added."); // NOLINT(*-msc50-cpp)
 	}
 
-	// Determine size of trimmed string, not including null terminator
+	// Project on the calling thread
+	struct projection_matrix expected;
+	TEST_ASSERT_TRUE_MESSAGE(projection_matrix_init(&expected, count, 2024, 2100), "Projection matrix could not be initialized.");
+	project_campuses(NULL, &campuses, &expected);
+
+	// Every pool size must produce the same matrix, and a pool must be reusable across runs
+	const unsigned int thread_counts[] = { 1, 2, 4, 7 };
+	for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++)
+	{
+		struct worker_pool pool;
+		TEST_ASSERT_TRUE_MESSAGE(worker_pool_init(&pool, thread_counts[t]), "Worker pool could not be started.");
+		for (int run = 0; run < 2; run++)
+		{
+			struct projection_matrix actual;
+			TEST_ASSERT_TRUE_MESSAGE(projection_matrix_init(&actual, count, 2024, 2100), "Projection matrix could not be initialized.");
+			project_campuses(&pool, &campuses, &actual);
+			TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected.growth_rates, actual.growth_rates, count * sizeof(double), "Growth rates depend on the number of threads.");
+			for (int year = expected.first_year; year <= expected.last_year; year++)
+			{
+				TEST_ASSERT_EQUAL_INT_ARRAY_MESSAGE(projection_matrix_row(&expected, year), projection_matrix_row(&actual, year), count, "Estimates depend on the number of threads.");
+			}
+			projection_matrix_free(&actual);
+		}
+		worker_pool_free(&pool);
+	}
+
+	// Free memory
+	projection_matrix_free(&expected);
+	campus_table_free(&campuses);
+}
+
+void test_3e_parse_campus_csv(void)
+{
+	// Header, CRLF and blank lines, int limits, malformed rows and a last row without a newline
+	const char text[] =
+		"initial_enrollment,target_enrollment,initial_year,target_year\r\n"
+		"30000,39930,2030,2033\r\n"
+		"\n"
+		"25000,24010,2024,2026\n"
+		"-5,2147483647,-2147483648,0\n"
+		"12,abc,2020,2021\n"
+		"1,2,3\n"
+		"99999999999,1,2,3\n"
+		"123456789,1234567890,1,2\n"
+		"7,8,9,10";
+	const int expected[][4] = {
+		{ 30000, 39930, 2030, 2033 },
+		{ 25000, 24010, 2024, 2026 },
+		{ -5, INT_MAX, INT_MIN, 0 },
+		{ 123456789, 1234567890, 1, 2 },
+		{ 7, 8, 9, 10 },
+	};
+	const size_t expected_rows = sizeof(expected) / sizeof(expected[0]);
+
+	// Parse on the calling thread and on a pool, appending after a row already in the table
+	struct worker_pool pool;
+	TEST_ASSERT_TRUE_MESSAGE(worker_pool_init(&pool, 3), "Worker pool could not be started.");
+	struct worker_pool* pools[] = { NULL, &pool };
+	for (size_t p = 0; p < sizeof(pools) / sizeof(pools[0]); p++)
+	{
+		struct campus_table campuses;
+		TEST_ASSERT_TRUE_MESSAGE(campus_table_init(&campuses, 1), "Campus table could not be initialized.");
+		TEST_ASSERT_TRUE_MESSAGE(campus_table_add(&campuses, 1, 2, 3, 4), "Campus could not be added.");
+
+		struct csv_ingest_stats stats;
+		TEST_ASSERT_TRUE_MESSAGE(parse_campus_csv(text, sizeof(text) - 1, pools[p], &campuses, &stats), "CSV text could not be parsed.");
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(sizeof(text) - 1, stats.bytes, "Wrong number of bytes reported.");
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(expected_rows, stats.rows, "Wrong number of rows parsed.");
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(3, stats.malformed_rows, "Wrong number of malformed rows.");
+		TEST_ASSERT_EQUAL_size_t_MESSAGE((size_t)(strstr(text, "12,abc") - text), stats.first_malformed_offset, "Wrong offset for the first malformed row.");
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(expected_rows + 1, campuses.count, "Rows were not appended after the existing campus.");
+		TEST_ASSERT_EQUAL_INT_MESSAGE(1, campuses.initial_enrollments[0], "Existing campus was overwritten.");
+
+		for (size_t i = 0; i < expected_rows; i++)
+		{
+			TEST_ASSERT_EQUAL_INT_MESSAGE(expected[i][0], campuses.initial_enrollments[i + 1], "Wrong initial enrollment.");
+			TEST_ASSERT_EQUAL_INT_MESSAGE(expected[i][1], campuses.target_enrollments[i + 1], "Wrong target enrollment.");
+			TEST_ASSERT_EQUAL_INT_MESSAGE(expected[i][2], campuses.initial_years[i + 1], "Wrong initial year.");
+			TEST_ASSERT_EQUAL_INT_MESSAGE(expected[i][3], campuses.target_years[i + 1], "Wrong target year.");
+		}
+
+		campus_table_free(&campuses);
+	}
+	worker_pool_free(&pool);
+}
+
+void test_3e_load_campus_csv(void)
+{
+	// Write random campuses to a temporary CSV file
+	char filename[] = "/tmp/test_hw1_wvuep_XXXXXX";
+	int fd = mkstemp(filename);
+	TEST_ASSERT_TRUE_MESSAGE(fd >= 0, "Temporary file could not be created.");
+	FILE* file = fdopen(fd, "w");
+	TEST_ASSERT_NOT_NULL_MESSAGE(file, "Temporary file could not be opened.");
+
+	const size_t count = 10007;
+	struct campus_table expected;
+	TEST_ASSERT_TRUE_MESSAGE(campus_table_init(&expected, count), "Campus table could not be initialized.");
+	fprintf(file, "initial_enrollment,target_enrollment,initial_year,target_year\n");
+	for (size_t i = 0; i < count; i++)
+	{
+		int initial_enrollment = rand() % 30000 + 10000; // NOLINT(*-msc50-cpp)
+		int target_enrollment = rand() % 60000 + 1000; // NOLINT(*-msc50-cpp)
+		int initial_year = rand() % 50 + 2000; // NOLINT(*-msc50-cpp)
+		int target_year = initial_year + rand() % 50 + 1; // NOLINT(*-msc50-cpp)
+		campus_table_add(&expected, initial_enrollment, initial_year, target_enrollment, target_year);
+		fprintf(file, "%d,%d,%d,%d\n", initial_enrollment, target_enrollment, initial_year, target_year);
+	}
+	long size = ftell(file);
+	fclose(file);
+
+	// Load the file on a pool
+	struct worker_pool pool;
+	TEST_ASSERT_TRUE_MESSAGE(worker_pool_init(&pool, 3), "Worker pool could not be started.");
+	struct campus_table campuses;
+	TEST_ASSERT_TRUE_MESSAGE(campus_table_init(&campuses, 0), "Campus table could not be initialized.");
+	struct csv_ingest_stats stats;
+	bool loaded = load_campus_csv(filename, &pool, &campuses, &stats);
+	worker_pool_free(&pool);
+	unlink(filename);
+	TEST_ASSERT_TRUE_MESSAGE(loaded, "CSV file could not be loaded.");
+
+	// Every row must match what was written, in order
+	TEST_ASSERT_EQUAL_size_t_MESSAGE((size_t)size, stats.bytes, "Wrong number of bytes reported.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(0, stats.malformed_rows, "Valid rows were reported as malformed.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(count, campuses.count, "Wrong number of rows loaded.");
+	TEST_ASSERT_EQUAL_INT_ARRAY_MESSAGE(expected.initial_enrollments, campuses.initial_enrollments, count, "Wrong initial enrollments.");
+	TEST_ASSERT_EQUAL_INT_ARRAY_MESSAGE(expected.target_enrollments, campuses.target_enrollments, count, "Wrong target enrollments.");
+	TEST_ASSERT_EQUAL_INT_ARRAY_MESSAGE(expected.initial_years, campuses.initial_years, count, "Wrong initial years.");
+	TEST_ASSERT_EQUAL_INT_ARRAY_MESSAGE(expected.target_years, campuses.target_years, count, "Wrong target years.");
+
+	// Free memory
+	campus_table_free(&campuses);
+	campus_table_free(&expected);
+}
+
+void test_3f_write_projection_file(void)
+{
+	// Project random campuses
+	const size_t count = 1000;
+	struct campus_table campuses;
+	TEST_ASSERT_TRUE_MESSAGE(campus_table_init(&campuses, count), "Campus table could not be initialized.");
+	for (size_t i = 0; i < count; i++)
+	{
+		TEST_ASSERT_TRUE_MESSAGE(campus_table_add(&campuses, rand() % 30000 + 10000, 2024, rand() % 60000 + 1000, 2024 + rand() % 50 + 1), "Campus could not be added."); // NOLINT(*-msc50-cpp)
+	}
+	struct projection_matrix matrix;
+	TEST_ASSERT_TRUE_MESSAGE(projection_matrix_init(&matrix, count, 2020, 2075), "Projection matrix could not be initialized.");
+	project_campuses(NULL, &campuses, &matrix);
+
+	// Write the matrix and map it back
+	char filename[] = "/tmp/test_hw1_wvuep_XXXXXX";
+	int fd = mkstemp(filename);
+	TEST_ASSERT_TRUE_MESSAGE(fd >= 0, "Temporary file could not be created.");
+	close(fd);
+	bool written = write_projection_file(filename, &matrix);
+	struct projection_file file;
+	bool opened = written && projection_file_open(&file, filename);
+	unlink(filename);
+	TEST_ASSERT_TRUE_MESSAGE(written, "Results file could not be written.");
+	TEST_ASSERT_TRUE_MESSAGE(opened, "Results file could not be opened.");
+
+	// The header, year column, rates and every estimate must match the matrix
+	TEST_ASSERT_EQUAL_UINT32_MESSAGE(PROJECTION_FILE_VERSION, file.header->version, "Wrong format version.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(matrix.first_year, file.header->first_year, "Wrong first year.");
+	TEST_ASSERT_EQUAL_UINT32_MESSAGE(matrix.year_count, file.header->year_count, "Wrong year count.");
+	TEST_ASSERT_EQUAL_UINT64_MESSAGE(count, file.header->campus_count, "Wrong campus count.");
+	for (size_t i = 0; i < matrix.year_count; i++)
+	{
+		TEST_ASSERT_EQUAL_INT_MESSAGE(matrix.first_year + (int)i, file.years[i], "Wrong year in year column.");
+	}
+	TEST_ASSERT_EQUAL_MEMORY_MESSAGE(matrix.growth_rates, file.growth_rates, count * sizeof(double), "Growth rates differ from the matrix.");
+	for (size_t campus = 0; campus < count; campus++)
+	{
+		for (int year = matrix.first_year; year <= matrix.last_year; year++)
+		{
+			TEST_ASSERT_EQUAL_INT_MESSAGE(projection_matrix_row(&matrix, year)[campus], projection_file_estimate(&file, campus, year), "Estimate differs from the matrix.");
+		}
+	}
+
+	// Free memory
+	projection_file_close(&file);
+	projection_matrix_free(&matrix);
+	campus_table_free(&campuses);
+}
+
+void test_3f_projection_file_open_invalid(void)
+{
+	// Write a valid file to corrupt
+	struct campus_table campuses;
+	TEST_ASSERT_TRUE_MESSAGE(campus_table_init(&campuses, 0), "Campus table could not be initialized.");
+	TEST_ASSERT_TRUE_MESSAGE(campus_table_add(&campuses, 29107, 2020, 60511, 2035), "Campus could not be added.");
+	struct projection_matrix matrix;
+	TEST_ASSERT_TRUE_MESSAGE(projection_matrix_init(&matrix, 1, 2020, 2035), "Projection matrix could not be initialized.");
+	project_campuses(NULL, &campuses, &matrix);
+	char filename[] = "/tmp/test_hw1_wvuep_XXXXXX";
+	int fd = mkstemp(filename);
+	TEST_ASSERT_TRUE_MESSAGE(fd >= 0, "Temporary file could not be created.");
+	close(fd);
+	TEST_ASSERT_TRUE_MESSAGE(write_projection_file(filename, &matrix), "Results file could not be written.");
+	struct stat status;
+	stat(filename, &status);
+
+	// Hide the error messages the rejected files print
+	int saved_stderr = dup(STDERR_FILENO);
+	int null_fd = open("/dev/null", O_WRONLY);
+	dup2(null_fd, STDERR_FILENO);
+
+	// A truncated file, a newer version and a different magic must all be rejected
+	struct projection_file file;
+	bool truncated_opened = truncate(filename, status.st_size - 1) == 0 && projection_file_open(&file, filename);
+	TEST_ASSERT_TRUE_MESSAGE(truncate(filename, status.st_size) == 0, "Results file could not be restored.");
+	fd = open(filename, O_WRONLY);
+	uint32_t version = PROJECTION_FILE_VERSION + 1;
+	pwrite(fd, &version, sizeof(version), offsetof(struct projection_file_header, version));
+	bool version_opened = projection_file_open(&file, filename);
+	pwrite(fd, "CSV", 4, 0);
+	bool magic_opened = projection_file_open(&file, filename);
+	close(fd);
+
+	// Redirect error messages to original destination
+	dup2(saved_stderr, STDERR_FILENO);
+	close(saved_stderr);
+	close(null_fd);
+	unlink(filename);
+
+	TEST_ASSERT_FALSE_MESSAGE(truncated_opened, "Truncated results file was opened.");
+	TEST_ASSERT_FALSE_MESSAGE(version_opened, "Results file with an unsupported version was opened.");
+	TEST_ASSERT_FALSE_MESSAGE(magic_opened, "File without the results magic was opened.");
+
+	// Free memory
+	projection_matrix_free(&matrix);
+	campus_table_free(&campuses);
+}
+
+/**
+ * @brief Check categories and histogram from classify_growth_rates against get_growth_rate_description
+ * @param growth_rates Rates to classify
+ * @param count Number of rates
+ */
+static void check_growth_rate_categories(const double* growth_rates, size_t count)
+{
+	// Description names in category order; descriptions are compared by prefix
+	static const char* names[GROWTH_RATE_CATEGORY_COUNT] = { "negative", "reasonable", "ambitious", "high", "unreasonable" };
+
+	unsigned char* categories = malloc(count);
+	TEST_ASSERT_NOT_NULL_MESSAGE(categories, "Memory could not be allocated for categories.");
+	size_t histogram[GROWTH_RATE_CATEGORY_COUNT];
+	classify_growth_rates(growth_rates, categories, count, histogram);
+
+	size_t expected_histogram[GROWTH_RATE_CATEGORY_COUNT] = { 0 };
+	for (size_t i = 0; i < count; i++)
+	{
+		TEST_ASSERT_TRUE_MESSAGE(categories[i] < GROWTH_RATE_CATEGORY_COUNT, "Category out of range.");
+		const char* description = get_growth_rate_description(growth_rates[i]);
+		TEST_ASSERT_EQUAL_STRING_LEN_MESSAGE(names[categories[i]], description, strlen(names[categories[i]]), "Category differs from get_growth_rate_description.");
+		TEST_ASSERT_EQUAL_INT_MESSAGE(classify_growth_rate(growth_rates[i]), categories[i], "Category differs from classify_growth_rate.");
+		expected_histogram[categories[i]]++;
+	}
+	TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected_histogram, histogram, sizeof(histogram), "Histogram does not match the categories.");
+
+	free(categories);
+}
+
+void test_3g_classify_growth_rates(void)
+{
+	// Random rates across every category, using a count that leaves a partial vector at the end
+	const size_t count = 100003;
+	double* growth_rates = malloc(count * sizeof(double));
+	TEST_ASSERT_NOT_NULL_MESSAGE(growth_rates, "Memory could not be allocated for growth rates.");
+	for (size_t i = 0; i < count; i++)
+	{
+		growth_rates[i] = (rand() % 20001 - 5000) / 100000.0; // NOLINT(*-msc50-cpp)
+	}
+
+	check_growth_rate_categories(growth_rates, count);
+
+	free(growth_rates);
+}
+
+void test_3g_classify_growth_rates_special_cases(void)
+{
+	// Values on and next to every threshold, signed zeros, infinities and NaN
+	double growth_rates[] = {
+		0.0, -0.0, nextafter(0.0, -1.0), nextafter(0.0, 1.0),
+		0.01, nextafter(0.01, 0.0), nextafter(0.01, 1.0),
+		0.02, nextafter(0.02, 0.0), nextafter(0.02, 1.0),
+		0.04, nextafter(0.04, 0.0), nextafter(0.04, 1.0),
+		INFINITY, -INFINITY, NAN, -NAN, 1.0, -1.0,
+	};
+
+	check_growth_rate_categories(growth_rates, sizeof(growth_rates) / sizeof(growth_rates[0]));
+
+	// The histogram is optional
+	unsigned char categories[4];
+	classify_growth_rates(growth_rates, categories, 4, NULL);
+	TEST_ASSERT_EQUAL_INT_MESSAGE(GROWTH_RATE_NEGATIVE, categories[2], "Histogram-free call gave the wrong category.");
+}
+
+void test_3h_read_target_enrollments(void)
+{
+	// Valid, negative, non-numeric and out-of-range tokens across lines, with no newline at the end
+	const char input[] = "29862 -5 abc\n  12x 0 -0 +7\n2147483648 2147483647\t99";
+	const int expected_targets[] = { 29862, 0, 0, 7, INT_MAX, 99 };
+	const struct target_token_rejection expected_rejections[] = {
+		{ TARGET_TOKEN_NEGATIVE, 6, 1, 7 },
+		{ TARGET_TOKEN_NOT_A_NUMBER, 9, 1, 10 },
+		{ TARGET_TOKEN_NOT_A_NUMBER, 15, 2, 3 },
+		{ TARGET_TOKEN_OUT_OF_RANGE, 27, 3, 1 },
+	};
+	const size_t expected_rejection_count = sizeof(expected_rejections) / sizeof(expected_rejections[0]);
+
+	// Send the input through a pipe like a script would
+	int pipe_fds[2];
+	TEST_ASSERT_EQUAL_INT_MESSAGE(0, pipe(pipe_fds), "Pipe could not be created.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE((int)sizeof(input) - 1, (int)write(pipe_fds[1], input, sizeof(input) - 1), "Input could not be written to the pipe.");
+	close(pipe_fds[1]);
+	struct target_enrollments targets;
+	bool success = read_target_enrollments(pipe_fds[0], &targets);
+	close(pipe_fds[0]);
+	TEST_ASSERT_TRUE_MESSAGE(success, "Target enrollments could not be read.");
+
+	// Check accepted values and each rejection's reason and position
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(sizeof(expected_targets) / sizeof(expected_targets[0]), targets.count, "Wrong number of targets accepted.");
+	TEST_ASSERT_EQUAL_INT_ARRAY_MESSAGE(expected_targets, targets.targets, targets.count, "Wrong targets accepted.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(expected_rejection_count, targets.rejection_count, "Wrong number of tokens rejected.");
+	for (size_t i = 0; i < expected_rejection_count; i++)
+	{
+		TEST_ASSERT_EQUAL_INT_MESSAGE(expected_rejections[i].problem, targets.rejections[i].problem, "Wrong reason for rejected token.");
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(expected_rejections[i].offset, targets.rejections[i].offset, "Wrong offset for rejected token.");
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(expected_rejections[i].line, targets.rejections[i].line, "Wrong line for rejected token.");
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(expected_rejections[i].column, targets.rejections[i].column, "Wrong column for rejected token.");
+	}
+
+	target_enrollments_free(&targets);
+}
+
+void test_3h_read_target_enrollments_large(void)
+{
+	// Write enough targets that tokens are split across reads, with a bad token every thousand
+	char filename[] = "/tmp/test_hw1_wvuep_XXXXXX";
+	int fd = mkstemp(filename);
+	TEST_ASSERT_TRUE_MESSAGE(fd >= 0, "Temporary file could not be created.");
+	FILE* file = fdopen(fd, "w");
+	TEST_ASSERT_NOT_NULL_MESSAGE(file, "Temporary file could not be opened.");
+	const size_t count = 100000;
+	int* expected = malloc(count * sizeof(int));
+	TEST_ASSERT_NOT_NULL_MESSAGE(expected, "Memory could not be allocated for targets.");
+	size_t bad_tokens = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		expected[i] = rand(); // NOLINT(*-msc50-cpp)
+		fprintf(file, "%d%c", expected[i], i % 10 == 9 ? '\n' : ' ');
+		if (i % 1000 == 999)
+		{
+			fprintf(file, "x%d ", expected[i]);
+			bad_tokens++;
+		}
+	}
+	fclose(file);
+
+	// Read the file through a descriptor
+	fd = open(filename, O_RDONLY);
+	TEST_ASSERT_TRUE_MESSAGE(fd >= 0, "Temporary file could not be reopened.");
+	struct target_enrollments targets;
+	bool success = read_target_enrollments(fd, &targets);
+	close(fd);
+	unlink(filename);
+	TEST_ASSERT_TRUE_MESSAGE(success, "Target enrollments could not be read.");
+
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(count, targets.count, "Wrong number of targets accepted.");
+	TEST_ASSERT_EQUAL_INT_ARRAY_MESSAGE(expected, targets.targets, count, "Wrong targets accepted.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(bad_tokens, targets.rejection_count, "Wrong number of tokens rejected.");
+
+	// Free memory
+	target_enrollments_free(&targets);
+	free(expected);
+}
+
+void test_3i_simulate_enrollment_bands(void)
+{
+	const int initial_enrollment = 20000;
+	const double growth_rate = 0.02;
+	const double volatility = 0.03;
+	struct enrollment_bands bands;
+
+	// Invalid parameters are rejected
+	TEST_ASSERT_FALSE_MESSAGE(simulate_enrollment_bands(NULL, 0, growth_rate, 2024, 2054, volatility, 1000, 1, &bands), "Zero initial enrollment was accepted.");
+	TEST_ASSERT_FALSE_MESSAGE(simulate_enrollment_bands(NULL, initial_enrollment, growth_rate, 2024, 2023, volatility, 1000, 1, &bands), "End year before initial year was accepted.");
+	TEST_ASSERT_FALSE_MESSAGE(simulate_enrollment_bands(NULL, initial_enrollment, growth_rate, 2024, 2054, -volatility, 1000, 1, &bands), "Negative volatility was accepted.");
+	TEST_ASSERT_FALSE_MESSAGE(simulate_enrollment_bands(NULL, initial_enrollment, growth_rate, 2024, 2054, volatility, 0, 1, &bands), "Zero paths were accepted.");
+
+	// Without volatility every percentile is the deterministic estimate, within the sketch accuracy
+	TEST_ASSERT_TRUE_MESSAGE(simulate_enrollment_bands(NULL, initial_enrollment, growth_rate, 2024, 2054, 0.0, 100, 1, &bands), "Bands could not be simulated.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(2024, bands.first_year, "Wrong first year.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(31, bands.year_count, "Wrong number of years.");
+	for (size_t year = 0; year < bands.year_count; year++)
+	{
+		double expected = initial_enrollment * pow(1 + growth_rate, (double)year);
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(expected * MONTE_CARLO_RELATIVE_ACCURACY, expected, bands.p5[year], "Wrong 5th percentile without volatility.");
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(expected * MONTE_CARLO_RELATIVE_ACCURACY, expected, bands.p50[year], "Wrong median without volatility.");
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(expected * MONTE_CARLO_RELATIVE_ACCURACY, expected, bands.p95[year], "Wrong 95th percentile without volatility.");
+	}
+	enrollment_bands_free(&bands);
+
+	// With volatility the percentiles follow the lognormal distribution of the paths
+	TEST_ASSERT_TRUE_MESSAGE(simulate_enrollment_bands(NULL, initial_enrollment, growth_rate, 2024, 2054, volatility, 40000, 42, &bands), "Bands could not be simulated.");
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(initial_enrollment, bands.p50[0], "Initial year is not exact.");
+	for (size_t year = 1; year < bands.year_count; year++)
+	{
+		double median = initial_enrollment * pow(1 + growth_rate, (double)year);
+		double spread = exp(1.6448536 * volatility * sqrt((double)year));
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(median * 0.025, median / spread, bands.p5[year], "5th percentile is not near the lognormal quantile.");
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(median * 0.025, median, bands.p50[year], "Median is not near the deterministic estimate.");
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(median * 0.025, median * spread, bands.p95[year], "95th percentile is not near the lognormal quantile.");
+		TEST_ASSERT_TRUE_MESSAGE(bands.p5[year] < bands.p50[year] && bands.p50[year] < bands.p95[year], "Percentiles are out of order.");
+	}
+	enrollment_bands_free(&bands);
+}
+
+void test_3i_simulate_enrollment_bands_thread_counts(void)
+{
+	// Use a path count that leaves a partial block
+	const size_t path_count = 3 * MONTE_CARLO_BLOCK_PATHS + 17;
+	struct enrollment_bands expected;
+	TEST_ASSERT_TRUE_MESSAGE(simulate_enrollment_bands(NULL, 15000, -0.01, 2024, 2060, 0.05, path_count, 7, &expected), "Bands could not be simulated.");
+
+	// Every pool size must produce exactly the same bands for the same seed
+	const unsigned int thread_counts[] = { 1, 2, 3, 4 };
+	for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++)
+	{
+		struct worker_pool pool;
+		TEST_ASSERT_TRUE_MESSAGE(worker_pool_init(&pool, thread_counts[t]), "Worker pool could not be started.");
+		struct enrollment_bands actual;
+		TEST_ASSERT_TRUE_MESSAGE(simulate_enrollment_bands(&pool, 15000, -0.01, 2024, 2060, 0.05, path_count, 7, &actual), "Bands could not be simulated.");
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(expected.year_count, actual.year_count, "Wrong number of years.");
+		TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected.p5, actual.p5, expected.year_count * sizeof(double), "5th percentiles depend on the number of threads.");
+		TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected.p50, actual.p50, expected.year_count * sizeof(double), "Medians depend on the number of threads.");
+		TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected.p95, actual.p95, expected.year_count * sizeof(double), "95th percentiles depend on the number of threads.");
+		enrollment_bands_free(&actual);
+		worker_pool_free(&pool);
+	}
+
+	// A different seed draws different paths
+	struct enrollment_bands other;
+	TEST_ASSERT_TRUE_MESSAGE(simulate_enrollment_bands(NULL, 15000, -0.01, 2024, 2060, 0.05, path_count, 8, &other), "Bands could not be simulated.");
+	TEST_ASSERT_TRUE_MESSAGE(memcmp(expected.p95, other.p95, expected.year_count * sizeof(double)) != 0, "Different seeds produced the same bands.");
+
+	// Free memory
+	enrollment_bands_free(&other);
+	enrollment_bands_free(&expected);
+}
+
+/**
+ * @brief Calculate a scheduled estimate by multiplying the growth of every segment from initial_year
+ * @param schedule Growth schedule
+ * @param estimate_year Year for which to calculate enrollment estimate
+ * @return Estimated enrollment
+ */
+static int recompute_scheduled_enrollment_estimate(const struct growth_schedule* schedule, int estimate_year)
+{
+	double growth_factor = 1.0;
+	size_t segment = 0;
+	while (segment + 1 < schedule->count && schedule->start_years[segment + 1] <= estimate_year)
+	{
+		growth_factor *= pow(1 + schedule->growth_rates[segment], schedule->start_years[segment + 1] - schedule->start_years[segment]);
+		segment++;
+	}
+	growth_factor *= pow(1 + schedule->growth_rates[segment], estimate_year - schedule->start_years[segment]);
+
+	return (int)round(schedule->initial_enrollment * growth_factor);
+}
+
+void test_3j_calculate_scheduled_enrollment_estimate(void)
+{
+	// A single segment matches calculate_enrollment_estimate, before and after the initial year
+	struct growth_schedule schedule;
+	TEST_ASSERT_TRUE_MESSAGE(growth_schedule_init(&schedule, 29862, 0.0231, 2024), "Growth schedule could not be initialized.");
+	for (int year = 2000; year <= 2200; year++)
+	{
+		TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_enrollment_estimate(29862, 0.0231, 2024, year), calculate_scheduled_enrollment_estimate(&schedule, year), "Single segment differs from calculate_enrollment_estimate.");
+	}
+	growth_schedule_free(&schedule);
+
+	// 10% growth for two years, flat for four, then a 10% decline
+	TEST_ASSERT_TRUE_MESSAGE(growth_schedule_init(&schedule, 10000, 0.10, 2024), "Growth schedule could not be initialized.");
+	TEST_ASSERT_TRUE_MESSAGE(growth_schedule_append(&schedule, 2026, 0.0), "Segment could not be added.");
+	TEST_ASSERT_TRUE_MESSAGE(growth_schedule_append(&schedule, 2030, -0.10), "Segment could not be added.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(9091, calculate_scheduled_enrollment_estimate(&schedule, 2023), "Wrong estimate before the initial year.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(10000, calculate_scheduled_enrollment_estimate(&schedule, 2024), "Wrong estimate in the initial year.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(11000, calculate_scheduled_enrollment_estimate(&schedule, 2025), "Wrong estimate in the first segment.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(12100, calculate_scheduled_enrollment_estimate(&schedule, 2026), "Wrong estimate at the start of the second segment.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(12100, calculate_scheduled_enrollment_estimate(&schedule, 2030), "Wrong estimate at the start of the last segment.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(10890, calculate_scheduled_enrollment_estimate(&schedule, 2031), "Wrong estimate in the last segment.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(9801, calculate_scheduled_enrollment_estimate(&schedule, 2032), "Wrong estimate in the last segment.");
+	growth_schedule_free(&schedule);
+}
+
+void test_3j_growth_schedule_append(void)
+{
+	// Segments must start after the last one
+	struct growth_schedule schedule;
+	TEST_ASSERT_TRUE_MESSAGE(growth_schedule_init(&schedule, 25000, 0.01, 2024), "Growth schedule could not be initialized.");
+	TEST_ASSERT_FALSE_MESSAGE(growth_schedule_append(&schedule, 2024, 0.02), "Segment starting with the last one was accepted.");
+	TEST_ASSERT_FALSE_MESSAGE(growth_schedule_append(&schedule, 2020, 0.02), "Segment starting before the last one was accepted.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(1, schedule.count, "Rejected segments were added.");
+
+	// Append random segments past the initial capacity, checking every year against recomputation after each one
+	int start_year = 2024;
+	for (int segment = 1; segment < 100; segment++)
+	{
+		start_year += rand() % 5 + 1; // NOLINT(*-msc50-cpp)
+		TEST_ASSERT_TRUE_MESSAGE(growth_schedule_append(&schedule, start_year, (rand() % 801 - 400) / 10000.0), "Segment could not be added."); // NOLINT(*-msc50-cpp)
+		for (int year = 2014; year <= start_year + 10; year++)
+		{
+			TEST_ASSERT_EQUAL_INT_MESSAGE(recompute_scheduled_enrollment_estimate(&schedule, year), calculate_scheduled_enrollment_estimate(&schedule, year), "Cached estimate differs from recomputation.");
+		}
+	}
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(100, schedule.count, "Wrong number of segments.");
+
+	// Free memory
+	growth_schedule_free(&schedule);
+}
+
+/**
+ * @brief Run a projection server until it is stopped
+ * @param server Pointer to the open projection_server
+ * @return NULL
+ */
+static void* run_projection_server(void* server)
+{
+	projection_server_run(server);
+
+	return NULL;
+}
+
+/**
+ * @brief Open a projection server on a temporary socket and run it on a new thread
+ * @param server Server to open
+ * @param path Buffer receiving the socket path, at least 32 bytes
+ * @param thread Thread running the server
+ */
+static void start_projection_server(struct projection_server* server, char* path, pthread_t* thread)
+{
+	// Reserve a unique name, then replace the file with the socket
+	strcpy(path, "/tmp/test_hw1_wvuep_XXXXXX");
+	int fd = mkstemp(path);
+	TEST_ASSERT_TRUE_MESSAGE(fd >= 0, "Temporary file could not be created.");
+	close(fd);
+	unlink(path);
+	TEST_ASSERT_TRUE_MESSAGE(projection_server_open(server, path), "Projection server could not be opened.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(0, pthread_create(thread, NULL, run_projection_server, server), "Server thread could not be started.");
+}
+
+/**
+ * @brief Check an answer against calculate_growth_rate and calculate_enrollment_estimate
+ * @param request Request answered
+ * @param response Start of the answer
+ * @param estimates Estimates of the answer
+ */
+static void check_projection_response(const struct projection_request* request, const struct projection_response* response, const int32_t* estimates)
+{
+	double growth_rate = calculate_growth_rate(request->initial_enrollment, request->target_enrollment, request->initial_year, request->target_year);
+	TEST_ASSERT_EQUAL_INT_MESSAGE(PROJECTION_STATUS_OK, response->status, "Valid request was not answered.");
+	TEST_ASSERT_EQUAL_UINT32_MESSAGE(request->last_year - request->first_year + 1, response->year_count, "Wrong number of estimates.");
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(growth_rate, response->growth_rate, "Wrong growth rate.");
+	for (uint32_t i = 0; i < response->year_count; i++)
+	{
+		TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_enrollment_estimate(request->initial_enrollment, growth_rate, request->initial_year, request->first_year + (int)i), estimates[i], "Estimate differs from calculate_enrollment_estimate.");
+	}
+}
+
+void test_3k_projection_server(void)
+{
+	struct projection_server server;
+	char path[32];
+	pthread_t thread;
+	start_projection_server(&server, path, &thread);
+	struct projection_client client;
+	TEST_ASSERT_TRUE_MESSAGE(projection_client_connect(&client, path), "Client could not connect.");
+
+	// A request is projected, and the same request again comes from the cache
+	struct projection_request request = { 25994, 30000, 2024, 2040, 2020, 2070 };
+	struct projection_response response;
+	int32_t estimates[PROJECTION_SERVER_MAX_YEARS];
+	for (int i = 0; i < 2; i++)
+	{
+		TEST_ASSERT_TRUE_MESSAGE(projection_client_query(&client, &request, &response, estimates, PROJECTION_SERVER_MAX_YEARS), "Request could not be answered.");
+		check_projection_response(&request, &response, estimates);
+	}
+
+	// Invalid requests are answered with a status and no estimates
+	const struct projection_request invalid[] = { { 0, 30000, 2024, 2040, 2024, 2070 }, { 25994, 30000, 2024, 2024, 2024, 2070 }, { 25994, 30000, 2024, 2040, 2070, 2024 }, { 25994, 30000, 2024, 2040, 2024, 2024 + PROJECTION_SERVER_MAX_YEARS } };
+	for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+	{
+		TEST_ASSERT_TRUE_MESSAGE(projection_client_query(&client, &invalid[i], &response, estimates, PROJECTION_SERVER_MAX_YEARS), "Invalid request was not answered.");
+		TEST_ASSERT_EQUAL_INT_MESSAGE(PROJECTION_STATUS_INVALID, response.status, "Invalid request was accepted.");
+		TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, response.year_count, "Invalid request has estimates.");
+	}
+
+	// Pipelined requests, with the last split across writes, are answered in order
+	struct projection_request pipelined[3] = { { 10000, 12000, 2024, 2030, 2024, 2030 }, { 20000, 15000, 2020, 2050, 2000, 2100 }, { 5000, 5000, 2024, 2025, 2024, 2024 } };
+	TEST_ASSERT_EQUAL_INT_MESSAGE((int)(sizeof(pipelined) - 7), (int)write(client.fd, pipelined, sizeof(pipelined) - 7), "Pipelined requests could not be sent.");
+	usleep(10000);
+	TEST_ASSERT_EQUAL_INT_MESSAGE(7, (int)write(client.fd, (char*)pipelined + sizeof(pipelined) - 7, 7), "Pipelined requests could not be sent.");
+	for (size_t i = 0; i < 3; i++)
+	{
+		TEST_ASSERT_EQUAL_INT_MESSAGE((int)sizeof(response), (int)recv(client.fd, &response, sizeof(response), MSG_WAITALL), "Pipelined answer could not be read.");
+		TEST_ASSERT_EQUAL_INT_MESSAGE((int)(response.year_count * sizeof(int32_t)), (int)recv(client.fd, estimates, response.year_count * sizeof(int32_t), MSG_WAITALL), "Pipelined estimates could not be read.");
+		check_projection_response(&pipelined[i], &response, estimates);
+	}
+
+	// Stop the server and check its counts
+	projection_client_close(&client);
+	projection_server_stop(&server);
+	pthread_join(thread, NULL);
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(9, server.requests, "Wrong number of requests counted.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(1, server.cache_hits, "Repeated request was not answered from the cache.");
+	projection_server_close(&server);
+	TEST_ASSERT_TRUE_MESSAGE(access(path, F_OK) != 0, "Socket was not removed.");
+}
+
+void test_3k_projection_server_clients(void)
+{
+	struct projection_server server;
+	char path[32];
+	pthread_t thread;
+	start_projection_server(&server, path, &thread);
+
+	// Interleave requests from several clients, dropping one part way through
+	enum { CLIENT_COUNT = 8, ROUNDS = 50 };
+	struct projection_client clients[CLIENT_COUNT];
+	for (int c = 0; c < CLIENT_COUNT; c++)
+	{
+		TEST_ASSERT_TRUE_MESSAGE(projection_client_connect(&clients[c], path), "Client could not connect.");
+	}
+	size_t requests = 0;
+	for (int round = 0; round < ROUNDS; round++)
+	{
+		for (int c = 0; c < CLIENT_COUNT; c++)
+		{
+			if (c == 0 && round == ROUNDS / 2)
+			{
+				projection_client_close(&clients[0]);
+			}
+			if (clients[c].fd < 0)
+			{
+				continue;
+			}
+
+			// A few distinct campuses per client, so most requests repeat
+			struct projection_request request = { 10000 + c * 1000 + round % 5, 20000, 2024, 2050, 2024, 2024 + round % 7 * 10 };
+			struct projection_response response;
+			int32_t estimates[PROJECTION_SERVER_MAX_YEARS];
+			TEST_ASSERT_TRUE_MESSAGE(projection_client_query(&clients[c], &request, &response, estimates, PROJECTION_SERVER_MAX_YEARS), "Request could not be answered.");
+			check_projection_response(&request, &response, estimates);
+			requests++;
+		}
+	}
+
+	// Closing the server with connections still open frees them
+	projection_server_stop(&server);
+	pthread_join(thread, NULL);
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(requests, server.requests, "Wrong number of requests counted.");
+	TEST_ASSERT_TRUE_MESSAGE(server.cache_hits > 0, "No request was answered from the cache.");
+	projection_server_close(&server);
+	for (int c = 1; c < CLIENT_COUNT; c++)
+	{
+		projection_client_close(&clients[c]);
+	}
+}
+
+void test_3l_growth_factor_table(void)
+{
+	// Invalid grids are rejected
+	struct growth_factor_table table;
+	TEST_ASSERT_FALSE_MESSAGE(growth_factor_table_init(&table, -10000, 0, 10), "Rate of -100% was accepted.");
+	TEST_ASSERT_FALSE_MESSAGE(growth_factor_table_init(&table, 100, 0, 10), "Empty rate range was accepted.");
+	TEST_ASSERT_FALSE_MESSAGE(growth_factor_table_init(&table, 0, 100, 0), "Empty horizon was accepted.");
+	TEST_ASSERT_TRUE_MESSAGE(growth_factor_table_init(&table, GROWTH_FACTOR_DEFAULT_MIN_BASIS_POINTS, GROWTH_FACTOR_DEFAULT_MAX_BASIS_POINTS, GROWTH_FACTOR_DEFAULT_YEARS), "Growth factor table could not be initialized.");
+
+	// Rates on the grid match pow and calculate_enrollment_estimate exactly
+	const double grid_rates[] = { -0.2, -0.0125, 0.0, 0.0231, 0.05, 0.2 };
+	for (size_t i = 0; i < sizeof(grid_rates) / sizeof(grid_rates[0]); i++)
+	{
+		for (int years = 0; years < GROWTH_FACTOR_DEFAULT_YEARS; years++)
+		{
+			TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(pow(1 + grid_rates[i], years), growth_factor_table_factor(&table, grid_rates[i], years), "Grid factor differs from pow.");
+			TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_enrollment_estimate(25994, grid_rates[i], 2024, 2024 + years), calculate_enrollment_estimate_table(&table, 25994, grid_rates[i], 2024, 2024 + years), "Grid estimate differs from calculate_enrollment_estimate.");
+		}
+		TEST_ASSERT_EQUAL_INT_MESSAGE(0, growth_factor_table_max_deviation(&table, 25994, grid_rates[i], 2024, 2024 + GROWTH_FACTOR_DEFAULT_YEARS - 1), "Grid rate has a deviation.");
+	}
+
+	// Rates and horizons outside the table fall back to pow exactly
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(pow(1.35, 10), growth_factor_table_factor(&table, 0.35, 10), "Rate above the table differs from pow.");
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(pow(1.0231, 250), growth_factor_table_factor(&table, 0.0231, 250), "Horizon beyond the table differs from pow.");
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(pow(1.0231, -5), growth_factor_table_factor(&table, 0.0231, -5), "Negative horizon differs from pow.");
+
+	// Rates between grid points are interpolated within the reported error
+	double max_error = growth_factor_table_max_error(&table);
+	TEST_ASSERT_TRUE_MESSAGE(max_error > 0.0 && max_error < 2e-9, "Interpolation error is too large.");
+	for (int i = 0; i < 2000; i++)
+	{
+		double growth_rate = calculate_growth_rate(rand() % 50000 + 1000, rand() % 50000 + 1000, 2024, 2025 + rand() % 60); // NOLINT(*-msc50-cpp)
+		if (fabs(growth_rate) > 0.2)
+		{
+			continue;
+		}
+		int years = rand() % GROWTH_FACTOR_DEFAULT_YEARS; // NOLINT(*-msc50-cpp)
+		double exact = pow(1 + growth_rate, years);
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(exact * max_error * 1.01, exact, growth_factor_table_factor(&table, growth_rate, years), "Interpolated factor exceeds the reported error.");
+		TEST_ASSERT_TRUE_MESSAGE(growth_factor_table_max_deviation(&table, 25994, growth_rate, 2024, 2024 + years) <= 1, "Interpolated estimate deviates by more than rounding.");
+	}
+
+	// Free memory
+	growth_factor_table_free(&table);
+}
+
+void test_3l_growth_factor_table_file(void)
+{
+	// Save a small table
+	struct growth_factor_table computed;
+	TEST_ASSERT_TRUE_MESSAGE(growth_factor_table_init(&computed, -500, 700, 120), "Growth factor table could not be initialized.");
+	char filename[] = "/tmp/test_hw1_wvuep_XXXXXX";
+	int fd = mkstemp(filename);
+	TEST_ASSERT_TRUE_MESSAGE(fd >= 0, "Temporary file could not be created.");
+	close(fd);
+	TEST_ASSERT_TRUE_MESSAGE(growth_factor_table_save(&computed, filename), "Growth factor table could not be saved.");
+
+	// The mapped table has the same grid and gives the same factors
+	struct growth_factor_table loaded;
+	TEST_ASSERT_TRUE_MESSAGE(growth_factor_table_load(&loaded, filename), "Growth factor table could not be loaded.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(-500, loaded.min_basis_points, "Wrong lowest rate.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(700, loaded.max_basis_points, "Wrong highest rate.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(120, loaded.year_count, "Wrong number of horizons.");
+	TEST_ASSERT_EQUAL_MEMORY_MESSAGE(computed.factors, loaded.factors, computed.rate_count * computed.year_count * sizeof(double), "Loaded factors differ.");
+	for (int i = 0; i < 1000; i++)
+	{
+		double growth_rate = (rand() % 140000 - 60000) / 1e6; // NOLINT(*-msc50-cpp)
+		int years = rand() % 130; // NOLINT(*-msc50-cpp)
+		TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(growth_factor_table_factor(&computed, growth_rate, years), growth_factor_table_factor(&loaded, growth_rate, years), "Loaded table gives a different factor.");
+	}
+	growth_factor_table_free(&loaded);
+
+	// A truncated file is rejected
+	TEST_ASSERT_EQUAL_INT_MESSAGE(0, truncate(filename, (off_t)(sizeof(struct growth_factor_file_header) + 1000 * sizeof(double))), "Temporary file could not be truncated.");
+	TEST_ASSERT_FALSE_MESSAGE(growth_factor_table_load(&loaded, filename), "Truncated file was accepted.");
+
+	// A file of another kind is rejected
+	FILE* file = fopen(filename, "w");
+	TEST_ASSERT_NOT_NULL_MESSAGE(file, "Temporary file could not be opened.");
+	fprintf(file, "%0100d\n", 0);
+	fclose(file);
+	TEST_ASSERT_FALSE_MESSAGE(growth_factor_table_load(&loaded, filename), "File without a header was accepted.");
+
+	// Free memory
+	unlink(filename);
+	growth_factor_table_free(&computed);
+}
+
+void test_3m_fixed_point_projection(void)
+{
+	// Known projections give the same bits on every build
+	const int projections[][4] = {{30000, 45000, 2024, 2050}, {25994, 1000, 2024, 2060}, {10000, 61000, 2024, 2025}, {40000, 12345, 2024, 1990}};
+	const uint64_t expected_factors[] = {4362471492u, 3923357022u, 26199300506u, 4446073045u};
+	const int expected_estimates[][3] = {{98141, 20634}, {27, 228098}, {INT_MAX, 0}, {553773, 17444}};
+	for (size_t i = 0; i < sizeof(projections) / sizeof(projections[0]); i++)
+	{
+		uint64_t growth_factor;
+		TEST_ASSERT_TRUE_MESSAGE(calculate_fixed_growth_factor(projections[i][0], projections[i][1], projections[i][2], projections[i][3], &growth_factor), "Growth factor could not be calculated.");
+		TEST_ASSERT_EQUAL_UINT64_MESSAGE(expected_factors[i], growth_factor, "Growth factor differs from the reference bits.");
+		TEST_ASSERT_EQUAL_INT_MESSAGE(projections[i][1], calculate_fixed_enrollment_estimate(projections[i][0], growth_factor, projections[i][2], projections[i][3]), "Target year does not reach the target enrollment.");
+		TEST_ASSERT_EQUAL_INT_MESSAGE(expected_estimates[i][0], calculate_fixed_enrollment_estimate(projections[i][0], growth_factor, 2024, 2100), "Later estimate differs from the reference.");
+		TEST_ASSERT_EQUAL_INT_MESSAGE(expected_estimates[i][1], calculate_fixed_enrollment_estimate(projections[i][0], growth_factor, 2024, 2000), "Earlier estimate differs from the reference.");
+	}
+
+	// Invalid parameters are rejected
+	uint64_t growth_factor;
+	TEST_ASSERT_FALSE_MESSAGE(calculate_fixed_growth_factor(0, 1000, 2024, 2030, &growth_factor), "Zero initial enrollment was accepted.");
+	TEST_ASSERT_FALSE_MESSAGE(calculate_fixed_growth_factor(1000, -1, 2024, 2030, &growth_factor), "Negative target enrollment was accepted.");
+	TEST_ASSERT_FALSE_MESSAGE(calculate_fixed_growth_factor(1000, 2000, 2024, 2024, &growth_factor), "Equal years were accepted.");
+	TEST_ASSERT_FALSE_MESSAGE(calculate_fixed_growth_factor(1000, 0, 2024, 2020, &growth_factor), "Zero target before the initial year was accepted.");
+	TEST_ASSERT_TRUE_MESSAGE(calculate_fixed_growth_factor(1000, 1000, 2024, 2030, &growth_factor), "Unchanged enrollment was rejected.");
+	TEST_ASSERT_EQUAL_UINT64_MESSAGE(FIXED_POINT_ONE, growth_factor, "Unchanged enrollment does not give a factor of 1.");
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(0.0, fixed_growth_factor_to_rate(growth_factor), "Factor of 1 does not give a rate of 0.");
+
+	// A target of 0 gives a factor of 0, so every estimate after the initial year is 0 on both paths
+	TEST_ASSERT_TRUE_MESSAGE(calculate_fixed_growth_factor(25994, 0, 2024, 2040, &growth_factor), "Zero target after the initial year was rejected.");
+	TEST_ASSERT_EQUAL_UINT64_MESSAGE(0, growth_factor, "Zero target does not give a factor of 0.");
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(-1.0, fixed_growth_factor_to_rate(growth_factor), "Factor of 0 does not give a rate of -1.");
+	double zero_target_rate = calculate_growth_rate(25994, 0, 2024, 2040);
+	for (int year = 2024; year <= 2040; year++)
+	{
+		TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_enrollment_estimate(25994, zero_target_rate, 2024, year), calculate_fixed_enrollment_estimate(25994, growth_factor, 2024, year), "Estimate for a zero target differs from the double-precision path.");
+	}
+
+	// The bulk estimates take the same steps as single estimates, including negative enrollments
+	int estimates[61];
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(0, calculate_fixed_enrollment_estimates(1000, FIXED_POINT_ONE, 2024, 2023, estimates), "Empty range produced estimates.");
+	for (int i = 0; i < 200; i++)
+	{
+		int initial_enrollment = rand() % 100000 - 1000; // NOLINT(*-msc50-cpp)
+		TEST_ASSERT_TRUE_MESSAGE(calculate_fixed_growth_factor(rand() % 30000 + 10000, rand() % 60000 + 1000, 2024, 2025 + rand() % 50, &growth_factor), "Growth factor could not be calculated."); // NOLINT(*-msc50-cpp)
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(61, calculate_fixed_enrollment_estimates(initial_enrollment, growth_factor, 2024, 2084, estimates), "Wrong number of estimates.");
+		for (int year = 2024; year <= 2084; year++)
+		{
+			TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_fixed_enrollment_estimate(initial_enrollment, growth_factor, 2024, year), estimates[year - 2024], "Bulk estimate differs from single estimate.");
+		}
+	}
+}
+
+void test_3m_fixed_point_divergence(void)
+{
+	// Enrollments and years from the tests above differ from the double-precision path by rounding at most
+	struct fixed_point_divergence divergence;
+	TEST_ASSERT_TRUE_MESSAGE(measure_fixed_point_divergence(10000, 40000, 1000, 61000, 2500, 50, &divergence), "Divergence could not be measured.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE((size_t)13 * 25 * 100, divergence.projections, "Wrong number of projections compared.");
+	TEST_ASSERT_TRUE_MESSAGE(divergence.max_rate_difference < 1e-8, "Growth rates differ by more than the fixed-point precision.");
+	TEST_ASSERT_TRUE_MESSAGE(divergence.max_estimate_difference <= 1, "Estimates differ by more than rounding.");
+	TEST_ASSERT_TRUE_MESSAGE(divergence.differing_estimates * 1000 < divergence.estimates, "More than 0.1% of estimates differ.");
+
+	// A target of 0 is projected forward only, and matches exactly
+	TEST_ASSERT_TRUE_MESSAGE(measure_fixed_point_divergence(10000, 40000, 0, 0, 2500, 50, &divergence), "Divergence for a zero target could not be measured.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE((size_t)13 * 50, divergence.projections, "Wrong number of zero target projections compared.");
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(0.0, divergence.max_rate_difference, "Zero target growth rates differ.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(0, divergence.max_estimate_difference, "Zero target estimates differ.");
+
+	// Invalid grids are rejected
+	TEST_ASSERT_FALSE_MESSAGE(measure_fixed_point_divergence(10000, 40000, 1000, 61000, 0, 50, &divergence), "Zero step was accepted.");
+	TEST_ASSERT_FALSE_MESSAGE(measure_fixed_point_divergence(10000, 40000, -1, 61000, 2500, 50, &divergence), "Negative target was accepted.");
+}
+
+/**
+ * @brief Fit a growth rate with scalar log and the textbook two-pass regression
+ * @param enrollments Enrollment for each year, 0 or below for missing years
+ * @param year_count Number of years
+ * @return Least-squares growth rate, or NaN if fewer than two years are present
+ */
+static double refit_growth_rate(const int* enrollments, int year_count)
+{
+	// Find the means of the present years
+	double count = 0.0;
+	double mean_t = 0.0;
+	double mean_y = 0.0;
+	for (int t = 0; t < year_count; t++)
+	{
+		if (enrollments[t] > 0)
+		{
+			count++;
+			mean_t += t;
+			mean_y += log(enrollments[t]);
+		}
+	}
+	if (count < 2.0)
+	{
+		return NAN;
+	}
+	mean_t /= count;
+	mean_y /= count;
+
+	// Regress around the means
+	double covariance = 0.0;
+	double variance = 0.0;
+	for (int t = 0; t < year_count; t++)
+	{
+		if (enrollments[t] > 0)
+		{
+			covariance += (t - mean_t) * (log(enrollments[t]) - mean_y);
+			variance += (t - mean_t) * (t - mean_t);
+		}
+	}
+
+	return expm1(covariance / variance);
+}
+
+void test_3n_fit_growth_rate(void)
+{
+	// A series that grows at a constant rate is fitted back to that rate, at any length
+	int enrollments[97];
+	for (int year_count = 2; year_count <= 97; year_count++)
+	{
+		double growth_rate = (rand() % 20001 - 10000) / 100000.0; // NOLINT(*-msc50-cpp)
+		int initial_enrollment = rand() % 30000 + 10000; // NOLINT(*-msc50-cpp)
+		double peak = growth_rate > 0 ? pow(1 + growth_rate, year_count - 1) : 1.0;
+		for (int t = 0; t < year_count; t++)
+		{
+			enrollments[t] = (int)round(initial_enrollment * 50000.0 * pow(1 + growth_rate, t) / peak);
+		}
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(2e-4, growth_rate, fit_growth_rate(enrollments, 2024, 2024 + year_count - 1), "Constant growth was not recovered.");
+	}
+
+	// Noisy series with missing years match the two-pass reference
+	for (int i = 0; i < 500; i++)
+	{
+		int year_count = rand() % 60 + 1; // NOLINT(*-msc50-cpp)
+		for (int t = 0; t < year_count; t++)
+		{
+			enrollments[t] = rand() % 8 == 0 ? -(rand() % 2) : rand() % 60000 + 1000; // NOLINT(*-msc50-cpp)
+		}
+		double expected = refit_growth_rate(enrollments, year_count);
+		double actual = fit_growth_rate(enrollments, 2000, 2000 + year_count - 1);
+		if (isnan(expected))
+		{
+			TEST_ASSERT_TRUE_MESSAGE(isnan(actual), "Series with fewer than two years was fitted.");
+			continue;
+		}
+		TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(1e-12 + fabs(expected) * 1e-10, expected, actual, "Fit differs from the reference regression.");
+	}
+
+	// Empty ranges and single years have no rate
+	enrollments[0] = 1000;
+	enrollments[1] = 0;
+	TEST_ASSERT_TRUE_MESSAGE(isnan(fit_growth_rate(enrollments, 2024, 2023)), "Empty range was fitted.");
+	TEST_ASSERT_TRUE_MESSAGE(isnan(fit_growth_rate(enrollments, 2024, 2025)), "Single present year was fitted.");
+}
+
+void test_3n_fit_growth_rates(void)
+{
+	// Histories for more campuses than fit in one tile, with a row length that is not a multiple of the vector width
+	const size_t campus_count = BACKFIT_TILE_CAMPUSES * 5 + 3;
+	const int year_count = 27;
+	int* enrollments = malloc(campus_count * year_count * sizeof(int));
+	double* serial = malloc(campus_count * sizeof(double));
+	double* parallel = malloc(campus_count * sizeof(double));
+	TEST_ASSERT_TRUE_MESSAGE(enrollments != NULL && serial != NULL && parallel != NULL, "Memory could not be allocated.");
+	for (size_t i = 0; i < campus_count * year_count; i++)
+	{
+		enrollments[i] = rand() % 16 == 0 ? 0 : rand() % 30000 + 10000; // NOLINT(*-msc50-cpp)
+	}
+
+	// Every campus matches the single-campus fit, with and without a pool
+	struct worker_pool pool;
+	TEST_ASSERT_TRUE_MESSAGE(worker_pool_init(&pool, 3), "Worker pool could not be initialized.");
+	fit_growth_rates(NULL, enrollments, campus_count, 1998, 1998 + year_count - 1, serial);
+	fit_growth_rates(&pool, enrollments, campus_count, 1998, 1998 + year_count - 1, parallel);
+	for (size_t i = 0; i < campus_count; i++)
+	{
+		double expected = fit_growth_rate(enrollments + i * year_count, 1998, 1998 + year_count - 1);
+		TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(expected, serial[i], "Campus fit differs from fit_growth_rate.");
+		TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(expected, parallel[i], "Parallel fit differs from fit_growth_rate.");
+	}
+
+	// Free memory
+	worker_pool_free(&pool);
+	free(enrollments);
+	free(serial);
+	free(parallel);
+}
+
+void test_3o_calculate_enrollment_sensitivities(void)
+{
+	// Estimates match calculate_enrollment_estimate and sensitivities match the derivative computed with pow
+	int estimates[130];
+	double sensitivities[130];
+	for (int i = 0; i < 2000; i++)
+	{
+		int initial_enrollment = rand() % 100000 - 1000; // NOLINT(*-msc50-cpp)
+		double growth_rate = ((double)rand() / RAND_MAX - 0.5) * 0.2; // NOLINT(*-msc50-cpp)
+		int initial_year = rand() % 100 + 1950; // NOLINT(*-msc50-cpp)
+		int end_year = initial_year + rand() % 130 - 1; // NOLINT(*-msc50-cpp)
+		size_t count = calculate_enrollment_sensitivities(initial_enrollment, growth_rate, initial_year, end_year, estimates, sensitivities);
+		TEST_ASSERT_EQUAL_size_t_MESSAGE(end_year < initial_year ? 0 : (size_t)(end_year - initial_year + 1), count, "Wrong number of years.");
+		for (size_t k = 0; k < count; k++)
+		{
+			double expected = k == 0 ? 0.0 : (double)k * initial_enrollment * pow(1 + growth_rate, (int)k - 1);
+			TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, initial_year + (int)k), estimates[k], "Estimate differs from calculate_enrollment_estimate.");
+			TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(fabs(expected) * 1e-12, expected, sensitivities[k], "Sensitivity differs from the derivative.");
+		}
+	}
+
+	// Estimates on exact halves round away from zero like round does
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(8, calculate_enrollment_sensitivities(5, 0.5, 2024, 2031, estimates, sensitivities), "Wrong number of years.");
+	for (int k = 0; k < 8; k++)
+	{
+		TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_enrollment_estimate(5, 0.5, 2024, 2024 + k), estimates[k], "Half was rounded differently.");
+	}
+
+	// A rate of -100% leaves only the first year's sensitivity
+	calculate_enrollment_sensitivities(1000, -1.0, 2024, 2031, estimates, sensitivities);
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(1000.0, sensitivities[1], "Wrong sensitivity of the first year at -100%.");
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(0.0, sensitivities[5], "Wrong sensitivity of a later year at -100%.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(0, estimates[5], "Wrong estimate at -100%.");
+
+	// The sensitivity matches a central difference of one basis point on each side
+	calculate_enrollment_sensitivities(25994, 0.0231, 2024, 2074, estimates, sensitivities);
+	double difference = (25994 * pow(1.0232, 50) - 25994 * pow(1.0230, 50)) / 2;
+	TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(0.01, difference, sensitivities[50] * 1e-4, "Sensitivity does not predict the change per basis point.");
+}
+
+void test_3o_sensitivity_grid(void)
+{
+	// A grid whose rate count is not a multiple of the vector width or the cache line
+	struct sensitivity_grid grid;
+	TEST_ASSERT_TRUE_MESSAGE(sensitivity_grid_init(&grid, -0.05, 0.0005, 203, 2024, 2123), "Sensitivity grid could not be initialized.");
+	TEST_ASSERT_EQUAL_size_t_MESSAGE(100, grid.year_count, "Wrong number of years.");
+	TEST_ASSERT_TRUE_MESSAGE(grid.stride >= 203 && grid.stride % 8 == 0, "Rows are not padded to a cache line.");
+	calculate_sensitivity_grid(&grid, 31234);
+
+	// Every entry matches the estimate and derivative computed with pow
+	for (size_t row = 0; row < grid.year_count; row++)
+	{
+		for (size_t column = 0; column < grid.rate_count; column++)
+		{
+			double growth_rate = -0.05 + (double)column * 0.0005;
+			double estimate = 31234 * pow(1 + growth_rate, (int)row);
+			double sensitivity = row == 0 ? 0.0 : (double)row * 31234 * pow(1 + growth_rate, (int)row - 1);
+			TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(growth_rate, grid.growth_rates[column], "Wrong rate for the column.");
+			TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(estimate * 1e-12, estimate, grid.estimates[row * grid.stride + column], "Grid estimate differs from pow.");
+			TEST_ASSERT_DOUBLE_WITHIN_MESSAGE(sensitivity * 1e-12, sensitivity, grid.sensitivities[row * grid.stride + column], "Grid sensitivity differs from the derivative.");
+		}
+	}
+	sensitivity_grid_free(&grid);
+
+	// An empty year range is rejected
+	TEST_ASSERT_FALSE_MESSAGE(sensitivity_grid_init(&grid, 0.0, 0.01, 10, 2024, 2023), "Empty year range was accepted.");
+}
+
+/**
+ * @brief Fork server function that kills its own process
+ * @param arguments Unused
+ * @param result Unused
+ * @return Does not return
+ */
+static int helper_fork_server_killed(const void* arguments, void* result)
+{
+	(void)arguments;
+	(void)result;
+	raise(SIGKILL);
+	return 0;
+}
+
+/**
+ * @brief Fork server function that never returns
+ * @param arguments Unused
+ * @param result Unused
+ * @return Does not return
+ */
+__attribute__((noreturn)) static int helper_fork_server_hangs(const void* arguments, void* result)
+{
+	(void)arguments;
+	(void)result;
+	while (true)
+	{
+		pause();
+	}
+}
+
+void test_3p_fork_server_call(void)
+{
+	// The fork server is running in the process that started it, but not in its children
+	TEST_ASSERT_TRUE_MESSAGE(start_fork_server(), "Fork server could not be started.");
+	TEST_ASSERT_TRUE_MESSAGE(is_fork_server_running(), "Fork server is not running.");
+
+	// A call returns the same value as a direct call
+	struct fork_server_arguments_calculate_growth_rate arguments = { 30000, 36000, 2024, 2034 };
+	double growth_rate = -1.0;
+	int status = call_in_fork_server(fork_server_call_calculate_growth_rate, FORK_SERVER_CHECK_NONE, &arguments, sizeof(arguments), &growth_rate, sizeof(growth_rate), TIMEOUT_MILLISECONDS);
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status), "Fork server child did not exit.");
+	if (WEXITSTATUS(status) == EXIT_NOT_IMPLEMENTED)
+	{
+		TEST_IGNORE_MESSAGE("calculate_growth_rate is not implemented.");
+	}
+	TEST_ASSERT_EQUAL_INT_MESSAGE(0, WEXITSTATUS(status), "Fork server child failed.");
+	TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(calculate_growth_rate(30000, 36000, 2024, 2034), growth_rate, "Fork server returned a different growth rate.");
+
+	// A returned string is copied from the child's memory
+	struct fork_server_arguments_get_growth_rate_description description_arguments = { 0.01 };
+	const char* description = NULL;
+	status = call_in_fork_server(fork_server_call_get_growth_rate_description, FORK_SERVER_CHECK_STRING, &description_arguments, sizeof(description_arguments), &description, sizeof(description), TIMEOUT_MILLISECONDS);
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status), "Fork server child did not exit.");
+	if (WEXITSTATUS(status) == 0)
+	{
+		TEST_ASSERT_EQUAL_PTR_MESSAGE(get_growth_rate_description(0.01), description, "Fork server returned a different string.");
+	}
+}
+
+void test_3p_fork_server_failures(void)
+{
+	TEST_ASSERT_TRUE_MESSAGE(start_fork_server(), "Fork server could not be started.");
+
+	// A child killed by a signal is reported with the signal
+	int status = call_in_fork_server(helper_fork_server_killed, FORK_SERVER_CHECK_NONE, NULL, 0, NULL, 0, TIMEOUT_MILLISECONDS);
+	TEST_ASSERT_TRUE_MESSAGE(WIFSIGNALED(status), "Killed child was not reported as signaled.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(SIGKILL, WTERMSIG(status), "Killed child was reported with the wrong signal.");
+
+	// A child that takes too long is killed and reported as timed out
+	status = call_in_fork_server(helper_fork_server_hangs, FORK_SERVER_CHECK_NONE, NULL, 0, NULL, 0, 200);
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_TIMED_OUT, "Hung child was not reported as timed out.");
+
+	// The fork server keeps serving calls
+	TEST_ASSERT_TRUE_MESSAGE(is_fork_server_running(), "Fork server stopped after a failed child.");
+	struct fork_server_arguments_calculate_enrollment_estimate arguments = { 30000, 0.0, 2024, 2030 };
+	int estimate = -1;
+	status = call_in_fork_server(fork_server_call_calculate_enrollment_estimate, FORK_SERVER_CHECK_NONE, &arguments, sizeof(arguments), &estimate, sizeof(estimate), TIMEOUT_MILLISECONDS);
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status), "Fork server child did not exit.");
+	if (WEXITSTATUS(status) == 0)
+	{
+		TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_enrollment_estimate(30000, 0.0, 2024, 2030), estimate, "Fork server returned a different estimate.");
+	}
+}
+
+/**
+ * @brief Gets the time used by this process
+ * @return Processor time in milliseconds
+ */
+static double helper_get_cpu_milliseconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+
+	return (double)now.tv_sec * 1e3 + (double)now.tv_nsec * 1e-6;
+}
+
+/**
+ * @brief Gets the time from a monotonic clock
+ * @return Time in milliseconds
+ */
+static double helper_get_wall_milliseconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec * 1e3 + (double)now.tv_nsec * 1e-6;
+}
+
+void test_3q_wait_for_child_pid(void)
+{
+	// A child that exits after a while is waited for without using the processor
+	pid_t pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		usleep(300000);
+		_exit(7);
+	}
+	double cpu_start = helper_get_cpu_milliseconds();
+	int status = wait_for_child_pid(pid, TIMEOUT_MILLISECONDS);
+	double cpu_used = helper_get_cpu_milliseconds() - cpu_start;
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status), "Child did not exit.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(7, WEXITSTATUS(status), "Wrong exit status.");
+	TEST_ASSERT_TRUE_MESSAGE(cpu_used < 30.0, "Waiting used the processor.");
+
+	// A child killed by a signal is reported with the signal, also without a timeout
+	pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		raise(SIGKILL);
+		_exit(0);
+	}
+	status = wait_for_child_pid(pid, -1);
+	TEST_ASSERT_TRUE_MESSAGE(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL, "Killed child was not reported as signaled.");
+}
+
+void test_3q_wait_for_child_pid_timeout(void)
+{
+	// A hung child is killed at the deadline to the millisecond, not the second
+	pid_t pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		while (true)
+		{
+			pause();
+		}
+	}
+	double start = helper_get_wall_milliseconds();
+	int status = wait_for_child_pid(pid, 250);
+	double elapsed = helper_get_wall_milliseconds() - start;
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_TIMED_OUT, "Hung child was not reported as timed out.");
+	TEST_ASSERT_TRUE_MESSAGE(elapsed >= 249.0, "Child was killed before the deadline.");
+	TEST_ASSERT_TRUE_MESSAGE(elapsed < 750.0, "Child was killed long after the deadline.");
+
+	// The killed child has been reaped
+	TEST_ASSERT_EQUAL_INT_MESSAGE(-1, waitpid(pid, NULL, WNOHANG), "Timed out child was not reaped.");
+}
+
+/**
+ * @brief Test case for the runner tests that passes
+ */
+static void helper_runner_pass(void)
+{
+}
+
+/**
+ * @brief Test case for the runner tests that fails
+ */
+static void helper_runner_fail(void)
+{
+	TEST_FAIL_MESSAGE("Expected failure.");
+}
+
+/**
+ * @brief Test case for the runner tests that is ignored
+ */
+static void helper_runner_ignore(void)
+{
+	TEST_IGNORE_MESSAGE("Expected ignore.");
+}
+
+/**
+ * @brief Test case for the runner tests that kills its worker
+ */
+static void helper_runner_crash(void)
+{
+	raise(SIGKILL);
+}
+
+/**
+ * @brief Runs the runner test cases on workers with stdout in a memory file, checking the output and counts
+ * @return 0 if the output and counts are right, 1 if the counts are wrong, 2 if the output is out of order, or 3 if the output could not be captured
+ */
+static int helper_run_runner_cases(void)
+{
+	// Capture the output
+	int fd = memfd_create("test_hw1_wvuep", 0);
+	if (fd < 0 || dup2(fd, STDOUT_FILENO) < 0)
+	{
+		return 3;
+	}
+
+	// Run steps with every outcome on three workers; the crash leaves the rest of its step unrun
+	const struct test_case cases[] = {
+		TEST_STEP("Runner step one", helper_runner_pass),
+		TEST_CASE(helper_runner_fail),
+		TEST_CASE(helper_runner_crash),
+		TEST_CASE(helper_runner_pass),
+		TEST_STEP("Runner step two", helper_runner_ignore),
+		TEST_CASE(helper_runner_pass),
+		TEST_STEP("Runner step three", helper_runner_pass),
+	};
+	struct test_runner_options options = { 3, 1, 1 };
+	Unity.NumberOfTests = 0;
+	Unity.TestFailures = 0;
+	Unity.TestIgnores = 0;
+	run_test_cases(cases, sizeof(cases) / sizeof(cases[0]), &options);
+	if (Unity.NumberOfTests != 7 || Unity.TestFailures != 3 || Unity.TestIgnores != 1)
+	{
+		return 1;
+	}
+
+	// The output follows the table
+	char output[4096] = { 0 };
+	if (pread(fd, output, sizeof(output) - 1, 0) <= 0)
+	{
+		return 3;
+	}
+	const char* expected[] = { "Runner step one", ":helper_runner_pass:", ":helper_runner_fail:", "Expected failure.", ":helper_runner_crash:", "crashed", ":helper_runner_pass:", "not run", "Runner step two", ":helper_runner_ignore:", ":helper_runner_pass:", "Runner step three", ":helper_runner_pass:" };
+	const char* position = output;
+	for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++)
+	{
+		position = strstr(position, expected[i]);
+		if (position == NULL)
+		{
+			return 2;
+		}
+		position += strlen(expected[i]);
+	}
+
+	return 0;
+}
+
+void test_3r_run_test_cases_parallel(void)
+{
+	// Run the cases in a child, so the nested run does not touch this test's counts
+	pid_t pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		_exit(helper_run_runner_cases());
+	}
+	int status = wait_for_child_pid(pid, TIMEOUT_MILLISECONDS);
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status), "Runner did not finish.");
+	TEST_ASSERT_NOT_EQUAL_INT_MESSAGE(1, WEXITSTATUS(status), "Runner counted the tests wrong.");
+	TEST_ASSERT_NOT_EQUAL_INT_MESSAGE(2, WEXITSTATUS(status), "Runner output is not in table order.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(0, WEXITSTATUS(status), "Runner output could not be captured.");
+}
+
+void test_3r_test_runner_options(void)
+{
+	// Options are read among other arguments
+	char program[] = "hw1";
+	char jobs[] = "--jobs";
+	char job_count[] = "4";
+	char shard[] = "--shard";
+	char shard_value[] = "2/3";
+	char other[] = "--verbose";
+	char* argv[] = { program, other, jobs, job_count, shard, shard_value };
+	struct test_runner_options options;
+	TEST_ASSERT_TRUE_MESSAGE(parse_test_runner_arguments(6, argv, &options), "Valid options were rejected.");
+	TEST_ASSERT_EQUAL_UINT_MESSAGE(4, options.jobs, "Wrong number of jobs.");
+	TEST_ASSERT_EQUAL_UINT_MESSAGE(2, options.shard_index, "Wrong shard.");
+	TEST_ASSERT_EQUAL_UINT_MESSAGE(3, options.shard_count, "Wrong number of shards.");
+	TEST_ASSERT_EQUAL_STRING_MESSAGE("2/3", shard_value, "Argument was modified.");
+
+	// Invalid options are rejected, leaving one job and one shard
+	char invalid_shard[] = "4/3";
+	char* invalid_shard_argv[] = { program, shard, invalid_shard };
+	TEST_ASSERT_FALSE_MESSAGE(parse_test_runner_arguments(3, invalid_shard_argv, &options), "Shard past the count was accepted.");
+	TEST_ASSERT_TRUE_MESSAGE(options.jobs == 1 && options.shard_index == 1 && options.shard_count == 1, "Rejected options were not reset.");
+	char* missing_argv[] = { program, jobs };
+	TEST_ASSERT_FALSE_MESSAGE(parse_test_runner_arguments(2, missing_argv, &options), "Missing job count was accepted.");
+
+	// Every step is in exactly one shard
+	for (size_t step = 0; step < 20; step++)
+	{
+		int shards = 0;
+		for (unsigned int shard_index = 1; shard_index <= 3; shard_index++)
+		{
+			struct test_runner_options shard_options = { 1, shard_index, 3 };
+			shards += is_test_step_in_shard(step, &shard_options);
+		}
+		TEST_ASSERT_EQUAL_INT_MESSAGE(1, shards, "Step is not in exactly one shard.");
+	}
+}
+
+/**
+ * @brief Tracks if the helper_copy_description function has been implemented, for CALL_FUNCTION_*_WITH_RETURN
+ */
+static bool not_implemented_helper_copy_description = false;
+
+/**
+ * @brief Tracks if the helper_copy_description function has crashed, for CALL_FUNCTION_*_WITH_RETURN
+ */
+static bool crashes_helper_copy_description = false;
+
+/**
+ * @brief Copies a growth rate description to dynamically allocated memory, as CALL_FUNCTION_*STRING_WITH_RETURN requires
+ * @param growth_rate Growth rate
+ * @return Copy of the description, or NULL if memory could not be allocated
+ */
+static char* helper_copy_description(double growth_rate)
+{
+	const char* description = get_growth_rate_description(growth_rate);
+	char* copy = malloc(strlen(description) + 1);
+	if (copy != NULL)
+	{
+		strcpy(copy, description);
+	}
+
+	return copy;
+}
+
+void test_3s_call_function_with_return(void)
+{
+	// Use plain forks, which the fork server would otherwise replace
+	stop_fork_server();
+
+	// More calls than the slab has slots return the values of direct calls
+	for (int i = 0; i < 200; i++)
+	{
+		CALL_FUNCTION_INT_WITH_RETURN(calculate_enrollment_estimate, 30000 + i, 0.001 * (i % 50), 2024, 2024 + i % 40);
+		TEST_ASSERT_EQUAL_INT_MESSAGE(calculate_enrollment_estimate(30000 + i, 0.001 * (i % 50), 2024, 2024 + i % 40), return_value_calculate_enrollment_estimate, "Wrong value returned through shared memory.");
+	}
+	CALL_FUNCTION_POINTER_WITH_RETURN(get_programmer_name);
+	TEST_ASSERT_EQUAL_PTR_MESSAGE(get_programmer_name(), return_value_get_programmer_name, "Wrong pointer returned through shared memory.");
+	CALL_FUNCTION_WRITEABLE_STRING_WITH_RETURN(helper_copy_description, 512, 0.01);
+	TEST_ASSERT_EQUAL_STRING_MESSAGE(get_growth_rate_description(0.01), return_value_helper_copy_description, "Wrong string returned through shared memory.");
+	free(return_value_helper_copy_description);
+	start_fork_server();
+}
+
+void test_3s_get_result_slot(void)
+{
+	// Consecutive slots do not overlap
+	unsigned char* first = get_result_slot(sizeof(double));
+	unsigned char* second = get_result_slot(sizeof(double));
+	TEST_ASSERT_NOT_NULL_MESSAGE(first, "Slot could not be mapped.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(second, "Slot could not be mapped.");
+	TEST_ASSERT_TRUE_MESSAGE(second >= first + sizeof(double) || first >= second + sizeof(double), "Consecutive slots overlap.");
+
+	// A large slot is zeroed and shared with a child
+	size_t size = 100000;
+	unsigned char* large = get_result_slot(size);
+	TEST_ASSERT_NOT_NULL_MESSAGE(large, "Large slot could not be mapped.");
+	TEST_ASSERT_EACH_EQUAL_UINT8_MESSAGE(0, large, size, "Large slot was not zeroed.");
+	pid_t pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		memset(large, 0x5A, size);
+		_exit(0);
+	}
+	int status = wait_for_child_pid(pid, TIMEOUT_MILLISECONDS);
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status) && WEXITSTATUS(status) == 0, "Child did not finish.");
+	TEST_ASSERT_EACH_EQUAL_UINT8_MESSAGE(0x5A, large, size, "Child's write is not visible through the slot.");
+
+	// A smaller request reuses the large slot, zeroed again
+	unsigned char* reused = get_result_slot(size / 2 + RESULT_SLOT_SIZE);
+	TEST_ASSERT_EQUAL_PTR_MESSAGE(large, reused, "Large slot was not reused.");
+	TEST_ASSERT_EACH_EQUAL_UINT8_MESSAGE(0, reused, size / 2 + RESULT_SLOT_SIZE, "Reused slot was not zeroed.");
+
+	// A larger request replaces the large slot and unmaps the old one
+	unsigned char* grown = get_result_slot(size * 4);
+	TEST_ASSERT_NOT_NULL_MESSAGE(grown, "Grown slot could not be mapped.");
+	TEST_ASSERT_EACH_EQUAL_UINT8_MESSAGE(0, grown, size * 4, "Grown slot was not zeroed.");
+	TEST_ASSERT_TRUE_MESSAGE(msync(large, size, MS_ASYNC) == -1 && errno == ENOMEM, "Old large slot was not unmapped.");
+}
+
+void test_3t_start_output_capture(void)
+{
+	// Nested captures each get only what was written while they were innermost
+	struct stat stdout_before;
+	fstat(STDOUT_FILENO, &stdout_before);
+	struct output_capture outer;
+	struct output_capture inner;
+	TEST_ASSERT_TRUE_MESSAGE(start_output_capture(&outer), "Outer capture could not be started.");
+	printf("outer ");
+	fprintf(stderr, "error ");
+	bool inner_started = start_output_capture(&inner);
+	printf("inner");
+	size_t inner_length = 0;
+	char* inner_output = inner_started ? finish_output_capture(&inner, &inner_length) : NULL;
+	printf("again");
+	size_t outer_length = 0;
+	char* outer_output = finish_output_capture(&outer, &outer_length);
+
+	// Output is back on the original stdout
+	struct stat stdout_after;
+	fstat(STDOUT_FILENO, &stdout_after);
+	TEST_ASSERT_TRUE_MESSAGE(stdout_before.st_dev == stdout_after.st_dev && stdout_before.st_ino == stdout_after.st_ino, "stdout was not restored.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(inner_output, "Inner capture was not read.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(outer_output, "Outer capture was not read.");
+	TEST_ASSERT_EQUAL_STRING("inner", inner_output);
+	TEST_ASSERT_EQUAL_size_t(5, inner_length);
+	TEST_ASSERT_EQUAL_STRING("outer error again", outer_output);
+	TEST_ASSERT_EQUAL_size_t(17, outer_length);
+	free(inner_output);
+	free(outer_output);
+}
+
+void test_3t_open_output_capture(void)
+{
+	// Children write to captures of their own at the same time, more than a pipe holds
+	size_t size = 200000;
+	struct output_capture captures[2];
+	pid_t pids[2];
+	for (int i = 0; i < 2; i++)
+	{
+		TEST_ASSERT_TRUE_MESSAGE(open_output_capture(&captures[i]), "Capture could not be opened.");
+		pids[i] = fork();
+		TEST_ASSERT_TRUE_MESSAGE(pids[i] >= 0, "Could not fork child process.");
+		if (pids[i] == 0)
+		{
+			dup2(captures[i].fd, STDOUT_FILENO);
+			for (size_t j = 0; j < size; j++)
+			{
+				putchar('a' + i);
+			}
+			fflush(stdout);
+			_exit(0);
+		}
+	}
+
+	// Each capture holds exactly its own child's output
+	for (int i = 0; i < 2; i++)
+	{
+		int status = wait_for_child_pid(pids[i], TIMEOUT_MILLISECONDS);
+		size_t length = 0;
+		char* output = finish_output_capture(&captures[i], &length);
+		TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status) && WEXITSTATUS(status) == 0, "Child did not finish.");
+		TEST_ASSERT_NOT_NULL_MESSAGE(output, "Capture was not read.");
+		TEST_ASSERT_EQUAL_size_t(size, length);
+		TEST_ASSERT_EACH_EQUAL_CHAR('a' + i, output, size);
+		TEST_ASSERT_EQUAL_CHAR('\0', output[size]);
+		free(output);
+	}
+}
+
+void test_3u_wait_for_child_pid_reading_input(void)
+{
+	// A child that reads the whole script and exits is reported with its own status
+	struct scripted_input input;
+	TEST_ASSERT_TRUE_MESSAGE(open_scripted_input(&input, "12\n34\n"), "Input could not be opened.");
+	pid_t pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		dup2(input.read_fd, STDIN_FILENO);
+		int first = 0;
+		int second = 0;
+		_exit(scanf("%d %d", &first, &second) == 2 && first == 12 && second == 34 ? 0 : 1);
+	}
+	int status = wait_for_child_pid_reading_input(pid, &input, 10000);
+	close_scripted_input(&input);
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status), "Child did not exit.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(0, WEXITSTATUS(status), "Child did not read the script.");
+
+	// A child reading past the script is killed as soon as it blocks, long before the deadline
+	TEST_ASSERT_TRUE_MESSAGE(open_scripted_input(&input, "12\n"), "Input could not be opened.");
+	pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		dup2(input.read_fd, STDIN_FILENO);
+		int first = 0;
+		int second = 0;
+		_exit(scanf("%d %d", &first, &second));
+	}
+	double start = helper_get_wall_milliseconds();
+	status = wait_for_child_pid_reading_input(pid, &input, 10000);
+	double elapsed = helper_get_wall_milliseconds() - start;
+	close_scripted_input(&input);
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_WAITING_FOR_INPUT, "Blocked child was not reported as waiting for input.");
+	TEST_ASSERT_TRUE_MESSAGE(elapsed < 1000.0, "Blocked child was not killed early.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(-1, waitpid(pid, NULL, WNOHANG), "Blocked child was not reaped.");
+}
+
+void test_3u_wait_for_child_pid_reading_input_timeout(void)
+{
+	// A child sleeping with input left is not mistaken for one waiting for input
+	struct scripted_input input;
+	TEST_ASSERT_TRUE_MESSAGE(open_scripted_input(&input, "56\n"), "Input could not be opened.");
+	pid_t pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		dup2(input.read_fd, STDIN_FILENO);
+		usleep(100000);
+		int number = 0;
+		_exit(scanf("%d", &number) == 1 && number == 56 ? 0 : 1);
+	}
+	int status = wait_for_child_pid_reading_input(pid, &input, 10000);
+	close_scripted_input(&input);
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status), "Child did not exit.");
+	TEST_ASSERT_EQUAL_INT_MESSAGE(0, WEXITSTATUS(status), "Child was killed before reading its input.");
+
+	// A child that hangs without reading is killed at the deadline
+	TEST_ASSERT_TRUE_MESSAGE(open_scripted_input(&input, ""), "Input could not be opened.");
+	pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		while (true)
+		{
+			pause();
+		}
+	}
+	double start = helper_get_wall_milliseconds();
+	status = wait_for_child_pid_reading_input(pid, &input, 250);
+	double elapsed = helper_get_wall_milliseconds() - start;
+	close_scripted_input(&input);
+	TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_TIMED_OUT, "Hung child was not reported as timed out.");
+	TEST_ASSERT_TRUE_MESSAGE(elapsed >= 249.0, "Child was killed before the deadline.");
+	TEST_ASSERT_TRUE_MESSAGE(elapsed < 750.0, "Child was killed long after the deadline.");
+}
+
+void test_3v_allocation_statistics(void)
+{
+	// Open an unbuffered stream for the report now, so it allocates nothing while blocks are counted
+	char report[1024] = { 0 };
+	FILE* stream = fmemopen(report, sizeof(report) - 1, "w");
+	TEST_ASSERT_NOT_NULL_MESSAGE(stream, "Report stream could not be opened.");
+	setvbuf(stream, NULL, _IONBF, 0);
+
+	// Allocate through each function, resizing one block and freeing another
+	begin_allocation_tracking();
+	char* resized = malloc(100);
+	char* zeroed = calloc(10, 10);
+	resized = realloc(resized, 300);
+	TEST_ASSERT_NOT_NULL(zeroed);
+	TEST_ASSERT_EACH_EQUAL_UINT8(0, zeroed, 100);
+	free(zeroed);
+	void* aligned = NULL;
+	int aligned_result = posix_memalign(&aligned, 64, 128);
+	struct allocation_statistics statistics;
+	get_allocation_statistics(&statistics);
+	size_t leaks = report_allocation_leaks(stream);
+	fclose(stream);
+
+	// Check the counts and that both live blocks are reported with their callers
+	TEST_ASSERT_NOT_NULL(resized);
+	TEST_ASSERT_EQUAL_INT(0, aligned_result);
+	TEST_ASSERT_EQUAL_size_t(4, statistics.allocations);
+	TEST_ASSERT_EQUAL_size_t(2, statistics.frees);
+	TEST_ASSERT_EQUAL_size_t(2, statistics.leaked_allocations);
+	TEST_ASSERT_EQUAL_size_t(428, statistics.leaked_bytes);
+	TEST_ASSERT_EQUAL_size_t(0, statistics.untracked_allocations);
+	TEST_ASSERT_TRUE_MESSAGE(statistics.peak_bytes >= statistics.live_bytes, "Peak is below the live bytes.");
+	TEST_ASSERT_EQUAL_size_t(2, leaks);
+	TEST_ASSERT_NOT_NULL_MESSAGE(strstr(report, "Leaked 300 bytes"), "Resized block was not reported.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(strstr(report, "Leaked 128 bytes"), "Aligned block was not reported.");
+	TEST_ASSERT_NOT_NULL_MESSAGE(strstr(report, "allocated from"), "Caller was not reported.");
+
+	// Freeing the blocks leaves nothing leaked
+	free(resized);
+	free(aligned);
+	get_allocation_statistics(&statistics);
+	TEST_ASSERT_EQUAL_size_t(0, statistics.leaked_allocations);
+	TEST_ASSERT_EQUAL_size_t(0, statistics.leaked_bytes);
+}
+
+void test_3v_malloc_poisoning(void)
+{
+	// Prefix poisoning sets only the first bytes
+	set_malloc_poisoning(MALLOC_POISON_PREFIX, 8);
+	unsigned char* prefixed = malloc(64);
+	TEST_ASSERT_NOT_NULL(prefixed);
+	TEST_ASSERT_EACH_EQUAL_HEX8(0xFF, prefixed, 8);
+	free(prefixed);
+
+	// Full poisoning sets every byte
+	set_malloc_poisoning(MALLOC_POISON_FULL, 0);
+	unsigned char* full = malloc(4096);
+	TEST_ASSERT_NOT_NULL(full);
+	TEST_ASSERT_EACH_EQUAL_HEX8(0xFF, full, 4096);
+	free(full);
+
+	// A guarded block is poisoned, keeps its contents when resized and ends at an inaccessible page
+	set_malloc_poisoning(MALLOC_POISON_GUARD_PAGE, 0);
+	unsigned char* guarded = malloc(100);
+	TEST_ASSERT_NOT_NULL(guarded);
+	TEST_ASSERT_EACH_EQUAL_HEX8(0xFF, guarded, 100);
+	TEST_ASSERT_EQUAL_size_t(100, ctest_get_malloc_size(guarded));
+	memset(guarded, 0x5A, 100);
+	guarded = realloc(guarded, 5000);
+	TEST_ASSERT_NOT_NULL(guarded);
+	TEST_ASSERT_EACH_EQUAL_HEX8(0x5A, guarded, 100);
+	TEST_ASSERT_EACH_EQUAL_HEX8(0xFF, guarded + 100, 4900);
+
+	// reallocarray resizes a guarded block in the same way, and valloc returns poisoned page-aligned memory
+	guarded = reallocarray(guarded, 50, 100);
+	TEST_ASSERT_NOT_NULL(guarded);
+	TEST_ASSERT_EQUAL_size_t(5000, ctest_get_malloc_size(guarded));
+	TEST_ASSERT_EACH_EQUAL_HEX8(0x5A, guarded, 100);
+	TEST_ASSERT_EACH_EQUAL_HEX8(0xFF, guarded + 100, 4900);
+	unsigned char* paged = valloc(100);
+	TEST_ASSERT_NOT_NULL(paged);
+	TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t) paged % (uintptr_t) sysconf(_SC_PAGESIZE));
+	TEST_ASSERT_EACH_EQUAL_HEX8(0xFF, paged, 100);
+	free(paged);
+	pid_t pid = fork();
+	TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "Could not fork child process.");
+	if (pid == 0)
+	{
+		volatile size_t overrun = 5000 + 16;
+		signal(SIGSEGV, SIG_DFL);
+		guarded[overrun] = 0;
+		_exit(0);
+	}
+	int status = wait_for_child_pid(pid, TIMEOUT_MILLISECONDS);
+	free(guarded);
+	TEST_ASSERT_TRUE_MESSAGE(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV, "Overrun of a guarded block did not crash.");
+}
+
+// ReSharper disable once CppDFAConstantFunctionResult
+const char* helper_get_programmer_name(void)
+{
+	// Check if function works in forked process
+	CALL_FUNCTION_STRING(get_programmer_name);
+
+	// Return programmer name
+	return get_programmer_name();
+
+}
+
+int helper_prompt_target_enrollment(int target_year)
+{
+	// Do not call function in a forked process because of corruption of input stream
+
+	// Assume that we don't crash
+	crashes_prompt_target_enrollment = false;
+
+	// Prompt for target enrollment
+	return prompt_target_enrollment(target_year);
+}
+
+double helper_calculate_growth_rate(int initial_enrollment, int target_enrollment, int initial_year, int target_year)
+{
+	// Check if function works in forked process
+	CALL_FUNCTION_DOUBLE(calculate_growth_rate, initial_enrollment, target_enrollment, initial_year, target_year);
+
+	// Return growth rate
+	return calculate_growth_rate(initial_enrollment, target_enrollment, initial_year, target_year);
+}
+
+const char* helper_get_growth_rate_description(double growth_rate)
+{
+	// Check if function works in forked process
+	CALL_FUNCTION_STRING(get_growth_rate_description, growth_rate);
+
+	// Return growth rate description
+	return get_growth_rate_description(growth_rate);
+}
+
+void helper_print_growth_rate(double growth_rate)
+{
+	// Check if function works in forked process
+	CALL_FUNCTION_VOID(print_growth_rate, growth_rate);
+
+	// Print growth rate
+	print_growth_rate(growth_rate);
+}
+
+// ReSharper disable once CppDFAConstantFunctionResult
+int helper_calculate_enrollment_estimate(int initial_enrollment, double growth_rate, int initial_year, int estimate_year)
+{
+	// Check if function works in forked process
+	CALL_FUNCTION_INT(calculate_enrollment_estimate, initial_enrollment, growth_rate, initial_year, estimate_year);
+
+	// Return enrollment estimate
+	return calculate_enrollment_estimate(initial_enrollment, growth_rate, initial_year, estimate_year);
+}
+
+void helper_print_enrollment_estimates(int initial_enrollment, double growth_rate, int initial_year, int end_year)
+{
+	// Check if function works in forked process
+	CALL_FUNCTION_VOID(print_enrollment_estimates, initial_enrollment, growth_rate, initial_year, end_year);
+
+	// Print enrollment estimates
+	print_enrollment_estimates(initial_enrollment, growth_rate, initial_year, end_year);
+}
+
+char* test_support_trim(const char* string)
+{
+	// Start at beginning of string and find first non-space character
+	size_t first_nonspace = 0;
+	while (first_nonspace < strlen(string) && isspace(string[first_nonspace]))
+	{
+		// Increment position
+		first_nonspace++;
+	}
+
+	// Determine if there is anything non-whitespace left in the string
+	if (first_nonspace == strlen(string))
+	{
+		// String is all whitespace, so return null-terminated string
+		char* emptyPtr = malloc(sizeof(char) * 1);
+		if (emptyPtr == NULL) {
+			return NULL;
+		}
+
+		// Null terminate string
+		emptyPtr[0] = '\0';
+
+		return emptyPtr;
+	}
+
+	// Start at end of string and find last non-space character
+	size_t last_nonspace = strlen(string) - 1;
+	while (last_nonspace >= first_nonspace && isspace(string[last_nonspace]))
+	{
+		// Decrement position
+		last_nonspace--;
+	}
+
+	// Determine size of trimmed string, not including null terminator
 	size_t trimmed_length = last_nonspace - first_nonspace + 1;
 
 	// Allocate new string
@@ -1547,3 +3387,31 @@ char* test_support_trim(const char* string)
 
 	return trimmedPtr;
 }
+
+char* test_support_trim_line(char* output, bool last)
+{
+	// Find the start of the line, skipping the newline that ends the output
+	char* line = output;
+	if (last)
+	{
+		size_t end = strlen(output);
+		if (end > 0 && output[end - 1] == '\n')
+		{
+			end--;
+		}
+		while (end > 0 && output[end - 1] != '\n')
+		{
+			end--;
+		}
+		line = &output[end];
+	}
+
+	// End the string at the end of the line
+	char* newline = strchr(line, '\n');
+	if (newline != NULL)
+	{
+		*newline = '\0';
+	}
+
+	return test_support_trim(line);
+}
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <stdbool.h>
+
 /**
  * @brief Return value if int-returning function is unimplemented
  */
@@ -136,6 +138,231 @@ void test_2i_print_enrollment_estimates_first(void);
 */
 void test_2i_print_enrollment_estimates_last(void);
 
+/**
+ * @brief Tests calculate_growth_rates function against calculate_growth_rate with random scenarios
+*/
+void test_3a_calculate_growth_rates(void);
+
+/**
+ * @brief Tests calculate_growth_rates function with scenarios handled by the scalar fallback
+*/
+void test_3a_calculate_growth_rates_special_cases(void);
+
+/**
+ * @brief Tests calculate_enrollment_estimates function against calculate_enrollment_estimate with random scenarios
+*/
+void test_3b_calculate_enrollment_estimates(void);
+
+/**
+ * @brief Tests calculate_enrollment_estimates function over 10,000-year horizons
+*/
+void test_3b_calculate_enrollment_estimates_long_horizon(void);
+
+/**
+ * @brief Tests format_int function against printf formatting
+*/
+void test_3c_format_int(void);
+
+/**
+ * @brief Tests table_buffer_append_enrollment_estimates function against printf formatting
+*/
+void test_3c_table_buffer_append_enrollment_estimates(void);
+
+/**
+ * @brief Tests that print_enrollment_estimates_buffered output is byte-identical to print_enrollment_estimates
+*/
+void test_3c_print_enrollment_estimates_buffered(void);
+
+/**
+ * @brief Tests project_campuses function against calculate_growth_rate and calculate_enrollment_estimate
+*/
+void test_3d_project_campuses(void);
+
+/**
+ * @brief Tests that project_campuses produces the same matrix for every number of threads
+*/
+void test_3d_project_campuses_thread_counts(void);
+
+/**
+ * @brief Tests parse_campus_csv function with headers, line endings, int limits and malformed rows
+*/
+void test_3e_parse_campus_csv(void);
+
+/**
+ * @brief Tests load_campus_csv function against a file of random campuses
+*/
+void test_3e_load_campus_csv(void);
+
+/**
+ * @brief Tests write_projection_file function by mapping the file back with projection_file_open
+*/
+void test_3f_write_projection_file(void);
+
+/**
+ * @brief Tests that projection_file_open rejects truncated files, unsupported versions and other files
+*/
+void test_3f_projection_file_open_invalid(void);
+
+/**
+ * @brief Tests classify_growth_rates function against get_growth_rate_description for random rates
+*/
+void test_3g_classify_growth_rates(void);
+
+/**
+ * @brief Tests classify_growth_rates function on threshold boundaries, signed zeros, infinities and NaN
+*/
+void test_3g_classify_growth_rates_special_cases(void);
+
+/**
+ * @brief Tests read_target_enrollments function validation and token positions through a pipe
+*/
+void test_3h_read_target_enrollments(void);
+
+/**
+ * @brief Tests read_target_enrollments function on a file larger than its read buffer
+*/
+void test_3h_read_target_enrollments_large(void);
+
+/**
+ * @brief Tests simulate_enrollment_bands function validation and percentiles against the lognormal distribution
+*/
+void test_3i_simulate_enrollment_bands(void);
+
+/**
+ * @brief Tests simulate_enrollment_bands function gives identical bands for every thread count
+*/
+void test_3i_simulate_enrollment_bands_thread_counts(void);
+
+/**
+ * @brief Tests calculate_scheduled_enrollment_estimate function against calculate_enrollment_estimate and known schedules
+*/
+void test_3j_calculate_scheduled_enrollment_estimate(void);
+
+/**
+ * @brief Tests growth_schedule_append function validation and incremental caching against recomputation
+*/
+void test_3j_growth_schedule_append(void);
+
+/**
+ * @brief Tests projection server answers, caching, invalid and pipelined requests
+*/
+void test_3k_projection_server(void);
+
+/**
+ * @brief Tests projection server with several interleaved clients and one closing early
+*/
+void test_3k_projection_server_clients(void);
+
+/**
+ * @brief Tests growth factor table lookups on and between grid rates and fallback to pow
+*/
+void test_3l_growth_factor_table(void);
+
+/**
+ * @brief Tests growth factor table save and mapped load, including truncated and foreign files
+*/
+void test_3l_growth_factor_table_file(void);
+
+/**
+ * @brief Tests fixed-point growth factors and estimates against reference bits and between single and bulk calls
+*/
+void test_3m_fixed_point_projection(void);
+
+/**
+ * @brief Tests the divergence of the fixed-point path from the double-precision path over the tested ranges
+*/
+void test_3m_fixed_point_divergence(void);
+
+/**
+ * @brief Tests growth rate backfits of constant, noisy and incomplete histories
+*/
+void test_3n_fit_growth_rate(void);
+
+/**
+ * @brief Tests backfitting many campuses on and off a worker pool
+*/
+void test_3n_fit_growth_rates(void);
+
+/**
+ * @brief Tests estimates and growth rate sensitivities for ranges of years, including exact halves and -100%
+*/
+void test_3o_calculate_enrollment_sensitivities(void);
+
+/**
+ * @brief Tests a grid of estimates and sensitivities over rates and years against pow
+*/
+void test_3o_sensitivity_grid(void);
+
+/**
+ * @brief Tests calls through the fork server
+*/
+void test_3p_fork_server_call(void);
+
+/**
+ * @brief Tests that the fork server reports killed and hung children and keeps running
+*/
+void test_3p_fork_server_failures(void);
+
+/**
+ * @brief Tests waiting for children that exit and are killed by signals, and that waiting does not use the processor
+*/
+void test_3q_wait_for_child_pid(void);
+
+/**
+ * @brief Tests that a hung child is killed and reaped at a millisecond deadline
+*/
+void test_3q_wait_for_child_pid_timeout(void);
+
+/**
+ * @brief Tests that steps run on workers are reported in table order with their counts, including a crashed worker
+*/
+void test_3r_run_test_cases_parallel(void);
+
+/**
+ * @brief Tests parsing of the --jobs and --shard options and that shards split the steps
+*/
+void test_3r_test_runner_options(void);
+
+/**
+ * @brief Tests CALL_FUNCTION_*_WITH_RETURN through plain forks, with more calls than the slab has slots
+*/
+void test_3s_call_function_with_return(void);
+
+/**
+ * @brief Tests that result slots do not overlap, are zeroed, are shared with children and are reused
+*/
+void test_3s_get_result_slot(void);
+
+/**
+ * @brief Tests that nested output captures each get their own output and restore stdout
+*/
+void test_3t_start_output_capture(void);
+
+/**
+ * @brief Tests that concurrent children write to their own captures, with more output than a pipe holds
+*/
+void test_3t_open_output_capture(void);
+
+/**
+ * @brief Tests that children reading scripted input are reported when they exit or as soon as they block for more
+*/
+void test_3u_wait_for_child_pid_reading_input(void);
+
+/**
+ * @brief Tests that children sleeping with input left are not killed early and that hung children are killed at the deadline
+*/
+void test_3u_wait_for_child_pid_reading_input_timeout(void);
+
+/**
+ * @brief Tests allocation counts, live and peak bytes and the report of leaked blocks with their callers
+*/
+void test_3v_allocation_statistics(void);
+
+/**
+ * @brief Tests prefix, full and guard page poisoning of new blocks
+*/
+void test_3v_malloc_poisoning(void);
+
 /**
  * @brief Function to get the name of the programmer
  * @return String with the name of the programmer
@@ -196,3 +423,11 @@ void helper_print_enrollment_estimates(int initial_enrollment, double growth_rat
  * @return New dynamically allocating string containing trimmed version of input string, or NULL if it cannot be allocated
 */
 char* test_support_trim(const char* string);
+
+/**
+ * @brief Trims leading and trailing whitespace from the first or last line of captured output
+ * @param output Captured output (modified in place)
+ * @param last True for the last line, false for the first
+ * @return New dynamically allocating string containing trimmed version of the line, or NULL if it cannot be allocated
+*/
+char* test_support_trim_line(char* output, bool last);
@@ -0,0 +1,243 @@
+/**
+ * @file train_hw1_wvuep.c
+ * @brief Profile-guided optimization training workload for CS 350 Homework #1: WVU Enrollment Problem
+ * @author Rashaan Clay
+ *
+ * Build together with hw1_wvuep.c and the other module source files, without main_hw1_wvuep.c;
+ * the Makefile's pgo configuration builds it instrumented and runs it to collect the profile.
+ * Instead of the interactive prompt, it plays a planning office's scenario mix: campuses drawn
+ * mostly from small and mid-sized institutions with a few flagships, targets that are mostly
+ * modest growth with some decline, ambitious plans, closures and targets already in the past,
+ * and both the one-campus report of main_hw1_wvuep.c and the bulk paths run over them. Printed
+ * output goes to /dev/null. The optional argument scales the number of campuses.
+ */
+
+// Use GNU source for clock_gettime
+#define _GNU_SOURCE // NOLINT(*-reserved-identifier)
+
+#include "hw1_wvuep.h"
+#include "batch_hw1_wvuep.h"
+#include "series_hw1_wvuep.h"
+#include "table_hw1_wvuep.h"
+#include "engine_hw1_wvuep.h"
+#include "pool_hw1_wvuep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Number of campuses in the scenario mix when no argument is given
+ */
+#define TRAIN_DEFAULT_CAMPUSES 20000
+
+/**
+ * @brief Year of every initial enrollment, as in main_hw1_wvuep.c
+ */
+#define TRAIN_INITIAL_YEAR 2024
+
+/**
+ * @brief Last year of the printed reports, as in main_hw1_wvuep.c
+ */
+#define TRAIN_END_YEAR 2070
+
+/**
+ * @brief Number of campuses that get the full printed report of main_hw1_wvuep.c
+ */
+#define TRAIN_REPORTED_CAMPUSES 2000
+
+/**
+ * @brief Draw a uniformly distributed integer
+ * @param low Smallest value
+ * @param high Largest value
+ * @return Integer between low and high
+ */
+static int train_uniform(int low, int high)
+{
+	return low + rand() % (high - low + 1); // NOLINT(*-msc50-cpp)
+}
+
+/**
+ * @brief Draw an initial enrollment from the size mix of a state system
+ * @return Enrollment
+ */
+static int train_initial_enrollment(void)
+{
+	// Most campuses are small or mid-sized, with a few flagships
+	int size = train_uniform(0, 99);
+	if (size < 60)
+	{
+		return train_uniform(800, 6000);
+	}
+	else if (size < 95)
+	{
+		return train_uniform(6000, 20000);
+	}
+	return train_uniform(20000, 60000);
+}
+
+/**
+ * @brief Draw a target for an initial enrollment
+ * @param initial_enrollment Enrollment in the initial year
+ * @param target_year Receives the target year
+ * @return Target enrollment
+ */
+static int train_target_enrollment(int initial_enrollment, int* target_year)
+{
+	*target_year = TRAIN_INITIAL_YEAR + train_uniform(5, 30);
+
+	// Mostly modest change, with the unusual plans a planning office still has to run
+	int plan = train_uniform(0, 99);
+	if (plan < 50)
+	{
+		return (int)(initial_enrollment * (1.0 + train_uniform(0, 300) * 1e-3));
+	}
+	else if (plan < 75)
+	{
+		return (int)(initial_enrollment * (1.0 - train_uniform(0, 300) * 1e-3));
+	}
+	else if (plan < 95)
+	{
+		return (int)(initial_enrollment * (1.0 + train_uniform(300, 2000) * 1e-3));
+	}
+	else if (plan < 97)
+	{
+		return 0;
+	}
+	*target_year = TRAIN_INITIAL_YEAR - train_uniform(1, 10);
+	return initial_enrollment + train_uniform(-500, 500);
+}
+
+/**
+ * @brief Get the current time from a monotonic clock
+ * @return Time in seconds
+ */
+static double train_get_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Program entry point
+ * @param argc Number of arguments
+ * @param argv Arguments; argv[1] is the number of campuses
+ * @return Status code
+ */
+int main(int argc, char** argv)
+{
+	// Read the scale
+	long campus_count = argc > 1 ? strtol(argv[1], NULL, 10) : TRAIN_DEFAULT_CAMPUSES;
+	if (campus_count <= 0)
+	{
+		fprintf(stderr, "Usage: %s [campuses]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// Seed random number generator with a fixed value so every training run is the same
+	srand(350);
+	double start = train_get_time();
+
+	// Draw the campuses
+	struct campus_table campuses;
+	if (!campus_table_init(&campuses, (size_t)campus_count))
+	{
+		return EXIT_FAILURE;
+	}
+	for (long i = 0; i < campus_count; i++)
+	{
+		int target_year;
+		int initial_enrollment = train_initial_enrollment();
+		int target_enrollment = train_target_enrollment(initial_enrollment, &target_year);
+		if (!campus_table_add(&campuses, initial_enrollment, TRAIN_INITIAL_YEAR, target_enrollment, target_year))
+		{
+			campus_table_free(&campuses);
+			return EXIT_FAILURE;
+		}
+	}
+
+	// Send the printed reports to /dev/null, unbuffered like run_tests leaves stdout
+	int null_fd = open("/dev/null", O_WRONLY);
+	int saved_stdout = dup(STDOUT_FILENO);
+	if (null_fd < 0 || saved_stdout < 0)
+	{
+		fprintf(stderr, "Could not redirect output: %s.\n", strerror(errno));
+		campus_table_free(&campuses);
+		return EXIT_FAILURE;
+	}
+	setbuf(stdout, NULL);
+	dup2(null_fd, STDOUT_FILENO);
+
+	// Run the report of main_hw1_wvuep.c for a share of the campuses, and single lookups for all
+	long long checksum = 0;
+	for (size_t i = 0; i < campuses.count; i++)
+	{
+		double growth_rate = calculate_growth_rate(campuses.initial_enrollments[i], campuses.target_enrollments[i], campuses.initial_years[i], campuses.target_years[i]);
+		checksum += get_growth_rate_description(growth_rate)[0];
+		checksum += calculate_enrollment_estimate(campuses.initial_enrollments[i], growth_rate, TRAIN_INITIAL_YEAR, campuses.target_years[i]);
+		if (i < TRAIN_REPORTED_CAMPUSES)
+		{
+			print_growth_rate(growth_rate);
+			print_enrollment_estimates(campuses.initial_enrollments[i], growth_rate, TRAIN_INITIAL_YEAR, TRAIN_END_YEAR);
+			print_enrollment_estimates_buffered(campuses.initial_enrollments[i], growth_rate, TRAIN_INITIAL_YEAR, TRAIN_END_YEAR);
+		}
+	}
+
+	// Run the bulk paths over every campus
+	double* growth_rates = malloc(campuses.count * sizeof(double));
+	unsigned char* categories = malloc(campuses.count);
+	int* estimates = malloc((TRAIN_END_YEAR - TRAIN_INITIAL_YEAR + 1) * sizeof(int));
+	struct projection_matrix matrix;
+	struct worker_pool pool;
+	bool succeeded = growth_rates != NULL && categories != NULL && estimates != NULL;
+	if (!succeeded)
+	{
+		fprintf(stderr, "Could not allocate memory: %s.\n", strerror(errno));
+	}
+	else if (projection_matrix_init(&matrix, campuses.count, TRAIN_INITIAL_YEAR, TRAIN_END_YEAR))
+	{
+		size_t histogram[GROWTH_RATE_CATEGORY_COUNT];
+		calculate_growth_rates(campuses.initial_enrollments, campuses.target_enrollments, campuses.initial_years, campuses.target_years, growth_rates, campuses.count);
+		classify_growth_rates(growth_rates, categories, campuses.count, histogram);
+		for (size_t i = 0; i < campuses.count; i++)
+		{
+			checksum += (long long)calculate_enrollment_estimates(campuses.initial_enrollments[i], growth_rates[i], TRAIN_INITIAL_YEAR, TRAIN_END_YEAR, estimates);
+			checksum += estimates[TRAIN_END_YEAR - TRAIN_INITIAL_YEAR];
+		}
+
+		// Project on a pool when one can be started, and on this thread otherwise
+		bool pooled = worker_pool_init(&pool, worker_pool_default_thread_count());
+		project_campuses(pooled ? &pool : NULL, &campuses, &matrix);
+		if (pooled)
+		{
+			worker_pool_free(&pool);
+		}
+		checksum += matrix.estimates[(matrix.year_count - 1) * matrix.stride];
+		projection_matrix_free(&matrix);
+	}
+	else
+	{
+		succeeded = false;
+	}
+
+	// Redirect output to original destination
+	dup2(saved_stdout, STDOUT_FILENO);
+	close(saved_stdout);
+	close(null_fd);
+
+	// Report the run
+	printf("Trained on %ld campuses in %.3f s (checksum %lld)\n", campus_count, train_get_time() - start, checksum);
+
+	// Free memory
+	free(growth_rates);
+	free(categories);
+	free(estimates);
+	campus_table_free(&campuses);
+
+	return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
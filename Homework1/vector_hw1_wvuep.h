@@ -0,0 +1,125 @@
+/**
+ * @file vector_hw1_wvuep.h
+ * @brief Vector types and log/exp kernels shared by the CS 350 Homework #1 batch modules
+ * @author Rashaan Clay
+ *
+ * Four-lane double vectors written with GCC vector extensions, with the fdlibm log and exp
+ * reductions and polynomials evaluated on all lanes at once. The helpers are always inlined so
+ * that each caller's kernels compile them for their own target, AVX2 or SSE2.
+ */
+
+#pragma once
+
+// Kernel helpers are always inlined, so the AVX argument-passing ABI never applies to them
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/**
+ * @brief Four doubles processed together by the kernels
+ */
+typedef double vector_double __attribute__((vector_size(32)));
+
+/**
+ * @brief Four 64-bit integers used for bit manipulation and lane masks
+ */
+typedef long long vector_int64 __attribute__((vector_size(32)));
+
+/**
+ * @brief Four unsigned 64-bit integers used for logical shifts
+ */
+typedef unsigned long long vector_uint64 __attribute__((vector_size(32)));
+
+/**
+ * @brief Four 32-bit integers loaded from the input arrays
+ */
+typedef int vector_int32 __attribute__((vector_size(16)));
+
+/**
+ * @brief Number of doubles in a vector_double
+ */
+#define VECTOR_DOUBLE_LANES 4
+
+/**
+ * @brief 1.5 * 2^52, used to round doubles to integers and convert small integers to doubles
+ */
+#define ROUNDING_MAGIC 0x1.8p52
+
+/**
+ * @brief Bit pattern of ROUNDING_MAGIC
+ */
+#define ROUNDING_MAGIC_BITS 0x4338000000000000LL
+
+// Constants from fdlibm e_log.c
+static const double ln2_hi = 6.93147180369123816490e-01;
+static const double ln2_lo = 1.90821492927058770002e-10;
+static const double Lg1 = 6.666666666666735130e-01;
+static const double Lg2 = 3.999999999940941908e-01;
+static const double Lg3 = 2.857142874366239149e-01;
+static const double Lg4 = 2.222219843214978396e-01;
+static const double Lg5 = 1.818357216161805012e-01;
+static const double Lg6 = 1.531383769920937332e-01;
+static const double Lg7 = 1.479819860511658591e-01;
+
+// Constants from fdlibm e_exp.c
+static const double inv_ln2 = 1.44269504088896338700e+00;
+static const double P1 = 1.66666666666666019037e-01;
+static const double P2 = -2.77777777770155933842e-03;
+static const double P3 = 6.61375632143793436117e-05;
+static const double P4 = -1.65339022054652515390e-06;
+static const double P5 = 4.13813679705723846039e-08;
+
+/**
+ * @brief Natural logarithm of four positive, finite, normal doubles
+ * @param x Values to take the logarithm of
+ * @return Logarithms
+ */
+static inline __attribute__((always_inline)) vector_double vector_log(vector_double x)
+{
+	// Reduce x into [sqrt(2)/2, sqrt(2)) and extract the power of two k
+	vector_uint64 bits = (vector_uint64)x;
+	bits += 0x3ff0000000000000ULL - 0x3fe6a09e00000000ULL;
+	vector_int64 k = (vector_int64)(bits >> 52) - 0x3ff;
+	bits = (bits & 0x000fffffffffffffULL) + 0x3fe6a09e00000000ULL;
+	vector_double f = (vector_double)bits - 1.0;
+
+	// Convert k to double without a 64-bit integer conversion instruction
+	vector_double dk = (vector_double)(k + ROUNDING_MAGIC_BITS) - ROUNDING_MAGIC;
+
+	// Evaluate polynomial approximation of log(1 + f)
+	vector_double hfsq = 0.5 * f * f;
+	vector_double s = f / (2.0 + f);
+	vector_double z = s * s;
+	vector_double w = z * z;
+	vector_double t1 = w * (Lg2 + w * (Lg4 + w * Lg6));
+	vector_double t2 = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+	vector_double r = t2 + t1;
+
+	return s * (hfsq + r) + dk * ln2_lo - hfsq + f + dk * ln2_hi;
+}
+
+/**
+ * @brief Exponential of four doubles with magnitude below 700
+ * @param x Values to exponentiate
+ * @return Exponentials
+ */
+static inline __attribute__((always_inline)) vector_double vector_exp(vector_double x)
+{
+	// Reduce x to r = x - k * ln(2) with |r| <= 0.5 * ln(2)
+	vector_double kd = (x * inv_ln2 + ROUNDING_MAGIC) - ROUNDING_MAGIC;
+	vector_double hi = x - kd * ln2_hi;
+	vector_double lo = kd * ln2_lo;
+	vector_double r = hi - lo;
+
+	// Evaluate rational approximation of exp(r)
+	vector_double rr = r * r;
+	vector_double c = r - rr * (P1 + rr * (P2 + rr * (P3 + rr * (P4 + rr * P5))));
+	vector_double y = 1.0 + (r * c / (2.0 - c) - lo + hi);
+
+	// Scale by 2^k by building the power of two directly from its exponent bits
+	vector_int64 k = (vector_int64)(kd + ROUNDING_MAGIC) - ROUNDING_MAGIC_BITS;
+	vector_double scale = (vector_double)((k + 0x3ff) << 52);
+
+	return y * scale;
+}
+
+#pragma GCC diagnostic pop